@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace BoundingShapes
+{
+    // axis aligned boxes stored as a structure of arrays, so several boxes can be tested at once
+    // the arrays are padded to a multiple of c_box_batch_width, only the first count boxes are valid
+    struct AxisAlignedBoxBatch
+    {
+        std::vector<float> center_x, center_y, center_z;
+        std::vector<float> extent_x, extent_y, extent_z;
+        uint32_t count = 0;
+    };
+}
@@ -0,0 +1,171 @@
+#include "AxisAlignedBoxBatchFunctions.h"
+
+#include "FrustumFunctions.h"
+
+#include <Math\SSE.h>
+
+#include <Utilities\StdVectorFunctions.h>
+
+#include <array>
+#include <cassert>
+
+namespace BoundingShapes
+{
+    namespace
+    {
+        size_t PaddedSize( size_t count )
+        {
+            return ( count + c_box_batch_width - 1 ) / c_box_batch_width * c_box_batch_width;
+        }
+
+
+        void ResizeBatch( size_t count, AxisAlignedBoxBatch & batch )
+        {
+            auto const padded_size = PaddedSize( count );
+            // the padding is never used, but it should contain valid floats
+            batch.center_x.assign( padded_size, 0 );
+            batch.center_y.assign( padded_size, 0 );
+            batch.center_z.assign( padded_size, 0 );
+            batch.extent_x.assign( padded_size, 0 );
+            batch.extent_y.assign( padded_size, 0 );
+            batch.extent_z.assign( padded_size, 0 );
+            batch.count = uint32_t( count );
+        }
+
+
+        void SetBox( AxisAlignedBox const & box, size_t index, AxisAlignedBoxBatch & batch )
+        {
+            batch.center_x[index] = box.center.x;
+            batch.center_y[index] = box.center.y;
+            batch.center_z[index] = box.center.z;
+            batch.extent_x[index] = box.extent.x;
+            batch.extent_y[index] = box.extent.y;
+            batch.extent_z[index] = box.extent.z;
+        }
+
+
+        // every component of the plane is repeated in all four lanes
+        struct PlaneSSE
+        {
+            Math::SSE::Float32Vector normal_x, normal_y, normal_z;
+            Math::SSE::Float32Vector absolute_normal_x, absolute_normal_y, absolute_normal_z;
+            Math::SSE::Float32Vector distance;
+        };
+
+
+        PlaneSSE SplatPlane( Plane const & plane )
+        {
+            using namespace Math::SSE;
+            PlaneSSE result;
+            result.normal_x = SetAll( plane.normal.x );
+            result.normal_y = SetAll( plane.normal.y );
+            result.normal_z = SetAll( plane.normal.z );
+            result.absolute_normal_x = Abs( result.normal_x );
+            result.absolute_normal_y = Abs( result.normal_y );
+            result.absolute_normal_z = Abs( result.normal_z );
+            result.distance = SetAll( plane.distance );
+            return result;
+        }
+    }
+
+
+    void CreateAxisAlignedBoxBatch( Range<AxisAlignedBox const *> boxes, AxisAlignedBoxBatch & batch )
+    {
+        ResizeBatch( Size( boxes ), batch );
+        for( auto i = 0u; i < Size( boxes ); ++i )
+        {
+            SetBox( boxes[i], i, batch );
+        }
+    }
+
+
+    void CreateAxisAlignedBoxBatch( Range<AxisAlignedBox const *> boxes, Range<uint32_t const *> indices, AxisAlignedBoxBatch & batch )
+    {
+        ResizeBatch( Size( indices ), batch );
+        for( auto i = 0u; i < Size( indices ); ++i )
+        {
+            SetBox( boxes[indices[i]], i, batch );
+        }
+    }
+
+
+    void Clear( AxisAlignedBoxBatch & batch )
+    {
+        ResizeBatch( 0, batch );
+    }
+
+
+    size_t BoxCount( AxisAlignedBoxBatch const & batch )
+    {
+        return batch.count;
+    }
+
+
+    void Intersect( AxisAlignedBoxBatch const & batch, Range<Plane const *> planes, std::vector<uint32_t> & contained_indices )
+    {
+        using namespace Math::SSE;
+        assert( Size( planes ) <= c_maximum_batch_planes );
+
+        std::array<PlaneSSE, c_maximum_batch_planes> sse_planes;
+        auto const plane_count = Size( planes );
+        for( auto p = 0u; p < plane_count; ++p )
+        {
+            sse_planes[p] = SplatPlane( planes[p] );
+        }
+
+        // make room for all boxes, so the indices can be written without checking whether they are needed
+        auto const offset = Size( contained_indices );
+        contained_indices.resize( offset + PaddedSize( batch.count ) );
+        auto output = contained_indices.data() + offset;
+        auto output_count = 0u;
+
+        auto const zero = SetAll( 0.f );
+        for( auto i = 0u; i < batch.count; i += c_box_batch_width )
+        {
+            auto const center_x = Load( batch.center_x.data() + i );
+            auto const center_y = Load( batch.center_y.data() + i );
+            auto const center_z = Load( batch.center_z.data() + i );
+            auto const extent_x = Load( batch.extent_x.data() + i );
+            auto const extent_y = Load( batch.extent_y.data() + i );
+            auto const extent_z = Load( batch.extent_z.data() + i );
+
+            // a box is outside if the corner furthest along the normal is behind any of the planes
+            auto outside = LessThan( zero, zero );
+            for( auto p = 0u; p < plane_count; ++p )
+            {
+                auto const & plane = sse_planes[p];
+                auto distance = MultiplyAdd( plane.normal_x, center_x, plane.distance );
+                distance = MultiplyAdd( plane.normal_y, center_y, distance );
+                distance = MultiplyAdd( plane.normal_z, center_z, distance );
+                distance = MultiplyAdd( plane.absolute_normal_x, extent_x, distance );
+                distance = MultiplyAdd( plane.absolute_normal_y, extent_y, distance );
+                distance = MultiplyAdd( plane.absolute_normal_z, extent_z, distance );
+                outside = Or( outside, LessThan( distance, zero ) );
+            }
+
+            auto const remaining = batch.count - i;
+            auto const valid_lanes = remaining >= c_box_batch_width ? 0xFu : ( 1u << remaining ) - 1;
+            auto const inside_lanes = ~MaskSignBits( outside ) & valid_lanes;
+
+            // always write the index, but only advance if the box is inside
+            output[output_count] = i + 0;
+            output_count += inside_lanes & 1;
+            output[output_count] = i + 1;
+            output_count += ( inside_lanes >> 1 ) & 1;
+            output[output_count] = i + 2;
+            output_count += ( inside_lanes >> 2 ) & 1;
+            output[output_count] = i + 3;
+            output_count += ( inside_lanes >> 3 ) & 1;
+        }
+
+        contained_indices.resize( offset + output_count );
+    }
+
+
+    void IntersectFrustum( AxisAlignedBoxBatch const & batch, Math::Float4x4 const & projection_matrix, std::vector<uint32_t> & intersecting_indices )
+    {
+        std::array<Plane, 6> planes;
+        GetFrustumPlanes( projection_matrix, planes );
+        Intersect( batch, planes, intersecting_indices );
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "AxisAlignedBox.h"
+#include "AxisAlignedBoxBatch.h"
+#include "Plane.h"
+
+#include <Math\FloatMatrixTypes.h>
+#include <Utilities\Range.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace BoundingShapes
+{
+    // number of boxes that are tested at once
+    uint32_t const c_box_batch_width = 4;
+    // maximum number of planes the boxes in a batch can be tested against
+    uint32_t const c_maximum_batch_planes = 8;
+
+    // fills the batch with the boxes, keeps the capacity of the batch
+    void CreateAxisAlignedBoxBatch( Range<AxisAlignedBox const *> boxes, AxisAlignedBoxBatch & batch );
+    // fills the batch with the boxes at the given indices, the indices returned by the intersection tests point into the indices range
+    void CreateAxisAlignedBoxBatch( Range<AxisAlignedBox const *> boxes, Range<uint32_t const *> indices, AxisAlignedBoxBatch & batch );
+    void Clear( AxisAlignedBoxBatch & batch );
+    size_t BoxCount( AxisAlignedBoxBatch const & batch );
+
+    // appends the indices of the boxes that intersect with the area contained by the planes, in increasing order
+    void Intersect( AxisAlignedBoxBatch const & batch, Range<Plane const *> planes, std::vector<uint32_t> & contained_indices );
+    // appends the indices of the boxes that intersect with the frustum defined by the projection matrix, see IntersectFrustum
+    void IntersectFrustum( AxisAlignedBoxBatch const & batch, Math::Float4x4 const & projection_matrix, std::vector<uint32_t> & intersecting_indices );
+}
@@ -30,6 +30,18 @@ namespace BoundingShapes
     }
 
 
+    AxisAlignedBoxHierarchyMesh CreateAxisAlignedBoxHierarchyMeshSAH( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices )
+    {
+        return CreateBoundingShapeHierarchyMeshSAH( move( vertex_positions ), move( indices ), CreateAxisAlignedBox );
+    }
+
+
+    float ExpectedTraversalCost( AxisAlignedBoxHierarchyMesh const & mesh )
+    {
+        return ExpectedTraversalCost<>( mesh );
+    }
+
+
     AxisAlignedBoxHierarchyMesh Transform( AxisAlignedBoxHierarchyMesh mesh, Math::Float4x4 const & transform )
     {
         mesh = Transform<>( std::move( mesh ), transform );
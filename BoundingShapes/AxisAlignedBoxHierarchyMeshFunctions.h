@@ -9,6 +9,10 @@
 namespace BoundingShapes
 {
     AxisAlignedBoxHierarchyMesh CreateAxisAlignedBoxHierarchyMesh( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices );
+    // builds a tree that is cheaper to traverse, but takes longer to build, use it for offline conversion
+    AxisAlignedBoxHierarchyMesh CreateAxisAlignedBoxHierarchyMeshSAH( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices );
+    // expected number of shape and triangle tests per query, see BoundingShapeHierarchyMeshFunctions.h
+    float ExpectedTraversalCost( AxisAlignedBoxHierarchyMesh const & mesh );
 
     AxisAlignedBoxHierarchyMesh Transform( AxisAlignedBoxHierarchyMesh mesh, Math::Float4x4 const & transform );
     AxisAlignedBoxHierarchyMesh TransformByOrientation( AxisAlignedBoxHierarchyMesh mesh, Orientation const & orientation );
@@ -17,9 +17,20 @@ namespace BoundingShapes
     template<typename ShapeType>
     using CreateShapeFunction = ShapeType( *)( Range<Math::Float3 const*> positions, Range<unsigned const *> indices );
 
+    // splits the triangles in two halves of the same size, along the direction given by find_split_direction
     template<typename ShapeType>
     BoundingShapeHierarchyMesh<ShapeType> CreateBoundingShapeHierarchyMesh( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices, FindSplitDirectionFunction const find_split_direction, CreateShapeFunction<ShapeType> create_shape );
 
+    // splits the triangles where the binned surface area heuristic is lowest
+    // slower to build than the median split, so meant for offline use, but the resulting tree is cheaper to traverse
+    template<typename ShapeType>
+    BoundingShapeHierarchyMesh<ShapeType> CreateBoundingShapeHierarchyMeshSAH( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices, CreateShapeFunction<ShapeType> create_shape );
+
+    // expected number of node and triangle tests for a query somewhere inside the bounds of the mesh, according to the surface area heuristic
+    // uses the axis aligned bounds of the triangles below each node, regardless of the shape type of the nodes
+    template<typename ShapeType>
+    float ExpectedTraversalCost( BoundingShapeHierarchyMesh<ShapeType> const & tree );
+
     template<typename ShapeType>
     BoundingShapeHierarchyMesh<ShapeType> Transform( BoundingShapeHierarchyMesh<ShapeType> mesh, Math::Float4x4 const & transform );
 
@@ -10,8 +10,12 @@
 #include <Math\IntegerTypes.h>
 
 #include <Utilities\IntegerRange.h>
+#include <Utilities\MinMaxFunctions.h>
 #include <Utilities\VertexReordering.h>
 
+#include <algorithm>
+#include <array>
+#include <limits>
 #include <tuple> // for tie
 
 
@@ -19,7 +23,30 @@ namespace BoundingShapes
 {
     namespace
     {
-        void Split( Range<unsigned *> indices, std::vector<Math::Float3> const & vertex_positions, FindSplitDirectionFunction const find_split_direction )
+        Math::Float3 Centroid( std::vector<Math::Float3> const & vertex_positions, Math::Unsigned3 const & triangle )
+        {
+            return ( vertex_positions[triangle[0]] + vertex_positions[triangle[1]] + vertex_positions[triangle[2]] ) / 3;
+        }
+
+
+        MinMax<Math::Float3> TriangleBounds( std::vector<Math::Float3> const & vertex_positions, Math::Unsigned3 const & triangle )
+        {
+            auto bounds = MinMax<Math::Float3>{ vertex_positions[triangle[0]], vertex_positions[triangle[0]] };
+            bounds = Update( bounds, vertex_positions[triangle[1]] );
+            return Update( bounds, vertex_positions[triangle[2]] );
+        }
+
+
+        // half of the surface area, only the ratios are used so the factor doesn't matter
+        float HalfSurfaceArea( MinMax<Math::Float3> const & bounds )
+        {
+            auto const size = bounds.max - bounds.min;
+            return size.x * size.y + size.y * size.z + size.z * size.x;
+        }
+
+
+        // sorts the triangles along the direction and returns the number of triangles in the first half
+        unsigned SplitMedian( Range<unsigned *> indices, std::vector<Math::Float3> const & vertex_positions, FindSplitDirectionFunction const find_split_direction )
         {
             using namespace Math;
             auto const direction = find_split_direction( vertex_positions, indices );
@@ -27,45 +54,120 @@ namespace BoundingShapes
             // do this ugly thing so we can sort the triplets, without having to copy everything
             auto const triplet_range = ReinterpretRange<Unsigned3>(indices);
 
+            // divide in half, with the first half having one more if uneven number of triplets
             auto const size = Size(triplet_range);
-            auto const half = triplet_range.start + size / 2;
+            auto const first_half_size = unsigned( ( size + 1 ) / 2 );
+            auto const half = triplet_range.start + first_half_size;
             std::nth_element( triplet_range.start, half, triplet_range.stop, [&vertex_positions, direction]( Unsigned3 const & first, Unsigned3 const & second )
             {
+                // compare the centers of the whole triangles, fall back to the indices so the order is strict
+                auto const center1 = Dot( Centroid( vertex_positions, first ), direction );
+                auto const center2 = Dot( Centroid( vertex_positions, second ), direction );
+                return std::tie( center1, first[0], first[1], first[2] ) < std::tie( center2, second[0], second[1], second[2] );
+            }
+            );
+            return first_half_size;
+        }
 
-                auto const triangle1 = CreateTriangle( vertex_positions[first[0]], vertex_positions[first[0]], vertex_positions[first[0]] );
-                auto const triangle2 = CreateTriangle( vertex_positions[second[0]], vertex_positions[second[0]], vertex_positions[second[0]] );
 
-                auto const minmax1 = SAT::ProjectToAxis( triangle1.corners, direction );
-                auto const minmax2 = SAT::ProjectToAxis( triangle2.corners, direction );
+        unsigned const c_sah_bin_count = 16;
 
-                // assuming the direction is positive
-                // separated: 1 before 2
-                if( minmax1.max < minmax2.min )
-                {
-                    return true;
-                }
-                // separated: 2 before 1
-                else if( minmax2.max < minmax1.min )
+
+        unsigned SAHBinIndex( float centroid, float axis_min, float axis_extent )
+        {
+            auto const bin = unsigned( ( centroid - axis_min ) / axis_extent * c_sah_bin_count );
+            return std::min( bin, c_sah_bin_count - 1 );
+        }
+
+
+        // bins the triangle centers along each axis and splits between the bins with the lowest surface area heuristic
+        // returns the number of triangles in the first half
+        unsigned SplitSAH( Range<unsigned *> indices, std::vector<Math::Float3> const & vertex_positions )
+        {
+            using namespace Math;
+            auto const triplet_range = ReinterpretRange<Unsigned3>(indices);
+            auto const triplet_count = unsigned( Size( triplet_range ) );
+
+            auto const first_centroid = Centroid( vertex_positions, First( triplet_range ) );
+            auto centroid_bounds = MinMax<Float3>{ first_centroid, first_centroid };
+            for( auto const & triangle : triplet_range )
+            {
+                centroid_bounds = Update( centroid_bounds, Centroid( vertex_positions, triangle ) );
+            }
+
+            struct Bin
+            {
+                MinMax<Float3> bounds;
+                unsigned count;
+            };
+
+            auto best_cost = std::numeric_limits<float>::max();
+            auto best_axis = 0u;
+            // the number of bins in the first half
+            auto best_split = 0u;
+            for( auto axis = 0u; axis < 3; ++axis )
+            {
+                auto const axis_min = centroid_bounds.min[axis];
+                auto const axis_extent = centroid_bounds.max[axis] - axis_min;
+                if( !( axis_extent > 0 ) ) continue;
+
+                std::array<Bin, c_sah_bin_count> bins;
+                for( auto & bin : bins ) bin.count = 0;
+                for( auto const & triangle : triplet_range )
                 {
-                    return false;
+                    auto & bin = bins[SAHBinIndex( Centroid( vertex_positions, triangle )[axis], axis_min, axis_extent )];
+                    auto const bounds = TriangleBounds( vertex_positions, triangle );
+                    bin.bounds = bin.count == 0 ? bounds : Combine( bin.bounds, bounds );
+                    ++bin.count;
                 }
-                // overlapping: 1 before 2
-                else if( minmax1.min < minmax2.min && minmax1.max < minmax2.max )
+
+                // sweep from the back to get the cost of every possible second half
+                std::array<float, c_sah_bin_count> second_half_costs;
+                auto second_half = Bin{ {}, 0 };
+                for( auto b = c_sah_bin_count - 1; b > 0; --b )
                 {
-                    return true;
+                    if( bins[b].count > 0 )
+                    {
+                        second_half.bounds = second_half.count == 0 ? bins[b].bounds : Combine( second_half.bounds, bins[b].bounds );
+                        second_half.count += bins[b].count;
+                    }
+                    second_half_costs[b] = second_half.count > 0 ? HalfSurfaceArea( second_half.bounds ) * second_half.count : 0;
                 }
-                // overlapping: 2 before 1
-                else if( minmax2.min < minmax1.min && minmax2.max < minmax1.max )
+
+                auto first_half = Bin{ {}, 0 };
+                for( auto b = 0u; b < c_sah_bin_count - 1; ++b )
                 {
-                    return false;
+                    if( bins[b].count > 0 )
+                    {
+                        first_half.bounds = first_half.count == 0 ? bins[b].bounds : Combine( first_half.bounds, bins[b].bounds );
+                        first_half.count += bins[b].count;
+                    }
+                    // both halves need at least one triangle
+                    if( first_half.count == 0 || first_half.count == triplet_count ) continue;
+
+                    auto const cost = HalfSurfaceArea( first_half.bounds ) * first_half.count + second_half_costs[b + 1];
+                    if( cost < best_cost )
+                    {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_split = b + 1;
+                    }
                 }
-                // overlapping and one extends beyond the other, check the center or indices themself
-                auto const center1 = minmax1.max - minmax1.min;
-                auto const center2 = minmax2.max - minmax2.min;
+            }
 
-                return std::tie( center1, first[0], first[1], first[2] ) < std::tie( center2, second[0], second[1], second[2] );
+            if( best_split == 0 )
+            {
+                // all centers are at the same position, any split is as good as any other
+                return ( triplet_count + 1 ) / 2;
             }
-            );
+
+            auto const axis_min = centroid_bounds.min[best_axis];
+            auto const axis_extent = centroid_bounds.max[best_axis] - axis_min;
+            auto const middle = std::partition( begin( triplet_range ), end( triplet_range ), [&]( Unsigned3 const & triangle )
+            {
+                return SAHBinIndex( Centroid( vertex_positions, triangle )[best_axis], axis_min, axis_extent ) < best_split;
+            } );
+            return unsigned( middle - begin( triplet_range ) );
         }
 
         // returns the number of child nodes in the tree given the number of leafs
@@ -84,8 +186,9 @@ namespace BoundingShapes
             return child_count / 2 + 1;
         }
 
-        template<typename NodeType>
-        void SortIndicesAndAddNodes( Range<unsigned *> indices, std::vector<Math::Float3> const & vertex_positions, std::vector<NodeType> & nodes, FindSplitDirectionFunction const find_split_direction )
+        // split_function reorders the triplets and returns how many of them go into the first child
+        template<typename NodeType, typename SplitFunctionType>
+        void SortIndicesAndAddNodes( Range<unsigned *> indices, std::vector<Math::Float3> const & vertex_positions, std::vector<NodeType> & nodes, SplitFunctionType const & split_function )
         {
             auto const triplet_count = unsigned( Size(indices) / 3 );
             if( triplet_count > 1 )
@@ -93,15 +196,15 @@ namespace BoundingShapes
                 auto const index = unsigned( nodes.size( ) );
                 nodes.emplace_back( );
                 nodes.back( ).escape_index = index + NodesFromLeafs( triplet_count );
-                Split( indices, vertex_positions, find_split_direction );
+                auto const first_count = split_function( indices, vertex_positions );
+                assert( first_count > 0 && first_count < triplet_count );
 
-                // divide in half, with the first half having one more if uneven number of triplets
                 // multiply with 3 because we split the triplets and have a vector of bare indices
-                auto const half_point = indices.start + ( ( triplet_count + 1 ) / 2 ) * 3;
+                auto const half_point = indices.start + first_count * 3;
                 auto const half1 = CreateRange( indices.start, half_point );
                 auto const half2 = CreateRange( half_point, indices.stop );
-                SortIndicesAndAddNodes( half1, vertex_positions, nodes, find_split_direction );
-                SortIndicesAndAddNodes( half2, vertex_positions, nodes, find_split_direction );
+                SortIndicesAndAddNodes( half1, vertex_positions, nodes, split_function );
+                SortIndicesAndAddNodes( half2, vertex_positions, nodes, split_function );
             }
             else
             {
@@ -131,21 +234,79 @@ namespace BoundingShapes
                 }
             }
         }
+
+
+        template<typename ShapeType, typename SplitFunctionType>
+        BoundingShapeHierarchyMesh<ShapeType> CreateBoundingShapeHierarchyMeshImpl( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices, SplitFunctionType const & split_function, CreateShapeFunction<ShapeType> create_shape )
+        {
+            auto const node_count = NodesFromLeafs( unsigned( indices.size( ) / 3 ) );
+            std::vector<typename BoundingShapeHierarchyMesh<ShapeType>::Node> nodes;
+            nodes.reserve( node_count );
+            SortIndicesAndAddNodes( indices, vertex_positions, nodes, split_function );
+            auto new_indices = CalculateNewIndices( indices, unsigned( vertex_positions.size( ) ) );
+            vertex_positions = ReorderData( std::move( vertex_positions ), indices, new_indices );
+
+            FillNodes( nodes, new_indices, vertex_positions, create_shape );
+
+            return{ nodes, vertex_positions };
+        }
     }
 
     template<typename ShapeType>
     BoundingShapeHierarchyMesh<ShapeType> CreateBoundingShapeHierarchyMesh( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices, FindSplitDirectionFunction const find_split_direction, CreateShapeFunction<ShapeType> create_shape )
     {
-        auto const node_count = NodesFromLeafs( unsigned( indices.size( ) / 3 ) );
-        std::vector<typename BoundingShapeHierarchyMesh<ShapeType>::Node> nodes;
-        nodes.reserve( node_count );
-        SortIndicesAndAddNodes( indices, vertex_positions, nodes, find_split_direction );
-        auto new_indices = CalculateNewIndices( indices, unsigned( vertex_positions.size( ) ) );
-        vertex_positions = ReorderData( std::move( vertex_positions ), indices, new_indices );
+        auto const split_function = [find_split_direction]( Range<unsigned *> indices, std::vector<Math::Float3> const & vertex_positions )
+        {
+            return SplitMedian( indices, vertex_positions, find_split_direction );
+        };
+        return CreateBoundingShapeHierarchyMeshImpl( std::move( vertex_positions ), std::move( indices ), split_function, create_shape );
+    }
+
+
+    template<typename ShapeType>
+    BoundingShapeHierarchyMesh<ShapeType> CreateBoundingShapeHierarchyMeshSAH( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices, CreateShapeFunction<ShapeType> create_shape )
+    {
+        return CreateBoundingShapeHierarchyMeshImpl( std::move( vertex_positions ), std::move( indices ), SplitSAH, create_shape );
+    }
+
+
+    template<typename ShapeType>
+    float ExpectedTraversalCost( BoundingShapeHierarchyMesh<ShapeType> const & tree )
+    {
+        auto const node_count = unsigned( Size( tree.nodes ) );
+        if( node_count == 0 ) return 0;
 
-        FillNodes( nodes, new_indices, vertex_positions, create_shape );
+        // the children of a node are stored after it, so going backwards gives the bounds of the children first
+        std::vector<MinMax<Math::Float3>> bounds( node_count );
+        for( auto i = node_count; i-- > 0; )
+        {
+            auto const & node = tree.nodes[i];
+            if( node.escape_index == i + 1 )
+            {
+                auto const & vertex_indices = node.vertex_indices;
+                auto const triangle = Math::Unsigned3( vertex_indices[0], vertex_indices[1], vertex_indices[2] );
+                bounds[i] = TriangleBounds( tree.vertex_positions, triangle );
+            }
+            else
+            {
+                bounds[i] = Combine( bounds[i + 1], bounds[tree.nodes[i + 1].escape_index] );
+            }
+        }
 
-        return{ nodes, vertex_positions };
+        // a node or triangle is tested when the query overlaps its parent, the chance of that is the ratio of the surface areas
+        auto const root_area = HalfSurfaceArea( bounds[0] );
+        if( !( root_area > 0 ) ) return float( node_count );
+        auto cost = 1.f;
+        for( auto i = 0u; i < node_count; ++i )
+        {
+            auto const & node = tree.nodes[i];
+            if( node.escape_index != i + 1 )
+            {
+                // both children are tested
+                cost += 2 * HalfSurfaceArea( bounds[i] ) / root_area;
+            }
+        }
+        return cost;
     }
 
 
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <Math\FloatTypes.h>
+
+namespace BoundingShapes
+{
+    // all points within radius of the line segment from start to end
+    struct Capsule
+    {
+        Math::Float3 start;
+        Math::Float3 end;
+        float radius;
+    };
+}
@@ -0,0 +1,302 @@
+#include "CapsuleFunctions.h"
+
+#include "AxisAlignedBoxFunctions.h"
+#include "TriangleFunctions.h"
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+#include <Math\MathConstants.h>
+#include <Math\TransformFunctions.h>
+
+#include <array>
+#include <cassert>
+#include <limits>
+
+namespace BoundingShapes
+{
+    namespace
+    {
+        // below this squared length the axis is treated as a point
+        float const c_squared_length_tolerance = 1e-12f;
+        // each step of the golden section search shrinks the interval to 0.618 of its size
+        uint32_t const c_golden_section_iterations = 32;
+
+
+        float SquaredDistance( Triangle const & triangle, Math::Float3 point )
+        {
+            return SquaredNorm( point - ClosestPoint( triangle, point ) );
+        }
+
+
+        float SquaredDistanceToExtent( Math::Float3 extent, Math::Float3 point )
+        {
+            return SquaredNorm( point - Clamp( -extent, extent, point ) );
+        }
+    }
+
+
+    Capsule CreateCapsule( Range<Math::Float3 const *> points )
+    {
+        assert( !IsEmpty( points ) );
+        // the two points farthest apart lie on the caps and give the axis direction
+        auto farthest_start = First( points );
+        auto farthest_end = First( points );
+        auto farthest_squared_distance = 0.f;
+        for( auto i = 0u; i < Size( points ); ++i )
+        {
+            for( auto j = i + 1; j < Size( points ); ++j )
+            {
+                auto const squared_distance = SquaredNorm( points[j] - points[i] );
+                if( squared_distance > farthest_squared_distance )
+                {
+                    farthest_squared_distance = squared_distance;
+                    farthest_start = points[i];
+                    farthest_end = points[j];
+                }
+            }
+        }
+
+        Capsule capsule;
+        capsule.start = ( farthest_start + farthest_end ) / 2;
+        capsule.end = capsule.start;
+        capsule.radius = 0;
+        if( farthest_squared_distance <= c_squared_length_tolerance )
+        {
+            return capsule;
+        }
+
+        // the radius is the largest distance from the axis, the caps start that far from the extreme points along it
+        auto const center = capsule.start;
+        auto const direction = ( farthest_end - farthest_start ) / Math::Sqrt( farthest_squared_distance );
+        auto minimum = 0.f;
+        auto maximum = 0.f;
+        auto squared_radius = 0.f;
+        for( auto const & point : points )
+        {
+            auto const offset = point - center;
+            auto const parameter = Dot( offset, direction );
+            minimum = Math::Min( parameter, minimum );
+            maximum = Math::Max( parameter, maximum );
+            squared_radius = Math::Max( SquaredNorm( offset - direction * parameter ), squared_radius );
+        }
+        auto const radius = Math::Sqrt( squared_radius );
+        capsule.start = center + direction * Math::Min( minimum + radius, 0.f );
+        capsule.end = center + direction * Math::Max( maximum - radius, 0.f );
+        // points that are not on a round cap, or a capsule shorter than its diameter, need a larger radius
+        for( auto const & point : points )
+        {
+            auto const axis_point = GetAxisPoint( capsule, ClosestAxisParameter( capsule, point ) );
+            squared_radius = Math::Max( SquaredNorm( point - axis_point ), squared_radius );
+        }
+        capsule.radius = Math::Sqrt( squared_radius );
+        return capsule;
+    }
+
+
+    Capsule Transform( Capsule capsule, Math::Float4x4 const & transform )
+    {
+        capsule.start = Math::TransformPosition( capsule.start, transform );
+        capsule.end = Math::TransformPosition( capsule.end, transform );
+        return capsule;
+    }
+
+
+    Capsule TransformByOrientation( Capsule capsule, Orientation const & orientation )
+    {
+        capsule.start = Math::Rotate( capsule.start, orientation.rotation ) + orientation.position;
+        capsule.end = Math::Rotate( capsule.end, orientation.rotation ) + orientation.position;
+        return capsule;
+    }
+
+
+    Capsule Rotate( Capsule capsule, Math::Quaternion const & rotation )
+    {
+        capsule.start = Math::Rotate( capsule.start, rotation );
+        capsule.end = Math::Rotate( capsule.end, rotation );
+        return capsule;
+    }
+
+
+    Capsule Translate( Capsule capsule, Math::Float3 translation )
+    {
+        capsule.start += translation;
+        capsule.end += translation;
+        return capsule;
+    }
+
+
+    float Volume( Capsule const & capsule )
+    {
+        // cylinder plus a sphere, pi r² h + 4/3 pi r³
+        auto const length = Norm( capsule.end - capsule.start );
+        auto const squared_radius = capsule.radius * capsule.radius;
+        return Math::c_PI.f * squared_radius * ( length + 4.f / 3.f * capsule.radius );
+    }
+
+
+    Math::Float3 GetCenter( Capsule const & capsule )
+    {
+        return ( capsule.start + capsule.end ) / 2;
+    }
+
+
+    AxisAlignedBox CreateAxisAlignedBox( Capsule const & capsule )
+    {
+        AxisAlignedBox box;
+        box.center = ( capsule.start + capsule.end ) / 2;
+        box.extent = Abs( capsule.end - capsule.start ) / 2 + capsule.radius;
+        return box;
+    }
+
+
+    Math::Float3 GetAxisPoint( Capsule const & capsule, float parameter )
+    {
+        return capsule.start + ( capsule.end - capsule.start ) * parameter;
+    }
+
+
+    float ClosestAxisParameter( Capsule const & capsule, Math::Float3 point )
+    {
+        auto const axis = capsule.end - capsule.start;
+        auto const squared_length = SquaredNorm( axis );
+        if( squared_length <= c_squared_length_tolerance ) return 0;
+        return Math::Clamp( 0.f, 1.f, Dot( point - capsule.start, axis ) / squared_length );
+    }
+
+
+    void ClosestAxisParameters( Capsule const & capsule1, Capsule const & capsule2, float & parameter1, float & parameter2 )
+    {
+        // see Real-Time Collision Detection, closest points of two segments
+        auto const axis1 = capsule1.end - capsule1.start;
+        auto const axis2 = capsule2.end - capsule2.start;
+        auto const offset = capsule1.start - capsule2.start;
+        auto const a = SquaredNorm( axis1 );
+        auto const e = SquaredNorm( axis2 );
+        auto const f = Dot( axis2, offset );
+
+        if( a <= c_squared_length_tolerance && e <= c_squared_length_tolerance )
+        {
+            parameter1 = 0;
+            parameter2 = 0;
+            return;
+        }
+        if( a <= c_squared_length_tolerance )
+        {
+            parameter1 = 0;
+            parameter2 = Math::Clamp( 0.f, 1.f, f / e );
+            return;
+        }
+
+        auto const c = Dot( axis1, offset );
+        if( e <= c_squared_length_tolerance )
+        {
+            parameter1 = Math::Clamp( 0.f, 1.f, -c / a );
+            parameter2 = 0;
+            return;
+        }
+
+        auto const b = Dot( axis1, axis2 );
+        auto const denominator = a * e - b * b;
+        // parallel axes have no unique closest points, start anywhere
+        auto s = denominator > 0 ? Math::Clamp( 0.f, 1.f, ( b * f - c * e ) / denominator ) : 0.f;
+        auto t = ( b * s + f ) / e;
+        if( t < 0 )
+        {
+            t = 0;
+            s = Math::Clamp( 0.f, 1.f, -c / a );
+        }
+        else if( t > 1 )
+        {
+            t = 1;
+            s = Math::Clamp( 0.f, 1.f, ( b - c ) / a );
+        }
+        parameter1 = s;
+        parameter2 = t;
+    }
+
+
+    float ClosestAxisParameter( Capsule const & capsule, Triangle const & triangle )
+    {
+        // the closest point is at an end of the axis, where the axis crosses the triangle or closest to one of the edges
+        std::array<float, 6> candidates = { { 0.f, 1.f } };
+        auto candidate_count = 2u;
+
+        auto const normal = GetAxis( triangle );
+        auto const start_distance = Dot( normal, capsule.start - triangle.corners[0] );
+        auto const end_distance = Dot( normal, capsule.end - triangle.corners[0] );
+        if( ( start_distance <= 0 ) != ( end_distance <= 0 ) )
+        {
+            candidates[candidate_count] = start_distance / ( start_distance - end_distance );
+            ++candidate_count;
+        }
+
+        for( auto i = 0u; i < 3; ++i )
+        {
+            Capsule const edge = { triangle.corners[i], triangle.corners[( i + 1 ) % 3], 0 };
+            float edge_parameter;
+            ClosestAxisParameters( capsule, edge, candidates[candidate_count], edge_parameter );
+            ++candidate_count;
+        }
+
+        auto closest_parameter = 0.f;
+        auto closest_distance = std::numeric_limits<float>::max();
+        for( auto i = 0u; i < candidate_count; ++i )
+        {
+            auto const distance = SquaredDistance( triangle, GetAxisPoint( capsule, candidates[i] ) );
+            if( distance < closest_distance )
+            {
+                closest_distance = distance;
+                closest_parameter = candidates[i];
+            }
+        }
+        return closest_parameter;
+    }
+
+
+    float ClosestAxisParameter( Capsule const & capsule, AxisAlignedBox const & box )
+    {
+        auto const local_capsule = Translate( capsule, -box.center );
+        auto const extent = box.extent;
+        // the distance to the box along the axis is convex, so a golden section search finds its minimum
+        auto const ratio = 0.618034f;
+        auto low = 0.f;
+        auto high = 1.f;
+        auto left = high - ratio * ( high - low );
+        auto right = low + ratio * ( high - low );
+        auto left_distance = SquaredDistanceToExtent( extent, GetAxisPoint( local_capsule, left ) );
+        auto right_distance = SquaredDistanceToExtent( extent, GetAxisPoint( local_capsule, right ) );
+        for( auto i = 0u; i < c_golden_section_iterations; ++i )
+        {
+            if( left_distance <= right_distance )
+            {
+                high = right;
+                right = left;
+                right_distance = left_distance;
+                left = high - ratio * ( high - low );
+                left_distance = SquaredDistanceToExtent( extent, GetAxisPoint( local_capsule, left ) );
+            }
+            else
+            {
+                low = left;
+                left = right;
+                left_distance = right_distance;
+                right = low + ratio * ( high - low );
+                right_distance = SquaredDistanceToExtent( extent, GetAxisPoint( local_capsule, right ) );
+            }
+        }
+
+        // the search never evaluates the ends themselves
+        auto parameter = ( low + high ) / 2;
+        auto distance = SquaredDistanceToExtent( extent, GetAxisPoint( local_capsule, parameter ) );
+        for( auto end_parameter : { 0.f, 1.f } )
+        {
+            auto const end_distance = SquaredDistanceToExtent( extent, GetAxisPoint( local_capsule, end_parameter ) );
+            if( end_distance < distance )
+            {
+                distance = end_distance;
+                parameter = end_parameter;
+            }
+        }
+        return parameter;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "AxisAlignedBox.h"
+#include "Capsule.h"
+#include "Triangle.h"
+
+#include <Conventions\Orientation.h>
+
+#include <Math\FloatTypes.h>
+
+#include <Utilities\Range.h>
+
+namespace BoundingShapes
+{
+    // fits a capsule around the points, the axis goes through the two points farthest apart
+    Capsule CreateCapsule( Range<Math::Float3 const *> points );
+
+    Capsule Transform( Capsule capsule, Math::Float4x4 const & transform );
+    Capsule TransformByOrientation( Capsule capsule, Orientation const & orientation );
+
+    Capsule Rotate( Capsule capsule, Math::Quaternion const & rotation );
+    Capsule Translate( Capsule capsule, Math::Float3 translation );
+
+    float Volume( Capsule const & capsule );
+    AxisAlignedBox CreateAxisAlignedBox( Capsule const & capsule );
+
+    // the middle of the axis, which is also the center of mass
+    Math::Float3 GetCenter( Capsule const & capsule );
+
+    // the point on the axis from start to end at parameter 0 to 1
+    Math::Float3 GetAxisPoint( Capsule const & capsule, float parameter );
+
+    // parameters of the points on the axis that are closest to the other shape, if several points are equally close any of them is returned
+    float ClosestAxisParameter( Capsule const & capsule, Math::Float3 point );
+    void ClosestAxisParameters( Capsule const & capsule1, Capsule const & capsule2, float & parameter1, float & parameter2 );
+    float ClosestAxisParameter( Capsule const & capsule, Triangle const & triangle );
+    float ClosestAxisParameter( Capsule const & capsule, AxisAlignedBox const & box );
+}
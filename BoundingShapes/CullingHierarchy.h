@@ -0,0 +1,30 @@
+#pragma once
+
+#include "AxisAlignedBox.h"
+#include "AxisAlignedBoxHierarchy.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace BoundingShapes
+{
+    // hierarchy over boxes that (almost) never move, so it can be kept between frames and whole subtrees can be culled at once
+    struct CullingHierarchy
+    {
+        AxisAlignedBoxHierarchy hierarchy;
+        // the boxes that are culled, the indices in the leafs of the hierarchy point into these
+        std::vector<AxisAlignedBox> boxes;
+    };
+
+
+    // marks that nothing was rejected
+    uint8_t const c_no_rejecting_plane = uint8_t(-1);
+
+    // per view (camera or shadow cascade) information that is kept between frames
+    // the plane that rejected a node or box in the previous frame is tested first in the next frame
+    struct CullingCoherence
+    {
+        std::vector<uint8_t> node_rejecting_planes;
+        std::vector<uint8_t> box_rejecting_planes;
+    };
+}
@@ -0,0 +1,194 @@
+#include "CullingHierarchyFunctions.h"
+
+#include "AxisAlignedBoxHierarchyFunctions.h"
+#include "FrustumFunctions.h"
+#include "PlaneFunctions.h"
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <Utilities\StdVectorFunctions.h>
+
+#include <array>
+
+namespace BoundingShapes
+{
+    namespace
+    {
+        enum struct PlaneTestResult
+        {
+            Outside,
+            Intersecting,
+            Inside,
+        };
+
+
+        PlaneTestResult TestPlane( AxisAlignedBox const & box, Plane const & plane )
+        {
+            auto const center_distance = Distance( plane, box.center );
+            auto const projected_extent = Dot( box.extent, Math::Abs( plane.normal ) );
+            if( center_distance + projected_extent < 0 ) return PlaneTestResult::Outside;
+            if( center_distance - projected_extent >= 0 ) return PlaneTestResult::Inside;
+            return PlaneTestResult::Intersecting;
+        }
+
+
+        // tests the box against the planes in the plane mask, starting with the plane that rejected it last time
+        // returns false if the box is outside, otherwise clears the bits of the planes the box is completely in front of
+        bool TestPlanes( AxisAlignedBox const & box, Plane const * planes, uint8_t & plane_mask, uint8_t & rejecting_plane )
+        {
+            if( rejecting_plane != c_no_rejecting_plane && ( plane_mask & ( 1 << rejecting_plane ) ) )
+            {
+                if( TestPlane( box, planes[rejecting_plane] ) == PlaneTestResult::Outside )
+                {
+                    return false;
+                }
+            }
+
+            for( auto p = 0u; p < c_maximum_culling_planes; ++p )
+            {
+                if( !( plane_mask & ( 1 << p ) ) ) continue;
+                switch( TestPlane( box, planes[p] ) )
+                {
+                case PlaneTestResult::Outside:
+                    rejecting_plane = uint8_t( p );
+                    return false;
+                case PlaneTestResult::Inside:
+                    plane_mask &= ~( 1 << p );
+                    break;
+                case PlaneTestResult::Intersecting:
+                    break;
+                }
+            }
+            rejecting_plane = c_no_rejecting_plane;
+            return true;
+        }
+
+
+        // appends all box indices in the leafs of the nodes from begin to end
+        void AppendAllLeafs( AxisAlignedBoxHierarchy const & tree, uint32_t node_begin, uint32_t node_end, std::vector<uint32_t> & visible_indices )
+        {
+            for( auto i = node_begin; i < node_end; ++i )
+            {
+                auto const & node = tree.nodes[i];
+                if( node.escape_index != i + 1 ) continue;
+                for( auto index : node.indices )
+                {
+                    if( index == uint32_t( -1 ) ) break;
+                    visible_indices.push_back( index );
+                }
+            }
+        }
+
+
+        void ResetCoherence( CullingHierarchy const & hierarchy, CullingCoherence & coherence )
+        {
+            if( Size( coherence.node_rejecting_planes ) != Size( hierarchy.hierarchy.nodes ) )
+            {
+                coherence.node_rejecting_planes.assign( Size( hierarchy.hierarchy.nodes ), c_no_rejecting_plane );
+            }
+            if( Size( coherence.box_rejecting_planes ) != Size( hierarchy.boxes ) )
+            {
+                coherence.box_rejecting_planes.assign( Size( hierarchy.boxes ), c_no_rejecting_plane );
+            }
+        }
+    }
+
+
+    void CreateCullingHierarchy( Range<AxisAlignedBox const *> boxes, CullingHierarchy & hierarchy )
+    {
+        hierarchy.boxes.assign( begin( boxes ), end( boxes ) );
+        hierarchy.hierarchy.nodes.clear();
+        CreateAxisAlignedBoxHierarchy( boxes, hierarchy.hierarchy );
+    }
+
+
+    void Clear( CullingHierarchy & hierarchy )
+    {
+        hierarchy.boxes.clear();
+        hierarchy.hierarchy.nodes.clear();
+    }
+
+
+    size_t BoxCount( CullingHierarchy const & hierarchy )
+    {
+        return Size( hierarchy.boxes );
+    }
+
+
+    void Cull( CullingHierarchy const & hierarchy, Range<Plane const *> planes, CullingCoherence & coherence, std::vector<uint32_t> & visible_indices )
+    {
+        assert( Size( planes ) <= c_maximum_culling_planes );
+        ResetCoherence( hierarchy, coherence );
+
+        // pad the planes, the mask makes sure the padding is never tested
+        std::array<Plane, c_maximum_culling_planes> plane_data;
+        std::copy( begin( planes ), end( planes ), plane_data.begin() );
+        auto const all_planes_mask = uint8_t( ( 1u << Size( planes ) ) - 1 );
+
+        // the planes that still have to be tested for the children of the nodes on the stack
+        struct StackEntry
+        {
+            uint32_t escape_index;
+            uint8_t plane_mask;
+        };
+        std::array<StackEntry, 64> stack;
+        auto stack_size = 0u;
+
+        auto const & tree = hierarchy.hierarchy;
+        auto const node_count = uint32_t( Size( tree.nodes ) );
+        auto i = 0u;
+        while( i < node_count )
+        {
+            while( stack_size > 0 && stack[stack_size - 1].escape_index <= i )
+            {
+                --stack_size;
+            }
+            auto const parent_mask = stack_size > 0 ? stack[stack_size - 1].plane_mask : all_planes_mask;
+
+            auto const & node = tree.nodes[i];
+            if( node.escape_index != i + 1 )
+            {
+                auto plane_mask = parent_mask;
+                if( !TestPlanes( node.box, plane_data.data(), plane_mask, coherence.node_rejecting_planes[i] ) )
+                {
+                    i = node.escape_index;
+                }
+                else if( plane_mask == 0 )
+                {
+                    // completely inside, no need to test anything below this node
+                    AppendAllLeafs( tree, i + 1, node.escape_index, visible_indices );
+                    i = node.escape_index;
+                }
+                else
+                {
+                    assert( stack_size < Size( stack ) );
+                    stack[stack_size] = { node.escape_index, plane_mask };
+                    ++stack_size;
+                    ++i;
+                }
+            }
+            else
+            {
+                for( auto index : node.indices )
+                {
+                    if( index == uint32_t( -1 ) ) break;
+                    auto plane_mask = parent_mask;
+                    if( TestPlanes( hierarchy.boxes[index], plane_data.data(), plane_mask, coherence.box_rejecting_planes[index] ) )
+                    {
+                        visible_indices.push_back( index );
+                    }
+                }
+                ++i;
+            }
+        }
+    }
+
+
+    void CullFrustum( CullingHierarchy const & hierarchy, Math::Float4x4 const & projection_matrix, CullingCoherence & coherence, std::vector<uint32_t> & visible_indices )
+    {
+        std::array<Plane, 6> planes;
+        GetFrustumPlanes( projection_matrix, planes );
+        Cull( hierarchy, planes, coherence, visible_indices );
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CullingHierarchy.h"
+#include "Plane.h"
+
+#include <Math\FloatMatrixTypes.h>
+#include <Utilities\Range.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace BoundingShapes
+{
+    // maximum number of planes that can be used to cull with
+    uint8_t const c_maximum_culling_planes = 8;
+
+    // (re)builds the hierarchy for the boxes, the indices returned by the cull functions point into the boxes range
+    void CreateCullingHierarchy( Range<AxisAlignedBox const *> boxes, CullingHierarchy & hierarchy );
+    void Clear( CullingHierarchy & hierarchy );
+    size_t BoxCount( CullingHierarchy const & hierarchy );
+
+    // appends the indices of the boxes that intersect with the area contained by the planes
+    // the previous results stored in the coherence are used as a starting hint and are updated for the next call
+    void Cull( CullingHierarchy const & hierarchy, Range<Plane const *> planes, CullingCoherence & coherence, std::vector<uint32_t> & visible_indices );
+    // appends the indices of the boxes that intersect with the frustum defined by the projection matrix, see IntersectFrustum
+    void CullFrustum( CullingHierarchy const & hierarchy, Math::Float4x4 const & projection_matrix, CullingCoherence & coherence, std::vector<uint32_t> & visible_indices );
+}
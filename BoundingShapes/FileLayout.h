@@ -14,6 +14,7 @@ struct CollisionMeshFileHeader
     // possible shapes:
     // - sphere
     // - oriented box
+    // - capsule
     // - mesh
 };
 
@@ -70,3 +70,16 @@ BoundingShapes::Plane BoundingShapes::GetBottomPlane(Math::Float4x4 const & proj
     return CreatePlane(projection_matrix[3] + projection_matrix[1]);
 }
 
+
+
+
+void BoundingShapes::GetFrustumPlanes(Math::Float4x4 const & projection_matrix, Range<Plane *> planes)
+{
+    assert(Size(planes) == 6);
+    planes[0] = GetNearPlane(projection_matrix);
+    planes[1] = GetFarPlane(projection_matrix);
+    planes[2] = GetLeftPlane(projection_matrix);
+    planes[3] = GetRightPlane(projection_matrix);
+    planes[4] = GetBottomPlane(projection_matrix);
+    planes[5] = GetTopPlane(projection_matrix);
+}
\ No newline at end of file
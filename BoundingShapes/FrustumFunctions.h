@@ -15,4 +15,7 @@ namespace BoundingShapes
     Plane GetLeftPlane(Math::Float4x4 const & projection_matrix);
     Plane GetTopPlane(Math::Float4x4 const & projection_matrix);
     Plane GetBottomPlane(Math::Float4x4 const & projection_matrix);
+
+    // fills the six planes of the frustum in the order near, far, left, right, bottom, top
+    void GetFrustumPlanes(Math::Float4x4 const & projection_matrix, Range<Plane *> planes);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "BoundingShapeHierarchyMeshFunctions.h"
 #include "AxisAlignedBoxFunctions.h"
+#include "CapsuleFunctions.h"
 #include "OrientedBoxFunctions.h"
 #include "TriangleFunctions.h"
 #include "AxisAlignedBoxSSEFunctions.h"
@@ -302,6 +303,56 @@ namespace BoundingShapes
     }
 
 
+    bool Intersect( Capsule const & capsule, Sphere const & sphere )
+    {
+        auto const axis_point = GetAxisPoint( capsule, ClosestAxisParameter( capsule, sphere.center ) );
+        return Intersect( Sphere{ axis_point, capsule.radius }, sphere );
+    }
+
+
+    bool Intersect( Capsule const & capsule1, Capsule const & capsule2 )
+    {
+        float parameter1, parameter2;
+        ClosestAxisParameters( capsule1, capsule2, parameter1, parameter2 );
+        auto const combined_radius = capsule1.radius + capsule2.radius;
+        auto const offset = GetAxisPoint( capsule1, parameter1 ) - GetAxisPoint( capsule2, parameter2 );
+        return SquaredNorm( offset ) < combined_radius * combined_radius;
+    }
+
+
+    namespace
+    {
+        // intersection between a capsule and an axis aligned box with the center at 0
+        bool IntersectExtent( Capsule const & capsule, Math::Float3 extent )
+        {
+            auto const axis_point = GetAxisPoint( capsule, ClosestAxisParameter( capsule, AxisAlignedBox{ 0, extent } ) );
+            auto const offset = axis_point - Clamp( -extent, extent, axis_point );
+            return SquaredNorm( offset ) < capsule.radius * capsule.radius;
+        }
+    }
+
+
+    bool Intersect( AxisAlignedBox const & box, Capsule const & capsule )
+    {
+        return IntersectExtent( Translate( capsule, -box.center ), box.extent );
+    }
+
+
+    bool Intersect( OrientedBox const & box, Capsule const & capsule )
+    {
+        auto const transformed_capsule = Rotate( Translate( capsule, -box.center ), Conjugate( box.rotation ) );
+        return IntersectExtent( transformed_capsule, box.extent );
+    }
+
+
+    bool Intersect( Triangle const & triangle, Capsule const & capsule )
+    {
+        auto const axis_point = GetAxisPoint( capsule, ClosestAxisParameter( capsule, triangle ) );
+        auto const offset = axis_point - ClosestPoint( triangle, axis_point );
+        return SquaredNorm( offset ) < capsule.radius * capsule.radius;
+    }
+
+
     bool InFront( AxisAlignedBox const & box, Plane plane )
     {
         auto signed_extent = CopySign( box.extent, plane.normal );
@@ -2,6 +2,7 @@
 
 #include "AxisAlignedBox.h"
 #include "AxisAlignedBoxHierarchyMesh.h"
+#include "Capsule.h"
 #include "OrientedBox.h"
 #include "Plane.h"
 #include "Ray.h"
@@ -40,6 +41,12 @@ namespace BoundingShapes
     bool Intersect( SphereHierarchyMesh const & mesh, OrientedBox const & box );
     bool Intersect( AxisAlignedBoxHierarchyMesh const & mesh, OrientedBox const & box );
 
+    bool Intersect( Capsule const & capsule, Sphere const & sphere );
+    bool Intersect( Capsule const & capsule1, Capsule const & capsule2 );
+    bool Intersect( AxisAlignedBox const & box, Capsule const & capsule );
+    bool Intersect( OrientedBox const & box, Capsule const & capsule );
+    bool Intersect( Triangle const & triangle, Capsule const & capsule );
+
     // does an intersection test for a box and a frustum defined by a projection matrix
     // -w <= x <= w
     // -w <= y <= w
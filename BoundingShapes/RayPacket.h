@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Math\SSETypes.h>
+
+#include <cstdint>
+
+namespace BoundingShapes
+{
+    // number of rays in a packet
+    uint32_t const c_ray_packet_width = 4;
+
+    // rays with their components split over the lanes, so they can be tested at once
+    // packets with fewer rays repeat the last one in the unused lanes
+    struct RayPacket
+    {
+        Math::SSE::Float32Vector start_x, start_y, start_z;
+        Math::SSE::Float32Vector direction_x, direction_y, direction_z;
+        Math::SSE::Float32Vector inverse_direction_x, inverse_direction_y, inverse_direction_z;
+        uint32_t count;
+    };
+}
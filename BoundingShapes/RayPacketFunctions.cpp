@@ -0,0 +1,57 @@
+#include "RayPacketFunctions.h"
+
+#include <Math\SSE.h>
+
+#include <cassert>
+#include <limits>
+
+namespace BoundingShapes
+{
+    RayPacket CreateRayPacket( Range<Ray const *> rays )
+    {
+        using namespace Math::SSE;
+        assert( !IsEmpty( rays ) && Size( rays ) <= c_ray_packet_width );
+
+        auto const count = uint32_t( Size( rays ) );
+        auto const & r0 = rays[0];
+        auto const & r1 = rays[count > 1 ? 1 : count - 1];
+        auto const & r2 = rays[count > 2 ? 2 : count - 1];
+        auto const & r3 = rays[count - 1];
+
+        RayPacket packet;
+        packet.start_x = Set( r0.start.x, r1.start.x, r2.start.x, r3.start.x );
+        packet.start_y = Set( r0.start.y, r1.start.y, r2.start.y, r3.start.y );
+        packet.start_z = Set( r0.start.z, r1.start.z, r2.start.z, r3.start.z );
+        packet.direction_x = Set( r0.direction.x, r1.direction.x, r2.direction.x, r3.direction.x );
+        packet.direction_y = Set( r0.direction.y, r1.direction.y, r2.direction.y, r3.direction.y );
+        packet.direction_z = Set( r0.direction.z, r1.direction.z, r2.direction.z, r3.direction.z );
+        // the approximate reciprocal isn't accurate enough for long rays
+        auto const one = SetAll( 1.f );
+        packet.inverse_direction_x = Divide( one, packet.direction_x );
+        packet.inverse_direction_y = Divide( one, packet.direction_y );
+        packet.inverse_direction_z = Divide( one, packet.direction_z );
+        packet.count = count;
+        return packet;
+    }
+
+
+    Math::SSE::Float32Vector VECTOR_CALL IntersectionTimes( RayPacket const & rays, AxisAlignedBox const & box )
+    {
+        using namespace Math::SSE;
+        auto slab = [&]( float center, float extent, Float32Vector start, Float32Vector inverse_direction, Float32Vector & entry, Float32Vector & exit )
+        {
+            auto t0 = Multiply( Subtract( SetAll( center - extent ), start ), inverse_direction );
+            auto t1 = Multiply( Subtract( SetAll( center + extent ), start ), inverse_direction );
+            entry = Max( entry, Min( t0, t1 ) );
+            exit = Min( exit, Max( t0, t1 ) );
+        };
+
+        auto entry = ZeroFloat32Vector();
+        auto exit = SetAll( std::numeric_limits<float>::infinity() );
+        slab( box.center.x, box.extent.x, rays.start_x, rays.inverse_direction_x, entry, exit );
+        slab( box.center.y, box.extent.y, rays.start_y, rays.inverse_direction_y, entry, exit );
+        slab( box.center.z, box.extent.z, rays.start_z, rays.inverse_direction_z, entry, exit );
+
+        return Blend( SetAll( std::numeric_limits<float>::infinity() ), entry, LessThanOrEqual( entry, exit ) );
+    }
+}
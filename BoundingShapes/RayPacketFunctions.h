@@ -0,0 +1,17 @@
+#pragma once
+
+#include "AxisAlignedBox.h"
+#include "Ray.h"
+#include "RayPacket.h"
+
+#include <Math\SSETypes.h>
+#include <Utilities\Range.h>
+
+namespace BoundingShapes
+{
+    // takes up to c_ray_packet_width rays
+    RayPacket CreateRayPacket( Range<Ray const *> rays );
+
+    // times at which the rays enter the box, zero for rays that start inside and infinity for rays that miss it
+    Math::SSE::Float32Vector VECTOR_CALL IntersectionTimes( RayPacket const & rays, AxisAlignedBox const & box );
+}
@@ -10,6 +10,7 @@ namespace BoundingShapes
         OrientedBox,
         Sphere,
         SphereHierarchyMesh,
-        Triangle
+        Triangle,
+        Capsule
     };
 }
\ No newline at end of file
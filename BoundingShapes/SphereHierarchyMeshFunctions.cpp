@@ -43,6 +43,18 @@ namespace BoundingShapes
     }
 
 
+    SphereHierarchyMesh CreateSphereHierarchyMeshSAH( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices )
+    {
+        return CreateBoundingShapeHierarchyMeshSAH( move( vertex_positions ), move( indices ), CreateSphere );
+    }
+
+
+    float ExpectedTraversalCost( SphereHierarchyMesh const & mesh )
+    {
+        return ExpectedTraversalCost<>( mesh );
+    }
+
+
     SphereHierarchyMesh Transform( SphereHierarchyMesh mesh, Math::Float4x4 const & transform )
     {
         mesh = Transform<>( std::move(mesh), transform );
@@ -9,6 +9,10 @@
 namespace BoundingShapes
 {
     SphereHierarchyMesh CreateSphereHierarchyMesh( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices );
+    // builds a tree that is cheaper to traverse, but takes longer to build, use it for offline conversion
+    SphereHierarchyMesh CreateSphereHierarchyMeshSAH( std::vector<Math::Float3> vertex_positions, std::vector<unsigned> indices );
+    // expected number of shape and triangle tests per query, see BoundingShapeHierarchyMeshFunctions.h
+    float ExpectedTraversalCost( SphereHierarchyMesh const & mesh );
 
     SphereHierarchyMesh Transform( SphereHierarchyMesh mesh, Math::Float4x4 const & transform );
     SphereHierarchyMesh TransformByOrientation( SphereHierarchyMesh mesh, Orientation const & orientation );
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace BoundingShapes
+{
+    // number of triangles that are tested at once
+    uint32_t const c_triangle_batch_width = 4;
+
+    // triangles stored as a structure of arrays, so several triangles can be tested at once
+    // x[c][t] is the x coordinate of corner c of triangle t, unused lanes should contain valid floats
+    struct TriangleBatch
+    {
+        std::array<std::array<float, c_triangle_batch_width>, 3> x, y, z;
+    };
+}
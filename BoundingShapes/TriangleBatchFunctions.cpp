@@ -0,0 +1,182 @@
+#include "TriangleBatchFunctions.h"
+
+#include <Math\SSE.h>
+
+#include <cassert>
+#include <limits>
+
+namespace BoundingShapes
+{
+    namespace
+    {
+        // relative tolerance of the separation, the exact test decides about triangles that only just touch the box
+        float const c_separation_tolerance = 1e-4f;
+        // cross products of edges with components below this are not used as an axis, same as in the scalar test
+        float const c_zero_axis_tolerance = 1e-3f;
+        // rays this close to parallel to a triangle miss it
+        float const c_parallel_tolerance = 1e-8f;
+
+
+        struct CornersSSE
+        {
+            Math::SSE::Float32Vector x, y, z;
+        };
+
+
+        struct AxisSSE
+        {
+            Math::SSE::Float32Vector x, y, z;
+        };
+
+
+        AxisSSE Cross( AxisSSE const & a, AxisSSE const & b )
+        {
+            using namespace Math::SSE;
+            return {
+                Subtract( Multiply( a.y, b.z ), Multiply( a.z, b.y ) ),
+                Subtract( Multiply( a.z, b.x ), Multiply( a.x, b.z ) ),
+                Subtract( Multiply( a.x, b.y ), Multiply( a.y, b.x ) ),
+            };
+        }
+
+
+        Math::SSE::Float32Vector Dot( AxisSSE const & a, AxisSSE const & b )
+        {
+            using namespace Math::SSE;
+            return MultiplyAdd( a.x, b.x, MultiplyAdd( a.y, b.y, Multiply( a.z, b.z ) ) );
+        }
+
+
+        Math::SSE::Float32Vector Project( AxisSSE const & axis, CornersSSE const & corner )
+        {
+            using namespace Math::SSE;
+            auto projection = Multiply( axis.x, corner.x );
+            projection = MultiplyAdd( axis.y, corner.y, projection );
+            return MultiplyAdd( axis.z, corner.z, projection );
+        }
+
+
+        // the box projects to [-radius, radius], the triangle to the range of its projected corners
+        Math::SSE::Float32Vector Separated( Math::SSE::Float32Vector p0, Math::SSE::Float32Vector p1, Math::SSE::Float32Vector p2, Math::SSE::Float32Vector radius )
+        {
+            using namespace Math::SSE;
+            auto const minimum = Min( p0, Min( p1, p2 ) );
+            auto const maximum = Max( p0, Max( p1, p2 ) );
+            auto const tolerance = Multiply( SetAll( c_separation_tolerance ), Add( radius, Max( Abs( minimum ), Abs( maximum ) ) ) );
+            auto const limit = Add( radius, tolerance );
+            return Or( GreaterThan( minimum, limit ), LessThan( maximum, Negate( limit ) ) );
+        }
+
+
+        Math::SSE::Float32Vector Separated( AxisSSE const & axis, std::array<CornersSSE, 3> const & corners, Math::SSE::Float32Vector extent_x, Math::SSE::Float32Vector extent_y, Math::SSE::Float32Vector extent_z )
+        {
+            using namespace Math::SSE;
+            auto radius = Multiply( extent_x, Abs( axis.x ) );
+            radius = MultiplyAdd( extent_y, Abs( axis.y ), radius );
+            radius = MultiplyAdd( extent_z, Abs( axis.z ), radius );
+            return Separated( Project( axis, corners[0] ), Project( axis, corners[1] ), Project( axis, corners[2] ), radius );
+        }
+
+
+        // the scalar test skips axes that are almost zero, so separation along them should not count either
+        Math::SSE::Float32Vector SeparatedOnEdgeAxis( AxisSSE const & axis, std::array<CornersSSE, 3> const & corners, Math::SSE::Float32Vector extent_x, Math::SSE::Float32Vector extent_y, Math::SSE::Float32Vector extent_z )
+        {
+            using namespace Math::SSE;
+            auto const tolerance = SetAll( c_zero_axis_tolerance );
+            auto const zero_axis = And( And( LessThanOrEqual( Abs( axis.x ), tolerance ), LessThanOrEqual( Abs( axis.y ), tolerance ) ), LessThanOrEqual( Abs( axis.z ), tolerance ) );
+            return AndNot( Separated( axis, corners, extent_x, extent_y, extent_z ), zero_axis );
+        }
+    }
+
+
+    void SetTriangle( Triangle const & triangle, uint32_t lane, TriangleBatch & batch )
+    {
+        assert( lane < c_triangle_batch_width );
+        for( auto c = 0u; c < 3; ++c )
+        {
+            batch.x[c][lane] = triangle.corners[c].x;
+            batch.y[c][lane] = triangle.corners[c].y;
+            batch.z[c][lane] = triangle.corners[c].z;
+        }
+    }
+
+
+    unsigned OverlappingLanes( TriangleBatch const & batch, Math::Float3 extent )
+    {
+        using namespace Math::SSE;
+
+        std::array<CornersSSE, 3> corners;
+        for( auto c = 0u; c < 3; ++c )
+        {
+            corners[c] = { Load( batch.x[c].data() ), Load( batch.y[c].data() ), Load( batch.z[c].data() ) };
+        }
+        auto const extent_x = SetAll( extent.x );
+        auto const extent_y = SetAll( extent.y );
+        auto const extent_z = SetAll( extent.z );
+
+        // faces of the box
+        auto separated = Separated( corners[0].x, corners[1].x, corners[2].x, extent_x );
+        separated = Or( separated, Separated( corners[0].y, corners[1].y, corners[2].y, extent_y ) );
+        separated = Or( separated, Separated( corners[0].z, corners[1].z, corners[2].z, extent_z ) );
+
+        // edges in the same order as GetEdges: 0->1, 1->2, 2->0
+        std::array<AxisSSE, 3> edges;
+        for( auto e = 0u; e < 3; ++e )
+        {
+            auto const & from = corners[e];
+            auto const & to = corners[( e + 1 ) % 3];
+            edges[e] = { Subtract( to.x, from.x ), Subtract( to.y, from.y ), Subtract( to.z, from.z ) };
+        }
+
+        // face of the triangle, the length of the normal does not matter for the separation
+        AxisSSE normal;
+        normal.x = Subtract( Multiply( edges[0].y, edges[1].z ), Multiply( edges[0].z, edges[1].y ) );
+        normal.y = Subtract( Multiply( edges[0].z, edges[1].x ), Multiply( edges[0].x, edges[1].z ) );
+        normal.z = Subtract( Multiply( edges[0].x, edges[1].y ), Multiply( edges[0].y, edges[1].x ) );
+        separated = Or( separated, Separated( normal, corners, extent_x, extent_y, extent_z ) );
+
+        // cross products of the box axes with the triangle edges
+        auto const zero = SetAll( 0.f );
+        for( auto const & edge : edges )
+        {
+            separated = Or( separated, SeparatedOnEdgeAxis( { zero, Negate( edge.z ), edge.y }, corners, extent_x, extent_y, extent_z ) );
+            separated = Or( separated, SeparatedOnEdgeAxis( { edge.z, zero, Negate( edge.x ) }, corners, extent_x, extent_y, extent_z ) );
+            separated = Or( separated, SeparatedOnEdgeAxis( { Negate( edge.y ), edge.x, zero }, corners, extent_x, extent_y, extent_z ) );
+        }
+
+        return ~MaskSignBits( separated ) & ( ( 1u << c_triangle_batch_width ) - 1 );
+    }
+
+
+    Math::SSE::Float32Vector VECTOR_CALL IntersectionTimes( Ray const & ray, TriangleBatch const & batch )
+    {
+        using namespace Math::SSE;
+
+        std::array<AxisSSE, 3> corners;
+        for( auto c = 0u; c < 3; ++c )
+        {
+            corners[c] = { Load( batch.x[c].data() ), Load( batch.y[c].data() ), Load( batch.z[c].data() ) };
+        }
+        AxisSSE const edge1 = { Subtract( corners[1].x, corners[0].x ), Subtract( corners[1].y, corners[0].y ), Subtract( corners[1].z, corners[0].z ) };
+        AxisSSE const edge2 = { Subtract( corners[2].x, corners[0].x ), Subtract( corners[2].y, corners[0].y ), Subtract( corners[2].z, corners[0].z ) };
+        AxisSSE const direction = { SetAll( ray.direction.x ), SetAll( ray.direction.y ), SetAll( ray.direction.z ) };
+        AxisSSE const start = { Subtract( SetAll( ray.start.x ), corners[0].x ), Subtract( SetAll( ray.start.y ), corners[0].y ), Subtract( SetAll( ray.start.z ), corners[0].z ) };
+
+        // solve start + t * direction = u * edge1 + v * edge2 with Cramer's rule
+        auto const p = Cross( direction, edge2 );
+        auto const determinant = Dot( edge1, p );
+        auto const inverse_determinant = Divide( SetAll( 1.f ), determinant );
+        auto const u = Multiply( Dot( start, p ), inverse_determinant );
+        auto const q = Cross( start, edge1 );
+        auto const v = Multiply( Dot( direction, q ), inverse_determinant );
+        auto const time = Multiply( Dot( edge2, q ), inverse_determinant );
+
+        auto const zero = ZeroFloat32Vector();
+        auto hit = GreaterThan( Abs( determinant ), SetAll( c_parallel_tolerance ) );
+        hit = And( hit, GreaterThanOrEqual( u, zero ) );
+        hit = And( hit, GreaterThanOrEqual( v, zero ) );
+        hit = And( hit, LessThanOrEqual( Add( u, v ), SetAll( 1.f ) ) );
+        hit = And( hit, GreaterThanOrEqual( time, zero ) );
+        return Blend( SetAll( std::numeric_limits<float>::infinity() ), time, hit );
+    }
+}
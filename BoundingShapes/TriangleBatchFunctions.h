@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Ray.h"
+#include "Triangle.h"
+#include "TriangleBatch.h"
+
+#include <Math\FloatTypes.h>
+#include <Math\SSETypes.h>
+
+#include <cstdint>
+
+namespace BoundingShapes
+{
+    void SetTriangle( Triangle const & triangle, uint32_t lane, TriangleBatch & batch );
+
+    // separating axis test of the triangles against an axis aligned box with its center at the origin
+    // uses the same axes as the scalar test, the box faces, the triangle normals and the cross products of the edges
+    // returns a mask with a bit set for each lane that could not be separated, separations within a small tolerance are ignored,
+    // so a set bit can still be rejected by the exact test, but a cleared bit is always separated
+    unsigned OverlappingLanes( TriangleBatch const & batch, Math::Float3 extent );
+
+    // Möller–Trumbore test of the ray against the triangles, both sides of a triangle are hit
+    // returns the time along the ray for each lane, infinity for lanes that are missed or lie behind the start of the ray
+    Math::SSE::Float32Vector VECTOR_CALL IntersectionTimes( Ray const & ray, TriangleBatch const & batch );
+}
@@ -27,6 +27,54 @@ namespace BoundingShapes
     }
 
 
+    Math::Float3 ClosestPoint( Triangle const & triangle, Math::Float3 point )
+    {
+        // see Real-Time Collision Detection, find the voronoi region of the triangle that contains the point
+        auto const & a = triangle.corners[0];
+        auto const & b = triangle.corners[1];
+        auto const & c = triangle.corners[2];
+        auto const ab = b - a;
+        auto const ac = c - a;
+
+        auto const ap = point - a;
+        auto const d1 = Dot( ab, ap );
+        auto const d2 = Dot( ac, ap );
+        if( d1 <= 0 && d2 <= 0 ) return a;
+
+        auto const bp = point - b;
+        auto const d3 = Dot( ab, bp );
+        auto const d4 = Dot( ac, bp );
+        if( d3 >= 0 && d4 <= d3 ) return b;
+
+        auto const vc = d1 * d4 - d3 * d2;
+        if( vc <= 0 && d1 >= 0 && d3 <= 0 )
+        {
+            return a + ab * ( d1 / ( d1 - d3 ) );
+        }
+
+        auto const cp = point - c;
+        auto const d5 = Dot( ab, cp );
+        auto const d6 = Dot( ac, cp );
+        if( d6 >= 0 && d5 <= d6 ) return c;
+
+        auto const vb = d5 * d2 - d1 * d6;
+        if( vb <= 0 && d2 >= 0 && d6 <= 0 )
+        {
+            return a + ac * ( d2 / ( d2 - d6 ) );
+        }
+
+        auto const va = d3 * d6 - d5 * d4;
+        if( va <= 0 && ( d4 - d3 ) >= 0 && ( d5 - d6 ) >= 0 )
+        {
+            return b + ( c - b ) * ( ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) ) );
+        }
+
+        // inside the face
+        auto const denominator = 1 / ( va + vb + vc );
+        return a + ab * ( vb * denominator ) + ac * ( vc * denominator );
+    }
+
+
     float Area(Triangle const & triangle)
     {
         return Norm( GetAxis( triangle ) );
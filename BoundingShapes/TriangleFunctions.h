@@ -15,6 +15,8 @@ namespace BoundingShapes
     Math::Float3 GetNormal( Triangle const & triangle );
     Math::Float3 GetAxis( Triangle const & triangle );
     Math::Float3 GetCenter( Triangle const & triangle );
+    // the point on the triangle that is closest to the given point
+    Math::Float3 ClosestPoint( Triangle const & triangle, Math::Float3 point );
 
     float Area(Triangle const & triangle);
     // is cheaper to compute than plain area
@@ -0,0 +1,134 @@
+#include "CppUnitTest.h"
+
+#include <BoundingShapes\AxisAlignedBoxBatchFunctions.h>
+#include <BoundingShapes\FrustumFunctions.h>
+#include <BoundingShapes\IntersectionTests.h>
+
+#include <Math\FloatMatrixOperators.h>
+#include <Math\TransformFunctions.h>
+
+#include <Utilities\HRTimer.h>
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BoundingShapes;
+
+namespace DogDealerBoundingShapesUnitTests
+{
+    namespace
+    {
+        std::vector<AxisAlignedBox> CreateRandomBoxes( uint32_t count, float world_size )
+        {
+            std::mt19937 generator( 4321 );
+            std::uniform_real_distribution<float> position( -world_size, world_size );
+            std::uniform_real_distribution<float> size( 0.1f, 4.f );
+            std::vector<AxisAlignedBox> boxes( count );
+            for( auto & box : boxes )
+            {
+                box.center = { position( generator ), position( generator ), position( generator ) };
+                box.extent = { size( generator ), size( generator ), size( generator ) };
+            }
+            return boxes;
+        }
+
+
+        Math::Float4x4 CreateCameraProjection( float angle )
+        {
+            auto projection = Math::PerspectiveFieldOfViewVertical( 1.2f, 16.f / 9.f, 0.5f, 500.f );
+            auto camera = Math::RotationToFloat4x4( Math::YAngleToQuaternion( angle ) );
+            return projection * camera;
+        }
+    }
+
+
+    TEST_CLASS(AxisAlignedBoxBatchUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestBatchMatchesSingleBoxTests)
+        {
+            // not a multiple of the batch width, so the last group is only partly filled
+            auto const boxes = CreateRandomBoxes( 1003, 300.f );
+            AxisAlignedBoxBatch batch;
+            CreateAxisAlignedBoxBatch( boxes, batch );
+            Assert::AreEqual( size_t( 1003 ), BoxCount( batch ) );
+
+            for( auto frame = 0u; frame < 8; ++frame )
+            {
+                auto const projection = CreateCameraProjection( 0.8f * frame );
+                std::array<Plane, 6> planes;
+                GetFrustumPlanes( projection, planes );
+
+                std::vector<uint32_t> expected, result;
+                Intersect( boxes, planes, expected );
+                Intersect( batch, planes, result );
+                Assert::IsTrue( expected == result );
+
+                expected.clear();
+                result.clear();
+                IntersectFrustum( boxes, projection, expected );
+                IntersectFrustum( batch, projection, result );
+                Assert::IsTrue( expected == result );
+            }
+        }
+
+
+        TEST_METHOD(TestBatchAppendsAndGathers)
+        {
+            auto const boxes = CreateRandomBoxes( 64, 50.f );
+            std::vector<uint32_t> indices = { 3, 7, 8, 20, 41, 63 };
+            AxisAlignedBoxBatch batch;
+            CreateAxisAlignedBoxBatch( boxes, indices, batch );
+            Assert::AreEqual( indices.size(), BoxCount( batch ) );
+
+            // a plane everything is in front of, the existing content should be kept
+            std::array<Plane, 1> planes = { { { { 0, 1, 0 }, 1000.f } } };
+            std::vector<uint32_t> result = { 42 };
+            Intersect( batch, planes, result );
+            Assert::IsTrue( std::vector<uint32_t>{ 42, 0, 1, 2, 3, 4, 5 } == result );
+
+            Clear( batch );
+            Intersect( batch, planes, result );
+            Assert::AreEqual( size_t( 7 ), result.size() );
+        }
+
+
+        TEST_METHOD(BenchmarkBatchFrustumTest100kBoxes)
+        {
+            auto const boxes = CreateRandomBoxes( 100000, 2000.f );
+            AxisAlignedBoxBatch batch;
+            CreateAxisAlignedBoxBatch( boxes, batch );
+
+            auto const frames = 32u;
+            std::vector<uint32_t> visible;
+            HRTimer timer;
+
+            timer.Start();
+            for( auto frame = 0u; frame < frames; ++frame )
+            {
+                visible.clear();
+                IntersectFrustum( boxes, CreateCameraProjection( 0.02f * frame ), visible );
+            }
+            timer.Stop();
+            auto const single_time = timer.GetMilliSeconds() / frames;
+            auto const single_visible = visible.size();
+
+            timer.Start();
+            for( auto frame = 0u; frame < frames; ++frame )
+            {
+                visible.clear();
+                IntersectFrustum( batch, CreateCameraProjection( 0.02f * frame ), visible );
+            }
+            timer.Stop();
+            auto const batch_time = timer.GetMilliSeconds() / frames;
+
+            Assert::AreEqual( single_visible, visible.size() );
+            auto message = "Frustum test 100k boxes, one at a time: " + std::to_string( single_time ) + " ms, batched: " + std::to_string( batch_time ) + " ms per frame";
+            Logger::WriteMessage( message.c_str() );
+        }
+    };
+}
@@ -0,0 +1,145 @@
+#include "CppUnitTest.h"
+
+#include <BoundingShapes\AxisAlignedBoxHierarchyMeshFunctions.h>
+#include <BoundingShapes\SphereHierarchyMeshFunctions.h>
+#include <BoundingShapes\IntersectionTests.h>
+
+#include <Math\FloatOperators.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BoundingShapes;
+
+namespace DogDealerBoundingShapesUnitTests
+{
+    namespace
+    {
+        // a bumpy grid, similar to a level mesh
+        void CreateTerrain( unsigned size, std::vector<Math::Float3> & positions, std::vector<unsigned> & indices )
+        {
+            for( auto z = 0u; z <= size; ++z )
+            {
+                for( auto x = 0u; x <= size; ++x )
+                {
+                    positions.push_back( { float( x ), 2 * std::sin( 0.3f * x ) * std::cos( 0.2f * z ), float( z ) } );
+                }
+            }
+            for( auto z = 0u; z < size; ++z )
+            {
+                for( auto x = 0u; x < size; ++x )
+                {
+                    auto const corner = z * ( size + 1 ) + x;
+                    indices.insert( indices.end(), { corner, corner + size + 1, corner + 1 } );
+                    indices.insert( indices.end(), { corner + 1, corner + size + 1, corner + size + 2 } );
+                }
+            }
+        }
+
+
+        // a few clusters of small triangles, where a median split is far from optimal
+        void CreateClusters( std::vector<Math::Float3> & positions, std::vector<unsigned> & indices )
+        {
+            std::mt19937 generator( 42 );
+            std::uniform_real_distribution<float> offset( -1.f, 1.f );
+            Math::Float3 const centers[] = { { 0, 0, 0 }, { 100, 0, 0 }, { 100, 100, 0 }, { 0, 3, 200 } };
+            for( auto const & center : centers )
+            {
+                for( auto i = 0u; i < 300; ++i )
+                {
+                    auto const start = unsigned( positions.size() );
+                    for( auto j = 0u; j < 3; ++j )
+                    {
+                        positions.push_back( center + Math::Float3{ offset( generator ), offset( generator ), offset( generator ) } * 5.f );
+                    }
+                    indices.insert( indices.end(), { start, start + 1, start + 2 } );
+                }
+            }
+        }
+
+
+        // every triangle is in exactly one leaf and within the boxes of all the nodes above it
+        void CheckTree( AxisAlignedBoxHierarchyMesh const & mesh, size_t triangle_count )
+        {
+            Assert::AreEqual( triangle_count * 2 - 1, mesh.nodes.size() );
+
+            auto leaf_count = size_t( 0 );
+            for( auto i = 0u; i < mesh.nodes.size(); ++i )
+            {
+                auto const & node = mesh.nodes[i];
+                if( node.escape_index == i + 1 )
+                {
+                    ++leaf_count;
+                    continue;
+                }
+                Assert::IsTrue( node.escape_index <= mesh.nodes.size() );
+                for( auto j = i + 1; j < node.escape_index; ++j )
+                {
+                    auto const & child = mesh.nodes[j];
+                    if( child.escape_index != j + 1 ) continue;
+                    for( auto vertex_index : child.vertex_indices )
+                    {
+                        auto box = node.shape;
+                        box.extent += 1e-4f;
+                        Assert::IsTrue( Contains( box, mesh.vertex_positions[vertex_index] ) );
+                    }
+                }
+            }
+            Assert::AreEqual( triangle_count, leaf_count );
+        }
+    }
+
+
+    TEST_CLASS(BoundingShapeHierarchyMeshUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestMedianAndSAHTreesAreValid)
+        {
+            std::vector<Math::Float3> positions;
+            std::vector<unsigned> indices;
+            CreateTerrain( 20, positions, indices );
+            CreateClusters( positions, indices );
+            auto const triangle_count = indices.size() / 3;
+
+            CheckTree( CreateAxisAlignedBoxHierarchyMesh( positions, indices ), triangle_count );
+            CheckTree( CreateAxisAlignedBoxHierarchyMeshSAH( positions, indices ), triangle_count );
+
+            auto const sphere_mesh = CreateSphereHierarchyMeshSAH( positions, indices );
+            Assert::AreEqual( triangle_count * 2 - 1, sphere_mesh.nodes.size() );
+        }
+
+
+        TEST_METHOD(TestSingleAndDegenerateTriangles)
+        {
+            std::vector<Math::Float3> positions = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+            std::vector<unsigned> indices = { 0, 1, 2 };
+            auto const single = CreateAxisAlignedBoxHierarchyMeshSAH( positions, indices );
+            Assert::AreEqual( size_t( 1 ), single.nodes.size() );
+            Assert::AreEqual( 1.f, ExpectedTraversalCost( single ) );
+
+            // the same triangle a few times, so all centers are equal
+            indices = { 0, 1, 2, 0, 1, 2, 0, 2, 1, 1, 2, 0 };
+            CheckTree( CreateAxisAlignedBoxHierarchyMeshSAH( positions, indices ), 4 );
+        }
+
+
+        TEST_METHOD(TestSAHIsCheaperThanMedianSplit)
+        {
+            std::vector<Math::Float3> positions;
+            std::vector<unsigned> indices;
+            CreateTerrain( 40, positions, indices );
+            CreateClusters( positions, indices );
+
+            auto const median_cost = ExpectedTraversalCost( CreateAxisAlignedBoxHierarchyMesh( positions, indices ) );
+            auto const sah_cost = ExpectedTraversalCost( CreateAxisAlignedBoxHierarchyMeshSAH( positions, indices ) );
+            Assert::IsTrue( sah_cost < median_cost );
+
+            auto message = "Expected traversal cost, median split: " + std::to_string( median_cost ) + ", SAH: " + std::to_string( sah_cost );
+            Logger::WriteMessage( message.c_str() );
+        }
+    };
+}
@@ -0,0 +1,154 @@
+#include "CppUnitTest.h"
+
+#include <BoundingShapes\CapsuleFunctions.h>
+#include <BoundingShapes\IntersectionTests.h>
+#include <BoundingShapes\TriangleFunctions.h>
+
+#include <Math\FloatOperators.h>
+#include <Math\MathConstants.h>
+#include <Math\MathFunctions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BoundingShapes;
+
+namespace DogDealerBoundingShapesUnitTests
+{
+    namespace
+    {
+        uint32_t const c_samples = 2000;
+
+
+        template<typename DistanceFunctionType>
+        float SampledMinimum( Capsule const & capsule, DistanceFunctionType squared_distance )
+        {
+            auto minimum = squared_distance( capsule.start );
+            for( auto i = 1u; i <= c_samples; ++i )
+            {
+                minimum = std::min( minimum, squared_distance( GetAxisPoint( capsule, float( i ) / c_samples ) ) );
+            }
+            return minimum;
+        }
+
+
+        Math::Float3 RandomPoint( std::mt19937 & generator )
+        {
+            std::uniform_real_distribution<float> position( -3.f, 3.f );
+            return { position( generator ), position( generator ), position( generator ) };
+        }
+    }
+
+
+    TEST_CLASS(CapsuleUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestClosestPointOnTriangleIsClosest)
+        {
+            std::mt19937 generator( 11 );
+            for( auto i = 0u; i < 200; ++i )
+            {
+                auto const triangle = CreateTriangle( RandomPoint( generator ), RandomPoint( generator ), RandomPoint( generator ) );
+                auto const point = RandomPoint( generator );
+                auto const closest_distance = SquaredNorm( point - ClosestPoint( triangle, point ) );
+
+                // no point on the triangle can be closer
+                for( auto u = 0u; u <= 20; ++u )
+                {
+                    for( auto v = 0u; u + v <= 20; ++v )
+                    {
+                        auto const sample = triangle.corners[0] + ( triangle.corners[1] - triangle.corners[0] ) * ( u / 20.f ) + ( triangle.corners[2] - triangle.corners[0] ) * ( v / 20.f );
+                        Assert::IsTrue( closest_distance <= SquaredNorm( point - sample ) + 1e-4f );
+                    }
+                }
+            }
+        }
+
+
+        TEST_METHOD(TestClosestAxisParametersMatchSampling)
+        {
+            std::mt19937 generator( 12 );
+            for( auto i = 0u; i < 100; ++i )
+            {
+                Capsule const capsule = { RandomPoint( generator ), RandomPoint( generator ), 0.5f };
+
+                Capsule const other = { RandomPoint( generator ), RandomPoint( generator ), 0.5f };
+                float parameter1, parameter2;
+                ClosestAxisParameters( capsule, other, parameter1, parameter2 );
+                auto const capsule_distance = SquaredNorm( GetAxisPoint( capsule, parameter1 ) - GetAxisPoint( other, parameter2 ) );
+                auto const sampled_capsule_distance = SampledMinimum( capsule, [&other]( Math::Float3 point )
+                {
+                    return SquaredNorm( point - GetAxisPoint( other, ClosestAxisParameter( other, point ) ) );
+                } );
+                Assert::IsTrue( capsule_distance <= sampled_capsule_distance + 1e-4f );
+
+                auto const triangle = CreateTriangle( RandomPoint( generator ), RandomPoint( generator ), RandomPoint( generator ) );
+                auto const triangle_point = GetAxisPoint( capsule, ClosestAxisParameter( capsule, triangle ) );
+                auto const triangle_distance = SquaredNorm( triangle_point - ClosestPoint( triangle, triangle_point ) );
+                auto const sampled_triangle_distance = SampledMinimum( capsule, [&triangle]( Math::Float3 point )
+                {
+                    return SquaredNorm( point - ClosestPoint( triangle, point ) );
+                } );
+                Assert::IsTrue( triangle_distance <= sampled_triangle_distance + 1e-4f );
+
+                AxisAlignedBox const box = { RandomPoint( generator ), { 0.5f, 1.f, 0.25f } };
+                auto const box_point = GetAxisPoint( capsule, ClosestAxisParameter( capsule, box ) );
+                auto const box_distance = SquaredNorm( box_point - Clamp( box.center - box.extent, box.center + box.extent, box_point ) );
+                auto const sampled_box_distance = SampledMinimum( capsule, [&box]( Math::Float3 point )
+                {
+                    return SquaredNorm( point - Clamp( box.center - box.extent, box.center + box.extent, point ) );
+                } );
+                Assert::IsTrue( box_distance <= sampled_box_distance + 1e-4f );
+            }
+        }
+
+
+        TEST_METHOD(TestCreateCapsuleFitsCapsuleSurface)
+        {
+            // rings around the cylinder and the caps of a capsule along x, plus the tips
+            Capsule const expected = { { -2, 1, 0 }, { 1, 1, 0 }, 0.5f };
+            std::vector<Math::Float3> points = { { -2.5f, 1, 0 }, { 1.5f, 1, 0 } };
+            for( auto i = 0u; i < 16; ++i )
+            {
+                auto const angle = i * 2 * Math::c_PI.f / 16;
+                auto const ring = Math::Float3{ 0, std::cos( angle ), std::sin( angle ) } * expected.radius;
+                points.push_back( expected.start + ring );
+                points.push_back( expected.end + ring );
+                points.push_back( ( expected.start + expected.end ) / 2 + ring );
+                points.push_back( expected.start + Math::Float3{ -expected.radius * 0.6f, 0, 0 } + ring * 0.8f );
+                points.push_back( expected.end + Math::Float3{ expected.radius * 0.6f, 0, 0 } + ring * 0.8f );
+            }
+
+            auto const capsule = CreateCapsule( points );
+
+            auto const forwards = SquaredNorm( capsule.start - expected.start ) + SquaredNorm( capsule.end - expected.end );
+            auto const backwards = SquaredNorm( capsule.start - expected.end ) + SquaredNorm( capsule.end - expected.start );
+            Assert::IsTrue( std::min( forwards, backwards ) < 1e-6f );
+            Assert::AreEqual( expected.radius, capsule.radius, 1e-4f );
+            for( auto const & point : points )
+            {
+                Assert::IsTrue( SquaredNorm( point - GetAxisPoint( capsule, ClosestAxisParameter( capsule, point ) ) ) <= capsule.radius * capsule.radius + 1e-4f );
+            }
+        }
+
+
+        TEST_METHOD(TestCapsuleIntersections)
+        {
+            Capsule const capsule = { { 0, 0, 0 }, { 0, 2, 0 }, 0.5f };
+            Assert::IsTrue( Intersect( capsule, Sphere{ { 0.9f, 1, 0 }, 0.5f } ) );
+            Assert::IsFalse( Intersect( capsule, Sphere{ { 1.1f, 1, 0 }, 0.5f } ) );
+            Assert::IsTrue( Intersect( capsule, Capsule{ { -1, 2.4f, 0 }, { 1, 2.4f, 0 }, 0.1f } ) );
+            Assert::IsFalse( Intersect( capsule, Capsule{ { -1, 2.7f, 0 }, { 1, 2.7f, 0 }, 0.1f } ) );
+            Assert::IsTrue( Intersect( AxisAlignedBox{ { 0, -1, 0 }, { 2, 0.6f, 2 } }, capsule ) );
+            Assert::IsFalse( Intersect( AxisAlignedBox{ { 0, -1, 0 }, { 2, 0.4f, 2 } }, capsule ) );
+            Assert::IsTrue( Intersect( CreateTriangle( { -1, 1, 0.4f }, { 1, 1, 0.4f }, { 0, 1, 2 } ), capsule ) );
+            Assert::IsFalse( Intersect( CreateTriangle( { -1, 1, 0.6f }, { 1, 1, 0.6f }, { 0, 1, 2 } ), capsule ) );
+            // the axis goes through the triangle
+            Assert::IsTrue( Intersect( CreateTriangle( { -1, 1, -1 }, { 1, 1, -1 }, { 0, 1, 2 } ), Capsule{ { 0, 0, 0 }, { 0, 2, 0 }, 0.01f } ) );
+        }
+    };
+}
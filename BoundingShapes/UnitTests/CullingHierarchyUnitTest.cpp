@@ -0,0 +1,135 @@
+#include "CppUnitTest.h"
+
+#include <BoundingShapes\CullingHierarchyFunctions.h>
+#include <BoundingShapes\IntersectionTests.h>
+
+#include <Math\FloatOperators.h>
+#include <Math\FloatMatrixOperators.h>
+#include <Math\MathFunctions.h>
+#include <Math\TransformFunctions.h>
+
+#include <Utilities\HRTimer.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BoundingShapes;
+
+namespace DogDealerBoundingShapesUnitTests
+{
+    namespace
+    {
+        std::vector<AxisAlignedBox> CreateRandomBoxes( uint32_t count, float world_size )
+        {
+            std::mt19937 generator( 1234 );
+            std::uniform_real_distribution<float> position( -world_size, world_size );
+            std::uniform_real_distribution<float> size( 0.1f, 4.f );
+            std::vector<AxisAlignedBox> boxes( count );
+            for( auto & box : boxes )
+            {
+                box.center = { position( generator ), position( generator ), position( generator ) };
+                box.extent = { size( generator ), size( generator ), size( generator ) };
+            }
+            return boxes;
+        }
+
+
+        Math::Float4x4 CreateCameraProjection( float angle )
+        {
+            auto projection = Math::PerspectiveFieldOfViewVertical( 1.2f, 16.f / 9.f, 0.5f, 500.f );
+            auto camera = Math::RotationToFloat4x4( Math::YAngleToQuaternion( angle ) );
+            return projection * camera;
+        }
+
+
+        std::vector<uint32_t> CullLinear( Range<AxisAlignedBox const *> boxes, Math::Float4x4 const & projection )
+        {
+            std::vector<uint32_t> indices;
+            IntersectFrustum( boxes, projection, indices );
+            return indices;
+        }
+    }
+
+
+    TEST_CLASS(CullingHierarchyUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestCullingMatchesLinearFrustumTest)
+        {
+            auto const boxes = CreateRandomBoxes( 5000, 300.f );
+            CullingHierarchy hierarchy;
+            CreateCullingHierarchy( boxes, hierarchy );
+            CullingCoherence coherence;
+
+            // repeat with a rotating camera so the coherence from the previous frame is used
+            for( auto frame = 0u; frame < 16; ++frame )
+            {
+                auto const projection = CreateCameraProjection( 0.1f * frame );
+                std::vector<uint32_t> visible;
+                CullFrustum( hierarchy, projection, coherence, visible );
+                std::sort( begin( visible ), end( visible ) );
+
+                auto const expected = CullLinear( boxes, projection );
+                Assert::IsTrue( expected == visible );
+            }
+        }
+
+
+        TEST_METHOD(TestCullingEmptyAndSmallHierarchies)
+        {
+            CullingHierarchy hierarchy;
+            CullingCoherence coherence;
+            std::vector<uint32_t> visible;
+            CreateCullingHierarchy( Range<AxisAlignedBox const *>(), hierarchy );
+            CullFrustum( hierarchy, CreateCameraProjection( 0 ), coherence, visible );
+            Assert::IsTrue( visible.empty() );
+
+            // one box in front of the camera and one behind it, which fits in a single leaf
+            std::vector<AxisAlignedBox> boxes = { { { 0, 0, 10 }, { 1, 1, 1 } }, { { 0, 0, -10 }, { 1, 1, 1 } } };
+            CreateCullingHierarchy( boxes, hierarchy );
+            CullFrustum( hierarchy, CreateCameraProjection( 0 ), coherence, visible );
+            Assert::AreEqual( size_t( 1 ), visible.size() );
+            Assert::IsTrue( CullLinear( boxes, CreateCameraProjection( 0 ) ) == visible );
+        }
+
+
+        TEST_METHOD(BenchmarkCulling100kComponents)
+        {
+            auto const boxes = CreateRandomBoxes( 100000, 2000.f );
+            CullingHierarchy hierarchy;
+            CreateCullingHierarchy( boxes, hierarchy );
+            CullingCoherence coherence;
+
+            auto const frames = 32u;
+            std::vector<uint32_t> visible;
+            HRTimer timer;
+
+            timer.Start();
+            for( auto frame = 0u; frame < frames; ++frame )
+            {
+                visible.clear();
+                IntersectFrustum( boxes, CreateCameraProjection( 0.02f * frame ), visible );
+            }
+            timer.Stop();
+            auto const linear_time = timer.GetMilliSeconds() / frames;
+            auto const linear_visible = visible.size();
+
+            timer.Start();
+            for( auto frame = 0u; frame < frames; ++frame )
+            {
+                visible.clear();
+                CullFrustum( hierarchy, CreateCameraProjection( 0.02f * frame ), coherence, visible );
+            }
+            timer.Stop();
+            auto const hierarchy_time = timer.GetMilliSeconds() / frames;
+
+            Assert::AreEqual( linear_visible, visible.size() );
+            auto message = "Culling 100k boxes, linear: " + std::to_string( linear_time ) + " ms, hierarchy: " + std::to_string( hierarchy_time ) + " ms per frame";
+            Logger::WriteMessage( message.c_str() );
+        }
+    };
+}
@@ -4,6 +4,9 @@
 #include "EntityAnimations.h"
 
 #include "AINavigation.h"
+#include "AINavigationMeshFunctions.h"
+#include "PathRequestQueue.h"
+#include "FlowFieldFunctions.h"
 
 #include "TimerSystem.h"
 #include "AIParameterContainer.h"
@@ -18,6 +21,8 @@
 
 #include <Math\MathFunctions.h>
 
+#include <algorithm>
+
 // For random striking directions
 #include <random>
 #include <time.h>
@@ -25,13 +30,100 @@
 
 namespace Logic{
 
+    // Targets followed by at least this many entities get a flow field shared by all their followers,
+    // instead of every follower finding its own path
+    unsigned const c_minimum_flow_field_followers = 4;
+
+
+    // Create flow fields for targets with many followers and set the paths of these followers from them.
+    // Flags the followers that use a flow field, these don't need paths of their own, so their pending requests are cancelled.
+    void UpdateFlowFieldFollowers(IndexedOrientations const & indexed_orientations,
+                                NavigationMesh const & navigation_mesh,
+                                AIParameterContainer & parameters,
+                                FlowFieldContainer & flow_fields,
+                                std::vector<bool> & flow_field_followers,
+                                PathRequestQueue & path_requests)
+    {
+        auto & following = parameters.m_following;
+        auto following_entity_count = following.m_entities.size();
+        flow_field_followers.assign(following_entity_count, false);
+
+        if(flow_fields.adjacency.centroids.size() != navigation_mesh.indices.size() / 3)
+        {
+            CreateTriangleAdjacency(navigation_mesh, flow_fields.adjacency);
+            flow_fields.fields.clear();
+        }
+
+        // Find the targets with enough followers
+        auto targets = following.m_target_entities;
+        std::sort(begin(targets), end(targets));
+        std::vector<EntityID> crowded_targets;
+        for(auto i = 0u; i < targets.size();)
+        {
+            auto end = i + 1;
+            while(end < targets.size() && targets[end] == targets[i]) ++end;
+            if(end - i >= c_minimum_flow_field_followers) crowded_targets.push_back(targets[i]);
+            i = end;
+        }
+
+        // Keep the fields of targets that are still crowded, in the order of the crowded targets
+        std::vector<FlowField> fields(crowded_targets.size());
+        for(auto & field : flow_fields.fields)
+        {
+            auto crowded_target = std::lower_bound(begin(crowded_targets), end(crowded_targets), field.target);
+            if(crowded_target != end(crowded_targets) && *crowded_target == field.target)
+            {
+                fields[crowded_target - begin(crowded_targets)] = std::move(field);
+            }
+        }
+        for(auto i = 0u; i < crowded_targets.size(); ++i)
+        {
+            fields[i].target = crowded_targets[i];
+        }
+        flow_fields.fields = std::move(fields);
+        if(flow_fields.fields.empty()) return;
+
+        // Only recalculates the fields of targets that moved to another triangle
+        std::vector<Math::Float3> target_positions(crowded_targets.size());
+        GetEntityPositions(crowded_targets, indexed_orientations, target_positions);
+        for(auto i = 0u; i < crowded_targets.size(); ++i)
+        {
+            UpdateFlowField(target_positions[i], navigation_mesh, flow_fields.adjacency, flow_fields.fields[i]);
+        }
+
+        std::vector<Math::Float3> entity_positions(following_entity_count);
+        GetEntityPositions(following.m_entities, indexed_orientations, entity_positions);
+        for(auto i = 0u; i < following_entity_count; ++i)
+        {
+            auto crowded_target = std::lower_bound(begin(crowded_targets), end(crowded_targets), following.m_target_entities[i]);
+            if(crowded_target == end(crowded_targets) || *crowded_target != following.m_target_entities[i]) continue;
+            auto const & field = flow_fields.fields[crowded_target - begin(crowded_targets)];
+
+            // Start looking for the current triangle from the last known one
+            auto entity_index = following.m_entities[i].index;
+            if(entity_index >= flow_fields.entity_triangles.size())
+            {
+                flow_fields.entity_triangles.resize(entity_index + 1, unsigned(-1));
+            }
+            auto & triangle = flow_fields.entity_triangles[entity_index];
+            triangle = FindTriangle(entity_positions[i], triangle, navigation_mesh, flow_fields.adjacency);
+
+            GetFlowFieldPath(field, navigation_mesh, entity_positions[i], triangle, following.m_paths[i]);
+            following.m_next_node_indices[i] = 0;
+            flow_field_followers[i] = true;
+            CancelPathRequest(following.m_entities[i], PathRequester::Following, path_requests);
+        }
+    }
+
 
-    // Recalculate paths consisting of only one node or no longer leading close enough
-    // to their respective target entities.
-    // Create paths for those following ai entities that have none yet.
+    // Repair paths consisting of only one node or no longer leading close enough
+    // to their respective target entities, or request new ones if their corridor can't be reused.
+    // Following ai entities that have no path yet walk straight towards their target until theirs is found.
     void UpdateFollowingAINavigation(IndexedOrientations const & indexed_orientations,
+                                    NavigationMesh const & navigation_mesh,
                                     AIParameterContainer & parameters,
-                                    NavigationMesh const & navigation_mesh)
+                                    std::vector<bool> const & flow_field_followers,
+                                    PathRequestQueue & path_requests)
     {
         // Recalculate a path if the target entity moved further from its destination
         float const c_maximum_destination_target_offset = 2.0f;
@@ -53,6 +145,9 @@ namespace Logic{
         // the path must be updated,
         for(auto i = 0; i < following_entity_count; i++)
         {
+            // Followers of crowded targets use the shared flow field
+            if(flow_field_followers[i]) continue;
+
             // Get path for current entity
             auto const & path = parameters.m_following.m_paths[i];
 
@@ -87,7 +182,6 @@ namespace Logic{
                 if(distance > c_maximum_destination_target_offset) recalculate = true;
             }
 
-            // TODO: It might not be necessary to recalculate the entire path
             if(recalculate)
             {
                 // Get ai entity
@@ -97,11 +191,16 @@ namespace Logic{
                 auto entity_position = entity_positions[i];
                 auto target_position = target_entity_positions[i];
 
-                auto new_path = FindPath(entity_position, target_position, navigation_mesh);
-
-                // Store the index of the path for the ai entity
-                parameters.m_following.m_paths[i] = new_path;
-				parameters.m_following.m_next_node_indices[i] = 0;
+                // Try to adjust the end of the current path first
+                if(RepairPath(entity_position, target_position, navigation_mesh, parameters.m_following.m_corridors[i], parameters.m_following.m_paths[i]))
+                {
+                    parameters.m_following.m_next_node_indices[i] = 0;
+                }
+                else
+                {
+                    // Keep the current path until the new one is found
+                    RequestPath(entity, PathRequester::Following, entity_position, target_position, path_requests);
+                }
             }
         }
 
@@ -114,19 +213,17 @@ namespace Logic{
             auto entity_position = entity_positions[i];
             auto target_entity_position = target_entity_positions[i];
 
-            // Find a path from entity to target
-            auto path = FindPath(entity_position, target_entity_position, navigation_mesh);
-
-            // Store the index of the path for the ai entity
-            parameters.m_following.m_paths[i] = path;
+            // Walk straight towards the target until a path from entity to target is found
+            parameters.m_following.m_paths[i].assign(1, Math::Float2(target_entity_position.x, target_entity_position.y));
 			parameters.m_following.m_next_node_indices[i] = 0;
+            RequestPath(entity, PathRequester::Following, entity_position, target_entity_position, path_requests);
         }
     }
 
 
 	void InitializeNewPatrollingPaths(IndexedOrientations const & indexed_orientations,
 									AIParameterContainer & parameters,
-									NavigationMesh const & navigation_mesh)
+									PathRequestQueue & path_requests)
 	{
 		auto patrolling_entity_count = parameters.m_navigating.m_entities.size();
 
@@ -145,12 +242,10 @@ namespace Logic{
 				auto entity_position = entity_positions[i];
 				auto target_position = parameters.m_navigating.m_target_positions[i];
 
-				// Find a path from entity to target
-				auto path = FindPath(entity_position, target_position, navigation_mesh);
-
-				// Store the index of the path for the ai entity
-				parameters.m_navigating.m_paths[i] = path;
+				// Walk straight towards the target until a path from entity to target is found
+				parameters.m_navigating.m_paths[i].assign(1, Math::Float2(target_position.x, target_position.y));
 				parameters.m_navigating.m_next_node_indices[i] = 0;
+				RequestPath(entity, PathRequester::Navigating, entity_position, target_position, path_requests);
 			}
 		}
 	}
@@ -664,7 +759,12 @@ namespace Logic{
                         std::vector<float> & target_z_angles,
 						std::vector<float> & target_speed_factors,
                         MeleeActionTriggers & melee_action_triggers,
-                        NavigationMesh const & navigation_mesh)
+                        NavigationMesh const & navigation_mesh,
+                        NavigationHierarchy const & navigation_hierarchy,
+                        PathRequestQueue & path_requests,
+                        FlowFieldContainer & flow_fields,
+                        Math::Float3 focus_position,
+                        float path_finding_budget_microseconds)
     {
         // Keep all passive AI entities in position
         Append(moving_ai_entity_ids, parameters.m_ai_passive_entities);
@@ -675,14 +775,18 @@ namespace Logic{
         GetEntityZAngles(parameters.m_ai_passive_entities, indexed_orientations, z_angles);
         Append(target_speed_factors, 1.0f, Size(parameters.m_ai_passive_entities));
 
-        // Update following paths and generate un-initialized ones
-        UpdateFollowingAINavigation(indexed_orientations, parameters, navigation_mesh);
+        // Request updated paths and paths for un-initialized entities,
+        // then find as many of them as the budget allows
+        std::vector<bool> flow_field_followers;
+        UpdateFlowFieldFollowers(indexed_orientations, navigation_mesh, parameters, flow_fields, flow_field_followers, path_requests);
+        UpdateFollowingAINavigation(indexed_orientations, navigation_mesh, parameters, flow_field_followers, path_requests);
+		InitializeNewPatrollingPaths(indexed_orientations, parameters, path_requests);
+        SolvePathRequests(navigation_mesh, navigation_hierarchy, focus_position, path_finding_budget_microseconds, path_requests, parameters);
+
 		UpdateAIPathNextNodes(indexed_orientations,
 			parameters.m_following.m_entities,
 			parameters.m_following.m_paths,
 			parameters.m_following.m_next_node_indices);
-
-		InitializeNewPatrollingPaths(indexed_orientations, parameters, navigation_mesh);
 		UpdateAIPathNextNodes(indexed_orientations,
 							  parameters.m_navigating.m_entities,
 							  parameters.m_navigating.m_paths,
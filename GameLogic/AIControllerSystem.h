@@ -12,6 +12,10 @@ struct AIParameterContainer;
 
 namespace Logic{
 
+    struct PathRequestQueue;
+    struct FlowFieldContainer;
+    struct NavigationHierarchy;
+
     void UpdateAIControllers(IndexedOrientations const & indexed_orientations,
 							IndexedVelocities const & indexed_velocities,
                             AIParameterContainer & parameters,
@@ -22,7 +26,12 @@ namespace Logic{
                             std::vector<float> & target_z_angles,
 							std::vector<float> & target_speed_factors,
                             MeleeActionTriggers & melee_action_triggers,
-                            NavigationMesh const & navigation_mesh);
+                            NavigationMesh const & navigation_mesh,
+                            NavigationHierarchy const & navigation_hierarchy,
+                            PathRequestQueue & path_requests,
+                            FlowFieldContainer & flow_fields,
+                            Math::Float3 focus_position,
+                            float path_finding_budget_microseconds);
 
 
     void AppendRandomAttackDirections(std::vector<Math::Float2>& attack_directions, 
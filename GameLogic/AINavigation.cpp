@@ -2,6 +2,7 @@
 
 #include "AINavigationMeshGenerator.h"
 #include "AINavigationMeshFunctions.h"
+#include "NavigationHierarchyFunctions.h"
 
 #include <array>
 
@@ -465,10 +466,24 @@ namespace Logic
     std::vector<Math::Float2> FindPath(Math::Float3 const input_start,
                                     Math::Float3 const input_destination,
                                     NavigationMesh const & navigation_mesh)
+    {
+        PathCorridor corridor;
+        return FindPath(input_start, input_destination, navigation_mesh, corridor);
+    }
+
+
+    std::vector<Math::Float2> FindPath(Math::Float3 const input_start,
+                                    Math::Float3 const input_destination,
+                                    NavigationMesh const & navigation_mesh,
+                                    PathCorridor & corridor)
     {
         unsigned start_triangle, destination_triangle;
         Math::Float2 start, destination; // TODO: Cant these be 2D?
         FindValidStartAndDestination(input_start, input_destination, navigation_mesh, start_triangle, destination_triangle, start, destination);
+
+        corridor.triangles.assign(1, start_triangle);
+        corridor.portals.vertices_0.clear();
+        corridor.portals.vertices_1.clear();
         
         // If on the same triangle try to walk towards destination directly
         if (start_triangle == destination_triangle)
@@ -491,7 +506,154 @@ namespace Logic
 
         assert(!output_path.empty() && "No valid path found for following ai entity");
 
+        // Keep the crossed triangles for later repairs
+        corridor.triangles.insert(corridor.triangles.end(), path_triangles.begin(), path_triangles.end());
+        corridor.portals = std::move(path_portals);
+
         // Return result path
         return output_path;
     }
+
+
+    // Long paths expand far fewer nodes in the hierarchy than on the triangles themselves
+    std::vector<Math::Float2> FindPath(Math::Float3 const input_start,
+                                    Math::Float3 const input_destination,
+                                    NavigationMesh const & navigation_mesh,
+                                    NavigationHierarchy const & navigation_hierarchy,
+                                    NavigationHierarchySearch & search,
+                                    PathCorridor & corridor)
+    {
+        unsigned start_triangle, destination_triangle;
+        Math::Float2 start, destination;
+        FindValidStartAndDestination(input_start, input_destination, navigation_mesh, start_triangle, destination_triangle, start, destination);
+
+        auto found = FindHierarchicalCorridor(start_triangle, destination_triangle, navigation_hierarchy, search, corridor);
+        assert(found && "Path finding could not reach destination");
+
+        // If on the same triangle, or unreachable, try to walk towards destination directly
+        if (!found || corridor.triangles.size() == 1)
+        {
+            return std::vector<Math::Float2>(1, destination);
+        }
+
+        std::vector<Math::Float2> output_path;
+        ExtractPathNodesByFunneling(start,
+                        destination,
+                        navigation_mesh,
+                        corridor.portals,
+                        output_path);
+
+        return output_path;
+    }
+
+
+    // ######################################################################
+    // ############################ PATH REPAIR: ############################
+    // ######################################################################
+
+
+    // Return the index of the first corridor triangle containing the position
+    // when searching from the front or back, or unsigned(-1) if none does
+    unsigned FindCorridorTriangleIndex(Math::Float2 const position,
+                                    PathCorridor const & corridor,
+                                    NavigationMesh const & mesh,
+                                    bool const search_from_back)
+    {
+        auto triangle_count = unsigned(corridor.triangles.size());
+        for(auto i = 0u; i < triangle_count; i++)
+        {
+            auto index = search_from_back ? triangle_count - i - 1 : i;
+
+            Math::Float2 vertex_0, vertex_1, vertex_2;
+            GetMeshTriangleVertices2D(corridor.triangles[index], mesh, vertex_0, vertex_1, vertex_2);
+            if(TriangleContainsPosition(position, vertex_0, vertex_1, vertex_2)) return index;
+        }
+        return unsigned(-1);
+    }
+
+
+    // Return true and the vertices of the edge if both triangles share one
+    bool GetSharedEdge(unsigned const triangle_a,
+                    unsigned const triangle_b,
+                    NavigationMesh const & mesh,
+                    // output
+                    unsigned & vertex_0,
+                    unsigned & vertex_1)
+    {
+        unsigned shared_vertices[3];
+        auto shared_count = 0u;
+        for(auto a = 0u; a < 3; a++)
+        {
+            for(auto b = 0u; b < 3; b++)
+            {
+                if(mesh.indices[3 * triangle_a + a] == mesh.indices[3 * triangle_b + b])
+                {
+                    shared_vertices[shared_count++] = mesh.indices[3 * triangle_a + a];
+                }
+            }
+        }
+
+        if(shared_count != 2) return false;
+
+        vertex_0 = shared_vertices[0];
+        vertex_1 = shared_vertices[1];
+        return true;
+    }
+
+
+    bool RepairPath(Math::Float3 const input_start,
+                    Math::Float3 const input_destination,
+                    NavigationMesh const & navigation_mesh,
+                    PathCorridor & corridor,
+                    std::vector<Math::Float2> & output_path)
+    {
+        if(corridor.triangles.empty()) return false;
+
+        auto start = Math::Float2(input_start.x, input_start.y);
+        auto destination = Math::Float2(input_destination.x, input_destination.y);
+
+        // The start has to be somewhere along the corridor
+        auto start_index = FindCorridorTriangleIndex(start, corridor, navigation_mesh, false);
+        if(start_index == unsigned(-1)) return false;
+
+        // Either the destination is still in the corridor
+        auto destination_index = FindCorridorTriangleIndex(destination, corridor, navigation_mesh, true);
+        if(destination_index == unsigned(-1))
+        {
+            // or it moved into a triangle next to the end of the corridor, which gets appended
+            auto destination_triangle = GetContainingTriangleIndex(input_destination, navigation_mesh);
+            if(destination_triangle == unsigned(-1)) return false;
+
+            unsigned vertex_0, vertex_1;
+            if(!GetSharedEdge(corridor.triangles.back(), destination_triangle, navigation_mesh, vertex_0, vertex_1)) return false;
+
+            corridor.triangles.push_back(destination_triangle);
+            corridor.portals.vertices_0.push_back(vertex_0);
+            corridor.portals.vertices_1.push_back(vertex_1);
+            destination_index = unsigned(corridor.triangles.size() - 1);
+        }
+
+        // The destination moved behind the start
+        if(destination_index < start_index) return false;
+
+        // Drop the triangles already passed and those behind the destination
+        corridor.triangles.erase(corridor.triangles.begin() + destination_index + 1, corridor.triangles.end());
+        corridor.triangles.erase(corridor.triangles.begin(), corridor.triangles.begin() + start_index);
+        for(auto vertices : { &corridor.portals.vertices_0, &corridor.portals.vertices_1 })
+        {
+            vertices->erase(vertices->begin() + destination_index, vertices->end());
+            vertices->erase(vertices->begin(), vertices->begin() + start_index);
+        }
+
+        output_path.clear();
+        if(corridor.triangles.size() == 1)
+        {
+            output_path.push_back(destination);
+        }
+        else
+        {
+            ExtractPathNodesByFunneling(start, destination, navigation_mesh, corridor.portals, output_path);
+        }
+        return true;
+    }
 }
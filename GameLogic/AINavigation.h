@@ -7,11 +7,41 @@ namespace Logic
 {
     struct NavigationMesh;
     struct PortalList;    
+    struct PathCorridor;
+    struct NavigationHierarchy;
+    struct NavigationHierarchySearch;
 
     std::vector<Math::Float2> FindPath(Math::Float3 const start,
                                     Math::Float3 const destination,
                                     NavigationMesh const & navigation_mesh);
 
+    // Same as above, additionally storing the crossed triangles for RepairPath
+    std::vector<Math::Float2> FindPath(Math::Float3 const start,
+                                    Math::Float3 const destination,
+                                    NavigationMesh const & navigation_mesh,
+                                    // output
+                                    PathCorridor & corridor);
+
+    // Same as above, but searching through the clusters of the hierarchy first.
+    // The search buffers should be kept between calls
+    std::vector<Math::Float2> FindPath(Math::Float3 const start,
+                                    Math::Float3 const destination,
+                                    NavigationMesh const & navigation_mesh,
+                                    NavigationHierarchy const & navigation_hierarchy,
+                                    NavigationHierarchySearch & search,
+                                    // output
+                                    PathCorridor & corridor);
+
+    // Reuse the corridor of an earlier path if the start is still inside it and the destination
+    // either is too or moved into a triangle adjacent to its end. The corridor is trimmed or extended
+    // and only funneled again. Returns false if a new path has to be found instead
+    bool RepairPath(Math::Float3 const start,
+                    Math::Float3 const destination,
+                    NavigationMesh const & navigation_mesh,
+                    // output
+                    PathCorridor & corridor,
+                    std::vector<Math::Float2> & output_path);
+
     // For UnitTests
     float GetPointDistanceFromTriangle3D(Math::Float3 const position,
         Math::Float3 vertex_0,
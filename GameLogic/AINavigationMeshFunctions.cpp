@@ -5,7 +5,9 @@
 
 #include <Math/MathFunctions.h>
 
+#include <algorithm>
 #include <array>
+#include <tuple>
 
 
 namespace Logic{
@@ -482,4 +484,85 @@ namespace Logic{
             }
         }
     }
+
+
+    // Store the neighbours of all triangles at once, by sorting the edges instead of comparing all triangle pairs
+    void CreateTriangleAdjacency(NavigationMesh const & mesh,
+        // output
+        TriangleAdjacency & adjacency)
+    {
+        auto triangle_count = unsigned(mesh.indices.size() / 3);
+
+        // sort all edges on their vertices, so the triangles sharing an edge end up next to each other
+        struct Edge
+        {
+            unsigned vertex_0, vertex_1, triangle;
+        };
+        std::vector<Edge> edges;
+        edges.reserve(mesh.indices.size());
+        for (auto t = 0u; t < triangle_count; ++t)
+        {
+            for (auto i = 0u; i < 3; ++i)
+            {
+                auto a = mesh.indices[3 * t + i];
+                auto b = mesh.indices[3 * t + (i + 1) % 3];
+                edges.push_back({ std::min(a, b), std::max(a, b), t });
+            }
+        }
+        std::sort(begin(edges), end(edges), [](Edge const & a, Edge const & b)
+        {
+            return std::tie(a.vertex_0, a.vertex_1, a.triangle) < std::tie(b.vertex_0, b.vertex_1, b.triangle);
+        });
+
+        // collect the pairs of triangles sharing an edge
+        std::vector<std::array<unsigned, 2>> pairs;
+        std::vector<std::array<unsigned, 2>> pair_portals;
+        for (auto i = 0u; i < edges.size();)
+        {
+            auto end = i + 1;
+            while (end < edges.size() && edges[end].vertex_0 == edges[i].vertex_0 && edges[end].vertex_1 == edges[i].vertex_1) ++end;
+            for (auto a = i; a < end; ++a)
+            {
+                for (auto b = a + 1; b < end; ++b)
+                {
+                    pairs.push_back({{edges[a].triangle, edges[b].triangle}});
+                    pair_portals.push_back({{edges[a].vertex_0, edges[a].vertex_1}});
+                }
+            }
+            i = end;
+        }
+
+        // and store them per triangle
+        adjacency.offsets.assign(triangle_count + 1, 0);
+        for (auto const & pair : pairs)
+        {
+            ++adjacency.offsets[pair[0] + 1];
+            ++adjacency.offsets[pair[1] + 1];
+        }
+        for (auto t = 0u; t < triangle_count; ++t)
+        {
+            adjacency.offsets[t + 1] += adjacency.offsets[t];
+        }
+        auto neighbour_count = adjacency.offsets.back();
+        adjacency.neighbours.resize(neighbour_count);
+        adjacency.portals.vertices_0.resize(neighbour_count);
+        adjacency.portals.vertices_1.resize(neighbour_count);
+        auto write_positions = adjacency.offsets;
+        for (auto p = 0u; p < pairs.size(); ++p)
+        {
+            for (auto side = 0u; side < 2; ++side)
+            {
+                auto n = write_positions[pairs[p][side]]++;
+                adjacency.neighbours[n] = pairs[p][1 - side];
+                adjacency.portals.vertices_0[n] = pair_portals[p][0];
+                adjacency.portals.vertices_1[n] = pair_portals[p][1];
+            }
+        }
+
+        adjacency.centroids.resize(triangle_count);
+        for (auto t = 0u; t < triangle_count; ++t)
+        {
+            adjacency.centroids[t] = GetTriangleCentroid(t, mesh);
+        }
+    }
 }
\ No newline at end of file
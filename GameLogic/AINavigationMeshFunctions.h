@@ -90,4 +90,10 @@ namespace Logic
         // output
         std::vector<unsigned> & adjacent_triangles,
         PortalList & adjacency_portals);
+
+
+    // Find the neighbours of all triangles of the mesh
+    void CreateTriangleAdjacency(NavigationMesh const & mesh,
+        // output
+        TriangleAdjacency & adjacency);
 }
@@ -59,6 +59,7 @@ void AIParameterContainer::AddFollowingTarget(EntityID const following_entity,
 	// Store yet invalid path index
 	m_following.m_next_node_indices.push_back(unsigned(-1));
 	m_following.m_paths.push_back(std::vector<Math::Float2>());
+	m_following.m_corridors.push_back(PathCorridor());
 }
 
 /*
@@ -118,7 +119,8 @@ void AIParameterContainer::RemoveFollowingAI(EntityID const entity_id)
 						 m_following.m_minimum_distances, 
 						 m_following.m_target_entities,
 						 m_following.m_next_node_indices,
-						 m_following.m_paths);
+						 m_following.m_paths,
+						 m_following.m_corridors);
         }
         else
         {
@@ -339,7 +341,8 @@ void AIParameterContainer::RemoveEntityAsFollower(EntityID const entity_id)
 						 m_following.m_minimum_distances, 
 						 m_following.m_maximum_distances,
 						 m_following.m_next_node_indices,
-						 m_following.m_paths);
+						 m_following.m_paths,
+						 m_following.m_corridors);
 		}
 		else
 		{
@@ -369,7 +372,8 @@ void AIParameterContainer::RemoveEntityFromFollowing(EntityID const entity_id)
 						 m_following.m_minimum_distances, 
 						 m_following.m_maximum_distances,
 						 m_following.m_next_node_indices,
-						 m_following.m_paths);
+						 m_following.m_paths,
+						 m_following.m_corridors);
 		}
 		else
 		{
@@ -3,6 +3,8 @@
 #include <Conventions\EntityID.h>
 #include <Conventions\Orientation.h>
 
+#include "Structures.h"
+
 #include <vector>
 
 namespace Logic{
@@ -25,6 +27,9 @@ namespace Logic{
 			std::vector<unsigned> m_next_node_indices;
 
 			std::vector<std::vector<Math::Float2>> m_paths;
+
+			// Triangles crossed by the paths, to repair them when the target moves
+			std::vector<PathCorridor> m_corridors;
         };
         Following m_following;
         
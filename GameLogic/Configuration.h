@@ -1,9 +1,18 @@
 #pragma once
 
+#include "NavigationMeshBuilder.h"
+#include "NavigationHierarchy.h"
+
 namespace Logic
 {
     struct WorldConfiguration
     {
+        // time that may be spent on finding AI paths each update, the other requests wait for the next update
+        float path_finding_budget_microseconds = 500.f;
+        // how much longer than the shortest path a path over the navigation hierarchy may be, relative to its length
+        float navigation_path_tolerance = c_navigation_path_tolerance;
+        // voxelization of the static geometry when generating the navigation mesh
+        NavigationMeshBuildSettings navigation_mesh;
     };
 
 }
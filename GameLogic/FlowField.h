@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Structures.h"
+
+#include <Conventions\EntityID.h>
+#include <Math\FloatTypes.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Logic
+{
+    // distances over the navigation mesh triangles towards a single target entity,
+    // shared by all agents following that target
+    struct FlowField
+    {
+        EntityID target;
+        // triangle the field was calculated for, the field only changes when the target leaves it
+        unsigned target_triangle = unsigned(-1);
+        Math::Float2 target_position;
+
+        // per triangle the distance to the target triangle, and the neighbour and portal to walk through to get closer
+        std::vector<float> costs;
+        std::vector<unsigned> next_triangles;
+        PortalList next_portals;
+
+        // kept between updates, to find the triangles whose way to the old target passed the new target triangle
+        std::vector<uint8_t> repair_states;
+        std::vector<unsigned> repair_chain;
+    };
+
+
+    struct FlowFieldContainer
+    {
+        TriangleAdjacency adjacency;
+        std::vector<FlowField> fields;
+        // last known triangle of each entity (by entity index), used as a starting point to find its current triangle
+        std::vector<unsigned> entity_triangles;
+    };
+}
@@ -0,0 +1,213 @@
+#include "FlowFieldFunctions.h"
+
+#include "AINavigationMeshFunctions.h"
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace Logic
+{
+    namespace
+    {
+        // agents aim for the part of a portal between these fractions, to keep them away from the corners
+        float const c_portal_margin = 0.2f;
+
+
+        bool MeshTriangleContainsPosition( unsigned triangle, Math::Float2 position, NavigationMesh const & mesh )
+        {
+            Math::Float2 vertex_0, vertex_1, vertex_2;
+            GetMeshTriangleVertices2D( triangle, mesh, vertex_0, vertex_1, vertex_2 );
+            return TriangleContainsPosition( position, vertex_0, vertex_1, vertex_2 );
+        }
+
+
+        Math::Float2 GetPortalPoint( Math::Float2 position, unsigned vertex_0, unsigned vertex_1, NavigationMesh const & mesh )
+        {
+            auto a = mesh.vertices[vertex_0];
+            auto b = mesh.vertices[vertex_1];
+            auto edge = b - a;
+            auto t = Math::Dot( position - a, edge ) / Math::Dot( edge, edge );
+            t = std::min( std::max( t, c_portal_margin ), 1 - c_portal_margin );
+            return a + edge * t;
+        }
+
+
+        enum RepairState : uint8_t
+        {
+            Unknown,
+            // the way to the old target went through the new target triangle, the rest of that way is still the shortest
+            Kept,
+            Reset
+        };
+
+
+        typedef std::pair<float, unsigned> OpenTriangle;
+        typedef std::priority_queue<OpenTriangle, std::vector<OpenTriangle>, std::greater<OpenTriangle>> OpenTriangles;
+
+
+        void ResetTriangle( unsigned triangle, FlowField & field )
+        {
+            field.costs[triangle] = std::numeric_limits<float>::infinity();
+            field.next_triangles[triangle] = unsigned(-1);
+            field.next_portals.vertices_0[triangle] = unsigned(-1);
+            field.next_portals.vertices_1[triangle] = unsigned(-1);
+        }
+
+
+        // Moves the root of the field from the old target triangle to the new one, which the old field reaches.
+        // With symmetric distances a triangle whose shortest way to the old target passes the new one is exactly
+        // the old cost minus the cost of the new target away from it. All other triangles are reset, and the kept
+        // triangles bordering them are returned as the starting points of Dijkstra's algorithm.
+        void RerootFlowField( unsigned target_triangle, TriangleAdjacency const & adjacency, FlowField & field, OpenTriangles & open )
+        {
+            auto triangle_count = unsigned( field.costs.size() );
+            auto target_cost = field.costs[target_triangle];
+            auto & states = field.repair_states;
+            auto & chain = field.repair_chain;
+            states.assign( triangle_count, Unknown );
+            states[target_triangle] = Kept;
+            for( auto t = 0u; t < triangle_count; ++t )
+            {
+                // follow the way to the old target until a triangle with a known state, the old target or an unreachable triangle
+                chain.clear();
+                auto current = t;
+                while( current != unsigned(-1) && states[current] == Unknown )
+                {
+                    chain.push_back( current );
+                    current = field.next_triangles[current];
+                }
+                auto state = current == unsigned(-1) ? RepairState(Reset) : RepairState(states[current]);
+                for( auto triangle : chain )
+                {
+                    states[triangle] = state;
+                }
+            }
+
+            for( auto t = 0u; t < triangle_count; ++t )
+            {
+                if( states[t] == Kept ) field.costs[t] -= target_cost;
+                else ResetTriangle( t, field );
+            }
+            ResetTriangle( target_triangle, field );
+            field.costs[target_triangle] = 0;
+
+            for( auto t = 0u; t < triangle_count; ++t )
+            {
+                if( states[t] != Kept ) continue;
+                for( auto n = adjacency.offsets[t]; n < adjacency.offsets[t + 1]; ++n )
+                {
+                    if( states[adjacency.neighbours[n]] == Reset )
+                    {
+                        open.push( { field.costs[t], t } );
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+
+    unsigned FindTriangle( Math::Float3 position, unsigned hint_triangle, NavigationMesh const & mesh, TriangleAdjacency const & adjacency )
+    {
+        auto position_2d = Math::Float2( position.x, position.y );
+        if( hint_triangle < adjacency.centroids.size() )
+        {
+            if( MeshTriangleContainsPosition( hint_triangle, position_2d, mesh ) ) return hint_triangle;
+            for( auto n = adjacency.offsets[hint_triangle]; n < adjacency.offsets[hint_triangle + 1]; ++n )
+            {
+                auto neighbour = adjacency.neighbours[n];
+                if( MeshTriangleContainsPosition( neighbour, position_2d, mesh ) ) return neighbour;
+            }
+        }
+
+        auto triangle = GetContainingTriangleIndex( position, mesh );
+        if( triangle == unsigned(-1) )
+        {
+            Math::Float3 closest_point;
+            GetClosestPointOnMesh( position, mesh, closest_point, triangle );
+        }
+        return triangle;
+    }
+
+
+    void UpdateFlowField( Math::Float3 target_position, NavigationMesh const & mesh, TriangleAdjacency const & adjacency, FlowField & field )
+    {
+        field.target_position = Math::Float2( target_position.x, target_position.y );
+        auto target_triangle = FindTriangle( target_position, field.target_triangle, mesh, adjacency );
+        auto triangle_count = unsigned( adjacency.centroids.size() );
+        auto valid = field.costs.size() == triangle_count;
+        if( target_triangle == field.target_triangle && valid ) return;
+
+        OpenTriangles open;
+        // a target that was reachable from the old target triangle keeps the part of the field beyond it
+        if( valid && field.costs[target_triangle] != std::numeric_limits<float>::infinity() )
+        {
+            RerootFlowField( target_triangle, adjacency, field, open );
+        }
+        else
+        {
+            field.costs.assign( triangle_count, std::numeric_limits<float>::infinity() );
+            field.next_triangles.assign( triangle_count, unsigned(-1) );
+            field.next_portals.vertices_0.assign( triangle_count, unsigned(-1) );
+            field.next_portals.vertices_1.assign( triangle_count, unsigned(-1) );
+            field.costs[target_triangle] = 0;
+            open.push( { 0.f, target_triangle } );
+        }
+        field.target_triangle = target_triangle;
+
+        // Dijkstra from the target over the triangle centroids
+        while( !open.empty() )
+        {
+            auto current = open.top();
+            open.pop();
+            // skip entries that were superseded by a cheaper one
+            if( current.first > field.costs[current.second] ) continue;
+
+            for( auto n = adjacency.offsets[current.second]; n < adjacency.offsets[current.second + 1]; ++n )
+            {
+                auto neighbour = adjacency.neighbours[n];
+                auto cost = current.first + Math::Norm( adjacency.centroids[neighbour] - adjacency.centroids[current.second] );
+                if( cost < field.costs[neighbour] )
+                {
+                    field.costs[neighbour] = cost;
+                    field.next_triangles[neighbour] = current.second;
+                    field.next_portals.vertices_0[neighbour] = adjacency.portals.vertices_0[n];
+                    field.next_portals.vertices_1[neighbour] = adjacency.portals.vertices_1[n];
+                    open.push( { cost, neighbour } );
+                }
+            }
+        }
+    }
+
+
+    void GetFlowFieldPath( FlowField const & field, NavigationMesh const & mesh, Math::Float3 position, unsigned triangle, std::vector<Math::Float2> & path )
+    {
+        path.clear();
+        auto position_2d = Math::Float2( position.x, position.y );
+
+        // walk straight to the target when in its triangle, or when it can't be reached over the mesh
+        if( triangle == field.target_triangle || field.next_triangles[triangle] == unsigned(-1) )
+        {
+            path.push_back( field.target_position );
+            return;
+        }
+
+        auto first = GetPortalPoint( position_2d, field.next_portals.vertices_0[triangle], field.next_portals.vertices_1[triangle], mesh );
+        path.push_back( first );
+
+        auto next_triangle = field.next_triangles[triangle];
+        if( next_triangle == field.target_triangle )
+        {
+            path.push_back( field.target_position );
+        }
+        else
+        {
+            path.push_back( GetPortalPoint( first, field.next_portals.vertices_0[next_triangle], field.next_portals.vertices_1[next_triangle], mesh ) );
+        }
+    }
+}
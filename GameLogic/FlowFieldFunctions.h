@@ -0,0 +1,19 @@
+#pragma once
+
+#include "FlowField.h"
+
+namespace Logic
+{
+    // returns the triangle containing the position, checking the hint triangle and its neighbours first.
+    // Positions that are not on the mesh return the triangle with the closest point.
+    unsigned FindTriangle( Math::Float3 position, unsigned hint_triangle, NavigationMesh const & mesh, TriangleAdjacency const & adjacency );
+
+    // recalculates the distances with Dijkstra's algorithm, but only if the target moved to another triangle.
+    // Triangles whose way to the old target passed the new target triangle keep their way, shortened by the distance between the two,
+    // Dijkstra's algorithm only runs over the other triangles.
+    void UpdateFlowField( Math::Float3 target_position, NavigationMesh const & mesh, TriangleAdjacency const & adjacency, FlowField & field );
+
+    // stores a path of at most two nodes, towards the portal the agent in the triangle should walk through next
+    // and the portal after that, or towards the target when they're in the same triangle
+    void GetFlowFieldPath( FlowField const & field, NavigationMesh const & mesh, Math::Float3 position, unsigned triangle, std::vector<Math::Float2> & path );
+}
@@ -7,6 +7,7 @@ namespace Logic{
 
     struct ItemContainer;
     struct EntityWieldingAbilities;
+    struct SpatialHash;
 
     struct WeaponWieldingParameters
     {
@@ -18,6 +19,7 @@ namespace Logic{
 
     void PickUpNearestItems(std::vector<EntityID> const & triggered_entities,
                             IndexedOrientations const & indexed_orientations,
+                            SpatialHash const & spatial_hash,
                             ItemContainer const & item_container,
                             EntityWieldingAbilities const & wielding_abilities,
                             std::vector<EntityID> & picking_entities,
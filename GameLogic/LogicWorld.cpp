@@ -15,6 +15,7 @@
 #include "MeleeSystem.h"
 #include "MeleeHitRegistration.h"
 #include "ItemSystem.h"
+#include "SpatialHashFunctions.h"
 
 #include <Math\MathFunctions.h>
 #include <Math\VectorAlgorithms.h>
@@ -32,6 +33,8 @@
 
 #include <Input\GameInput.h>
 
+#include <fstream>
+
 // Temporarily for striking:
 #include <random>
 #include <time.h>
@@ -50,9 +53,9 @@ float const c_play_dead_animation_time = 1.5f;
 LogicWorld::LogicWorld()
 {
     // Hardcoded scampage
-    //m_resource_manager.ProvideNavigationMesh("navigation_castle", m_navmesh_container);
-	//m_resource_manager.ProvideNavigationMesh("navigation_multitower", m_navmesh_container);
-	//m_resource_manager.ProvideNavigationMesh("navigation_100x100m_quad", m_navmesh_container);
+    //m_resource_manager.ProvideNavigationMesh("navigation_castle", m_navmesh_container, m_configuration.navigation_path_tolerance);
+	//m_resource_manager.ProvideNavigationMesh("navigation_multitower", m_navmesh_container, m_configuration.navigation_path_tolerance);
+	//m_resource_manager.ProvideNavigationMesh("navigation_100x100m_quad", m_navmesh_container, m_configuration.navigation_path_tolerance);
 }
 
 
@@ -583,6 +586,8 @@ LogicWorld::Output LogicWorld::UpdateGameLogic(const float time_step,
 	// ##### Perform immediate actions that occurred after the last game tick
     InitializeRecentEntities(output);
 
+    CreateSpatialHash(indexed_orientations, c_spatial_hash_cell_size, m_spatial_hash);
+
 	Append(output.entity_component_replacements.entity_ids, m_immediate_body_replacements.entity_ids);
 	Append(output.entity_component_replacements.template_ids, m_immediate_body_replacements.template_ids);
 
@@ -640,6 +645,7 @@ LogicWorld::Output LogicWorld::UpdateGameLogic(const float time_step,
     if(!m_navmesh_container.m_navigation_meshes.empty())
     {
         auto & navigation_mesh = m_navmesh_container.m_navigation_meshes.front();
+        auto & navigation_hierarchy = m_navmesh_container.m_navigation_hierarchies.front();
         UpdateAIControllers(indexed_orientations,
                             indexed_velocities,
                             m_ai_parameters,
@@ -650,7 +656,12 @@ LogicWorld::Output LogicWorld::UpdateGameLogic(const float time_step,
                             target_z_angles,
                             target_speed_factors,
                             melee_action_triggers,
-                            navigation_mesh);
+                            navigation_mesh,
+                            navigation_hierarchy,
+                            m_path_requests,
+                            m_flow_fields,
+                            m_camera.m_position,
+                            m_configuration.path_finding_budget_microseconds);
     }
     assert(Size(moving_entity_ids) == Size(movements));
 
@@ -828,6 +839,7 @@ LogicWorld::Output LogicWorld::UpdateGameLogic(const float time_step,
         std::vector<EntityID> picking_entities, picked_up_entities;
         PickUpNearestItems( entities_that_want_to_pick_up_an_item,
                             indexed_orientations,
+                            m_spatial_hash,
                             m_item_container,
                             m_entity_wielding_abilities,
                             picking_entities,
@@ -998,6 +1010,8 @@ void LogicWorld::SetCameraTarget(EntityID entity_id)
 void LogicWorld::AdjustAllPositions(Math::Float3 adjustment)
 {
     m_camera.m_position += adjustment;
+    // the stored positions are no longer valid, the hash is rebuilt in the next update
+    m_spatial_hash = SpatialHash();
 }
 
 
@@ -1005,3 +1019,86 @@ void LogicWorld::UpdateCamera(const float time_step, CameraInput const & input,
 {
     m_camera.Update(time_step, input, indexed_orientations);
 }
+
+
+void LogicWorld::SetNavigationMesh( NavigationMesh mesh )
+{
+    if( m_navmesh_container.m_navigation_meshes.empty() )
+    {
+        m_navmesh_container.AddNavigationMesh( std::move( mesh ), m_configuration.navigation_path_tolerance );
+    }
+    else
+    {
+        m_navmesh_container.ReplaceNavigationMesh( NavigationMeshID( 0, 0 ), std::move( mesh ), m_configuration.navigation_path_tolerance );
+    }
+    NavigationMeshChanged();
+}
+
+
+void LogicWorld::NavigationMeshChanged()
+{
+    for( auto & corridor : m_ai_parameters.m_following.m_corridors )
+    {
+        corridor = PathCorridor();
+    }
+    m_flow_fields = FlowFieldContainer();
+}
+
+
+void LogicWorld::GenerateNavigationMesh( NavigationGeometry const & geometry )
+{
+    BuildNavigationTiles( geometry, m_configuration.navigation_mesh, m_navigation_tiles );
+    NavigationMesh mesh;
+    MergeNavigationTiles( m_navigation_tiles, mesh );
+    SetNavigationMesh( std::move( mesh ) );
+}
+
+
+void LogicWorld::UpdateNavigationMesh( NavigationGeometry const & geometry, Math::Float3 changed_minimum, Math::Float3 changed_maximum )
+{
+    if( m_navigation_tiles.tiles.empty() )
+    {
+        GenerateNavigationMesh( geometry );
+        return;
+    }
+
+    RebuildNavigationTiles( geometry, m_configuration.navigation_mesh, changed_minimum, changed_maximum, m_navigation_tiles );
+    NavigationMesh mesh;
+    MergeNavigationTiles( m_navigation_tiles, mesh );
+    SetNavigationMesh( std::move( mesh ) );
+}
+
+
+void LogicWorld::SaveNavigationMesh( std::string const & name ) const
+{
+    if( m_navmesh_container.m_navigation_meshes.empty() ) return;
+
+    std::ofstream data_stream( "Resources\\" + name + ".navmesh", std::ios::binary );
+    m_navmesh_container.SavePrebuiltNavigationMesh( NavigationMeshID( 0, 0 ), data_stream );
+}
+
+
+bool LogicWorld::LoadNavigationMesh( std::string const & name )
+{
+    std::ifstream data_stream( "Resources\\" + name + ".navmesh", std::ios::binary );
+    if( !data_stream.good() ) return false;
+
+    // the saved mesh comes with its hierarchy, so nothing has to be built
+    NavigationMeshContainer loaded;
+    loaded.LoadPrebuiltNavigationMesh( data_stream );
+    // a hierarchy built with another tolerance is out of date, let the caller generate the mesh again
+    if( loaded.m_navigation_hierarchies.front().tolerance != m_configuration.navigation_path_tolerance ) return false;
+    if( m_navmesh_container.m_navigation_meshes.empty() )
+    {
+        m_navmesh_container = std::move( loaded );
+    }
+    else
+    {
+        m_navmesh_container.m_navigation_meshes.front() = std::move( loaded.m_navigation_meshes.front() );
+        m_navmesh_container.m_navigation_hierarchies.front() = std::move( loaded.m_navigation_hierarchies.front() );
+    }
+    // there are no tiles for it, the next update of the static geometry generates the whole mesh again
+    m_navigation_tiles = NavigationTiles();
+    NavigationMeshChanged();
+    return true;
+}
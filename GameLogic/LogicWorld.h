@@ -18,6 +18,8 @@
 
 #include "AIParameterContainer.h"
 #include "NavigationMeshContainer.h"
+#include "PathRequestQueue.h"
+#include "FlowField.h"
 
 #include "ItemContainer.h"
 #include "ProjectileContainer.h"
@@ -26,6 +28,8 @@
 
 #include "AnimatingStateMachineContainer.h"
 
+#include "SpatialHash.h"
+
 #include <Conventions\AnimatingInstructions.h>
 #include <Conventions\CollisionEvent.h>
 #include <Conventions\EntitySpawnDescription.h>
@@ -166,11 +170,25 @@ namespace Logic{
 
         void UpdateCamera(const float time_step, CameraInput const & input, IndexedOrientations const & indexed_orientations);
 
+        // replaces the navigation mesh the AI uses
+        void SetNavigationMesh( NavigationMesh mesh );
+        // builds the navigation mesh from the static geometry, see m_configuration.navigation_mesh
+        void GenerateNavigationMesh( NavigationGeometry const & geometry );
+        // rebuilds the part of the generated navigation mesh around the corners, after the static geometry there changed
+        void UpdateNavigationMesh( NavigationGeometry const & geometry, Math::Float3 changed_minimum, Math::Float3 changed_maximum );
+        // writes the navigation mesh as Resources\name.navmesh, which is loaded in place of name.mesh
+        void SaveNavigationMesh( std::string const & name ) const;
+        // replaces the navigation mesh with Resources\name.navmesh, returns false if there is no such file
+        bool LoadNavigationMesh( std::string const & name );
+
     public:
         WorldConfiguration m_configuration;
         Camera	m_camera;
 	private:
 
+        // drops the corridors and flow fields, which refer to triangles of the old navigation mesh
+        void NavigationMeshChanged();
+
         std::vector<EntityID> m_uninitialized_entities;
         std::vector<EntityID> m_entities_to_be_killed;
 
@@ -202,10 +220,17 @@ namespace Logic{
         ProjectileContainer m_projectile_container;
         ItemContainer m_item_container;
         AttachmentPointContainer m_attachment_point_container;
+
+        // entity positions of the current update, rebuilt at the start of each UpdateGameLogic
+        SpatialHash m_spatial_hash;
         DamageDealersContainer m_damage_dealers_container;
 
         AIParameterContainer m_ai_parameters;
+        PathRequestQueue m_path_requests;
+        FlowFieldContainer m_flow_fields;
         NavigationMeshContainer m_navmesh_container;
+        // tiles of the generated navigation mesh, kept to rebuild parts of it
+        NavigationTiles m_navigation_tiles;
 
 		AnimatingStateMachineContainer m_animating_state_machine_container;
 	};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Structures.h"
+
+#include <vector>
+
+namespace Logic
+{
+    // number of triangles grouped into one cluster of the navigation hierarchy
+    unsigned const c_navigation_cluster_size = 64;
+    // how much longer than the shortest one a path found through the hierarchy may be, as a fraction
+    float const c_navigation_path_tolerance = 0.1f;
+
+
+    // Abstraction of a navigation mesh for long paths. The triangles are grouped into connected clusters,
+    // the triangles on the cluster borders form a graph of their own. Its edges either cross into the
+    // neighbouring cluster or hold the precomputed distance to another border triangle of the same cluster.
+    struct NavigationHierarchy
+    {
+        TriangleAdjacency adjacency;
+
+        // the triangles of cluster c are cluster_triangles[cluster_offsets[c]] to cluster_triangles[cluster_offsets[c + 1] - 1]
+        std::vector<unsigned> triangle_clusters;
+        std::vector<unsigned> cluster_offsets;
+        std::vector<unsigned> cluster_triangles;
+
+        // border triangles, per cluster in the same way as the triangles
+        std::vector<unsigned> node_triangles;
+        std::vector<unsigned> triangle_nodes;
+        std::vector<unsigned> cluster_node_offsets;
+
+        // edges of node n are edge_targets[edge_offsets[n]] to edge_targets[edge_offsets[n + 1] - 1]
+        std::vector<unsigned> edge_offsets;
+        std::vector<unsigned> edge_targets;
+        std::vector<float> edge_costs;
+
+        float tolerance = c_navigation_path_tolerance;
+    };
+
+
+    // state of a search over the triangles, sized for the whole mesh but only reset where it was used
+    struct TriangleSearch
+    {
+        std::vector<float> costs;
+        std::vector<unsigned> predecessors;
+        // index into the adjacency of the predecessor, for the crossed portal
+        std::vector<unsigned> predecessor_neighbours;
+        std::vector<unsigned> touched;
+    };
+
+
+    // Buffers of FindHierarchicalCorridor. Kept by the caller between queries, so that a query
+    // only pays for the triangles and nodes it visits instead of the size of the mesh.
+    struct NavigationHierarchySearch
+    {
+        TriangleSearch start_search;
+        TriangleSearch destination_search;
+        TriangleSearch refinement;
+
+        // per border node, with the destination as an extra node after them
+        std::vector<float> node_costs;
+        std::vector<unsigned> node_predecessors;
+        std::vector<unsigned> touched_nodes;
+
+        // per cluster whether the triangle searches may enter it, and the clusters that are set
+        std::vector<char> allowed_clusters;
+        std::vector<unsigned> allowed_cluster_list;
+    };
+}
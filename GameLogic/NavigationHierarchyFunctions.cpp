@@ -0,0 +1,352 @@
+#include "NavigationHierarchyFunctions.h"
+
+#include "AINavigationMeshFunctions.h"
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace Logic
+{
+    namespace
+    {
+        float const c_unreached = std::numeric_limits<float>::infinity();
+
+        typedef std::pair<float, unsigned> OpenEntry;
+        typedef std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> OpenQueue;
+
+
+        void ResetSearch( unsigned triangle_count, TriangleSearch & search )
+        {
+            if( search.costs.size() != triangle_count )
+            {
+                search.costs.assign( triangle_count, c_unreached );
+                search.predecessors.assign( triangle_count, unsigned(-1) );
+                search.predecessor_neighbours.assign( triangle_count, unsigned(-1) );
+            }
+            else
+            {
+                for( auto t : search.touched )
+                {
+                    search.costs[t] = c_unreached;
+                    search.predecessors[t] = unsigned(-1);
+                    search.predecessor_neighbours[t] = unsigned(-1);
+                }
+            }
+            search.touched.clear();
+        }
+
+
+        // A* over the triangle centroids, only entering triangles of the allowed clusters.
+        // Without a destination all reachable triangles get their shortest distance.
+        void SearchTriangles( unsigned start, unsigned destination, std::vector<char> const & allowed_clusters, NavigationHierarchy const & hierarchy, TriangleSearch & search )
+        {
+            auto const & adjacency = hierarchy.adjacency;
+            auto heuristic = [&]( unsigned triangle )
+            {
+                return destination == unsigned(-1) ? 0.f : Math::Norm( adjacency.centroids[triangle] - adjacency.centroids[destination] );
+            };
+
+            ResetSearch( unsigned( adjacency.centroids.size() ), search );
+            search.costs[start] = 0;
+            search.touched.push_back( start );
+
+            OpenQueue open;
+            open.push( { heuristic( start ), start } );
+            while( !open.empty() )
+            {
+                auto current = open.top();
+                open.pop();
+                if( current.second == destination ) return;
+                // skip entries that were superseded by a cheaper one
+                if( current.first > search.costs[current.second] + heuristic( current.second ) ) continue;
+
+                for( auto n = adjacency.offsets[current.second]; n < adjacency.offsets[current.second + 1]; ++n )
+                {
+                    auto neighbour = adjacency.neighbours[n];
+                    if( !allowed_clusters[hierarchy.triangle_clusters[neighbour]] ) continue;
+
+                    auto cost = search.costs[current.second] + Math::Norm( adjacency.centroids[neighbour] - adjacency.centroids[current.second] );
+                    if( cost < search.costs[neighbour] )
+                    {
+                        if( search.costs[neighbour] == c_unreached ) search.touched.push_back( neighbour );
+                        search.costs[neighbour] = cost;
+                        search.predecessors[neighbour] = current.second;
+                        search.predecessor_neighbours[neighbour] = n;
+                        open.push( { cost + heuristic( neighbour ), neighbour } );
+                    }
+                }
+            }
+        }
+
+
+        void SearchCluster( unsigned start, unsigned cluster, std::vector<char> & allowed_clusters, NavigationHierarchy const & hierarchy, TriangleSearch & search )
+        {
+            allowed_clusters[cluster] = true;
+            SearchTriangles( start, unsigned(-1), allowed_clusters, hierarchy, search );
+            allowed_clusters[cluster] = false;
+        }
+
+
+        // sizes the node and cluster buffers for the hierarchy the first time, afterwards only resets what the last query used
+        void ResetHierarchySearch( NavigationHierarchy const & hierarchy, NavigationHierarchySearch & search )
+        {
+            auto node_count = hierarchy.node_triangles.size() + 1;
+            if( search.node_costs.size() != node_count )
+            {
+                search.node_costs.assign( node_count, c_unreached );
+                search.node_predecessors.assign( node_count, unsigned(-1) );
+            }
+            else
+            {
+                for( auto node : search.touched_nodes )
+                {
+                    search.node_costs[node] = c_unreached;
+                    search.node_predecessors[node] = unsigned(-1);
+                }
+            }
+            search.touched_nodes.clear();
+
+            auto cluster_count = hierarchy.cluster_offsets.size() - 1;
+            if( search.allowed_clusters.size() != cluster_count )
+            {
+                search.allowed_clusters.assign( cluster_count, false );
+            }
+            else
+            {
+                for( auto cluster : search.allowed_cluster_list )
+                {
+                    search.allowed_clusters[cluster] = false;
+                }
+            }
+            search.allowed_cluster_list.clear();
+        }
+
+
+        void AllowCluster( unsigned cluster, NavigationHierarchySearch & search )
+        {
+            if( search.allowed_clusters[cluster] ) return;
+            search.allowed_clusters[cluster] = true;
+            search.allowed_cluster_list.push_back( cluster );
+        }
+
+
+        void GrowClusters( unsigned cluster_size, NavigationHierarchy & hierarchy )
+        {
+            auto const & adjacency = hierarchy.adjacency;
+            auto triangle_count = unsigned( adjacency.centroids.size() );
+            hierarchy.triangle_clusters.assign( triangle_count, unsigned(-1) );
+            hierarchy.cluster_offsets.assign( 1, 0 );
+            hierarchy.cluster_triangles.clear();
+            hierarchy.cluster_triangles.reserve( triangle_count );
+
+            // grow each cluster breadth first from the first unassigned triangle,
+            // using the cluster triangles as the queue
+            for( auto seed = 0u; seed < triangle_count; ++seed )
+            {
+                if( hierarchy.triangle_clusters[seed] != unsigned(-1) ) continue;
+
+                auto cluster = unsigned( hierarchy.cluster_offsets.size() - 1 );
+                auto first = unsigned( hierarchy.cluster_triangles.size() );
+                hierarchy.triangle_clusters[seed] = cluster;
+                hierarchy.cluster_triangles.push_back( seed );
+
+                for( auto i = first; i < hierarchy.cluster_triangles.size(); ++i )
+                {
+                    auto triangle = hierarchy.cluster_triangles[i];
+                    for( auto n = adjacency.offsets[triangle]; n < adjacency.offsets[triangle + 1]; ++n )
+                    {
+                        auto neighbour = adjacency.neighbours[n];
+                        if( hierarchy.triangle_clusters[neighbour] != unsigned(-1) ) continue;
+                        if( hierarchy.cluster_triangles.size() - first >= cluster_size ) break;
+
+                        hierarchy.triangle_clusters[neighbour] = cluster;
+                        hierarchy.cluster_triangles.push_back( neighbour );
+                    }
+                }
+                hierarchy.cluster_offsets.push_back( unsigned( hierarchy.cluster_triangles.size() ) );
+            }
+        }
+
+
+        void FindBorderNodes( NavigationHierarchy & hierarchy )
+        {
+            auto const & adjacency = hierarchy.adjacency;
+            auto cluster_count = unsigned( hierarchy.cluster_offsets.size() - 1 );
+            hierarchy.triangle_nodes.assign( adjacency.centroids.size(), unsigned(-1) );
+            hierarchy.node_triangles.clear();
+            hierarchy.cluster_node_offsets.assign( 1, 0 );
+
+            for( auto c = 0u; c < cluster_count; ++c )
+            {
+                for( auto i = hierarchy.cluster_offsets[c]; i < hierarchy.cluster_offsets[c + 1]; ++i )
+                {
+                    auto triangle = hierarchy.cluster_triangles[i];
+                    for( auto n = adjacency.offsets[triangle]; n < adjacency.offsets[triangle + 1]; ++n )
+                    {
+                        if( hierarchy.triangle_clusters[adjacency.neighbours[n]] != c )
+                        {
+                            hierarchy.triangle_nodes[triangle] = unsigned( hierarchy.node_triangles.size() );
+                            hierarchy.node_triangles.push_back( triangle );
+                            break;
+                        }
+                    }
+                }
+                hierarchy.cluster_node_offsets.push_back( unsigned( hierarchy.node_triangles.size() ) );
+            }
+        }
+
+
+        void ConnectBorderNodes( NavigationHierarchy & hierarchy )
+        {
+            auto const & adjacency = hierarchy.adjacency;
+            auto node_count = unsigned( hierarchy.node_triangles.size() );
+            hierarchy.edge_offsets.assign( 1, 0 );
+            hierarchy.edge_targets.clear();
+            hierarchy.edge_costs.clear();
+
+            TriangleSearch search;
+            std::vector<char> allowed_clusters( hierarchy.cluster_offsets.size() - 1, false );
+            for( auto node = 0u; node < node_count; ++node )
+            {
+                auto triangle = hierarchy.node_triangles[node];
+                auto cluster = hierarchy.triangle_clusters[triangle];
+
+                // into the neighbouring clusters
+                for( auto n = adjacency.offsets[triangle]; n < adjacency.offsets[triangle + 1]; ++n )
+                {
+                    auto neighbour = adjacency.neighbours[n];
+                    if( hierarchy.triangle_clusters[neighbour] == cluster ) continue;
+                    hierarchy.edge_targets.push_back( hierarchy.triangle_nodes[neighbour] );
+                    hierarchy.edge_costs.push_back( Math::Norm( adjacency.centroids[neighbour] - adjacency.centroids[triangle] ) );
+                }
+
+                // and through the own cluster to its other borders
+                SearchCluster( triangle, cluster, allowed_clusters, hierarchy, search );
+                for( auto other = hierarchy.cluster_node_offsets[cluster]; other < hierarchy.cluster_node_offsets[cluster + 1]; ++other )
+                {
+                    auto cost = search.costs[hierarchy.node_triangles[other]];
+                    if( other == node || cost == c_unreached ) continue;
+                    hierarchy.edge_targets.push_back( other );
+                    hierarchy.edge_costs.push_back( cost );
+                }
+                hierarchy.edge_offsets.push_back( unsigned( hierarchy.edge_targets.size() ) );
+            }
+        }
+    }
+
+
+    void CreateNavigationHierarchy( NavigationMesh const & mesh, unsigned cluster_size, float tolerance, NavigationHierarchy & hierarchy )
+    {
+        assert( cluster_size > 0 );
+        hierarchy.tolerance = tolerance;
+        CreateTriangleAdjacency( mesh, hierarchy.adjacency );
+        GrowClusters( cluster_size, hierarchy );
+        FindBorderNodes( hierarchy );
+        ConnectBorderNodes( hierarchy );
+    }
+
+
+    bool FindHierarchicalCorridor( unsigned start_triangle, unsigned destination_triangle, NavigationHierarchy const & hierarchy, NavigationHierarchySearch & search, PathCorridor & corridor )
+    {
+        corridor.triangles.assign( 1, start_triangle );
+        corridor.portals.vertices_0.clear();
+        corridor.portals.vertices_1.clear();
+        if( start_triangle == destination_triangle ) return true;
+
+        auto const & adjacency = hierarchy.adjacency;
+        auto start_cluster = hierarchy.triangle_clusters[start_triangle];
+        auto destination_cluster = hierarchy.triangle_clusters[destination_triangle];
+        ResetHierarchySearch( hierarchy, search );
+        auto & allowed_clusters = search.allowed_clusters;
+        auto const & start_search = search.start_search;
+        auto const & destination_search = search.destination_search;
+
+        // distances from the start to the borders of its cluster and from the borders of the destination cluster to the destination
+        SearchCluster( start_triangle, start_cluster, allowed_clusters, hierarchy, search.start_search );
+        SearchCluster( destination_triangle, destination_cluster, allowed_clusters, hierarchy, search.destination_search );
+
+        // weighted A* over the border nodes, with the destination as an extra node.
+        // The weight keeps the result within the tolerance of the shortest connection
+        auto node_count = unsigned( hierarchy.node_triangles.size() );
+        auto goal = node_count;
+        auto weight = 1 + hierarchy.tolerance;
+        auto destination = adjacency.centroids[destination_triangle];
+        auto heuristic = [&]( unsigned node )
+        {
+            return node == goal ? 0.f : weight * Math::Norm( adjacency.centroids[hierarchy.node_triangles[node]] - destination );
+        };
+
+        auto & costs = search.node_costs;
+        auto & predecessors = search.node_predecessors;
+        OpenQueue open;
+        auto relax = [&]( unsigned node, unsigned predecessor, float cost )
+        {
+            if( cost >= costs[node] ) return;
+            if( costs[node] == c_unreached ) search.touched_nodes.push_back( node );
+            costs[node] = cost;
+            predecessors[node] = predecessor;
+            open.push( { cost + heuristic( node ), node } );
+        };
+
+        if( start_cluster == destination_cluster )
+        {
+            relax( goal, unsigned(-1), start_search.costs[destination_triangle] );
+        }
+        for( auto node = hierarchy.cluster_node_offsets[start_cluster]; node < hierarchy.cluster_node_offsets[start_cluster + 1]; ++node )
+        {
+            relax( node, unsigned(-1), start_search.costs[hierarchy.node_triangles[node]] );
+        }
+
+        while( !open.empty() )
+        {
+            auto current = open.top();
+            open.pop();
+            if( current.second == goal ) break;
+            if( current.first > costs[current.second] + heuristic( current.second ) ) continue;
+
+            auto triangle = hierarchy.node_triangles[current.second];
+            if( hierarchy.triangle_clusters[triangle] == destination_cluster )
+            {
+                relax( goal, current.second, costs[current.second] + destination_search.costs[triangle] );
+            }
+            for( auto e = hierarchy.edge_offsets[current.second]; e < hierarchy.edge_offsets[current.second + 1]; ++e )
+            {
+                relax( hierarchy.edge_targets[e], current.second, costs[current.second] + hierarchy.edge_costs[e] );
+            }
+        }
+        if( costs[goal] == c_unreached ) return false;
+
+        // refine within the clusters along the route
+        AllowCluster( start_cluster, search );
+        AllowCluster( destination_cluster, search );
+        for( auto node = predecessors[goal]; node != unsigned(-1); node = predecessors[node] )
+        {
+            AllowCluster( hierarchy.triangle_clusters[hierarchy.node_triangles[node]], search );
+        }
+
+        auto const & refinement = search.refinement;
+        SearchTriangles( start_triangle, destination_triangle, allowed_clusters, hierarchy, search.refinement );
+        if( refinement.costs[destination_triangle] == c_unreached ) return false;
+
+        // collect the triangles and crossed portals from the destination back to the start
+        corridor.triangles.clear();
+        for( auto triangle = destination_triangle; triangle != start_triangle; triangle = refinement.predecessors[triangle] )
+        {
+            auto n = refinement.predecessor_neighbours[triangle];
+            corridor.triangles.push_back( triangle );
+            corridor.portals.vertices_0.push_back( adjacency.portals.vertices_0[n] );
+            corridor.portals.vertices_1.push_back( adjacency.portals.vertices_1[n] );
+        }
+        corridor.triangles.push_back( start_triangle );
+        std::reverse( begin( corridor.triangles ), end( corridor.triangles ) );
+        std::reverse( begin( corridor.portals.vertices_0 ), end( corridor.portals.vertices_0 ) );
+        std::reverse( begin( corridor.portals.vertices_1 ), end( corridor.portals.vertices_1 ) );
+        return true;
+    }
+}
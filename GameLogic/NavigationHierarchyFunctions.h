@@ -0,0 +1,13 @@
+#pragma once
+
+#include "NavigationHierarchy.h"
+
+namespace Logic
+{
+    void CreateNavigationHierarchy( NavigationMesh const & mesh, unsigned cluster_size, float tolerance, NavigationHierarchy & hierarchy );
+
+    // Searches the graph of cluster borders first and then the triangles of the clusters on the found route.
+    // The corridor is at most 1 + tolerance times as long as the shortest connection of the triangle centroids.
+    // Returns false if the destination can't be reached.
+    bool FindHierarchicalCorridor( unsigned start_triangle, unsigned destination_triangle, NavigationHierarchy const & hierarchy, NavigationHierarchySearch & search, PathCorridor & corridor );
+}
@@ -0,0 +1,601 @@
+#include "NavigationMeshBuilder.h"
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <ppl.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <tuple>
+
+namespace Logic
+{
+    namespace
+    {
+        unsigned const c_no_vertex = unsigned(-1);
+        // larger bounds are rejected, their cell and sample counts don't fit the integer types
+        float const c_maximum_cells_per_side = float( 1 << 20 );
+        float const c_maximum_samples_per_column = float( 1 << 16 );
+
+
+        // solid vertical interval of a voxel column
+        struct Span
+        {
+            float minimum;
+            float maximum;
+            // whether the top of the span can be walked on
+            bool walkable;
+        };
+
+
+        // the spans of a block of columns, the first column belongs to the cell (first_x, first_y)
+        struct Heightfield
+        {
+            int first_x, first_y;
+            int width, height;
+            std::vector<std::vector<Span>> columns;
+        };
+
+
+        int GetColumnIndex( int x, int y, Heightfield const & heightfield )
+        {
+            return ( y - heightfield.first_y ) * heightfield.width + ( x - heightfield.first_x );
+        }
+
+
+        // the cells [begin, end) touched by the interval, limited to the cells [first, first + count)
+        void GetCellRange( float minimum, float maximum, float origin, float cell_size, int first, int count, int & begin, int & end )
+        {
+            // limit the cells while they're floats, huge intervals don't fit into an int
+            auto first_cell = float( first );
+            auto last_cell = float( first + count );
+            begin = int( std::min( std::max( first_cell, std::floor( ( minimum - origin ) / cell_size ) ), last_cell ) );
+            end = int( std::min( std::max( first_cell, std::floor( ( maximum - origin ) / cell_size ) + 1 ), last_cell ) );
+        }
+
+
+        // the part of the density bounds within the level bounds, the maximum is below the minimum if they don't overlap
+        void ClampToLevel( Math::Float3 & minimum, Math::Float3 & maximum, NavigationMeshBuildSettings const & settings )
+        {
+            for( auto a = 0u; a < 3; ++a )
+            {
+                minimum[a] = std::max( minimum[a], settings.level_minimum[a] );
+                maximum[a] = std::min( maximum[a], settings.level_maximum[a] );
+            }
+        }
+
+
+        // keeps the part of the polygon on one side of the plane where the coordinate along the axis equals the limit
+        void ClipPolygon( unsigned axis, float limit, bool keep_above, std::vector<Math::Float3> const & input, std::vector<Math::Float3> & output )
+        {
+            output.clear();
+            auto count = input.size();
+            for( auto i = 0u; i < count; ++i )
+            {
+                auto const & a = input[i];
+                auto const & b = input[( i + 1 ) % count];
+                auto distance_a = keep_above ? a[axis] - limit : limit - a[axis];
+                auto distance_b = keep_above ? b[axis] - limit : limit - b[axis];
+                if( distance_a >= 0 ) output.push_back( a );
+                if( ( distance_a >= 0 ) != ( distance_b >= 0 ) )
+                {
+                    output.push_back( a + ( b - a ) * ( distance_a / ( distance_a - distance_b ) ) );
+                }
+            }
+        }
+
+
+        // adds a span to each column the triangle passes through, reaching from its lowest to its highest point within the column
+        void RasterizeTriangle( Math::Float3 a, Math::Float3 b, Math::Float3 c, NavigationMeshBuildSettings const & settings, Math::Float2 origin, Heightfield & heightfield )
+        {
+            auto normal = Math::Cross( b - a, c - a );
+            auto length = Math::Norm( normal );
+            if( length <= 0 ) return;
+            auto walkable = normal.z >= settings.minimum_walkable_normal_z * length;
+
+            auto cell_size = settings.cell_size;
+            int x_begin, x_end, y_begin, y_end;
+            GetCellRange( std::min( { a.x, b.x, c.x } ), std::max( { a.x, b.x, c.x } ), origin.x, cell_size, heightfield.first_x, heightfield.width, x_begin, x_end );
+            GetCellRange( std::min( { a.y, b.y, c.y } ), std::max( { a.y, b.y, c.y } ), origin.y, cell_size, heightfield.first_y, heightfield.height, y_begin, y_end );
+
+            std::vector<Math::Float3> triangle = { a, b, c };
+            std::vector<Math::Float3> row, cell, scratch;
+            for( auto y = y_begin; y < y_end; ++y )
+            {
+                // clip to the row first, then to each cell of it
+                ClipPolygon( 1, origin.y + y * cell_size, true, triangle, scratch );
+                ClipPolygon( 1, origin.y + ( y + 1 ) * cell_size, false, scratch, row );
+                if( row.empty() ) continue;
+
+                for( auto x = x_begin; x < x_end; ++x )
+                {
+                    ClipPolygon( 0, origin.x + x * cell_size, true, row, scratch );
+                    ClipPolygon( 0, origin.x + ( x + 1 ) * cell_size, false, scratch, cell );
+                    if( cell.empty() ) continue;
+
+                    auto minimum = cell.front().z;
+                    auto maximum = cell.front().z;
+                    for( auto const & vertex : cell )
+                    {
+                        minimum = std::min( minimum, vertex.z );
+                        maximum = std::max( maximum, vertex.z );
+                    }
+                    heightfield.columns[GetColumnIndex( x, y, heightfield )].push_back( { minimum, maximum, walkable } );
+                }
+            }
+        }
+
+
+        // adds the solid intervals along each column through the bounds, interpolating where the density changes its sign
+        void SampleDensityFunction( NavigationDensityFunction const & function, Math::Float3 minimum, Math::Float3 maximum, NavigationMeshBuildSettings const & settings, Math::Float2 origin, Heightfield & heightfield )
+        {
+            auto cell_size = settings.cell_size;
+            int x_begin, x_end, y_begin, y_end;
+            GetCellRange( minimum.x, maximum.x, origin.x, cell_size, heightfield.first_x, heightfield.width, x_begin, x_end );
+            GetCellRange( minimum.y, maximum.y, origin.y, cell_size, heightfield.first_y, heightfield.height, y_begin, y_end );
+
+            auto samples = std::ceil( ( maximum.z - minimum.z ) / settings.cell_height ) + 1;
+            if( !( samples <= c_maximum_samples_per_column ) )
+            {
+                assert( false && "Too many density samples per column, the level bounds are too high for the cell height" );
+                samples = c_maximum_samples_per_column;
+            }
+            auto sample_count = std::max( 2, int( samples ) );
+            auto step = ( maximum.z - minimum.z ) / ( sample_count - 1 );
+
+            for( auto y = y_begin; y < y_end; ++y )
+            {
+                for( auto x = x_begin; x < x_end; ++x )
+                {
+                    auto & column = heightfield.columns[GetColumnIndex( x, y, heightfield )];
+                    auto position = Math::Float3( origin.x + ( x + 0.5f ) * cell_size, origin.y + ( y + 0.5f ) * cell_size, minimum.z );
+
+                    auto inside = false;
+                    auto bottom = minimum.z;
+                    auto previous_density = 0.f;
+                    for( auto k = 0; k < sample_count; ++k )
+                    {
+                        position.z = minimum.z + step * k;
+                        float density;
+                        Math::Float3 gradient;
+                        function( position, density, gradient );
+
+                        auto solid = density > 0;
+                        if( solid != inside )
+                        {
+                            auto crossing = k == 0 ? position.z : position.z - step + step * previous_density / ( previous_density - density );
+                            if( solid )
+                            {
+                                bottom = crossing;
+                            }
+                            else
+                            {
+                                // the surface normal points against the gradient
+                                auto gradient_length = Math::Norm( gradient );
+                                auto walkable = gradient_length > 0 && -gradient.z >= settings.minimum_walkable_normal_z * gradient_length;
+                                column.push_back( { bottom, crossing, walkable } );
+                            }
+                            inside = solid;
+                        }
+                        previous_density = density;
+                    }
+                    // cut off by the bounds, so the top is no surface
+                    if( inside ) column.push_back( { bottom, maximum.z, false } );
+                }
+            }
+        }
+
+
+        // merges the overlapping spans of each column and keeps the tops that are walkable and have enough space above them
+        void FindWalkableSurfaces( NavigationMeshBuildSettings const & settings, Heightfield & heightfield, std::vector<std::vector<float>> & surfaces )
+        {
+            surfaces.resize( heightfield.columns.size() );
+            std::vector<Span> merged;
+            for( auto c = 0u; c < heightfield.columns.size(); ++c )
+            {
+                auto & column = heightfield.columns[c];
+                std::sort( begin( column ), end( column ), []( Span const & a, Span const & b ) { return a.minimum < b.minimum; } );
+
+                merged.clear();
+                for( auto const & span : column )
+                {
+                    if( merged.empty() || span.minimum > merged.back().maximum )
+                    {
+                        merged.push_back( span );
+                        continue;
+                    }
+
+                    // the top decides whether the merged span is walkable, tops within climbing distance of each other both count
+                    auto & top = merged.back();
+                    if( span.maximum > top.maximum + settings.maximum_climb ) top.walkable = span.walkable;
+                    else if( std::abs( span.maximum - top.maximum ) <= settings.maximum_climb ) top.walkable = top.walkable || span.walkable;
+                    top.maximum = std::max( top.maximum, span.maximum );
+                }
+
+                surfaces[c].clear();
+                for( auto i = 0u; i < merged.size(); ++i )
+                {
+                    if( !merged[i].walkable ) continue;
+                    auto ceiling = i + 1 < merged.size() ? merged[i + 1].minimum : std::numeric_limits<float>::infinity();
+                    if( ceiling - merged[i].maximum >= settings.agent_height ) surfaces[c].push_back( merged[i].maximum );
+                }
+            }
+        }
+
+
+        // consecutive cells merged into one polygon, with the surface used in each of its cells
+        struct Rectangle
+        {
+            int x, y;
+            int width, height;
+            std::vector<unsigned> surfaces;
+        };
+
+
+        void BuildTile( unsigned tile_index, NavigationGeometry const & geometry, NavigationMeshBuildSettings const & settings, NavigationTiles & tiles )
+        {
+            auto cell_size = settings.cell_size;
+            auto tile_cells = int( settings.tile_cells );
+            int x0 = ( tile_index % tiles.tile_count_x ) * tile_cells;
+            int y0 = ( tile_index / tiles.tile_count_x ) * tile_cells;
+            int x1 = std::min( x0 + tile_cells, int( tiles.cell_count_x ) );
+            int y1 = std::min( y0 + tile_cells, int( tiles.cell_count_y ) );
+
+            // voxelize the tile and a ring of cells around it, so the vertices on the tile border
+            // come out the same as those of the neighbouring tiles
+            Heightfield heightfield;
+            heightfield.first_x = x0 - 1;
+            heightfield.first_y = y0 - 1;
+            heightfield.width = x1 - x0 + 2;
+            heightfield.height = y1 - y0 + 2;
+            heightfield.columns.resize( heightfield.width * heightfield.height );
+
+            auto origin = tiles.origin;
+            auto minimum_x = origin.x + heightfield.first_x * cell_size;
+            auto minimum_y = origin.y + heightfield.first_y * cell_size;
+            auto maximum_x = minimum_x + heightfield.width * cell_size;
+            auto maximum_y = minimum_y + heightfield.height * cell_size;
+
+            auto const & vertices = geometry.triangle_vertices;
+            for( auto t = 0u; t + 2 < vertices.size(); t += 3 )
+            {
+                auto const & a = vertices[t];
+                auto const & b = vertices[t + 1];
+                auto const & c = vertices[t + 2];
+                if( std::max( { a.x, b.x, c.x } ) < minimum_x || std::min( { a.x, b.x, c.x } ) > maximum_x ) continue;
+                if( std::max( { a.y, b.y, c.y } ) < minimum_y || std::min( { a.y, b.y, c.y } ) > maximum_y ) continue;
+                RasterizeTriangle( a, b, c, settings, origin, heightfield );
+            }
+            for( auto d = 0u; d < geometry.density_functions.size(); ++d )
+            {
+                auto minimum = geometry.density_minimums[d];
+                auto maximum = geometry.density_maximums[d];
+                ClampToLevel( minimum, maximum, settings );
+                if( maximum.z < minimum.z ) continue;
+                if( maximum.x < minimum_x || minimum.x > maximum_x || maximum.y < minimum_y || minimum.y > maximum_y ) continue;
+                SampleDensityFunction( geometry.density_functions[d], minimum, maximum, settings, origin, heightfield );
+            }
+
+            std::vector<std::vector<float>> surfaces;
+            FindWalkableSurfaces( settings, heightfield, surfaces );
+
+            auto & tile = tiles.tiles[tile_index];
+            tile = NavigationTile();
+            auto & mesh = tile.mesh;
+
+            // one vertex per grid point and group of surfaces around it that are within climbing distance,
+            // stored for each corner of the surfaces of the cells inside the tile.
+            // Corners are counter clockwise starting at the lowest x and y
+            std::vector<std::vector<std::array<unsigned, 4>>> corners( heightfield.columns.size() );
+            struct CornerSurface
+            {
+                float height;
+                int column;
+                unsigned surface;
+                unsigned corner;
+            };
+            std::vector<CornerSurface> corner_surfaces;
+            for( auto y = y0; y < y1; ++y )
+            {
+                for( auto x = x0; x < x1; ++x )
+                {
+                    auto column = GetColumnIndex( x, y, heightfield );
+                    corners[column].assign( surfaces[column].size(), {{ c_no_vertex, c_no_vertex, c_no_vertex, c_no_vertex }} );
+                }
+            }
+            for( auto py = y0; py <= y1; ++py )
+            {
+                for( auto px = x0; px <= x1; ++px )
+                {
+                    corner_surfaces.clear();
+                    for( auto corner = 0u; corner < 4; ++corner )
+                    {
+                        auto column = GetColumnIndex( px - ( corner == 1 || corner == 2 ), py - ( corner >= 2 ), heightfield );
+                        for( auto s = 0u; s < surfaces[column].size(); ++s )
+                        {
+                            corner_surfaces.push_back( { surfaces[column][s], column, s, corner } );
+                        }
+                    }
+                    std::sort( begin( corner_surfaces ), end( corner_surfaces ), []( CornerSurface const & a, CornerSurface const & b ) { return a.height < b.height; } );
+
+                    for( auto i = 0u; i < corner_surfaces.size(); )
+                    {
+                        auto end = i + 1;
+                        while( end < corner_surfaces.size() && corner_surfaces[end].height - corner_surfaces[end - 1].height <= settings.maximum_climb ) ++end;
+
+                        auto height_sum = 0.f;
+                        for( auto j = i; j < end; ++j ) height_sum += corner_surfaces[j].height;
+
+                        auto vertex = unsigned( mesh.vertices.size() );
+                        mesh.vertices.push_back( Math::Float2( origin.x + px * cell_size, origin.y + py * cell_size ) );
+                        mesh.vertices_z.push_back( height_sum / ( end - i ) );
+                        tile.vertex_grid_x.push_back( unsigned( px ) );
+                        tile.vertex_grid_y.push_back( unsigned( py ) );
+
+                        for( auto j = i; j < end; ++j )
+                        {
+                            auto & cell_corners = corners[corner_surfaces[j].column];
+                            // the ring around the tile has no corners of its own
+                            if( cell_corners.empty() ) continue;
+                            cell_corners[corner_surfaces[j].surface][corner_surfaces[j].corner] = vertex;
+                        }
+                        i = end;
+                    }
+                }
+            }
+
+            // grow rectangles of flat connected surfaces, every other surface becomes a rectangle of its own
+            std::vector<std::vector<char>> used( heightfield.columns.size() );
+            for( auto c = 0u; c < corners.size(); ++c ) used[c].assign( corners[c].size(), false );
+
+            auto is_flat = [&]( std::array<unsigned, 4> const & cell_corners )
+            {
+                auto z = mesh.vertices_z[cell_corners[0]];
+                return mesh.vertices_z[cell_corners[1]] == z && mesh.vertices_z[cell_corners[2]] == z && mesh.vertices_z[cell_corners[3]] == z;
+            };
+            // returns the unused surface of the cell that has the vertices at the corners, or c_no_vertex
+            auto find_surface = [&]( int x, int y, unsigned corner_a, unsigned vertex_a, unsigned corner_b, unsigned vertex_b )
+            {
+                auto column = GetColumnIndex( x, y, heightfield );
+                for( auto s = 0u; s < corners[column].size(); ++s )
+                {
+                    auto const & cell_corners = corners[column][s];
+                    if( !used[column][s] && cell_corners[corner_a] == vertex_a && cell_corners[corner_b] == vertex_b && is_flat( cell_corners ) ) return s;
+                }
+                return c_no_vertex;
+            };
+            auto get_corners = [&]( Rectangle const & rectangle, int x, int y ) -> std::array<unsigned, 4> const &
+            {
+                auto column = GetColumnIndex( x, y, heightfield );
+                return corners[column][rectangle.surfaces[( y - rectangle.y ) * rectangle.width + ( x - rectangle.x )]];
+            };
+
+            std::vector<Rectangle> rectangles;
+            std::vector<char> marked( mesh.vertices.size(), false );
+            std::vector<unsigned> row_surfaces;
+            for( auto y = y0; y < y1; ++y )
+            {
+                for( auto x = x0; x < x1; ++x )
+                {
+                    auto column = GetColumnIndex( x, y, heightfield );
+                    for( auto s = 0u; s < corners[column].size(); ++s )
+                    {
+                        if( used[column][s] ) continue;
+                        used[column][s] = true;
+                        Rectangle rectangle = { x, y, 1, 1, { s } };
+
+                        if( is_flat( corners[column][s] ) )
+                        {
+                            while( x + rectangle.width < x1 )
+                            {
+                                auto const & left = get_corners( rectangle, x + rectangle.width - 1, y );
+                                auto next = find_surface( x + rectangle.width, y, 0, left[1], 3, left[2] );
+                                if( next == c_no_vertex ) break;
+                                used[GetColumnIndex( x + rectangle.width, y, heightfield )][next] = true;
+                                rectangle.surfaces.push_back( next );
+                                ++rectangle.width;
+                            }
+                            while( y + rectangle.height < y1 )
+                            {
+                                auto row_y = y + rectangle.height;
+                                row_surfaces.clear();
+                                for( auto i = 0; i < rectangle.width; ++i )
+                                {
+                                    auto const & below = get_corners( rectangle, x + i, row_y - 1 );
+                                    auto next = find_surface( x + i, row_y, 0, below[3], 1, below[2] );
+                                    if( next == c_no_vertex ) break;
+                                    row_surfaces.push_back( next );
+                                }
+                                if( int( row_surfaces.size() ) < rectangle.width ) break;
+                                for( auto i = 0; i < rectangle.width; ++i )
+                                {
+                                    used[GetColumnIndex( x + i, row_y, heightfield )][row_surfaces[i]] = true;
+                                }
+                                rectangle.surfaces.insert( rectangle.surfaces.end(), row_surfaces.begin(), row_surfaces.end() );
+                                ++rectangle.height;
+                            }
+                        }
+
+                        marked[get_corners( rectangle, x, y )[0]] = true;
+                        marked[get_corners( rectangle, x + rectangle.width - 1, y )[1]] = true;
+                        marked[get_corners( rectangle, x + rectangle.width - 1, y + rectangle.height - 1 )[2]] = true;
+                        marked[get_corners( rectangle, x, y + rectangle.height - 1 )[3]] = true;
+                        rectangles.push_back( std::move( rectangle ) );
+                    }
+                }
+            }
+
+            // Triangulate the rectangles. Their outlines include the corners of neighbouring rectangles
+            // and all grid points on the tile border, so neighbours always share complete edges
+            auto on_outline = [&]( unsigned vertex )
+            {
+                auto x = int( tile.vertex_grid_x[vertex] );
+                auto y = int( tile.vertex_grid_y[vertex] );
+                return marked[vertex] || x == x0 || x == x1 || y == y0 || y == y1;
+            };
+            std::vector<unsigned> outline;
+            for( auto const & rectangle : rectangles )
+            {
+                auto right = rectangle.x + rectangle.width - 1;
+                auto top = rectangle.y + rectangle.height - 1;
+                outline.clear();
+                for( auto x = rectangle.x; x <= right; ++x ) outline.push_back( get_corners( rectangle, x, rectangle.y )[0] );
+                for( auto y = rectangle.y; y <= top; ++y ) outline.push_back( get_corners( rectangle, right, y )[1] );
+                for( auto x = right; x >= rectangle.x; --x ) outline.push_back( get_corners( rectangle, x, top )[2] );
+                for( auto y = top; y >= rectangle.y; --y ) outline.push_back( get_corners( rectangle, rectangle.x, y )[3] );
+                outline.erase( std::remove_if( begin( outline ), end( outline ), [&]( unsigned vertex ) { return !on_outline( vertex ); } ), end( outline ) );
+
+                if( outline.size() == 4 )
+                {
+                    mesh.indices.insert( mesh.indices.end(), { outline[0], outline[1], outline[2], outline[0], outline[2], outline[3] } );
+                    continue;
+                }
+
+                // fan around the center, it is flat so the height of any corner works
+                auto center = unsigned( mesh.vertices.size() );
+                mesh.vertices.push_back( Math::Float2( origin.x + ( rectangle.x + 0.5f * rectangle.width ) * cell_size, origin.y + ( rectangle.y + 0.5f * rectangle.height ) * cell_size ) );
+                mesh.vertices_z.push_back( mesh.vertices_z[outline[0]] );
+                tile.vertex_grid_x.push_back( unsigned(-1) );
+                tile.vertex_grid_y.push_back( unsigned(-1) );
+                for( auto i = 0u; i < outline.size(); ++i )
+                {
+                    mesh.indices.insert( mesh.indices.end(), { center, outline[i], outline[( i + 1 ) % outline.size()] } );
+                }
+            }
+
+            // drop the vertices inside the merged rectangles
+            std::vector<unsigned> remap( mesh.vertices.size(), c_no_vertex );
+            for( auto index : mesh.indices ) remap[index] = 0;
+            auto kept = 0u;
+            for( auto v = 0u; v < remap.size(); ++v )
+            {
+                if( remap[v] == c_no_vertex ) continue;
+                remap[v] = kept;
+                mesh.vertices[kept] = mesh.vertices[v];
+                mesh.vertices_z[kept] = mesh.vertices_z[v];
+                tile.vertex_grid_x[kept] = tile.vertex_grid_x[v];
+                tile.vertex_grid_y[kept] = tile.vertex_grid_y[v];
+                ++kept;
+            }
+            mesh.vertices.resize( kept );
+            mesh.vertices_z.resize( kept );
+            tile.vertex_grid_x.resize( kept );
+            tile.vertex_grid_y.resize( kept );
+            for( auto & index : mesh.indices ) index = remap[index];
+        }
+
+
+        void BuildTiles( std::vector<unsigned> const & tile_indices, NavigationGeometry const & geometry, NavigationMeshBuildSettings const & settings, NavigationTiles & tiles )
+        {
+            // every tile only writes its own output, so they can be built by any thread
+            Concurrency::parallel_for( size_t( 0 ), tile_indices.size(),
+                [&]( size_t i )
+            {
+                BuildTile( tile_indices[i], geometry, settings, tiles );
+            } );
+        }
+    }
+
+
+    void BuildNavigationTiles( NavigationGeometry const & geometry, NavigationMeshBuildSettings const & settings, NavigationTiles & tiles )
+    {
+        tiles = NavigationTiles();
+
+        auto minimum = Math::Float3( std::numeric_limits<float>::max() );
+        auto maximum = Math::Float3( -std::numeric_limits<float>::max() );
+        auto extend = [&]( Math::Float3 const & point )
+        {
+            minimum = Math::Float3( std::min( minimum.x, point.x ), std::min( minimum.y, point.y ), std::min( minimum.z, point.z ) );
+            maximum = Math::Float3( std::max( maximum.x, point.x ), std::max( maximum.y, point.y ), std::max( maximum.z, point.z ) );
+        };
+        for( auto const & vertex : geometry.triangle_vertices ) extend( vertex );
+        for( auto d = 0u; d < geometry.density_functions.size(); ++d )
+        {
+            auto density_minimum = geometry.density_minimums[d];
+            auto density_maximum = geometry.density_maximums[d];
+            ClampToLevel( density_minimum, density_maximum, settings );
+            if( density_maximum.x < density_minimum.x || density_maximum.y < density_minimum.y || density_maximum.z < density_minimum.z ) continue;
+            extend( density_minimum );
+            extend( density_maximum );
+        }
+        if( minimum.x > maximum.x ) return;
+
+        auto cells_x = std::floor( ( maximum.x - minimum.x ) / settings.cell_size ) + 1;
+        auto cells_y = std::floor( ( maximum.y - minimum.y ) / settings.cell_size ) + 1;
+        if( !( cells_x <= c_maximum_cells_per_side && cells_y <= c_maximum_cells_per_side ) )
+        {
+            assert( false && "The navigation geometry is too large for the cell size" );
+            return;
+        }
+        tiles.origin = Math::Float2( minimum.x, minimum.y );
+        tiles.cell_count_x = unsigned( cells_x );
+        tiles.cell_count_y = unsigned( cells_y );
+        tiles.tile_count_x = ( tiles.cell_count_x + settings.tile_cells - 1 ) / settings.tile_cells;
+        tiles.tile_count_y = ( tiles.cell_count_y + settings.tile_cells - 1 ) / settings.tile_cells;
+        tiles.tiles.resize( tiles.tile_count_x * tiles.tile_count_y );
+
+        std::vector<unsigned> tile_indices( tiles.tiles.size() );
+        for( auto i = 0u; i < tile_indices.size(); ++i ) tile_indices[i] = i;
+        BuildTiles( tile_indices, geometry, settings, tiles );
+    }
+
+
+    void RebuildNavigationTiles( NavigationGeometry const & geometry, NavigationMeshBuildSettings const & settings, Math::Float3 changed_minimum, Math::Float3 changed_maximum, NavigationTiles & tiles )
+    {
+        if( tiles.tiles.empty() ) return;
+
+        // tiles see one cell beyond their border, and their border vertices depend on it
+        auto margin = 2 * settings.cell_size;
+        auto tile_size = settings.cell_size * settings.tile_cells;
+        int x_begin, x_end, y_begin, y_end;
+        GetCellRange( changed_minimum.x - margin, changed_maximum.x + margin, tiles.origin.x, tile_size, 0, int( tiles.tile_count_x ), x_begin, x_end );
+        GetCellRange( changed_minimum.y - margin, changed_maximum.y + margin, tiles.origin.y, tile_size, 0, int( tiles.tile_count_y ), y_begin, y_end );
+
+        std::vector<unsigned> tile_indices;
+        for( auto y = y_begin; y < y_end; ++y )
+        {
+            for( auto x = x_begin; x < x_end; ++x )
+            {
+                tile_indices.push_back( unsigned( y ) * tiles.tile_count_x + unsigned( x ) );
+            }
+        }
+        BuildTiles( tile_indices, geometry, settings, tiles );
+    }
+
+
+    void MergeNavigationTiles( NavigationTiles const & tiles, NavigationMesh & mesh )
+    {
+        mesh = NavigationMesh();
+
+        // vertices on grid points are identified by the point and their height
+        std::map<std::tuple<unsigned, unsigned, float>, unsigned> grid_vertices;
+        std::vector<unsigned> remap;
+        for( auto const & tile : tiles.tiles )
+        {
+            remap.resize( tile.mesh.vertices.size() );
+            for( auto v = 0u; v < tile.mesh.vertices.size(); ++v )
+            {
+                auto vertex = unsigned( mesh.vertices.size() );
+                if( tile.vertex_grid_x[v] != unsigned(-1) )
+                {
+                    auto key = std::make_tuple( tile.vertex_grid_x[v], tile.vertex_grid_y[v], tile.mesh.vertices_z[v] );
+                    auto inserted = grid_vertices.insert( { key, vertex } );
+                    if( !inserted.second )
+                    {
+                        remap[v] = inserted.first->second;
+                        continue;
+                    }
+                }
+                remap[v] = vertex;
+                mesh.vertices.push_back( tile.mesh.vertices[v] );
+                mesh.vertices_z.push_back( tile.mesh.vertices_z[v] );
+            }
+            for( auto index : tile.mesh.indices ) mesh.indices.push_back( remap[index] );
+        }
+    }
+}
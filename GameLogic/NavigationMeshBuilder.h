@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Structures.h"
+
+#include <Math\FloatTypes.h>
+
+#include <functional>
+#include <vector>
+
+namespace Logic
+{
+    // same signature as the physics density functions, positive density is solid
+    typedef std::function<void(Math::Float3 const position, float & density, Math::Float3 & gradient)> NavigationDensityFunction;
+
+
+    struct NavigationMeshBuildSettings
+    {
+        // horizontal size of a voxel column and vertical resolution of the density sampling
+        float cell_size = 0.5f;
+        float cell_height = 0.1f;
+        // free space needed above a surface to walk on it
+        float agent_height = 1.8f;
+        // largest height difference between neighbouring cells that is still connected
+        float maximum_climb = 0.4f;
+        // surfaces with normals tilted further than this from the z axis aren't walkable
+        float minimum_walkable_normal_z = 0.7f;
+        // cells per side of a tile, tiles are built independently from each other
+        unsigned tile_cells = 32;
+        // density functions are only sampled within these corners, terrain densities usually have no bounds of their own.
+        // Every column samples the whole height, so larger levels get expensive quickly
+        Math::Float3 level_minimum = Math::Float3( -128, -128, -32 );
+        Math::Float3 level_maximum = Math::Float3( 128, 128, 32 );
+    };
+
+
+    // static collision geometry in world space
+    struct NavigationGeometry
+    {
+        // three vertices per triangle, counter clockwise when seen from outside the solid
+        std::vector<Math::Float3> triangle_vertices;
+
+        // only sampled between their minimum and maximum corners, limited to the level bounds of the settings
+        std::vector<NavigationDensityFunction> density_functions;
+        std::vector<Math::Float3> density_minimums;
+        std::vector<Math::Float3> density_maximums;
+    };
+
+
+    struct NavigationTile
+    {
+        NavigationMesh mesh;
+        // grid point of each vertex, unsigned(-1) for vertices inside the tile which no other tile uses
+        std::vector<unsigned> vertex_grid_x;
+        std::vector<unsigned> vertex_grid_y;
+    };
+
+
+    // the geometry's bounds split into cells of cell_size, grouped into tiles of tile_cells cells per side
+    struct NavigationTiles
+    {
+        Math::Float2 origin;
+        unsigned cell_count_x = 0;
+        unsigned cell_count_y = 0;
+        unsigned tile_count_x = 0;
+        unsigned tile_count_y = 0;
+
+        // row by row
+        std::vector<NavigationTile> tiles;
+    };
+
+
+    // voxelizes the walkable surfaces of the geometry and extracts a simplified mesh for every tile, in parallel
+    void BuildNavigationTiles( NavigationGeometry const & geometry, NavigationMeshBuildSettings const & settings, NavigationTiles & tiles );
+
+    // rebuilds only the tiles that can be affected by geometry changes between the corners, in parallel.
+    // The geometry is expected to still fit the bounds of the last full build
+    void RebuildNavigationTiles( NavigationGeometry const & geometry, NavigationMeshBuildSettings const & settings, Math::Float3 changed_minimum, Math::Float3 changed_maximum, NavigationTiles & tiles );
+
+    // joins the tiles into a single mesh, welding the vertices on the tile borders
+    void MergeNavigationTiles( NavigationTiles const & tiles, NavigationMesh & mesh );
+}
@@ -1,14 +1,44 @@
 #include "NavigationMeshContainer.h"
+#include "NavigationHierarchyFunctions.h"
 
 #include <Math/FloatOperators.h>
 #include <FileLayout\VertexDataType.h>
 #include <BoundingShapes\AxisAlignedBox.h>
 
 #include <Utilities\StreamHelpers.h>
+#include <Utilities\DogDealerException.h>
 
 namespace Logic{
 
-    NavigationMeshID NavigationMeshContainer::LoadNavigationMesh(std::istream& data_stream)
+    namespace
+    {
+        uint32_t const c_prebuilt_navigation_mesh_magic = 0x48534d4e; // "NMSH"
+        uint32_t const c_prebuilt_navigation_mesh_version = 1;
+
+        struct PrebuiltNavigationMeshHeader
+        {
+            uint32_t magic = c_prebuilt_navigation_mesh_magic;
+            uint32_t version = c_prebuilt_navigation_mesh_version;
+        };
+
+
+        template<typename Type>
+        void WriteSizedVector(std::ostream& stream, std::vector<Type> const & vector)
+        {
+            WriteObject(stream, uint32_t(vector.size()));
+            WriteVector(stream, vector);
+        }
+
+
+        template<typename Type>
+        void ReadSizedVector(std::istream& stream, std::vector<Type>& vector)
+        {
+            vector.resize(ReadObject<uint32_t>(stream));
+            ReadVector(stream, vector);
+        }
+    }
+
+    NavigationMeshID NavigationMeshContainer::LoadNavigationMesh(std::istream& data_stream, float path_tolerance)
     {
         using namespace std;
 
@@ -64,6 +94,102 @@ namespace Logic{
 		}
 		assert(duplicate_indices.empty() && "Duplicate vertices in navigation mesh.");
 
+        m_navigation_hierarchies.emplace_back();
+        CreateNavigationHierarchy(mesh, c_navigation_cluster_size, path_tolerance, m_navigation_hierarchies.back());
+
+        return id;
+    }
+
+
+    NavigationMeshID NavigationMeshContainer::AddNavigationMesh(NavigationMesh mesh, float path_tolerance)
+    {
+        NavigationMeshID id;
+        id.index = static_cast<NavigationMeshID::index_t>(m_navigation_meshes.size());
+
+        m_navigation_meshes.push_back(std::move(mesh));
+        m_navigation_hierarchies.emplace_back();
+        CreateNavigationHierarchy(m_navigation_meshes.back(), c_navigation_cluster_size, path_tolerance, m_navigation_hierarchies.back());
+
+        return id;
+    }
+
+
+    void NavigationMeshContainer::ReplaceNavigationMesh(NavigationMeshID id, NavigationMesh mesh, float path_tolerance)
+    {
+        auto& stored_mesh = m_navigation_meshes[id.index];
+        stored_mesh = std::move(mesh);
+        CreateNavigationHierarchy(stored_mesh, c_navigation_cluster_size, path_tolerance, m_navigation_hierarchies[id.index]);
+    }
+
+
+    void NavigationMeshContainer::SavePrebuiltNavigationMesh(NavigationMeshID id, std::ostream& data_stream) const
+    {
+        auto const & mesh = m_navigation_meshes[id.index];
+        auto const & hierarchy = m_navigation_hierarchies[id.index];
+
+        WriteObject(data_stream, PrebuiltNavigationMeshHeader());
+
+        WriteSizedVector(data_stream, mesh.vertices);
+        WriteSizedVector(data_stream, mesh.vertices_z);
+        WriteSizedVector(data_stream, mesh.indices);
+
+        auto const & adjacency = hierarchy.adjacency;
+        WriteSizedVector(data_stream, adjacency.offsets);
+        WriteSizedVector(data_stream, adjacency.neighbours);
+        WriteSizedVector(data_stream, adjacency.portals.vertices_0);
+        WriteSizedVector(data_stream, adjacency.portals.vertices_1);
+        WriteSizedVector(data_stream, adjacency.centroids);
+
+        WriteSizedVector(data_stream, hierarchy.triangle_clusters);
+        WriteSizedVector(data_stream, hierarchy.cluster_offsets);
+        WriteSizedVector(data_stream, hierarchy.cluster_triangles);
+        WriteSizedVector(data_stream, hierarchy.node_triangles);
+        WriteSizedVector(data_stream, hierarchy.triangle_nodes);
+        WriteSizedVector(data_stream, hierarchy.cluster_node_offsets);
+        WriteSizedVector(data_stream, hierarchy.edge_offsets);
+        WriteSizedVector(data_stream, hierarchy.edge_targets);
+        WriteSizedVector(data_stream, hierarchy.edge_costs);
+        WriteObject(data_stream, hierarchy.tolerance);
+    }
+
+
+    NavigationMeshID NavigationMeshContainer::LoadPrebuiltNavigationMesh(std::istream& data_stream)
+    {
+        auto header = ReadObject<PrebuiltNavigationMeshHeader>(data_stream);
+        if (header.magic != c_prebuilt_navigation_mesh_magic || header.version != c_prebuilt_navigation_mesh_version)
+        {
+            throw DogDealerException("Unknown prebuilt navigation mesh format.", false);
+        }
+
+        NavigationMeshID id;
+        id.index = static_cast<NavigationMeshID::index_t>(m_navigation_meshes.size());
+
+        m_navigation_meshes.emplace_back();
+        auto& mesh = m_navigation_meshes.back();
+        ReadSizedVector(data_stream, mesh.vertices);
+        ReadSizedVector(data_stream, mesh.vertices_z);
+        ReadSizedVector(data_stream, mesh.indices);
+
+        m_navigation_hierarchies.emplace_back();
+        auto& hierarchy = m_navigation_hierarchies.back();
+        auto& adjacency = hierarchy.adjacency;
+        ReadSizedVector(data_stream, adjacency.offsets);
+        ReadSizedVector(data_stream, adjacency.neighbours);
+        ReadSizedVector(data_stream, adjacency.portals.vertices_0);
+        ReadSizedVector(data_stream, adjacency.portals.vertices_1);
+        ReadSizedVector(data_stream, adjacency.centroids);
+
+        ReadSizedVector(data_stream, hierarchy.triangle_clusters);
+        ReadSizedVector(data_stream, hierarchy.cluster_offsets);
+        ReadSizedVector(data_stream, hierarchy.cluster_triangles);
+        ReadSizedVector(data_stream, hierarchy.node_triangles);
+        ReadSizedVector(data_stream, hierarchy.triangle_nodes);
+        ReadSizedVector(data_stream, hierarchy.cluster_node_offsets);
+        ReadSizedVector(data_stream, hierarchy.edge_offsets);
+        ReadSizedVector(data_stream, hierarchy.edge_targets);
+        ReadSizedVector(data_stream, hierarchy.edge_costs);
+        ReadObject(data_stream, hierarchy.tolerance);
+
         return id;
     }
 }
\ No newline at end of file
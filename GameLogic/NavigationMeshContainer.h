@@ -1,13 +1,25 @@
 #pragma once
 #include "Structures.h"
+#include "NavigationHierarchy.h"
 
 namespace Logic
 {
     struct NavigationMeshContainer
     {
         // Read a .mesh file and store its content as a NavigationMesh
-        NavigationMeshID LoadNavigationMesh(std::istream& data_stream);
+        NavigationMeshID LoadNavigationMesh(std::istream& data_stream, float path_tolerance);
+        // Store a generated mesh and build its hierarchy
+        NavigationMeshID AddNavigationMesh(NavigationMesh mesh, float path_tolerance);
+        // Replace a mesh, for example after regenerating parts of it
+        void ReplaceNavigationMesh(NavigationMeshID id, NavigationMesh mesh, float path_tolerance);
+
+        // Write a mesh together with its hierarchy as a .navmesh file,
+        // which can be loaded again without processing
+        void SavePrebuiltNavigationMesh(NavigationMeshID id, std::ostream& data_stream) const;
+        NavigationMeshID LoadPrebuiltNavigationMesh(std::istream& data_stream);
 
         std::vector<NavigationMesh> m_navigation_meshes;
+        // Parallel to the meshes, for long distance path finding
+        std::vector<NavigationHierarchy> m_navigation_hierarchies;
     };
 }
@@ -0,0 +1,177 @@
+#include "PathRequestQueue.h"
+
+#include "AINavigation.h"
+#include "AIParameterContainer.h"
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <Utilities\HRTimer.h>
+#include <Utilities\InvalidIndex.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace Logic
+{
+    namespace
+    {
+        // how much closer to the focus a request counts as for every tick it has been waiting
+        float const c_waiting_distance_per_tick = 2.0f;
+
+
+        // returns the index of the entity, or -1 if it no longer has the AI role
+        ptrdiff_t DeliverPath( EntityID entity, std::vector<Math::Float2> path, std::vector<EntityID> const & entities, std::vector<std::vector<Math::Float2>> & paths, std::vector<unsigned> & next_node_indices )
+        {
+            auto position = std::find( begin( entities ), end( entities ), entity );
+            if( position == end( entities ) ) return -1;
+
+            auto index = position - begin( entities );
+            paths[index] = move( path );
+            next_node_indices[index] = 0;
+            return index;
+        }
+
+
+        std::vector<uint32_t> & GetSlots( PathRequester requester, PathRequestQueue & queue )
+        {
+            return requester == PathRequester::Following ? queue.following_slots : queue.navigating_slots;
+        }
+
+
+        // returns the position of the pending request of the entity, or c_invalid_index
+        uint32_t FindSlot( EntityID entity, PathRequester requester, PathRequestQueue & queue )
+        {
+            auto const & slots = GetSlots( requester, queue );
+            if( entity.index >= slots.size() ) return c_invalid_index;
+            auto slot = slots[entity.index];
+            // the index may have been reused by a newer entity
+            if( slot == c_invalid_index || queue.entities[slot] != entity ) return c_invalid_index;
+            return slot;
+        }
+    }
+
+
+    void RequestPath( EntityID entity, PathRequester requester, Math::Float3 start, Math::Float3 destination, PathRequestQueue & queue )
+    {
+        auto slot = FindSlot( entity, requester, queue );
+        if( slot != c_invalid_index )
+        {
+            queue.starts[slot] = start;
+            queue.destinations[slot] = destination;
+            return;
+        }
+
+        auto & slots = GetSlots( requester, queue );
+        if( entity.index >= slots.size() )
+        {
+            slots.resize( entity.index + 1, c_invalid_index );
+        }
+        slots[entity.index] = uint32_t( queue.entities.size() );
+        queue.entities.push_back( entity );
+        queue.requesters.push_back( requester );
+        queue.starts.push_back( start );
+        queue.destinations.push_back( destination );
+        queue.waiting_ticks.push_back( 0 );
+    }
+
+
+    void CancelPathRequest( EntityID entity, PathRequester requester, PathRequestQueue & queue )
+    {
+        auto slot = FindSlot( entity, requester, queue );
+        if( slot == c_invalid_index ) return;
+
+        // move the last request into the slot, the order only breaks ties between equally urgent requests
+        GetSlots( requester, queue )[entity.index] = c_invalid_index;
+        auto last = uint32_t( queue.entities.size() - 1 );
+        if( slot != last )
+        {
+            auto & last_slot = GetSlots( queue.requesters[last], queue )[queue.entities[last].index];
+            if( last_slot == last ) last_slot = slot;
+            queue.entities[slot] = queue.entities[last];
+            queue.requesters[slot] = queue.requesters[last];
+            queue.starts[slot] = queue.starts[last];
+            queue.destinations[slot] = queue.destinations[last];
+            queue.waiting_ticks[slot] = queue.waiting_ticks[last];
+        }
+        queue.entities.pop_back();
+        queue.requesters.pop_back();
+        queue.starts.pop_back();
+        queue.destinations.pop_back();
+        queue.waiting_ticks.pop_back();
+    }
+
+
+    void SolvePathRequests(
+        NavigationMesh const & navigation_mesh,
+        NavigationHierarchy const & navigation_hierarchy,
+        Math::Float3 focus_position,
+        float budget_microseconds,
+        PathRequestQueue & queue,
+        AIParameterContainer & parameters )
+    {
+        auto request_count = uint32_t( queue.entities.size() );
+        if( request_count == 0 ) return;
+
+        // order the requests by urgency
+        std::vector<float> urgencies( request_count );
+        for( auto i = 0u; i < request_count; ++i )
+        {
+            urgencies[i] = Math::Norm( queue.starts[i] - focus_position ) - c_waiting_distance_per_tick * queue.waiting_ticks[i];
+        }
+        std::vector<uint32_t> order( request_count );
+        std::iota( begin( order ), end( order ), 0u );
+        std::stable_sort( begin( order ), end( order ), [&urgencies]( uint32_t a, uint32_t b ) { return urgencies[a] < urgencies[b]; } );
+
+        HRTimer timer;
+        timer.Start();
+        std::vector<bool> solved( request_count, false );
+        for( auto i : order )
+        {
+            if( queue.requesters[i] == PathRequester::Following )
+            {
+                // following paths keep their corridor, so they can be repaired when the target moves
+                PathCorridor corridor;
+                auto path = FindPath( queue.starts[i], queue.destinations[i], navigation_mesh, navigation_hierarchy, queue.search, corridor );
+                auto index = DeliverPath( queue.entities[i], move( path ), parameters.m_following.m_entities, parameters.m_following.m_paths, parameters.m_following.m_next_node_indices );
+                if( index >= 0 ) parameters.m_following.m_corridors[index] = std::move( corridor );
+            }
+            else
+            {
+                PathCorridor corridor;
+                auto path = FindPath( queue.starts[i], queue.destinations[i], navigation_mesh, navigation_hierarchy, queue.search, corridor );
+                DeliverPath( queue.entities[i], move( path ), parameters.m_navigating.m_entities, parameters.m_navigating.m_paths, parameters.m_navigating.m_next_node_indices );
+            }
+            solved[i] = true;
+
+            timer.Stop();
+            if( timer.GetMilliSeconds() * 1000.0 >= budget_microseconds ) break;
+        }
+
+        // keep the unsolved requests, in their original order
+        auto kept = 0u;
+        for( auto i = 0u; i < request_count; ++i )
+        {
+            // a request of an older entity with the same index doesn't own the slot
+            auto & slot = GetSlots( queue.requesters[i], queue )[queue.entities[i].index];
+            auto owns_slot = slot == i;
+            if( solved[i] )
+            {
+                if( owns_slot ) slot = c_invalid_index;
+                continue;
+            }
+            if( owns_slot ) slot = kept;
+            queue.entities[kept] = queue.entities[i];
+            queue.requesters[kept] = queue.requesters[i];
+            queue.starts[kept] = queue.starts[i];
+            queue.destinations[kept] = queue.destinations[i];
+            queue.waiting_ticks[kept] = queue.waiting_ticks[i] + 1;
+            ++kept;
+        }
+        queue.entities.resize( kept );
+        queue.requesters.resize( kept );
+        queue.starts.resize( kept );
+        queue.destinations.resize( kept );
+        queue.waiting_ticks.resize( kept );
+    }
+}
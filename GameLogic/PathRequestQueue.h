@@ -0,0 +1,57 @@
+#pragma once
+
+#include "NavigationHierarchy.h"
+
+#include <Conventions\EntityID.h>
+#include <Math\FloatTypes.h>
+
+#include <vector>
+
+namespace Logic
+{
+    struct NavigationMesh;
+    struct AIParameterContainer;
+
+    // the AI parameters a found path is stored in
+    enum struct PathRequester : uint8_t
+    {
+        Following,
+        Navigating,
+    };
+
+    // paths that still have to be found, solved a few at a time by SolvePathRequests.
+    // The agents keep walking their old path until the new one is delivered.
+    struct PathRequestQueue
+    {
+        std::vector<EntityID> entities;
+        std::vector<PathRequester> requesters;
+        std::vector<Math::Float3> starts;
+        std::vector<Math::Float3> destinations;
+        // number of SolvePathRequests calls the request survived
+        std::vector<uint32_t> waiting_ticks;
+
+        // per entity index the position of its pending request of each requester, or c_invalid_index
+        std::vector<uint32_t> following_slots;
+        std::vector<uint32_t> navigating_slots;
+
+        // kept between calls, so a path only costs as much as the part of the mesh it searches
+        NavigationHierarchySearch search;
+    };
+
+    // adds a request, or updates the start and destination of the pending request of the entity
+    void RequestPath( EntityID entity, PathRequester requester, Math::Float3 start, Math::Float3 destination, PathRequestQueue & queue );
+
+    // drops the pending request of the entity, if there is one
+    void CancelPathRequest( EntityID entity, PathRequester requester, PathRequestQueue & queue );
+
+    // finds paths for the most urgent requests until the budget is spent, at least one per call so the queue always drains.
+    // Requests near the focus position and requests that have been waiting long go first.
+    // The paths are stored in the parameters, requests of entities that no longer have that AI role are dropped.
+    void SolvePathRequests(
+        NavigationMesh const & navigation_mesh,
+        NavigationHierarchy const & navigation_hierarchy,
+        Math::Float3 focus_position,
+        float budget_microseconds,
+        PathRequestQueue & queue,
+        AIParameterContainer & parameters );
+}
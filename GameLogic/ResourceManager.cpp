@@ -15,11 +15,17 @@ namespace {
 		auto file_path = "Resources\\" + mesh_name + ".mesh";
 		return file_path;
 	}
+
+	string FilePathFromPrebuiltNavigationMeshName(string const & mesh_name)
+	{
+		auto file_path = "Resources\\" + mesh_name + ".navmesh";
+		return file_path;
+	}
 }
 
 namespace Logic{
 	
-    NavigationMeshID ResourceManager::ProvideNavigationMesh(std::string const & mesh_name, NavigationMeshContainer & navmesh_container)
+    NavigationMeshID ResourceManager::ProvideNavigationMesh(std::string const & mesh_name, NavigationMeshContainer & navmesh_container, float path_tolerance)
     {
 
 		auto result = m_navmesh_dictionary.find(mesh_name);
@@ -29,12 +35,21 @@ namespace Logic{
 			return result->second;
 		}
 
+		// Prefer the prebuilt mesh, it already has its hierarchy
+		ifstream prebuilt_stream(FilePathFromPrebuiltNavigationMeshName(mesh_name), std::ios::binary);
+		if (prebuilt_stream.good())
+		{
+			auto navmesh = navmesh_container.LoadPrebuiltNavigationMesh(prebuilt_stream);
+			m_navmesh_dictionary[mesh_name] = navmesh;
+			return navmesh;
+		}
+
 		// Otherwise load from file
 		auto navmesh_file_path = FilePathFromNavigationMeshName(mesh_name);
 		ifstream data_stream(navmesh_file_path, std::ios::binary);
 		assert(data_stream.good());
 
-		auto navmesh = navmesh_container.LoadNavigationMesh(data_stream);
+		auto navmesh = navmesh_container.LoadNavigationMesh(data_stream, path_tolerance);
 		data_stream.close();
 
 		// add or overwrite if the ids were invalid.
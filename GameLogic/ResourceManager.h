@@ -13,7 +13,7 @@ namespace Logic{
 
 	public:
 
-        NavigationMeshID ProvideNavigationMesh(std::string const & navigation_mesh_name, NavigationMeshContainer& navmesh_container);
+        NavigationMeshID ProvideNavigationMesh(std::string const & navigation_mesh_name, NavigationMeshContainer& navmesh_container, float path_tolerance);
     
     private:
 		std::map<std::string, NavigationMeshID>	m_navmesh_dictionary;
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Math\FloatTypes.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Logic
+{
+    // size of the cubic cells used to bucket the entity positions
+    float const c_spatial_hash_cell_size = 4.0f;
+
+    // uniform grid over the entity positions, hashed into buckets so the grid doesn't need bounds.
+    // The entries are sorted by bucket, bucket b has the entries [bucket_starts[b], bucket_starts[b + 1]).
+    struct SpatialHash
+    {
+        float cell_size = c_spatial_hash_cell_size;
+
+        std::vector<uint32_t> bucket_starts;
+
+        // parallel vectors, one element per entity
+        std::vector<uint32_t> entity_indices; // as used by IndexedOrientations::indices
+        std::vector<Math::Float3> positions;
+        std::vector<std::array<int32_t, 3>> cells;
+    };
+}
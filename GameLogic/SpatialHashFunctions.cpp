@@ -0,0 +1,201 @@
+#include "SpatialHashFunctions.h"
+
+#include <Conventions\Orientation.h>
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <Utilities\InvalidIndex.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Logic
+{
+    namespace
+    {
+        // if a query covers more cells than this, checking all entities is cheaper
+        uint32_t const c_maximum_query_cells = 512;
+
+
+        std::array<int32_t, 3> GetCell( Math::Float3 position, float inverse_cell_size )
+        {
+            return {{
+                int32_t( std::floor( position.x * inverse_cell_size ) ),
+                int32_t( std::floor( position.y * inverse_cell_size ) ),
+                int32_t( std::floor( position.z * inverse_cell_size ) ) }};
+        }
+
+
+        uint32_t GetBucket( std::array<int32_t, 3> cell, uint32_t bucket_mask )
+        {
+            auto hash = ( uint32_t( cell[0] ) * 73856093u ) ^ ( uint32_t( cell[1] ) * 19349663u ) ^ ( uint32_t( cell[2] ) * 83492791u );
+            return hash & bucket_mask;
+        }
+
+
+        uint32_t BucketCount( SpatialHash const & hash )
+        {
+            return uint32_t( hash.bucket_starts.size() - 1 );
+        }
+
+
+        // calls function with the entry index of every entity that is in a cell overlapping the box from minimum to maximum
+        template<typename Function>
+        void ForEachEntryInBox( SpatialHash const & hash, Math::Float3 minimum, Math::Float3 maximum, Function function )
+        {
+            if( hash.entity_indices.empty() ) return;
+
+            auto inverse_cell_size = 1.0f / hash.cell_size;
+            auto first = GetCell( minimum, inverse_cell_size );
+            auto last = GetCell( maximum, inverse_cell_size );
+            auto cell_count = uint64_t( 1 );
+            for( auto i = 0u; i < 3; ++i )
+            {
+                cell_count *= uint64_t( int64_t( last[i] ) - first[i] + 1 );
+            }
+
+            if( cell_count > std::max( c_maximum_query_cells, BucketCount( hash ) ) )
+            {
+                for( auto i = 0u; i < hash.entity_indices.size(); ++i )
+                {
+                    function( i );
+                }
+                return;
+            }
+
+            auto bucket_mask = BucketCount( hash ) - 1;
+            std::array<int32_t, 3> cell;
+            for( cell[2] = first[2]; cell[2] <= last[2]; ++cell[2] )
+            {
+                for( cell[1] = first[1]; cell[1] <= last[1]; ++cell[1] )
+                {
+                    for( cell[0] = first[0]; cell[0] <= last[0]; ++cell[0] )
+                    {
+                        auto bucket = GetBucket( cell, bucket_mask );
+                        for( auto i = hash.bucket_starts[bucket]; i < hash.bucket_starts[bucket + 1]; ++i )
+                        {
+                            // different cells can share a bucket, only visit the entries of this cell so none are visited twice
+                            if( hash.cells[i] == cell )
+                            {
+                                function( i );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+
+    void CreateSpatialHash( IndexedOrientations const & indexed_orientations, float cell_size, SpatialHash & hash )
+    {
+        hash.cell_size = cell_size;
+        hash.entity_indices.clear();
+        hash.positions.clear();
+        hash.cells.clear();
+
+        auto entity_count = 0u;
+        for( auto index : indexed_orientations.indices )
+        {
+            entity_count += index != c_invalid_index;
+        }
+
+        // about two buckets per entity, a power of two so the bucket can be masked out of the hash
+        auto bucket_count = 16u;
+        while( bucket_count < 2 * entity_count )
+        {
+            bucket_count *= 2;
+        }
+        auto bucket_mask = bucket_count - 1;
+        auto inverse_cell_size = 1.0f / cell_size;
+
+        // count the entities per bucket
+        std::vector<uint32_t> entity_buckets;
+        entity_buckets.reserve( entity_count );
+        hash.bucket_starts.assign( bucket_count + 1, 0 );
+        for( auto entity_index = 0u; entity_index < indexed_orientations.indices.size(); ++entity_index )
+        {
+            auto orientation_index = indexed_orientations.indices[entity_index];
+            if( orientation_index == c_invalid_index ) continue;
+            auto bucket = GetBucket( GetCell( indexed_orientations.orientations[orientation_index].position, inverse_cell_size ), bucket_mask );
+            entity_buckets.push_back( bucket );
+            ++hash.bucket_starts[bucket + 1];
+        }
+        for( auto b = 0u; b < bucket_count; ++b )
+        {
+            hash.bucket_starts[b + 1] += hash.bucket_starts[b];
+        }
+
+        // and put them in their bucket
+        hash.entity_indices.resize( entity_count );
+        hash.positions.resize( entity_count );
+        hash.cells.resize( entity_count );
+        auto write_positions = hash.bucket_starts;
+        auto e = 0u;
+        for( auto entity_index = 0u; entity_index < indexed_orientations.indices.size(); ++entity_index )
+        {
+            auto orientation_index = indexed_orientations.indices[entity_index];
+            if( orientation_index == c_invalid_index ) continue;
+            auto position = indexed_orientations.orientations[orientation_index].position;
+            auto i = write_positions[entity_buckets[e++]]++;
+            hash.entity_indices[i] = entity_index;
+            hash.positions[i] = position;
+            hash.cells[i] = GetCell( position, inverse_cell_size );
+        }
+    }
+
+
+    void FindEntitiesInRadius( SpatialHash const & hash, Math::Float3 center, float radius, std::vector<uint32_t> & entity_indices )
+    {
+        auto squared_radius = radius * radius;
+        ForEachEntryInBox( hash, center - radius, center + radius, [&]( uint32_t i )
+        {
+            if( SquaredNorm( hash.positions[i] - center ) <= squared_radius )
+            {
+                entity_indices.push_back( hash.entity_indices[i] );
+            }
+        } );
+    }
+
+
+    void FindNearestEntities( SpatialHash const & hash, Math::Float3 center, float maximum_distance, uint32_t count, std::vector<uint32_t> & entity_indices )
+    {
+        auto squared_maximum_distance = maximum_distance * maximum_distance;
+        std::vector<std::pair<float, uint32_t>> candidates;
+        ForEachEntryInBox( hash, center - maximum_distance, center + maximum_distance, [&]( uint32_t i )
+        {
+            auto squared_distance = SquaredNorm( hash.positions[i] - center );
+            if( squared_distance <= squared_maximum_distance )
+            {
+                candidates.emplace_back( squared_distance, hash.entity_indices[i] );
+            }
+        } );
+
+        // ties are broken on the entity index, so the result doesn't depend on the bucket order
+        auto result_count = std::min<size_t>( count, candidates.size() );
+        std::partial_sort( begin( candidates ), begin( candidates ) + result_count, end( candidates ) );
+        for( auto i = 0u; i < result_count; ++i )
+        {
+            entity_indices.push_back( candidates[i].second );
+        }
+    }
+
+
+    void FindEntitiesInCone( SpatialHash const & hash, Math::Float3 apex, Math::Float3 direction, float cos_half_angle, float range, std::vector<uint32_t> & entity_indices )
+    {
+        auto squared_range = range * range;
+        ForEachEntryInBox( hash, apex - range, apex + range, [&]( uint32_t i )
+        {
+            auto offset = hash.positions[i] - apex;
+            auto squared_distance = SquaredNorm( offset );
+            if( squared_distance > squared_range || squared_distance == 0 ) return;
+            // dot >= cos * |offset|, compared as signed squares to avoid the root
+            auto dot = Dot( offset, direction );
+            if( dot * std::abs( dot ) >= cos_half_angle * std::abs( cos_half_angle ) * squared_distance )
+            {
+                entity_indices.push_back( hash.entity_indices[i] );
+            }
+        } );
+    }
+}
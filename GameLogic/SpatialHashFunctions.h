@@ -0,0 +1,24 @@
+#pragma once
+
+#include "SpatialHash.h"
+
+#include <vector>
+
+struct IndexedOrientations;
+
+namespace Logic
+{
+    // rebuilds the hash from the positions of all entities in the indexed orientations
+    void CreateSpatialHash( IndexedOrientations const & indexed_orientations, float cell_size, SpatialHash & hash );
+
+    // appends the entity indices of all entities within radius of the center
+    void FindEntitiesInRadius( SpatialHash const & hash, Math::Float3 center, float radius, std::vector<uint32_t> & entity_indices );
+
+    // appends the entity indices of at most count entities within maximum_distance of the center, nearest first
+    void FindNearestEntities( SpatialHash const & hash, Math::Float3 center, float maximum_distance, uint32_t count, std::vector<uint32_t> & entity_indices );
+
+    // appends the entity indices of all entities within range of the apex,
+    // whose direction from the apex makes an angle with the cosine of at least cos_half_angle with the (normalized) direction.
+    // Entities at the apex have no direction and are skipped, so the entity looking is not found itself
+    void FindEntitiesInCone( SpatialHash const & hash, Math::Float3 apex, Math::Float3 direction, float cos_half_angle, float range, std::vector<uint32_t> & entity_indices );
+}
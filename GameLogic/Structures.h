@@ -59,4 +59,22 @@ namespace Logic{
         std::vector<unsigned> vertices_1;
     };
 
+    // The neighbours of all navigation mesh triangles, triangle t has the neighbours [offsets[t], offsets[t + 1])
+    struct TriangleAdjacency
+    {
+        std::vector<unsigned> offsets;
+        std::vector<unsigned> neighbours;
+        // Vertices of the shared edge with each neighbour
+        PortalList portals;
+        std::vector<Math::Float2> centroids;
+    };
+
+    // Triangles crossed by a path, kept to repair the path when its destination moves.
+    // Portal i is the edge between triangle i and i + 1
+    struct PathCorridor
+    {
+        std::vector<unsigned> triangles;
+        PortalList portals;
+    };
+
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "CppUnitTest.h"
+#include "GridNavigationMesh.h"
 
 #include <GameLogic\AINavigation.h>
+#include <GameLogic\Structures.h>
 
 #include <Math\MathFunctions.h>
 
@@ -167,5 +169,50 @@ namespace DogDealerLogic
             auto error = abs(distance - target_distance);
             Assert::IsTrue(error < 0.01f);
         }
+
+        // ####################
+        // ########## Path repair
+        // ####################
+
+        // Moving the destination along or next to the end of the corridor
+        // keeps and adjusts the corridor instead of searching again
+        TEST_METHOD(TestRepairPathExtendsAndTrimsCorridor)
+        {
+            auto mesh = CreateGridMesh(6, 1);
+            PathCorridor corridor;
+            auto path = FindPath(Math::Float3(0.2f, 0.5f, 0), Math::Float3(3.5f, 0.5f, 0), mesh, corridor);
+            Assert::AreEqual(3.5f, path.back().x);
+            auto corridor_length = corridor.triangles.size();
+            Assert::AreEqual(corridor_length - 1, corridor.portals.vertices_0.size());
+
+            // Into the adjacent triangle
+            std::vector<Math::Float2> repaired_path;
+            Assert::IsTrue(RepairPath(Math::Float3(0.2f, 0.5f, 0), Math::Float3(4.2f, 0.5f, 0), mesh, corridor, repaired_path));
+            Assert::AreEqual(corridor_length + 1, corridor.triangles.size());
+            Assert::AreEqual(4.2f, repaired_path.back().x);
+
+            // Back along the corridor, with the start having moved on
+            Assert::IsTrue(RepairPath(Math::Float3(1.5f, 0.5f, 0), Math::Float3(2.5f, 0.5f, 0), mesh, corridor, repaired_path));
+            Assert::AreEqual(corridor.triangles.size() - 1, corridor.portals.vertices_1.size());
+            Assert::AreEqual(2.5f, repaired_path.back().x);
+            Assert::IsTrue(corridor.triangles.size() < corridor_length);
+
+            // A straight strip needs no intermediate nodes
+            Assert::AreEqual(size_t(1), repaired_path.size());
+        }
+
+        // Destinations that jumped away or starts that left the corridor need a new search
+        TEST_METHOD(TestRepairPathFailsOutsideCorridor)
+        {
+            auto mesh = CreateGridMesh(6, 1);
+            PathCorridor corridor;
+            FindPath(Math::Float3(0.2f, 0.5f, 0), Math::Float3(2.5f, 0.5f, 0), mesh, corridor);
+            auto const original_corridor = corridor.triangles;
+
+            std::vector<Math::Float2> path;
+            Assert::IsFalse(RepairPath(Math::Float3(0.2f, 0.5f, 0), Math::Float3(5.5f, 0.5f, 0), mesh, corridor, path));
+            Assert::IsFalse(RepairPath(Math::Float3(4.5f, 0.5f, 0), Math::Float3(2.5f, 0.5f, 0), mesh, corridor, path));
+            Assert::IsTrue(original_corridor == corridor.triangles);
+        }
     };
 }
\ No newline at end of file
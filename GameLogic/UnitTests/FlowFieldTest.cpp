@@ -0,0 +1,127 @@
+#include "CppUnitTest.h"
+#include "GridNavigationMesh.h"
+
+#include <GameLogic\AINavigationMeshFunctions.h>
+#include <GameLogic\FlowFieldFunctions.h>
+#include <GameLogic\Structures.h>
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Logic;
+
+namespace DogDealerLogic
+{
+    TEST_CLASS(FlowFieldTest)
+    {
+    public:
+
+        TEST_METHOD(TestFieldLeadsEveryTriangleToTheTarget)
+        {
+            auto const mesh = CreateGridMesh( 6, 6 );
+            TriangleAdjacency adjacency;
+            CreateTriangleAdjacency( mesh, adjacency );
+            auto const triangle_count = unsigned( mesh.indices.size() / 3 );
+            Assert::AreEqual( size_t( triangle_count + 1 ), adjacency.offsets.size() );
+            for( auto t = 0u; t < triangle_count; ++t )
+            {
+                auto neighbour_count = adjacency.offsets[t + 1] - adjacency.offsets[t];
+                Assert::IsTrue( neighbour_count >= 1 && neighbour_count <= 3 );
+            }
+
+            FlowField field;
+            UpdateFlowField( { 5.7f, 5.2f, 0 }, mesh, adjacency, field );
+            Assert::AreEqual( FindTriangle( { 5.7f, 5.2f, 0 }, unsigned(-1), mesh, adjacency ), field.target_triangle );
+            Assert::AreEqual( 0.f, field.costs[field.target_triangle] );
+
+            for( auto t = 0u; t < triangle_count; ++t )
+            {
+                // following the next triangles always reaches the target, getting closer with every step
+                auto current = t;
+                auto steps = 0u;
+                while( current != field.target_triangle )
+                {
+                    auto next = field.next_triangles[current];
+                    Assert::IsTrue( field.costs[next] < field.costs[current] );
+                    current = next;
+                    Assert::IsTrue( ++steps < triangle_count );
+                }
+            }
+
+            // moving the target within its triangle keeps the field
+            auto const costs = field.costs;
+            field.costs[0] = -1;
+            UpdateFlowField( { 5.8f, 5.3f, 0 }, mesh, adjacency, field );
+            Assert::AreEqual( -1.f, field.costs[0] );
+            UpdateFlowField( { 0.5f, 0.2f, 0 }, mesh, adjacency, field );
+            Assert::AreEqual( 0.f, field.costs[field.target_triangle] );
+            Assert::IsTrue( costs != field.costs );
+        }
+
+
+        TEST_METHOD(TestRepairedFieldMatchesRecalculatedField)
+        {
+            auto const mesh = CreateGridMesh( 8, 8 );
+            TriangleAdjacency adjacency;
+            CreateTriangleAdjacency( mesh, adjacency );
+            auto const triangle_count = unsigned( mesh.indices.size() / 3 );
+
+            // the target walks over the mesh, then jumps to the other side
+            std::vector<Math::Float3> const target_positions = {
+                { 1.3f, 1.6f, 0 }, { 1.7f, 1.2f, 0 }, { 2.4f, 1.5f, 0 }, { 3.5f, 2.5f, 0 }, { 3.6f, 3.8f, 0 }, { 7.5f, 7.2f, 0 }, { 0.2f, 7.9f, 0 }
+            };
+            FlowField field;
+            for( auto const & position : target_positions )
+            {
+                UpdateFlowField( position, mesh, adjacency, field );
+                FlowField recalculated;
+                UpdateFlowField( position, mesh, adjacency, recalculated );
+
+                Assert::AreEqual( recalculated.target_triangle, field.target_triangle );
+                Assert::AreEqual( unsigned(-1), field.next_triangles[field.target_triangle] );
+                for( auto t = 0u; t < triangle_count; ++t )
+                {
+                    Assert::AreEqual( recalculated.costs[t], field.costs[t], 1e-4f );
+                    if( t == field.target_triangle ) continue;
+                    // ties may pick another neighbour, but it has to be on a shortest way
+                    auto next = field.next_triangles[t];
+                    auto step = Math::Norm( adjacency.centroids[next] - adjacency.centroids[t] );
+                    Assert::AreEqual( field.costs[t], field.costs[next] + step, 1e-4f );
+                }
+            }
+        }
+
+
+        TEST_METHOD(TestPathsGoThroughThePortals)
+        {
+            auto const mesh = CreateGridMesh( 4, 4 );
+            TriangleAdjacency adjacency;
+            CreateTriangleAdjacency( mesh, adjacency );
+            FlowField field;
+            UpdateFlowField( { 3.5f, 3.2f, 0 }, mesh, adjacency, field );
+
+            std::vector<Math::Float2> path;
+            GetFlowFieldPath( field, mesh, { 3.6f, 3.1f, 0 }, field.target_triangle, path );
+            Assert::AreEqual( size_t( 1 ), path.size() );
+            Assert::AreEqual( 3.5f, path[0].x );
+
+            // a wrong hint still finds the right triangle
+            Math::Float3 const position = { 0.3f, 0.6f, 0 };
+            auto const triangle = FindTriangle( position, field.target_triangle, mesh, adjacency );
+            Assert::AreEqual( FindTriangle( position, unsigned(-1), mesh, adjacency ), triangle );
+
+            GetFlowFieldPath( field, mesh, position, triangle, path );
+            Assert::AreEqual( size_t( 2 ), path.size() );
+
+            // the first node lies on the edge between the triangle and the next one
+            auto a = mesh.vertices[field.next_portals.vertices_0[triangle]];
+            auto b = mesh.vertices[field.next_portals.vertices_1[triangle]];
+            auto cross = ( b.x - a.x ) * ( path[0].y - a.y ) - ( b.y - a.y ) * ( path[0].x - a.x );
+            Assert::IsTrue( std::abs( cross ) < 1e-4f );
+        }
+    };
+}
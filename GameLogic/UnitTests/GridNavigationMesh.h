@@ -0,0 +1,39 @@
+#pragma once
+
+#include <GameLogic\Structures.h>
+
+namespace DogDealerLogic
+{
+    // a grid of size_x x size_y unit squares, each split into two counter clockwise triangles,
+    // leaving out the squares for which is_missing( x, y ) is true
+    template<typename MissingSquares>
+    Logic::NavigationMesh CreateGridMesh( unsigned size_x, unsigned size_y, MissingSquares is_missing )
+    {
+        Logic::NavigationMesh mesh;
+        for( auto y = 0u; y <= size_y; ++y )
+        {
+            for( auto x = 0u; x <= size_x; ++x )
+            {
+                mesh.vertices.push_back( { float( x ), float( y ) } );
+                mesh.vertices_z.push_back( 0 );
+            }
+        }
+        for( auto y = 0u; y < size_y; ++y )
+        {
+            for( auto x = 0u; x < size_x; ++x )
+            {
+                if( is_missing( x, y ) ) continue;
+                auto v = y * ( size_x + 1 ) + x;
+                mesh.indices.insert( mesh.indices.end(), { v, v + 1, v + size_x + 2 } );
+                mesh.indices.insert( mesh.indices.end(), { v, v + size_x + 2, v + size_x + 1 } );
+            }
+        }
+        return mesh;
+    }
+
+
+    inline Logic::NavigationMesh CreateGridMesh( unsigned size_x, unsigned size_y )
+    {
+        return CreateGridMesh( size_x, size_y, []( unsigned, unsigned ){ return false; } );
+    }
+}
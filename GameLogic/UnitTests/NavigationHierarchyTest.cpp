@@ -0,0 +1,105 @@
+#include "CppUnitTest.h"
+#include "GridNavigationMesh.h"
+
+#include <GameLogic\AINavigation.h>
+#include <GameLogic\NavigationHierarchyFunctions.h>
+#include <GameLogic\Structures.h>
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <cmath>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Logic;
+
+namespace DogDealerLogic
+{
+    namespace
+    {
+        // a grid of size x size squares split into two triangles each, with a wall of missing squares
+        // across the middle that only has a gap at one end
+        NavigationMesh CreateWalledGridMesh( unsigned size )
+        {
+            return CreateGridMesh( size, size, [size]( unsigned x, unsigned y ){ return y == size / 2 && x > 1; } );
+        }
+
+
+        float GetCorridorLength( PathCorridor const & corridor, NavigationHierarchy const & hierarchy )
+        {
+            auto length = 0.f;
+            for( auto i = 1u; i < corridor.triangles.size(); ++i )
+            {
+                auto const & centroids = hierarchy.adjacency.centroids;
+                length += Math::Norm( centroids[corridor.triangles[i]] - centroids[corridor.triangles[i - 1]] );
+            }
+            return length;
+        }
+    }
+
+
+    TEST_CLASS(NavigationHierarchyTest)
+    {
+    public:
+
+        TEST_METHOD(TestClustersCoverTheMesh)
+        {
+            auto const mesh = CreateWalledGridMesh( 16 );
+            NavigationHierarchy hierarchy;
+            CreateNavigationHierarchy( mesh, 24, 0.1f, hierarchy );
+
+            auto const triangle_count = unsigned( mesh.indices.size() / 3 );
+            Assert::AreEqual( size_t( triangle_count ), hierarchy.cluster_triangles.size() );
+            Assert::IsTrue( hierarchy.cluster_offsets.size() > 2 );
+            for( auto c = 0u; c + 1 < hierarchy.cluster_offsets.size(); ++c )
+            {
+                Assert::IsTrue( hierarchy.cluster_offsets[c + 1] - hierarchy.cluster_offsets[c] <= 24 );
+                for( auto i = hierarchy.cluster_offsets[c]; i < hierarchy.cluster_offsets[c + 1]; ++i )
+                {
+                    Assert::AreEqual( c, hierarchy.triangle_clusters[hierarchy.cluster_triangles[i]] );
+                }
+            }
+            Assert::AreEqual( hierarchy.node_triangles.size() + 1, hierarchy.edge_offsets.size() );
+        }
+
+
+        TEST_METHOD(TestCorridorsStayWithinToleranceOfFlatSearch)
+        {
+            auto const mesh = CreateWalledGridMesh( 16 );
+            auto const tolerance = 0.1f;
+            NavigationHierarchy hierarchy;
+            CreateNavigationHierarchy( mesh, 24, tolerance, hierarchy );
+
+            std::mt19937 generator( 42 );
+            std::uniform_real_distribution<float> coordinate( 0.1f, 15.9f );
+            // one set of search buffers for all queries, as the path request queue keeps it
+            NavigationHierarchySearch search;
+            auto tested = 0u;
+            while( tested < 50 )
+            {
+                Math::Float3 start = { coordinate( generator ), coordinate( generator ), 0 };
+                Math::Float3 destination = { coordinate( generator ), coordinate( generator ), 0 };
+                // skip positions in the wall
+                if( std::abs( start.y - 8.5f ) < 0.5f || std::abs( destination.y - 8.5f ) < 0.5f ) continue;
+                ++tested;
+
+                PathCorridor flat_corridor, hierarchical_corridor;
+                auto const flat_path = FindPath( start, destination, mesh, flat_corridor );
+                auto const hierarchical_path = FindPath( start, destination, mesh, hierarchy, search, hierarchical_corridor );
+
+                Assert::AreEqual( flat_corridor.triangles.front(), hierarchical_corridor.triangles.front() );
+                Assert::AreEqual( flat_corridor.triangles.back(), hierarchical_corridor.triangles.back() );
+                Assert::AreEqual( hierarchical_corridor.triangles.size() - 1, hierarchical_corridor.portals.vertices_0.size() );
+                Assert::IsTrue( GetCorridorLength( hierarchical_corridor, hierarchy ) <= ( 1 + tolerance ) * GetCorridorLength( flat_corridor, hierarchy ) + 1e-3f );
+                Assert::AreEqual( flat_path.back().x, hierarchical_path.back().x );
+
+                // reused buffers give the same corridor as fresh ones
+                NavigationHierarchySearch fresh_search;
+                PathCorridor fresh_corridor;
+                FindPath( start, destination, mesh, hierarchy, fresh_search, fresh_corridor );
+                Assert::IsTrue( fresh_corridor.triangles == hierarchical_corridor.triangles );
+            }
+        }
+    };
+}
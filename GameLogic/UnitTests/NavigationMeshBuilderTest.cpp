@@ -0,0 +1,212 @@
+#include "CppUnitTest.h"
+
+#include <GameLogic\AINavigation.h>
+#include <GameLogic\AINavigationMeshFunctions.h>
+#include <GameLogic\NavigationMeshBuilder.h>
+#include <GameLogic\Structures.h>
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <cmath>
+#include <set>
+#include <tuple>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Logic;
+
+namespace DogDealerLogic
+{
+    namespace
+    {
+        void AddQuad( Math::Float3 a, Math::Float3 b, Math::Float3 c, Math::Float3 d, NavigationGeometry & geometry )
+        {
+            geometry.triangle_vertices.insert( geometry.triangle_vertices.end(), { a, b, c, a, c, d } );
+        }
+
+
+        // a square ground of two triangles with a box standing on it
+        NavigationGeometry CreateGroundWithBox( float ground_size, Math::Float3 box_minimum, Math::Float3 box_maximum )
+        {
+            NavigationGeometry geometry;
+            AddQuad( { 0, 0, 0 }, { ground_size, 0, 0 }, { ground_size, ground_size, 0 }, { 0, ground_size, 0 }, geometry );
+
+            auto l = box_minimum;
+            auto h = box_maximum;
+            AddQuad( { l.x, l.y, h.z }, { h.x, l.y, h.z }, { h.x, h.y, h.z }, { l.x, h.y, h.z }, geometry );
+            AddQuad( { l.x, l.y, l.z }, { l.x, h.y, l.z }, { h.x, h.y, l.z }, { h.x, l.y, l.z }, geometry );
+            AddQuad( { l.x, l.y, l.z }, { h.x, l.y, l.z }, { h.x, l.y, h.z }, { l.x, l.y, h.z }, geometry );
+            AddQuad( { h.x, h.y, l.z }, { l.x, h.y, l.z }, { l.x, h.y, h.z }, { h.x, h.y, h.z }, geometry );
+            AddQuad( { l.x, h.y, l.z }, { l.x, l.y, l.z }, { l.x, l.y, h.z }, { l.x, h.y, h.z }, geometry );
+            AddQuad( { h.x, l.y, l.z }, { h.x, h.y, l.z }, { h.x, h.y, h.z }, { h.x, l.y, h.z }, geometry );
+            return geometry;
+        }
+
+
+        Math::Float3 GetVertex( NavigationMesh const & mesh, unsigned index )
+        {
+            auto const & vertex = mesh.vertices[index];
+            return { vertex.x, vertex.y, mesh.vertices_z[index] };
+        }
+
+
+        float GetArea( NavigationMesh const & mesh )
+        {
+            auto area = 0.f;
+            for( auto i = 0u; i < mesh.indices.size(); i += 3 )
+            {
+                auto a = mesh.vertices[mesh.indices[i]];
+                auto b = mesh.vertices[mesh.indices[i + 1]];
+                auto c = mesh.vertices[mesh.indices[i + 2]];
+                area += 0.5f * Math::Cross( b - a, c - a );
+            }
+            return area;
+        }
+    }
+
+
+    TEST_CLASS(NavigationMeshBuilderTest)
+    {
+    public:
+
+        TEST_METHOD(TestBoxOnGroundIsCutOutAndTopIsWalkable)
+        {
+            auto geometry = CreateGroundWithBox( 20, { 8, 8, 0 }, { 12, 12, 1 } );
+            NavigationMeshBuildSettings settings;
+            settings.tile_cells = 16;
+
+            NavigationTiles tiles;
+            BuildNavigationTiles( geometry, settings, tiles );
+            Assert::AreEqual( 9u, unsigned( tiles.tiles.size() ) );
+
+            NavigationMesh mesh;
+            MergeNavigationTiles( tiles, mesh );
+
+            // flat areas are merged into larger triangles instead of two per cell
+            auto cell_count = tiles.cell_count_x * tiles.cell_count_y;
+            Assert::IsTrue( mesh.indices.size() / 3 < cell_count / 2 );
+
+            // all triangles are counter clockwise and lie on the ground or on top of the box
+            for( auto i = 0u; i < mesh.indices.size(); i += 3 )
+            {
+                auto a = GetVertex( mesh, mesh.indices[i] );
+                auto b = GetVertex( mesh, mesh.indices[i + 1] );
+                auto c = GetVertex( mesh, mesh.indices[i + 2] );
+                Assert::IsTrue( Math::Cross( Math::Float2( b.x - a.x, b.y - a.y ), Math::Float2( c.x - a.x, c.y - a.y ) ) > 0 );
+
+                auto center = ( a + b + c ) / 3.f;
+                auto on_box = center.x > 8 && center.x < 12 && center.y > 8 && center.y < 12;
+                Assert::AreEqual( on_box ? 1.f : 0.f, center.z, 1e-4f );
+            }
+
+            // no vertex is left unwelded on the tile borders
+            std::set<std::tuple<float, float, float>> positions;
+            for( auto v = 0u; v < mesh.vertices.size(); ++v )
+            {
+                Assert::IsTrue( positions.insert( std::make_tuple( mesh.vertices[v].x, mesh.vertices[v].y, mesh.vertices_z[v] ) ).second );
+            }
+
+            // so a path leads across all tiles, around the box
+            Math::Float3 start = { 1, 1, 0 };
+            Math::Float3 destination = { 19, 19, 0 };
+            PathCorridor corridor;
+            FindPath( start, destination, mesh, corridor );
+            Assert::IsFalse( corridor.triangles.empty() );
+            Assert::AreEqual( GetContainingTriangleIndex( destination, mesh ), corridor.triangles.back() );
+
+            auto top = GetContainingTriangleIndex( { 10, 10, 1 }, mesh );
+            Assert::AreNotEqual( unsigned(-1), top );
+            Assert::AreEqual( 1.f, mesh.vertices_z[mesh.indices[3 * top]], 1e-4f );
+        }
+
+
+        TEST_METHOD(TestRebuildingTilesMatchesFullBuild)
+        {
+            NavigationMeshBuildSettings settings;
+            settings.tile_cells = 16;
+
+            NavigationTiles tiles;
+            BuildNavigationTiles( CreateGroundWithBox( 20, { 2, 2, 0 }, { 4, 4, 1 } ), settings, tiles );
+
+            // move the box to another corner and only rebuild around its old and new place
+            auto moved = CreateGroundWithBox( 20, { 15, 15, 0 }, { 17, 17, 1 } );
+            RebuildNavigationTiles( moved, settings, { 2, 2, 0 }, { 4, 4, 1 }, tiles );
+            RebuildNavigationTiles( moved, settings, { 15, 15, 0 }, { 17, 17, 1 }, tiles );
+            NavigationMesh rebuilt;
+            MergeNavigationTiles( tiles, rebuilt );
+
+            BuildNavigationTiles( moved, settings, tiles );
+            NavigationMesh built;
+            MergeNavigationTiles( tiles, built );
+
+            Assert::IsTrue( built.indices == rebuilt.indices );
+            Assert::IsTrue( built.vertices_z == rebuilt.vertices_z );
+        }
+
+
+        TEST_METHOD(TestDensityFunctionGround)
+        {
+            NavigationGeometry geometry;
+            geometry.density_functions.push_back( []( Math::Float3 const position, float & density, Math::Float3 & gradient )
+            {
+                density = 2 - position.z;
+                gradient = { 0, 0, -1 };
+            } );
+            geometry.density_minimums.push_back( { 0, 0, 0 } );
+            geometry.density_maximums.push_back( { 10, 10, 4 } );
+
+            NavigationMeshBuildSettings settings;
+            NavigationTiles tiles;
+            BuildNavigationTiles( geometry, settings, tiles );
+            NavigationMesh mesh;
+            MergeNavigationTiles( tiles, mesh );
+
+            Assert::IsFalse( mesh.indices.empty() );
+            for( auto z : mesh.vertices_z )
+            {
+                Assert::AreEqual( 2.f, z, 1e-3f );
+            }
+            // the cells cover the bounds, rounded up to whole cells
+            auto cells = std::floor( 10 / settings.cell_size ) + 1;
+            Assert::AreEqual( cells * cells * settings.cell_size * settings.cell_size, GetArea( mesh ), 1e-2f );
+        }
+
+
+        TEST_METHOD(TestUnboundedDensityFunctionIsLimitedToTheLevel)
+        {
+            // terrain bodies have practically infinite bounds
+            NavigationGeometry geometry;
+            geometry.density_functions.push_back( []( Math::Float3 const position, float & density, Math::Float3 & gradient )
+            {
+                density = 2 - position.z;
+                gradient = { 0, 0, -1 };
+            } );
+            geometry.density_minimums.push_back( Math::Float3( -1e30f ) );
+            geometry.density_maximums.push_back( Math::Float3( 1e30f ) );
+
+            NavigationMeshBuildSettings settings;
+            settings.level_minimum = { 0, 0, -4 };
+            settings.level_maximum = { 10, 10, 4 };
+            NavigationTiles tiles;
+            BuildNavigationTiles( geometry, settings, tiles );
+            NavigationMesh mesh;
+            MergeNavigationTiles( tiles, mesh );
+
+            Assert::IsFalse( mesh.indices.empty() );
+            for( auto i = 0u; i < mesh.vertices.size(); ++i )
+            {
+                Assert::AreEqual( 2.f, mesh.vertices_z[i], 1e-3f );
+                Assert::IsTrue( mesh.vertices[i].x >= 0 && mesh.vertices[i].x <= 10 + settings.cell_size );
+                Assert::IsTrue( mesh.vertices[i].y >= 0 && mesh.vertices[i].y <= 10 + settings.cell_size );
+            }
+            auto cells = std::floor( 10 / settings.cell_size ) + 1;
+            Assert::AreEqual( cells * cells * settings.cell_size * settings.cell_size, GetArea( mesh ), 1e-2f );
+
+            // rebuilding an unbounded area only touches the existing tiles
+            RebuildNavigationTiles( geometry, settings, Math::Float3( -1e30f ), Math::Float3( 1e30f ), tiles );
+            NavigationMesh rebuilt;
+            MergeNavigationTiles( tiles, rebuilt );
+            Assert::IsTrue( mesh.indices == rebuilt.indices );
+        }
+    };
+}
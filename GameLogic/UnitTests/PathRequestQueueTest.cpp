@@ -0,0 +1,156 @@
+#include "CppUnitTest.h"
+
+#include <GameLogic\PathRequestQueue.h>
+#include <GameLogic\NavigationHierarchyFunctions.h>
+#include <GameLogic\AIParameterContainer.h>
+#include <GameLogic\Structures.h>
+
+#include <Utilities\UnitTest\CreateHandle.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Logic;
+
+namespace DogDealerLogic
+{
+    namespace
+    {
+        // a single big triangle, so every path is a straight line to the destination
+        NavigationMesh CreateTriangleMesh()
+        {
+            NavigationMesh mesh;
+            mesh.vertices = { { -100, -100 }, { 100, -100 }, { 0, 100 } };
+            mesh.vertices_z = { 0, 0, 0 };
+            mesh.indices = { 0, 1, 2 };
+            return mesh;
+        }
+    }
+
+
+    TEST_CLASS(PathRequestQueueTest)
+    {
+    public:
+
+        TEST_METHOD(TestRequestsAreSolvedNearestFirstWithinBudget)
+        {
+            auto const mesh = CreateTriangleMesh();
+            NavigationHierarchy hierarchy;
+            CreateNavigationHierarchy( mesh, c_navigation_cluster_size, c_navigation_path_tolerance, hierarchy );
+            AIParameterContainer parameters;
+            PathRequestQueue queue;
+            for( auto i = 0u; i < 3; ++i )
+            {
+                parameters.AddPatrollingTarget( CreateHandle<EntityID>( i ), { float( i ), 10, 0 } );
+            }
+            // entity 2 starts nearest to the focus, then entity 0, then entity 1
+            RequestPath( CreateHandle<EntityID>( 0 ), PathRequester::Navigating, { 20, 0, 0 }, { 0, 10, 0 }, queue );
+            RequestPath( CreateHandle<EntityID>( 1 ), PathRequester::Navigating, { 40, 0, 0 }, { 1, 10, 0 }, queue );
+            RequestPath( CreateHandle<EntityID>( 2 ), PathRequester::Navigating, { 10, 0, 0 }, { 2, 10, 0 }, queue );
+            // a repeated request replaces the pending one
+            RequestPath( CreateHandle<EntityID>( 2 ), PathRequester::Navigating, { 5, 0, 0 }, { 2, 20, 0 }, queue );
+            Assert::AreEqual( size_t( 3 ), queue.entities.size() );
+
+            // without budget exactly one request is solved per call
+            SolvePathRequests( mesh, hierarchy, 0, 0, queue, parameters );
+            Assert::AreEqual( size_t( 2 ), queue.entities.size() );
+            Assert::AreEqual( size_t( 1 ), parameters.m_navigating.m_paths[2].size() );
+            Assert::AreEqual( 20.f, parameters.m_navigating.m_paths[2].back().y );
+            Assert::AreEqual( 0u, parameters.m_navigating.m_next_node_indices[2] );
+            Assert::IsTrue( parameters.m_navigating.m_paths[0].empty() );
+            Assert::IsTrue( parameters.m_navigating.m_paths[1].empty() );
+
+            SolvePathRequests( mesh, hierarchy, 0, 0, queue, parameters );
+            Assert::IsFalse( parameters.m_navigating.m_paths[0].empty() );
+            Assert::IsTrue( parameters.m_navigating.m_paths[1].empty() );
+
+            // requests of entities that stopped patrolling are dropped
+            parameters.RemoveEntityFromPatrolling( CreateHandle<EntityID>( 1 ) );
+            SolvePathRequests( mesh, hierarchy, 0, 0, queue, parameters );
+            Assert::IsTrue( queue.entities.empty() );
+        }
+
+
+        TEST_METHOD(TestWaitingRequestsOvertakeNearerOnes)
+        {
+            auto const mesh = CreateTriangleMesh();
+            NavigationHierarchy hierarchy;
+            CreateNavigationHierarchy( mesh, c_navigation_cluster_size, c_navigation_path_tolerance, hierarchy );
+            AIParameterContainer parameters;
+            PathRequestQueue queue;
+            parameters.AddPatrollingTarget( CreateHandle<EntityID>( 0 ), { 0, 10, 0 } );
+            RequestPath( CreateHandle<EntityID>( 0 ), PathRequester::Navigating, { 30, 0, 0 }, { 0, 10, 0 }, queue );
+
+            // keep adding requests nearer to the focus, the far request still gets its turn
+            for( auto i = 1u; i < 40 && !queue.entities.empty(); ++i )
+            {
+                parameters.AddPatrollingTarget( CreateHandle<EntityID>( i ), { 0, 10, 0 } );
+                RequestPath( CreateHandle<EntityID>( i ), PathRequester::Navigating, { 1, 0, 0 }, { 0, 10, 0 }, queue );
+                SolvePathRequests( mesh, hierarchy, 0, 0, queue, parameters );
+            }
+            Assert::IsFalse( parameters.m_navigating.m_paths[0].empty() );
+        }
+
+
+        TEST_METHOD(TestCancelledRequestsAreNotSolved)
+        {
+            auto const mesh = CreateTriangleMesh();
+            NavigationHierarchy hierarchy;
+            CreateNavigationHierarchy( mesh, c_navigation_cluster_size, c_navigation_path_tolerance, hierarchy );
+            AIParameterContainer parameters;
+            PathRequestQueue queue;
+            for( auto i = 0u; i < 3; ++i )
+            {
+                parameters.AddPatrollingTarget( CreateHandle<EntityID>( i ), { float( i ), 10, 0 } );
+                RequestPath( CreateHandle<EntityID>( i ), PathRequester::Navigating, { 1, 0, 0 }, { float( i ), 10, 0 }, queue );
+            }
+            // only the request of the same requester is cancelled
+            CancelPathRequest( CreateHandle<EntityID>( 1 ), PathRequester::Following, queue );
+            Assert::AreEqual( size_t( 3 ), queue.entities.size() );
+            CancelPathRequest( CreateHandle<EntityID>( 1 ), PathRequester::Navigating, queue );
+            Assert::AreEqual( size_t( 2 ), queue.entities.size() );
+
+            SolvePathRequests( mesh, hierarchy, 0, 1e9f, queue, parameters );
+            Assert::IsTrue( queue.entities.empty() );
+            Assert::IsFalse( parameters.m_navigating.m_paths[0].empty() );
+            Assert::IsTrue( parameters.m_navigating.m_paths[1].empty() );
+            Assert::IsFalse( parameters.m_navigating.m_paths[2].empty() );
+        }
+
+
+        TEST_METHOD(TestRepeatedRequestsReplaceThePendingOnes)
+        {
+            auto const mesh = CreateTriangleMesh();
+            NavigationHierarchy hierarchy;
+            CreateNavigationHierarchy( mesh, c_navigation_cluster_size, c_navigation_path_tolerance, hierarchy );
+            AIParameterContainer parameters;
+            PathRequestQueue queue;
+            auto const entity_count = 60u;
+            for( auto i = 0u; i < entity_count; ++i )
+            {
+                parameters.AddPatrollingTarget( CreateHandle<EntityID>( i ), { 0, 10, 0 } );
+                RequestPath( CreateHandle<EntityID>( i ), PathRequester::Navigating, { float( i ), 0, 0 }, { 0, 10, 0 }, queue );
+            }
+
+            // cancelling and solving moves the pending requests around, retargeting still finds them
+            for( auto i = 0u; i < entity_count; i += 3 )
+            {
+                CancelPathRequest( CreateHandle<EntityID>( i ), PathRequester::Navigating, queue );
+            }
+            SolvePathRequests( mesh, hierarchy, 0, 0, queue, parameters );
+            SolvePathRequests( mesh, hierarchy, 0, 0, queue, parameters );
+            auto const pending = queue.entities.size();
+            Assert::AreEqual( size_t( entity_count - entity_count / 3 - 2 ), pending );
+            for( auto i = 0u; i < entity_count; ++i )
+            {
+                RequestPath( CreateHandle<EntityID>( i ), PathRequester::Navigating, { float( i ), 0, 0 }, { 0, 20, 0 }, queue );
+            }
+            // only the cancelled and solved requests were added again
+            Assert::AreEqual( size_t( entity_count ), queue.entities.size() );
+
+            SolvePathRequests( mesh, hierarchy, 0, 1e9f, queue, parameters );
+            for( auto i = 0u; i < entity_count; ++i )
+            {
+                Assert::AreEqual( 20.f, parameters.m_navigating.m_paths[i].back().y );
+            }
+        }
+    };
+}
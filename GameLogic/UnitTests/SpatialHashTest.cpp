@@ -0,0 +1,132 @@
+#include "CppUnitTest.h"
+
+#include <GameLogic\SpatialHashFunctions.h>
+
+#include <Conventions\Orientation.h>
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+#include <Utilities\InvalidIndex.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Logic;
+
+namespace DogDealerLogic
+{
+    namespace
+    {
+        // every third entity index is unused, the others are spread over a cube
+        IndexedOrientations CreateRandomOrientations( uint32_t entity_count, float world_size )
+        {
+            std::mt19937 generator( 4321 );
+            std::uniform_real_distribution<float> position( -world_size, world_size );
+            IndexedOrientations result;
+            for( auto i = 0u; i < entity_count; ++i )
+            {
+                if( i % 3 == 2 )
+                {
+                    result.indices.push_back( c_invalid_index );
+                    continue;
+                }
+                result.indices.push_back( unsigned( result.orientations.size() ) );
+                result.orientations.push_back( { Math::Float3( position( generator ), position( generator ), position( generator ) ), Math::Identity() } );
+            }
+            return result;
+        }
+
+
+        std::vector<uint32_t> FindInRadiusLinear( IndexedOrientations const & orientations, Math::Float3 center, float radius )
+        {
+            std::vector<uint32_t> result;
+            for( auto i = 0u; i < orientations.indices.size(); ++i )
+            {
+                if( orientations.indices[i] == c_invalid_index ) continue;
+                if( SquaredNorm( orientations.orientations[orientations.indices[i]].position - center ) <= radius * radius )
+                {
+                    result.push_back( i );
+                }
+            }
+            return result;
+        }
+    }
+
+
+    TEST_CLASS(SpatialHashTest)
+    {
+    public:
+
+        TEST_METHOD(TestRadiusQueryMatchesLinearSearch)
+        {
+            auto const orientations = CreateRandomOrientations( 3000, 50.f );
+            SpatialHash hash;
+            CreateSpatialHash( orientations, c_spatial_hash_cell_size, hash );
+
+            // small radii use the cells, the largest radius falls back to checking everything
+            for( auto radius : { 0.5f, 3.f, 11.f, 400.f } )
+            {
+                for( auto center : { Math::Float3( 0 ), Math::Float3( -20, 7, 33 ), Math::Float3( 49, -49, 0 ) } )
+                {
+                    std::vector<uint32_t> found;
+                    FindEntitiesInRadius( hash, center, radius, found );
+                    std::sort( begin( found ), end( found ) );
+                    Assert::IsTrue( FindInRadiusLinear( orientations, center, radius ) == found );
+                }
+            }
+        }
+
+
+        TEST_METHOD(TestNearestQueryIsSortedAndLimited)
+        {
+            auto const orientations = CreateRandomOrientations( 3000, 50.f );
+            SpatialHash hash;
+            CreateSpatialHash( orientations, c_spatial_hash_cell_size, hash );
+
+            Math::Float3 center = { 3, -4, 5 };
+            std::vector<uint32_t> nearest;
+            FindNearestEntities( hash, center, 15.f, 10, nearest );
+            Assert::AreEqual( size_t( 10 ), nearest.size() );
+
+            auto distance = [&]( uint32_t entity_index )
+            {
+                return SquaredNorm( orientations.orientations[orientations.indices[entity_index]].position - center );
+            };
+            Assert::IsTrue( std::is_sorted( begin( nearest ), end( nearest ), [&]( uint32_t a, uint32_t b ) { return distance( a ) < distance( b ); } ) );
+
+            // nothing that wasn't returned may be nearer than the last one that was
+            for( auto entity_index : FindInRadiusLinear( orientations, center, 15.f ) )
+            {
+                if( std::find( begin( nearest ), end( nearest ), entity_index ) == end( nearest ) )
+                {
+                    Assert::IsTrue( distance( entity_index ) >= distance( nearest.back() ) );
+                }
+            }
+        }
+
+
+        TEST_METHOD(TestConeQuery)
+        {
+            IndexedOrientations orientations;
+            orientations.indices = { 0, 1, 2, 3, 4 };
+            orientations.orientations = {
+                { Math::Float3( 5, 0, 0 ), Math::Identity() },  // straight ahead
+                { Math::Float3( 5, 4, 0 ), Math::Identity() },  // about 39 degrees off
+                { Math::Float3( -5, 0, 0 ), Math::Identity() }, // behind
+                { Math::Float3( 20, 0, 0 ), Math::Identity() }, // out of range
+                { Math::Float3( 0, 0, 0 ), Math::Identity() },  // at the apex, the one looking
+            };
+            SpatialHash hash;
+            CreateSpatialHash( orientations, c_spatial_hash_cell_size, hash );
+
+            std::vector<uint32_t> found;
+            FindEntitiesInCone( hash, 0, { 1, 0, 0 }, std::cos( 0.5f ), 10.f, found );
+            Assert::IsTrue( std::vector<uint32_t>{ 0 } == found );
+
+            found.clear();
+            FindEntitiesInCone( hash, 0, { 1, 0, 0 }, std::cos( 0.8f ), 10.f, found );
+            std::sort( begin( found ), end( found ) );
+            Assert::IsTrue( ( std::vector<uint32_t>{ 0, 1 } ) == found );
+        }
+    };
+}
@@ -0,0 +1,104 @@
+#include "FrameTransformFunctions.h"
+
+#include <Conventions\OrientationFunctions.h>
+
+#include <Math\FloatOperators.h>
+#include <Math\SSE.h>
+#include <Math\SSEMathConversions.h>
+
+#include <Utilities\StdVectorFunctions.h>
+
+#include <ppl.h>
+
+#include <algorithm>
+
+namespace Graphics
+{
+    namespace
+    {
+        // small enough to spread the work over the cores, large enough to not drown in scheduling overhead
+        uint32_t const c_transforms_per_task = 256;
+
+        template<typename FunctionType>
+        void ParallelForChunks( size_t count, FunctionType function )
+        {
+            auto const chunk_count = uint32_t( ( count + c_transforms_per_task - 1 ) / c_transforms_per_task );
+            Concurrency::parallel_for( 0u, chunk_count,
+                [=]( uint32_t chunk )
+            {
+                auto const chunk_begin = chunk * c_transforms_per_task;
+                auto const chunk_end = uint32_t( std::min<size_t>( chunk_begin + c_transforms_per_task, count ) );
+                function( chunk_begin, chunk_end );
+            } );
+        }
+
+
+        void CreateTransformsParallel( Range<Orientation const *> orientations, Math::Float3 position_offset, std::vector<Math::Float4x4> & transforms )
+        {
+            transforms.resize( Size( orientations ) );
+            ParallelForChunks( Size( orientations ), [&]( uint32_t chunk_begin, uint32_t chunk_end )
+            {
+                CreateTransforms( CreateRange( orientations, chunk_begin, chunk_end ), position_offset, CreateRange( transforms, chunk_begin, chunk_end ) );
+            } );
+        }
+    }
+
+
+    void PrepareTickTransforms(
+        IndexedOrientations const & orientations,
+        IndexedOffsetPoses const & poses,
+        Math::Float3 camera_position,
+        Math::Float3 previous_camera_position,
+        FrameTransforms & frame_transforms )
+    {
+        CreateTransformsParallel( orientations.orientations, -camera_position, frame_transforms.transforms );
+        CreateTransformsParallel( orientations.previous_orientations, -previous_camera_position, frame_transforms.previous_transforms );
+        CreateTransformsParallel( poses.bone_states, Math::Float3( 0 ), frame_transforms.bone_states );
+        CreateTransformsParallel( poses.previous_bone_states, Math::Float3( 0 ), frame_transforms.previous_bone_states );
+    }
+
+
+    void BlendFrameTransforms(
+        float blend_factor,
+        Range<EntityID const *> component_entities,
+        Range<uint32_t const *> orientation_indices,
+        Range<Math::Float4x4 const *> component_offsets,
+        FrameTransforms & frame_transforms )
+    {
+        using namespace Math::SSE;
+        assert( Size( component_entities ) == Size( component_offsets ) );
+        assert( Size( frame_transforms.transforms ) == Size( frame_transforms.previous_transforms ) );
+        assert( Size( frame_transforms.bone_states ) == Size( frame_transforms.previous_bone_states ) );
+
+        auto const sse_blend_factor = SetAll( blend_factor );
+
+        // blend, order and apply the offset in one pass, so only the transforms of components are blended
+        auto const component_count = Size( component_entities );
+        frame_transforms.component_transforms.resize( component_count );
+        auto const transforms = CreateRange( frame_transforms.transforms );
+        auto const previous_transforms = CreateRange( frame_transforms.previous_transforms );
+        auto const component_transforms = CreateRange( frame_transforms.component_transforms );
+        ParallelForChunks( component_count, [=]( uint32_t chunk_begin, uint32_t chunk_end )
+        {
+            for( auto i = chunk_begin; i < chunk_end; ++i )
+            {
+                auto const data_index = orientation_indices[component_entities[i].index];
+                auto const blended = Lerp( SSEFromFloat4x4( previous_transforms[data_index] ), SSEFromFloat4x4( transforms[data_index] ), sse_blend_factor );
+                component_transforms[i] = Float4x4FromSSE( Multiply( blended, SSEFromFloat4x4( component_offsets[i] ) ) );
+            }
+        } );
+
+        auto const bone_count = Size( frame_transforms.bone_states );
+        frame_transforms.bone_palette.resize( bone_count );
+        auto const bone_states = CreateRange( frame_transforms.bone_states );
+        auto const previous_bone_states = CreateRange( frame_transforms.previous_bone_states );
+        auto const bone_palette = CreateRange( frame_transforms.bone_palette );
+        ParallelForChunks( bone_count, [=]( uint32_t chunk_begin, uint32_t chunk_end )
+        {
+            for( auto i = chunk_begin; i < chunk_end; ++i )
+            {
+                bone_palette[i] = Float4x4FromSSE( Lerp( SSEFromFloat4x4( previous_bone_states[i] ), SSEFromFloat4x4( bone_states[i] ), sse_blend_factor ) );
+            }
+        } );
+    }
+}
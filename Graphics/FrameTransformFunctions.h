@@ -0,0 +1,33 @@
+#pragma once
+
+#include "FrameTransforms.h"
+
+#include <Conventions\EntityID.h>
+#include <Conventions\Orientation.h>
+#include <Conventions\PoseInfo.h>
+
+#include <Math\FloatTypes.h>
+#include <Math\FloatMatrixTypes.h>
+
+#include <Utilities\Range.h>
+
+namespace Graphics
+{
+    // creates the current and previous transforms of all orientations and bone states
+    // the orientations are made relative to the camera position of the same tick
+    void PrepareTickTransforms(
+        IndexedOrientations const & orientations,
+        IndexedOffsetPoses const & poses,
+        Math::Float3 camera_position,
+        Math::Float3 previous_camera_position,
+        FrameTransforms & frame_transforms );
+
+    // blends the transforms of the tick for one frame
+    // the component transforms are ordered like the component entities and multiplied with their offsets
+    void BlendFrameTransforms(
+        float blend_factor,
+        Range<EntityID const *> component_entities,
+        Range<uint32_t const *> orientation_indices,
+        Range<Math::Float4x4 const *> component_offsets,
+        FrameTransforms & frame_transforms );
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Math\FloatMatrixTypes.h>
+
+#include <vector>
+
+namespace Graphics
+{
+    // the transforms needed to render the frames of one tick
+    // kept between ticks so the buffers only grow and are never reallocated in steady state
+    struct FrameTransforms
+    {
+        // created once per tick, relative to the camera position of that tick
+        std::vector<Math::Float4x4> transforms;
+        std::vector<Math::Float4x4> previous_transforms;
+        std::vector<Math::Float4x4> bone_states;
+        std::vector<Math::Float4x4> previous_bone_states;
+
+        // blended for every frame, the component transforms are ordered like the components and include the component offset
+        std::vector<Math::Float4x4> component_transforms;
+        std::vector<Math::Float4x4> bone_palette;
+    };
+}
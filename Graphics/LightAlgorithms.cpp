@@ -299,7 +299,7 @@ namespace Graphics
     }
 
 
-    void FillLightBuffer( Math::Quaternion const light_rotation, Math::Float3 const light_color, Range<BoundingShapes::AxisAlignedBox const *> const bounding_boxes, PerspectiveViewParameters perspective_view, Math::Float4x4 const & camera_matrix, ID3D11DeviceContext* const device_context, ID3D11Buffer * const light_buffer, Range<Math::Float4x4 *> const light_transforms, Range<uint32_t *> visible_box_indices_offsets, std::vector<uint32_t> & visible_box_indices)
+    void FillLightBuffer( Math::Quaternion const light_rotation, Math::Float3 const light_color, Range<BoundingShapes::AxisAlignedBox const *> const bounding_boxes, PerspectiveViewParameters perspective_view, Math::Float4x4 const & camera_matrix, ID3D11DeviceContext* const device_context, ID3D11Buffer * const light_buffer, Range<Math::Float4x4 *> const light_transforms, CullShadowMapFunctionType const & cull_shadow_map, Range<uint32_t *> visible_box_indices_offsets, std::vector<uint32_t> & visible_box_indices)
     {
         using namespace BoundingShapes;
         using namespace Math;
@@ -342,7 +342,7 @@ namespace Graphics
 
             auto index_offset = uint32_t(Size(visible_box_indices));
             visible_box_indices_offsets[i] = index_offset;
-            Intersect(bounding_boxes, light_planes, visible_box_indices);
+            cull_shadow_map(i, light_planes, visible_box_indices);
             if( !IsEmpty( CreateRange( visible_box_indices, index_offset, Size(visible_box_indices) ) ) )
             {
                 lightspace_minmax.max.z = std::numeric_limits<float>::max();
@@ -10,12 +10,14 @@
 
 #include <Utilities\Range.h>
 #include <Utilities\MinMax.h>
+#include <functional>
 #include <vector>
 
 // forward declarations
 namespace BoundingShapes
 {
     struct AxisAlignedBox;
+    struct Plane;
 }
 namespace Graphics
 {
@@ -63,6 +65,9 @@ namespace Graphics
     // fills the light buffers and returns the calculated light transforms
     void FillLightBuffers( Range<Math::Quaternion const *> light_rotations, Range<ID3D11Buffer * const *> const light_buffers, Range<uint32_t const*> const color_render_component_indices, Range<BoundingShapes::AxisAlignedBox const *> const bounding_boxes, Range<Math::Float4x4 const*> const transforms, ID3D11DeviceContext* const device_context, Range<Math::Float4x4 *> const light_transforms );
 
+    // appends the indices of the boxes that intersect the planes of the given shadow map, sorted and in the same space as the boxes
+    typedef std::function<void( uint32_t shadow_map_index, Range<BoundingShapes::Plane const *> planes, std::vector<uint32_t> & visible_box_indices )> CullShadowMapFunctionType;
+
     // calculates the light transforms for multiple shadow maps and boxes that intersect each light frustum
     void FillLightBuffer(
         Math::Quaternion const light_rotation,
@@ -73,6 +78,7 @@ namespace Graphics
         ID3D11DeviceContext* const device_context,
         ID3D11Buffer * const light_buffer,
         Range<Math::Float4x4 *> const light_transforms,
+        CullShadowMapFunctionType const & cull_shadow_map,
         Range<uint32_t *> visible_box_indices_offsets,
         std::vector<uint32_t> & visible_box_indices
         );
@@ -7,6 +7,7 @@
 #include "ConstantBufferFunctions.h"
 #include "ConstantBufferTypeAndIDFunctions.h"
 #include "FillConstantBuffer.h"
+#include "FrameTransformFunctions.h"
 #include "LightAlgorithms.h"
 #include "SetShaderResources.h"
 #include "RenderComponentFunctions.h"
@@ -15,13 +16,18 @@
 
 #include <BoundingShapes\IntersectionTests.h>
 #include <BoundingShapes\AxisAlignedBoxFunctions.h>
+#include <BoundingShapes\AxisAlignedBoxBatchFunctions.h>
+#include <BoundingShapes\CullingHierarchyFunctions.h>
+#include <BoundingShapes\FrustumFunctions.h>
 #include <BoundingShapes\OrientedBox.h>
+#include <BoundingShapes\Plane.h>
 
 #include <Conventions\OrientationFunctions.h>
 #include <Conventions\PerspectiveViewFunctions.h>
 
 #include <Math\Conversions.h>
 #include <Math\FloatMatrixOperators.h>
+#include <Math\FloatOperators.h>
 #include <Math\FloatMatrixTypes.h>
 #include <Math\FloatTypes.h>
 #include <Math\MathFunctions.h>
@@ -151,6 +157,8 @@ void RenderWorld::CreateRenderComponent( RenderComponentDescription const & comp
         m_component_container);
 
     CreateDebugRenderComponent(entity_id, mesh_data.bounding_box);
+
+    m_culling_components_changed = true;
 }
 
 
@@ -161,6 +169,8 @@ void RenderWorld::CreateDebugRenderComponent( EntityID entity_id, BoundingShapes
         return;
     }
 
+    m_culling_components_changed = true;
+
     RenderComponent component;
     auto mesh_data = m_resource_manager.ProvideMeshData("debug_wire_box", m_index_buffer_container, m_vertex_buffer_container, m_device);
     component.mesh = mesh_data.mesh;
@@ -242,6 +252,9 @@ void RenderWorld::CreateDebugRenderComponents( Range<EntityID const*> entity_ids
 // Creates a RenderComponent from the description, returning its ID
 void RenderWorld::ReplaceRenderComponents( Range<RenderComponentDescription const *> const component_descriptions, EntityID entity_id )
 {
+    m_culling_components_changed = true;
+    m_static_culling_hierarchy_changed |= IsStaticEntity( entity_id );
+
     auto start_search = begin( m_component_container.entity_ids );
     for( size_t i = 0; i < Size( component_descriptions ); i++ )
     {
@@ -384,6 +397,8 @@ void RenderWorld::CreateTerrainRenderComponent(
         m_terrain_2d_data
         );
 
+    m_culling_components_changed = true;
+    m_static_culling_hierarchy_changed = true;
     auto old_size = Size(m_component_container.bounding_boxes);
     AddRenderComponents(m_terrain_2d_data, m_component_container);
     auto new_size = Size(m_component_container.bounding_boxes);
@@ -510,6 +525,8 @@ void RenderWorld::UpdateTerrain2D(Math::Float3 position)
         );
 
     RemoveRenderComponents(m_terrain_2d_data.entity_id, m_component_container);
+    m_culling_components_changed = true;
+    m_static_culling_hierarchy_changed = true;
     auto old_size = Size(m_component_container.bounding_boxes);
     AddRenderComponents(m_terrain_2d_data, m_component_container);
     AddGrassRenderComponents(m_terrain_2d_data, m_component_container);
@@ -572,6 +589,8 @@ void RenderWorld::UpdateTerrain3D(Math::Float3 const position, bool const force_
 
         // ERASE OLD TERRAIN BLOCK RENDER COMPONENTS:
         RemoveRenderComponents(m_terrain_3d_data.terrain_entity_id, m_component_container);
+        m_culling_components_changed = true;
+        m_static_culling_hierarchy_changed = true;
 
         // Initialize new render components to be used for the terrain blocks
         AddTerrainBlockRenderComponents(
@@ -686,8 +705,10 @@ namespace
 
 void RenderWorld::RemoveEntities( std::vector<EntityID> const & entity_ids )
 {
+    m_culling_components_changed = true;
     for( auto id : entity_ids )
     {
+        m_static_culling_hierarchy_changed |= IsStaticEntity( id );
         // TODO: Remove resources used by components
         RemoveRenderComponents(id, m_component_container);
 
@@ -769,20 +790,6 @@ void RenderWorld::DefaultInitialize( HWND const window )
 namespace
 {
 
-    template<typename Type>
-    inline void OrderData( Range<EntityID const * > ids, Range<Type const *> data, Range<uint32_t const *> indices, Range<Type *> output )
-    {
-        assert(Size(output) == Size( ids ) );
-        auto size = Size( ids );
-        for( auto i = 0u; i < size; ++i )
-        {
-            auto index = ids[i].index;
-            auto data_index = indices[index];
-            output[i] = data[data_index];
-        }
-    }
-
-
     void SetRenderTargetsAndStates( ID3D11DeviceContext* context, TargetsAndStates const & targets_and_states )
     {
         // things I have no idea about
@@ -924,38 +931,107 @@ namespace
 }
 
 
+bool RenderWorld::IsStaticEntity( EntityID entity_id ) const
+{
+    return entity_id != c_invalid_entity_id && ( entity_id == m_terrain_3d_data.terrain_entity_id || entity_id == m_terrain_2d_data.entity_id );
+}
+
+
+void RenderWorld::UpdateCullingComponents( Range<Math::Float4x4 const *> transforms, Math::Float3 camera_position, uint32_t component_count )
+{
+    m_dynamic_component_indices.clear();
+    m_culling_buffer.clear();
+    for( auto i = 0u; i < component_count; ++i )
+    {
+        if( IsStaticEntity( m_component_container.entity_ids[i] ) )
+        {
+            m_culling_buffer.push_back( i );
+        }
+        else
+        {
+            m_dynamic_component_indices.push_back( i );
+        }
+    }
+
+    // static components only move around in the container when something is removed, if they are all still in the same place we can keep the hierarchy
+    if( m_static_culling_hierarchy_changed || m_culling_buffer != m_static_component_indices )
+    {
+        swap( m_static_component_indices, m_culling_buffer );
+        std::vector<BoundingShapes::AxisAlignedBox> world_boxes( Size( m_static_component_indices ) );
+        for( auto i = 0u; i < Size( m_static_component_indices ); ++i )
+        {
+            auto const component_index = m_static_component_indices[i];
+            world_boxes[i] = Transform( m_component_container.bounding_boxes[component_index], transforms[component_index] );
+            world_boxes[i].center += camera_position;
+        }
+        CreateCullingHierarchy( world_boxes, m_static_culling_hierarchy );
+    }
+
+    m_culling_components_changed = false;
+    m_static_culling_hierarchy_changed = false;
+}
+
+
+void RenderWorld::CullComponents(
+    Range<BoundingShapes::Plane const *> planes,
+    Math::Float3 camera_position,
+    BoundingShapes::CullingCoherence & coherence,
+    Range<BoundingShapes::AxisAlignedBox *> transformed_boxes,
+    std::vector<uint32_t> & visible_component_indices )
+{
+    auto const offset = Size( visible_component_indices );
+
+    // the dynamic components, including the debug components that only exist for this tick, are tested in batches
+    m_culling_buffer.clear();
+    Intersect( m_dynamic_box_batch, planes, m_culling_buffer );
+    for( auto batch_index : m_culling_buffer )
+    {
+        visible_component_indices.push_back( m_dynamic_batch_component_indices[batch_index] );
+    }
+
+    // the static hierarchy is in world space
+    std::array<BoundingShapes::Plane, BoundingShapes::c_maximum_culling_planes> world_planes;
+    assert( Size( planes ) <= Size( world_planes ) );
+    for( auto i = 0u; i < Size( planes ); ++i )
+    {
+        world_planes[i] = { planes[i].normal, planes[i].distance - Dot( planes[i].normal, camera_position ) };
+    }
+    m_culling_buffer.clear();
+    Cull( m_static_culling_hierarchy, CreateRange( world_planes.data(), Size( planes ) ), coherence, m_culling_buffer );
+    for( auto static_index : m_culling_buffer )
+    {
+        auto const component_index = m_static_component_indices[static_index];
+        auto box = m_static_culling_hierarchy.boxes[static_index];
+        box.center -= camera_position;
+        transformed_boxes[component_index] = box;
+        visible_component_indices.push_back( component_index );
+    }
+
+    std::sort( begin( visible_component_indices ) + offset, end( visible_component_indices ) );
+}
+
+
 void RenderWorld::RenderFor( double start_time, float time_step, IndexedOrientations const & orientations, IndexedOffsetPoses const & poses, Orientation new_camera_orientation, Orientation previous_camera_orientation, PerspectiveViewParameters perspective_view_parameters )
 {
     m_loop_timer.Start();
 
+    auto const base_component_count = uint32_t( ComponentCount( m_component_container ) );
     if(m_world_configuration.render_external_debug_components)
     {
         Append(m_external_debug_component_container, m_component_container);
     }
+    auto const component_count = uint32_t( ComponentCount( m_component_container ) );
 
-    std::vector<Math::Float4x4> transforms( Size( orientations.orientations ) );
-    CreateTransforms( orientations.orientations, -new_camera_orientation.position, transforms );
+    PrepareTickTransforms( orientations, poses, new_camera_orientation.position, previous_camera_orientation.position, m_frame_transforms );
 
     auto new_camera_matrix = RotationToFloat3x3( Conjugate(new_camera_orientation.rotation) );
 
-    std::vector<Math::Float4x4> previous_transforms( Size( orientations.previous_orientations ) );
-    CreateTransforms( orientations.previous_orientations, -previous_camera_orientation.position, previous_transforms );
-
     auto previous_camera_matrix = RotationToFloat3x3( Conjugate(previous_camera_orientation.rotation) );
 
     auto projection_matrix = PerspectiveFieldOfViewVertical( perspective_view_parameters );
 
-    std::vector<Math::Float4x4> bone_states( Size( poses.bone_states ) );
-    CreateTransforms( poses.bone_states, bone_states );
-    std::vector<Math::Float4x4> previous_bone_states( Size( poses.previous_bone_states ) );
-    CreateTransforms( poses.previous_bone_states, previous_bone_states );
-
-    std::vector<Math::Float4x4> const & component_offset_transforms = m_component_container.orientation_offsets;
-
-    std::vector<Math::Float4x4> blended_transforms( Size( transforms ) );
-    std::vector<Math::Float4x4> blended_bone_states( Size( bone_states ) );
-
-    std::vector<Math::Float4x4> ordered_blended_transforms( Size( m_component_container.entity_ids ) );
+    auto const & ordered_blended_transforms = m_frame_transforms.component_transforms;
+    auto const & blended_bone_states = m_frame_transforms.bone_palette;
 
     std::vector<Math::Float4x4> light_matrices( Size(m_light_container.entity_ids) * m_light_container.shadow_map_count );
     std::vector<uint32_t> color_render_component_indices, shadow_render_component_indices_offsets, shadow_render_component_indices, all_to_be_rendered_components(m_component_container.entity_ids.size());
@@ -973,26 +1049,37 @@ void RenderWorld::RenderFor( double start_time, float time_step, IndexedOrientat
         return "Total rendering time this tick: " + std::to_string( this->m_loop_timer.GetMilliSeconds() ) + " ms";
     } ) )
     {
-        BlendTransforms( transforms, previous_transforms, blend_factor, blended_transforms );
-
-        BlendTransforms( bone_states, previous_bone_states, blend_factor, blended_bone_states );
-
-        OrderData<Math::Float4x4>( m_component_container.entity_ids, blended_transforms, orientations.indices, ordered_blended_transforms );
-
-        for (auto i = 0u; i < ordered_blended_transforms.size(); i++)
-        {
-            ordered_blended_transforms[i] *= component_offset_transforms[i];
-        }
+        BlendFrameTransforms( blend_factor, m_component_container.entity_ids, orientations.indices, m_component_container.orientation_offsets, m_frame_transforms );
 
         auto const blended_camera_matrix = Lerp( previous_camera_matrix, new_camera_matrix, blend_factor );
 
         auto camera_projection = projection_matrix * CombineFloat3x3AndTranslation(blended_camera_matrix, 0);
 
-        FillPerFrameConstantBuffers( blended_camera_matrix, projection_matrix, Lerp(previous_camera_orientation.position, new_camera_orientation.position, blend_factor) );
+        auto const blended_camera_position = Lerp( previous_camera_orientation.position, new_camera_orientation.position, blend_factor );
 
-        Transform( m_component_container.bounding_boxes, ordered_blended_transforms, transformed_boxes );
+        FillPerFrameConstantBuffers( blended_camera_matrix, projection_matrix, blended_camera_position );
+
+        if( m_culling_components_changed || m_static_culling_hierarchy_changed )
+        {
+            UpdateCullingComponents( ordered_blended_transforms, blended_camera_position, base_component_count );
+        }
+        // only the dynamic components have to be transformed every frame, the visible static ones are filled in while culling
+        m_dynamic_batch_component_indices = m_dynamic_component_indices;
+        for( auto component_index = base_component_count; component_index < component_count; ++component_index )
+        {
+            m_dynamic_batch_component_indices.push_back( component_index );
+        }
+        for( auto component_index : m_dynamic_batch_component_indices )
+        {
+            transformed_boxes[component_index] = Transform( m_component_container.bounding_boxes[component_index], ordered_blended_transforms[component_index] );
+        }
+        CreateAxisAlignedBoxBatch( transformed_boxes, m_dynamic_batch_component_indices, m_dynamic_box_batch );
+
+        std::array<BoundingShapes::Plane, 6> camera_planes;
+        BoundingShapes::GetFrustumPlanes( camera_projection, camera_planes );
+        m_culling_coherences.resize( 1 + m_light_container.shadow_map_count );
         color_render_component_indices.clear();
-        BoundingShapes::IntersectFrustum( transformed_boxes, camera_projection, color_render_component_indices );
+        CullComponents( camera_planes, blended_camera_position, m_culling_coherences[0], transformed_boxes, color_render_component_indices );
 
         // we support only one light
         assert( m_light_container.entity_ids.size() == 1 );
@@ -1011,6 +1098,10 @@ void RenderWorld::RenderFor( double start_time, float time_step, IndexedOrientat
             m_immediate_context,
             light_buffer,
             light_matrices,
+            [&]( uint32_t shadow_map_index, Range<BoundingShapes::Plane const *> planes, std::vector<uint32_t> & visible_box_indices )
+            {
+                CullComponents( planes, blended_camera_position, m_culling_coherences[1 + shadow_map_index], transformed_boxes, visible_box_indices );
+            },
             shadow_render_component_indices_offsets,
             shadow_render_component_indices );
 
@@ -1498,4 +1589,5 @@ void RenderWorld::AdjustAllPositions(Math::Float3 adjustment)
 {
     m_terrain_3d_data.real_center += adjustment;
     m_terrain_2d_data.center += adjustment;
+    m_static_culling_hierarchy_changed = true;
 }
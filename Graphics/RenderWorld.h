@@ -8,6 +8,7 @@
 #include "2DTerrainConfiguration.h"
 #include "3DTerrainSystemStructs.h"
 #include "ConstantBufferContainer.h"
+#include "FrameTransforms.h"
 #include "IndexBufferContainer.h"
 #include "LightContainer.h"
 #include "MeshFunctions.h"
@@ -19,6 +20,9 @@
 #include "VertexBufferContainer.h"
 #include "WorldConfiguration.h"
 
+#include <BoundingShapes\AxisAlignedBoxBatch.h>
+#include <BoundingShapes\CullingHierarchy.h>
+
 #include <Conventions\Orientation.h>
 #include <Conventions\PoseInfo.h>
 #include <Conventions\EntityID.h>
@@ -30,6 +34,7 @@
 namespace BoundingShapes
 {
     struct OrientedBox;
+    struct Plane;
     struct Sphere;
 }
 
@@ -79,6 +84,24 @@ namespace Graphics
 
         HRTimer m_loop_timer;
 
+        FrameTransforms m_frame_transforms;
+
+        // components that don't move (terrain and grass) are culled with a hierarchy that is kept between frames
+        BoundingShapes::CullingHierarchy m_static_culling_hierarchy;
+        // the component index for each box in the static culling hierarchy
+        std::vector<uint32_t> m_static_component_indices;
+        std::vector<uint32_t> m_dynamic_component_indices;
+        // the boxes of the dynamic and debug components for the current frame and their component indices
+        BoundingShapes::AxisAlignedBoxBatch m_dynamic_box_batch;
+        std::vector<uint32_t> m_dynamic_batch_component_indices;
+        // one for the camera and one for each shadow map
+        std::vector<BoundingShapes::CullingCoherence> m_culling_coherences;
+        std::vector<uint32_t> m_culling_buffer;
+        // set when components are added or removed, so the static and dynamic components are split again
+        bool m_culling_components_changed = true;
+        // set when static components are added, removed or moved, so the hierarchy is rebuilt
+        bool m_static_culling_hierarchy_changed = true;
+
     public:
 
         WorldConfiguration m_world_configuration;
@@ -146,6 +169,18 @@ namespace Graphics
 
         void RenderSky();
 
+        bool IsStaticEntity( EntityID entity_id ) const;
+        // splits the components in static and dynamic ones and rebuilds the static hierarchy if needed, the transforms are relative to the camera position
+        void UpdateCullingComponents( Range<Math::Float4x4 const *> transforms, Math::Float3 camera_position, uint32_t component_count );
+        // appends the sorted indices of the components that intersect with the area contained by the planes
+        // the planes and dynamic box batch are relative to the camera position, the transformed boxes of the visible static components are filled in
+        void CullComponents(
+            Range<BoundingShapes::Plane const *> planes,
+            Math::Float3 camera_position,
+            BoundingShapes::CullingCoherence & coherence,
+            Range<BoundingShapes::AxisAlignedBox *> transformed_boxes,
+            std::vector<uint32_t> & visible_component_indices );
+
         void Render( Range<DisplayTechnique const *> const display_techniques,
                      Range<uint32_t const *> component_indices,
 
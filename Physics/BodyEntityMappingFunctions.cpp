@@ -36,6 +36,49 @@ void Physics::Add(
 }
 
 
+void Physics::Add(
+    Range<EntityID const *> entities,
+    Range<BodyID const *> bodies,
+    BodyEntityMapping& self
+    )
+{
+    assert(Size(entities) == Size(bodies));
+    if(IsEmpty(bodies)) return;
+
+    // store what entity the bodies belong to and count how many bodies each entity gets
+    std::vector<uint32_t> added_counts(Size(self.entity_to_bodies), 0);
+    for(auto i = 0u; i < Size(bodies); ++i)
+    {
+        auto entity = entities[i];
+        EnsureElementExists(bodies[i].index, c_invalid_entity_id, self.entity_ids) = entity;
+        EnsureElementExists(entity.index + 1, Last(self.entity_to_bodies), self.entity_to_bodies);
+        EnsureElementExists(entity.index, 0u, added_counts) += 1;
+    }
+    added_counts.resize(Size(self.entity_to_bodies), 0);
+
+    // move the existing bodies to their new place and remember where the new bodies of each entity go
+    std::vector<BodyID> entity_bodies(Size(self.entity_bodies) + Size(bodies));
+    std::vector<uint32_t> write_positions(Size(self.entity_to_bodies) - 1);
+    uint32_t added = 0;
+    for(auto e = 0u; e < Size(write_positions); ++e)
+    {
+        auto old_start = self.entity_to_bodies[e];
+        auto old_end = self.entity_to_bodies[e + 1];
+        std::copy(begin(self.entity_bodies) + old_start, begin(self.entity_bodies) + old_end, begin(entity_bodies) + old_start + added);
+        write_positions[e] = old_end + added;
+        self.entity_to_bodies[e] += added;
+        added += added_counts[e];
+    }
+    Last(self.entity_to_bodies) += added;
+
+    for(auto i = 0u; i < Size(bodies); ++i)
+    {
+        entity_bodies[write_positions[entities[i].index]++] = bodies[i];
+    }
+    self.entity_bodies = move(entity_bodies);
+}
+
+
 void Physics::Remove(
     Range<EntityID const *> entities,
     BodyEntityMapping& self
@@ -23,6 +23,13 @@ namespace Physics
         BodyEntityMapping& self
         );
 
+    // adds bodies[i] to entities[i] for all i in a single pass over the mapping
+    void Add(
+        Range<EntityID const *> entities,
+        Range<BodyID const *> bodies,
+        BodyEntityMapping& self
+        );
+
     void Remove(
         Range<EntityID const *> entities, 
         BodyEntityMapping& self
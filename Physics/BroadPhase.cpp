@@ -125,6 +125,27 @@ namespace
 
         CreateAxisAlignedBoxHierarchy( transformed_boxes, box_hierarchy );
     }
+
+
+    void AppendBodyAndOrientationPairs(
+        std::vector<std::pair<uint32_t, uint32_t>> const & overlapping_index_pairs,
+        Range<Orientation const *> orientations,
+        Range<BodyID const *> body_ids,
+        std::vector<BodyAndOrientationPair> & output
+        )
+    {
+        auto output_range = Grow(output, Size(overlapping_index_pairs));
+        for (auto i = 0u; i < Size(overlapping_index_pairs); ++i)
+        {
+            auto index_pair = overlapping_index_pairs[i];
+            BodyAndOrientationPair thingy;
+            thingy.body1 = body_ids[index_pair.first];
+            thingy.body2 = body_ids[index_pair.second];
+            thingy.orientation1 = orientations[index_pair.first];
+            thingy.orientation2 = orientations[index_pair.second];
+            output_range[i] = thingy;
+        }
+    }
 }
 
 void Physics::BroadPhaseCollisionDetection(
@@ -145,7 +166,8 @@ void Physics::BroadPhaseCollisionDetection(
     BoundingShapes::AxisAlignedBoxHierarchy aabh;
     std::vector<BoundingShapes::AxisAlignedBox> transformed_boxes;
     UpdateAxisAlignedBoxHierarchy(static_boxes, dynamic_boxes, dynamic_orientations, aabh, transformed_boxes);
-    BroadPhaseCollisionDetection(transformed_boxes, aabh, orientations, body_ids, static_entity_count, output);
+    std::vector<std::pair<uint32_t, uint32_t>> overlapping_index_pairs;
+    BroadPhaseCollisionDetection(transformed_boxes, aabh, orientations, body_ids, static_entity_count, overlapping_index_pairs, output);
 }
 
 
@@ -155,26 +177,52 @@ void Physics::BroadPhaseCollisionDetection(
         Range<Orientation const *> orientations,
         Range<BodyID const *> body_ids,
         uint32_t static_entity_count,
+        std::vector<std::pair<uint32_t, uint32_t>> & overlapping_index_pairs,
         std::vector<BodyAndOrientationPair> & output)
 {
     assert(Size(transformed_boxes) == Size(orientations));
     assert(Size(transformed_boxes) == Size(body_ids));
     assert(Size(transformed_boxes) >= static_entity_count);
 
-    std::vector<std::pair<uint32_t, uint32_t>> overlapping_index_pairs;
+    overlapping_index_pairs.clear();
     DetectOverlappingPairs( box_hierarchy, transformed_boxes, static_entity_count, overlapping_index_pairs);
 
-    auto output_range = Grow(output, Size(overlapping_index_pairs));
-    for (auto i = 0u; i < Size(overlapping_index_pairs); ++i)
+    AppendBodyAndOrientationPairs(overlapping_index_pairs, orientations, body_ids, output);
+}
+
+
+void Physics::BroadPhaseCollisionDetection(
+        Range<BoundingShapes::AxisAlignedBox const *> transformed_boxes,
+        BoundingShapes::AxisAlignedBoxHierarchy const & static_box_hierarchy,
+        BoundingShapes::AxisAlignedBoxHierarchy const & dynamic_box_hierarchy,
+        Range<Orientation const *> orientations,
+        Range<BodyID const *> body_ids,
+        uint32_t static_entity_count,
+        std::vector<std::pair<uint32_t, uint32_t>> & overlapping_index_pairs,
+        std::vector<BodyAndOrientationPair> & output)
+{
+    assert(Size(transformed_boxes) == Size(orientations));
+    assert(Size(transformed_boxes) == Size(body_ids));
+    assert(Size(transformed_boxes) >= static_entity_count);
+
+    auto static_boxes = CreateRange(transformed_boxes, 0, static_entity_count);
+    auto dynamic_boxes = CreateRange(transformed_boxes, static_entity_count);
+
+    // dynamic against dynamic, then dynamic against static, the dynamic index comes first like with a single hierarchy
+    overlapping_index_pairs.clear();
+    DetectOverlappingPairs( dynamic_box_hierarchy, dynamic_boxes, 0, overlapping_index_pairs);
+    auto dynamic_pair_count = Size(overlapping_index_pairs);
+    if( !IsEmpty(static_boxes) )
     {
-        auto index_pair = overlapping_index_pairs[i];
-        BodyAndOrientationPair thingy;
-        thingy.body1 = body_ids[index_pair.first];
-        thingy.body2 = body_ids[index_pair.second];
-        thingy.orientation1 = orientations[index_pair.first];
-        thingy.orientation2 = orientations[index_pair.second];
-        output_range[i] = thingy;
+        DetectOverlappingPairs( dynamic_boxes, static_box_hierarchy, static_boxes, overlapping_index_pairs);
     }
+    for( auto i = 0u; i < Size(overlapping_index_pairs); ++i )
+    {
+        overlapping_index_pairs[i].first += static_entity_count;
+        if( i < dynamic_pair_count ) overlapping_index_pairs[i].second += static_entity_count;
+    }
+
+    AppendBodyAndOrientationPairs(overlapping_index_pairs, orientations, body_ids, output);
 }
 
 
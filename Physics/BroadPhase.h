@@ -57,12 +57,30 @@ namespace Physics
 
 
     // assumes the static entities come first in the ranges
+    // overlapping_index_pairs is only used as temporary storage, pass the same vector every time to reuse its memory
     void BroadPhaseCollisionDetection(
         Range<BoundingShapes::AxisAlignedBox const *> transformed_boxes,
         BoundingShapes::AxisAlignedBoxHierarchy const & box_hierarchy,
         Range<Orientation const *> orientations,
         Range<BodyID const *> body_ids,
         uint32_t static_entity_count,
+        std::vector<std::pair<uint32_t, uint32_t>> & overlapping_index_pairs,
+        std::vector<BodyAndOrientationPair> & output
+        );
+
+
+    // assumes the static entities come first in the ranges
+    // the static hierarchy indexes the static boxes, the dynamic hierarchy the dynamic boxes counted from static_entity_count,
+    // so the static one can be kept as long as the static bodies don't change
+    // overlapping_index_pairs is only used as temporary storage, pass the same vector every time to reuse its memory
+    void BroadPhaseCollisionDetection(
+        Range<BoundingShapes::AxisAlignedBox const *> transformed_boxes,
+        BoundingShapes::AxisAlignedBoxHierarchy const & static_box_hierarchy,
+        BoundingShapes::AxisAlignedBoxHierarchy const & dynamic_box_hierarchy,
+        Range<Orientation const *> orientations,
+        Range<BodyID const *> body_ids,
+        uint32_t static_entity_count,
+        std::vector<std::pair<uint32_t, uint32_t>> & overlapping_index_pairs,
         std::vector<BodyAndOrientationPair> & output
         );
 
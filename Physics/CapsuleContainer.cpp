@@ -0,0 +1,78 @@
+
+#include "CapsuleContainer.h"
+
+#include <Utilities\IndexedHelp.h>
+#include <Utilities\VectorHelper.h>
+#include <Utilities\ContainerHelpers.h>
+
+using namespace Physics;
+using namespace BoundingShapes;
+
+
+namespace
+{
+    uint32_t CapsuleCount( uint32_t index, CapsuleContainer const & self )
+    {
+        return self.offsets[index + 1] - self.offsets[index];
+    }
+}
+
+Physics::CapsuleContainer::CapsuleContainer()
+{
+    Append(offsets, 0u);
+}
+
+
+void Physics::AddCapsule(BodyID body, Capsule capsule, CapsuleContainer & self)
+{
+    AddCapsules(body, CreateRange(&capsule, 1), self);
+}
+
+
+void Physics::AddCapsules(BodyID body, Range<BoundingShapes::Capsule const*> capsules, CapsuleContainer & self)
+{
+    assert(!Contains(body, self));
+    Append(self.capsules, capsules);
+    Append(self.bodies, body, Size(capsules));
+    Append(self.offsets, uint32_t(Size(self.capsules)));
+    AddIndexToIndices( self.body_to_offset, body.index, uint32_t(Size(self.offsets) - 2));
+}
+
+
+void Physics::Remove(Range<BodyID const*> bodies, CapsuleContainer & self)
+{
+    // a body with as many capsules as the last body is replaced by it, only the others need the compacting removal below
+    std::vector<BodyID> compacted_bodies;
+    for( auto body : bodies )
+    {
+        auto index = GetOptional( self.body_to_offset, body.index );
+        if( index == c_invalid_index ) continue;
+        auto last_index = uint32_t( Size( self.offsets ) - 2 );
+        auto count = CapsuleCount( index, self );
+        if( count == 0 || count != CapsuleCount( last_index, self ) )
+        {
+            compacted_bodies.push_back( body );
+            continue;
+        }
+        auto last_body = self.bodies.back();
+        SwapAndPruneBlock( index, self.offsets, self.capsules );
+        SwapAndPruneBlock( index, self.offsets, self.bodies );
+        self.offsets.pop_back();
+        self.body_to_offset[last_body.index] = index;
+        self.body_to_offset[body.index] = c_invalid_index;
+    }
+
+    Range<BodyID const *> compacted_range = CreateRange( compacted_bodies );
+    auto indices = RemoveIndices( self.body_to_offset, compacted_range );
+    std::sort( begin( indices ), end( indices ) );
+
+    RemoveEntries( self.capsules, self.offsets, indices );
+    RemoveEntries( self.bodies, self.offsets, indices );
+    RemoveOffsets( self.offsets, indices );
+}
+
+
+bool Physics::Contains( BodyID id, CapsuleContainer const & self )
+{
+    return GetOptional(self.body_to_offset, id.index) != c_invalid_index;
+}
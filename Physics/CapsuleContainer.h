@@ -0,0 +1,27 @@
+#pragma once
+
+#include "BodyID.h"
+#include <BoundingShapes\Capsule.h>
+#include <Utilities\Range.h>
+
+#include <vector>
+
+namespace Physics
+{
+    struct CapsuleContainer
+    {
+        std::vector<BoundingShapes::Capsule> capsules;
+
+        std::vector<uint32_t> offsets;
+        std::vector<BodyID> bodies;
+        std::vector<uint32_t> body_to_offset;
+
+        CapsuleContainer();
+    };
+
+
+    void AddCapsule(BodyID body, BoundingShapes::Capsule capsule, CapsuleContainer & self);
+    void AddCapsules(BodyID body, Range<BoundingShapes::Capsule const*> capsules, CapsuleContainer & self);
+    void Remove(Range<BodyID const*> bodies, CapsuleContainer & self);
+    bool Contains(BodyID id, CapsuleContainer const & self );
+}
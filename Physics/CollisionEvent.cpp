@@ -4,11 +4,13 @@
 
 #include <Math\FloatOperators.h>
 
+#include <Utilities\FrameArena.h>
+#include <Utilities\InvalidIndex.h>
 #include <Utilities\VectorHelper.h>
 #include <Utilities\IntegerIterator.h>
 #include <Utilities\Memory.h>
 
-#include <memory>
+#include <algorithm>
 
 using namespace Physics;
 
@@ -36,23 +38,24 @@ void Resize(size_t size, CollisionEvents & ce)
 }
 
 
-void Reorder(Range<uint32_t const *> indices, CollisionEvents & ce)
+void Reorder(Range<uint32_t const *> indices, FrameArena & arena, CollisionEvents & ce)
 {
     auto size = ce.bodies.size();
     // allocate enough memory to use as temporary buffer for all three vectors
     constexpr auto max_size = std::max(std::max(sizeof(BodyPair), sizeof(Math::Float3)), std::max(sizeof(Manifold), sizeof(uint8_t)));
-    auto data_buffer = std::make_unique<uint8_t[]>(size * max_size);
+    constexpr auto max_alignment = std::max(std::max(alignof(BodyPair), alignof(Math::Float3)), alignof(Manifold));
+    auto data_buffer = static_cast<uint8_t*>(arena.Allocate(size * max_size, max_alignment));
     // copy and reorder each vector
     // bodies
-    auto entity_buffer = static_cast<BodyPair*>(static_cast<void*>(data_buffer.get()));
+    auto entity_buffer = static_cast<BodyPair*>(static_cast<void*>(data_buffer));
     Copy(ce.bodies.data(), size, entity_buffer);
     ::Reorder<BodyPair>(CreateRange(entity_buffer, size), indices, ce.bodies);
     // positions
-    auto position_buffer = static_cast<Math::Float3*>(static_cast<void*>(data_buffer.get()));
+    auto position_buffer = static_cast<Math::Float3*>(static_cast<void*>(data_buffer));
     Copy(ce.relative_positions.data(), size, position_buffer);
     ::Reorder<Math::Float3>(CreateRange(position_buffer, size), indices, ce.relative_positions);
     // manifolds
-    auto manifold_buffer = static_cast<Manifold*>(static_cast<void*>(data_buffer.get()));
+    auto manifold_buffer = static_cast<Manifold*>(static_cast<void*>(data_buffer));
     Copy(ce.manifolds.data(), size, manifold_buffer);
     ::Reorder<Manifold>(CreateRange(manifold_buffer, size), indices, ce.manifolds);
 }
@@ -99,3 +102,72 @@ void PutHigherOrderBodyFirst( Range<uint32_t const *> body_to_order, CollisionEv
         return body_to_order[bodies.id1.index] < body_to_order[bodies.id2.index];
     });
 }
+
+
+namespace
+{
+    uint32_t HashTableSize(uint32_t event_count)
+    {
+        // a power of two that keeps the table at most half full
+        auto size = 16u;
+        while(size < 2 * event_count)
+        {
+            size *= 2;
+        }
+        return size;
+    }
+
+
+    uint32_t Hash(BodyPair bodies, uint32_t table_mask)
+    {
+        auto const key = (uint64_t(bodies.id1.index) << 32) | bodies.id2.index;
+        return uint32_t((key * 0x9E3779B97F4A7C15ull) >> 32) & table_mask;
+    }
+}
+
+
+void RemoveDuplicates(CollisionEvents & events, FrameArena & arena)
+{
+    // first make sure the first entity is always smaller
+    FlipIf(events, [](auto const & bodies)
+    {
+        return bodies.id1.index < bodies.id2.index;
+    });
+
+    // open addressing with linear probing, each slot holds the index of the first event with its bodies
+    auto const size = uint32_t(Size(events.bodies));
+    auto const table_size = HashTableSize(size);
+    auto table = AllocateRange<uint32_t>(arena, table_size);
+    std::fill(begin(table), end(table), c_invalid_index);
+    auto kept_indices = AllocateRange<uint32_t>(arena, size);
+    auto kept_count = 0u;
+
+    for(auto i = 0u; i < size; ++i)
+    {
+        auto const bodies = events.bodies[i];
+        for(auto slot = Hash(bodies, table_size - 1); ; slot = (slot + 1) & (table_size - 1))
+        {
+            auto const first = table[slot];
+            if(first == c_invalid_index)
+            {
+                table[slot] = i;
+                kept_indices[kept_count] = i;
+                ++kept_count;
+                break;
+            }
+            if(events.bodies[first] == bodies)
+            {
+                events.manifolds[first] = MergeManifolds(events.manifolds[first], events.manifolds[i]);
+                break;
+            }
+        }
+    }
+
+    if(kept_count == size)
+    {
+        return;
+    }
+    kept_indices.stop = kept_indices.start + kept_count;
+    Reorder(kept_indices, arena, events);
+    Resize(kept_count, events);
+}
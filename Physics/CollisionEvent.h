@@ -7,6 +7,8 @@
 
 #include <vector>
 
+class FrameArena;
+
 namespace Physics
 {
     struct CollisionEvents
@@ -24,11 +26,16 @@ namespace Physics
 void Clear(Physics::CollisionEvents & ce);
 uint32_t Size(Physics::CollisionEvents const & ce);
 void Resize(size_t size, Physics::CollisionEvents & ce);
-void Reorder(Range<uint32_t const *> indices, Physics::CollisionEvents & ce);
+// the arena is used for the temporary copy of the events
+void Reorder(Range<uint32_t const *> indices, FrameArena & arena, Physics::CollisionEvents & ce);
 void Append(Physics::CollisionEvents & a, Physics::CollisionEvents const & b);
 void Flip(Physics::BodyPair & bodies, Math::Float3 & relative_position, Manifold & manifold);
 void PutLowerOrderBodyFirst(Range<uint32_t const *> body_to_order, Physics::CollisionEvents & events);
 void PutHigherOrderBodyFirst(Range<uint32_t const *> body_to_order, Physics::CollisionEvents & events);
+// merges the manifolds of events with the same bodies into the first of them and removes the others
+// puts the body with the higher index first, otherwise the order of the events is kept
+// the hash table is allocated from the arena
+void RemoveDuplicates(Physics::CollisionEvents & events, FrameArena & arena);
 
 
 template<typename CompareFunction>
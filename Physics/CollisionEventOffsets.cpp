@@ -2,9 +2,11 @@
 #include "CollisionEvent.h"
 #include "ManifoldFunctions.h"
 
+#include <Utilities\FrameArena.h>
 #include <Utilities\IntegerIterator.h>
 #include <Utilities\IntegerRange.h>
 #include <algorithm>
+#include <numeric>
 
 using namespace Physics;
 
@@ -13,13 +15,15 @@ void Physics::SortAndCatagorize(
     CollisionEventOffsets& collision_event_ranges,
     Range<uint32_t const *> body_to_index,
     uint32_t kinematic_body_start_index,
-    uint32_t rigid_body_start_index )
+    uint32_t rigid_body_start_index,
+    FrameArena & arena )
 {
     assert(kinematic_body_start_index <= rigid_body_start_index);
     PutHigherOrderBodyFirst( body_to_index, collision_events );
 
     auto size = uint32_t(Size(collision_events.bodies));
-    std::vector<uint32_t> indices(IntegerIterator<uint32_t>(0), IntegerIterator<uint32_t>(size));
+    auto indices = AllocateRange<uint32_t>(arena, size);
+    std::iota(begin(indices), end(indices), 0u);
 
     auto kinematic_static_start = begin( indices );
 
@@ -74,7 +78,7 @@ void Physics::SortAndCatagorize(
     std::sort(rigid_static_start, rigid_rigid_start, body_comparer);
     std::sort(rigid_rigid_start, end(indices), body_comparer);
 
-    Reorder(indices, collision_events);
+    Reorder(indices, arena, collision_events);
     collision_event_ranges.kinematic_static = uint32_t(kinematic_static_start - begin(indices));
     collision_event_ranges.kinematic_kinematic = uint32_t(kinematic_kinematic_start - begin(indices));
     collision_event_ranges.rigid_kinematic = uint32_t(rigid_kinematic_start - begin(indices));
@@ -5,6 +5,8 @@
 #include <vector>
 #include <cstdint>
 
+class FrameArena;
+
 namespace Physics
 {
     struct CollisionEvents;
@@ -98,7 +100,9 @@ namespace Physics
         CollisionEventOffsets& collision_event_offsets,
         Range<uint32_t const *> body_to_index,
         uint32_t kinematic_body_start_index,
-        uint32_t rigid_body_start_index );
+        uint32_t rigid_body_start_index,
+        // for temporary buffers
+        FrameArena & arena );
 
 
     void MergeEventManifolds(
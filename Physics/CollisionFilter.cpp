@@ -0,0 +1,269 @@
+#include "CollisionFilter.h"
+
+#include <Math\SSE.h>
+
+#include <Utilities\VectorHelper.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace Physics
+{
+    namespace
+    {
+        uint64_t const c_empty_slot = ~0ull;
+        uint32_t const c_minimum_table_size = 16;
+
+
+        uint64_t PairKey(uint32_t index1, uint32_t index2)
+        {
+            auto const low = std::min(index1, index2);
+            auto const high = std::max(index1, index2);
+            return (uint64_t(low) << 32) | high;
+        }
+
+
+        uint32_t HomeSlot(uint64_t key, size_t table_size)
+        {
+            return uint32_t((key * 0x9E3779B97F4A7C15ull) >> 32) & uint32_t(table_size - 1);
+        }
+
+
+        uint32_t NextSlot(uint32_t slot, size_t table_size)
+        {
+            return (slot + 1) & uint32_t(table_size - 1);
+        }
+
+
+        // returns the slot with the key, or the empty slot where it would be inserted
+        uint32_t FindSlot(uint64_t key, std::vector<uint64_t> const & table)
+        {
+            auto slot = HomeSlot(key, table.size());
+            while(table[slot] != key && table[slot] != c_empty_slot)
+            {
+                slot = NextSlot(slot, table.size());
+            }
+            return slot;
+        }
+
+
+        void Rehash(size_t table_size, CollisionFilter & self)
+        {
+            std::vector<uint64_t> table(table_size, c_empty_slot);
+            for(auto key : self.excluded_pairs)
+            {
+                if(key != c_empty_slot)
+                {
+                    table[FindSlot(key, table)] = key;
+                }
+            }
+            swap(table, self.excluded_pairs);
+        }
+
+
+        void RemoveKey(uint64_t key, CollisionFilter & self)
+        {
+            auto & table = self.excluded_pairs;
+            auto slot = FindSlot(key, table);
+            if(table[slot] == c_empty_slot)
+            {
+                return;
+            }
+            // shift the following keys back, so no probe sequence passes an empty slot before reaching its key
+            auto empty = slot;
+            for(auto next = NextSlot(empty, table.size()); table[next] != c_empty_slot; next = NextSlot(next, table.size()))
+            {
+                auto const home = HomeSlot(table[next], table.size());
+                auto const distance_to_empty = (empty - home) & uint32_t(table.size() - 1);
+                auto const distance_to_next = (next - home) & uint32_t(table.size() - 1);
+                if(distance_to_empty < distance_to_next)
+                {
+                    table[empty] = table[next];
+                    empty = next;
+                }
+            }
+            table[empty] = c_empty_slot;
+            --self.excluded_pair_count;
+            --self.exclusion_counts[uint32_t(key >> 32)];
+            --self.exclusion_counts[uint32_t(key)];
+        }
+
+
+        template<typename Type>
+        void GrowToInclude(uint32_t index, Type default_value, std::vector<Type> & values)
+        {
+            if(index >= values.size())
+            {
+                values.resize(index + 1, default_value);
+            }
+        }
+
+
+        uint32_t Layer(uint32_t body_index, CollisionFilter const & self)
+        {
+            return GetOptional(self.layers, body_index, c_default_collision_layer);
+        }
+
+
+        uint32_t Mask(uint32_t body_index, CollisionFilter const & self)
+        {
+            return GetOptional(self.masks, body_index, c_all_collision_layers);
+        }
+
+
+        uint32_t ExclusionCount(uint32_t body_index, CollisionFilter const & self)
+        {
+            return GetOptional(self.exclusion_counts, body_index, 0u);
+        }
+
+
+        // returns a bit for each of the four pairs that has to be checked against the excluded pairs
+        // and clears the bits of the pairs whose layers and masks don't match
+        unsigned TestLayers(BodyAndOrientationPair const * pairs, CollisionFilter const & self, unsigned & keep_mask)
+        {
+            using namespace Math::SSE;
+            alignas(16) uint32_t layers1[4], masks1[4], counts1[4], layers2[4], masks2[4], counts2[4];
+            for(auto i = 0u; i < 4; ++i)
+            {
+                auto const index1 = pairs[i].body1.index;
+                auto const index2 = pairs[i].body2.index;
+                layers1[i] = Layer(index1, self);
+                masks1[i] = Mask(index1, self);
+                counts1[i] = ExclusionCount(index1, self);
+                layers2[i] = Layer(index2, self);
+                masks2[i] = Mask(index2, self);
+                counts2[i] = ExclusionCount(index2, self);
+            }
+            auto const zero = SetAll(0u);
+            auto const blocked = Or(
+                Equal32Bit(And(Load(layers1), Load(masks2)), zero),
+                Equal32Bit(And(Load(layers2), Load(masks1)), zero));
+            auto const no_exclusions = Or(Equal32Bit(Load(counts1), zero), Equal32Bit(Load(counts2), zero));
+            keep_mask = ~MaskSignBits(CastToFloatFromInteger(blocked)) & 0xf;
+            return ~MaskSignBits(CastToFloatFromInteger(no_exclusions)) & keep_mask;
+        }
+    }
+
+
+    void SetLayer(BodyID body, uint32_t layer, uint32_t mask, CollisionFilter & self)
+    {
+        GrowToInclude(body.index, c_default_collision_layer, self.layers);
+        GrowToInclude(body.index, c_all_collision_layers, self.masks);
+        self.layers[body.index] = layer;
+        self.masks[body.index] = mask;
+    }
+
+
+    void AddExcludedPair(BodyID body1, BodyID body2, CollisionFilter & self)
+    {
+        if(2 * (self.excluded_pair_count + 1) > self.excluded_pairs.size())
+        {
+            Rehash(std::max<size_t>(c_minimum_table_size, 2 * self.excluded_pairs.size()), self);
+        }
+        auto const key = PairKey(body1.index, body2.index);
+        auto const slot = FindSlot(key, self.excluded_pairs);
+        if(self.excluded_pairs[slot] == key)
+        {
+            return;
+        }
+        self.excluded_pairs[slot] = key;
+        ++self.excluded_pair_count;
+        GrowToInclude(std::max(body1.index, body2.index), 0u, self.exclusion_counts);
+        ++self.exclusion_counts[body1.index];
+        ++self.exclusion_counts[body2.index];
+    }
+
+
+    void RemoveExcludedPair(BodyID body1, BodyID body2, CollisionFilter & self)
+    {
+        if(self.excluded_pair_count == 0)
+        {
+            return;
+        }
+        RemoveKey(PairKey(body1.index, body2.index), self);
+    }
+
+
+    bool IsExcludedPair(BodyID body1, BodyID body2, CollisionFilter const & self)
+    {
+        if(ExclusionCount(body1.index, self) == 0 || ExclusionCount(body2.index, self) == 0)
+        {
+            return false;
+        }
+        auto const key = PairKey(body1.index, body2.index);
+        return self.excluded_pairs[FindSlot(key, self.excluded_pairs)] == key;
+    }
+
+
+    void Remove(Range<BodyID const *> bodies, CollisionFilter & self)
+    {
+        for(auto body : bodies)
+        {
+            if(body.index < self.layers.size())
+            {
+                self.layers[body.index] = c_default_collision_layer;
+                self.masks[body.index] = c_all_collision_layers;
+            }
+            if(ExclusionCount(body.index, self) == 0)
+            {
+                continue;
+            }
+            // removing keys moves others around, so collect them first
+            std::vector<uint64_t> keys;
+            for(auto key : self.excluded_pairs)
+            {
+                if(key != c_empty_slot && (uint32_t(key >> 32) == body.index || uint32_t(key) == body.index))
+                {
+                    keys.push_back(key);
+                }
+            }
+            for(auto key : keys)
+            {
+                RemoveKey(key, self);
+            }
+        }
+    }
+
+
+    bool CanCollide(BodyID body1, BodyID body2, CollisionFilter const & self)
+    {
+        return
+            (Layer(body1.index, self) & Mask(body2.index, self)) != 0 &&
+            (Layer(body2.index, self) & Mask(body1.index, self)) != 0 &&
+            !IsExcludedPair(body1, body2, self);
+    }
+
+
+    size_t Filter(CollisionFilter const & self, Range<BodyAndOrientationPair *> pairs)
+    {
+        auto const size = Size(pairs);
+        auto kept = size_t(0);
+        auto i = size_t(0);
+        for(; i + 4 <= size; i += 4)
+        {
+            unsigned keep_mask;
+            auto const check_exclusion = TestLayers(begin(pairs) + i, self, keep_mask);
+            for(auto lane = 0u; lane < 4; ++lane)
+            {
+                auto const & pair = pairs[i + lane];
+                if((check_exclusion & (1u << lane)) && IsExcludedPair(pair.body1, pair.body2, self))
+                {
+                    keep_mask &= ~(1u << lane);
+                }
+                // branch free compaction, the pair is always written but only kept if its bit is set
+                pairs[kept] = pair;
+                kept += (keep_mask >> lane) & 1u;
+            }
+        }
+        for(; i < size; ++i)
+        {
+            auto const & pair = pairs[i];
+            if(CanCollide(pair.body1, pair.body2, self))
+            {
+                pairs[kept] = pair;
+                ++kept;
+            }
+        }
+        return kept;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "BodyAndOrientationPair.h"
+#include "BodyID.h"
+
+#include <Utilities\Range.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Physics
+{
+    uint32_t const c_default_collision_layer = 1;
+    uint32_t const c_all_collision_layers = ~0u;
+
+    // decides which of the candidate pairs from the broad phase have to go through the narrow phase
+    // two bodies can collide if the layer of each body is in the mask of the other one and the pair isn't excluded
+    struct CollisionFilter
+    {
+        // indexed by body index, bodies past the end have the default layer and collide with all layers
+        std::vector<uint32_t> layers;
+        std::vector<uint32_t> masks;
+        // number of excluded pairs each body is part of, the set only has to be searched if both bodies are in one
+        std::vector<uint32_t> exclusion_counts;
+        // open addressing hash set with linear probing, the keys are the packed body indices of the excluded pairs
+        std::vector<uint64_t> excluded_pairs;
+        uint32_t excluded_pair_count = 0;
+    };
+
+
+    void SetLayer(BodyID body, uint32_t layer, uint32_t mask, CollisionFilter & self);
+    // the pairs are symmetric, excluding a pair that is already excluded does nothing
+    void AddExcludedPair(BodyID body1, BodyID body2, CollisionFilter & self);
+    void RemoveExcludedPair(BodyID body1, BodyID body2, CollisionFilter & self);
+    bool IsExcludedPair(BodyID body1, BodyID body2, CollisionFilter const & self);
+    // resets the layers of the bodies and removes all excluded pairs with them
+    void Remove(Range<BodyID const *> bodies, CollisionFilter & self);
+
+    bool CanCollide(BodyID body1, BodyID body2, CollisionFilter const & self);
+    // removes the pairs that can't collide, the remaining pairs keep their order, returns the number of remaining pairs
+    size_t Filter(CollisionFilter const & self, Range<BodyAndOrientationPair *> pairs);
+}
@@ -17,32 +17,37 @@
 // input:
 // - plane_normals & plane_origins,
 // - vertices, each vertex forms an edge with the subsequent vertex
-std::vector<Math::Float3> SutherlandHodgman( Range<BoundingShapes::Plane const *> planes, Range<Math::Float3 const*> vertices )
+size_t SutherlandHodgman( Range<BoundingShapes::Plane const *> planes, Range<Math::Float3 const*> vertices, std::array<Math::Float3, c_max_clipped_vertex_count> & clipped_vertices )
 {
     assert( Size( vertices ) > 0 );
+    assert( Size( vertices ) + Size( planes ) <= c_max_clipped_vertex_count );
 
-    std::vector<Math::Float3> clipped_vertices( begin( vertices ), end( vertices ) ), temp;
+    std::copy( begin( vertices ), end( vertices ), begin( clipped_vertices ) );
+    auto clipped_count = Size( vertices );
+    std::array<Math::Float3, c_max_clipped_vertex_count> temp;
+    auto temp_count = size_t( 0 );
 
     auto normal_count = Size( planes );
-    for( auto i = 0u; i < normal_count && !IsEmpty(clipped_vertices); ++i )
+    for( auto i = 0u; i < normal_count && clipped_count > 0; ++i )
     {
         auto plane = planes[i];
-        auto v0 = Last( clipped_vertices );
+        auto v0 = clipped_vertices[clipped_count - 1];
         auto distance0 = Distance(plane, v0);
-        for( auto v1 : clipped_vertices )
+        for( auto j = size_t( 0 ); j < clipped_count; ++j )
         {
+            auto v1 = clipped_vertices[j];
             auto distance1 = Distance( plane, v1 );
 
             if( distance0 < 0 )
             {
                 if( distance1 < 0 )
                 {
-                    temp.push_back( v1 );
+                    temp[temp_count++] = v1;
                 }
                 else
                 {
                     auto intersect_factor = distance0 / ( distance0 - distance1 );
-                    temp.push_back( Lerp( v0, v1, intersect_factor ) );
+                    temp[temp_count++] = Lerp( v0, v1, intersect_factor );
                 }
             }
             else
@@ -51,19 +56,20 @@ std::vector<Math::Float3> SutherlandHodgman( Range<BoundingShapes::Plane const *
                 {
                     // Start >= 0, end < 0 so output intersection and end
                     auto intersect_factor = distance0 / ( distance0 - distance1 );
-                    temp.push_back( Lerp( v0, v1, intersect_factor ) );
-                    temp.push_back( v1 );
+                    temp[temp_count++] = Lerp( v0, v1, intersect_factor );
+                    temp[temp_count++] = v1;
                 }
             }
 
             v0 = v1;
             distance0 = distance1;
         }
-        swap( clipped_vertices, temp );
-        temp.clear();
+        std::copy( begin( temp ), begin( temp ) + temp_count, begin( clipped_vertices ) );
+        clipped_count = temp_count;
+        temp_count = 0;
     }
 
-    return clipped_vertices;
+    return clipped_count;
 }
 
 
@@ -227,10 +233,11 @@ uint8_t FindContactPoints( Math::Float3 extent, BoundingShapes::Triangle triangl
         }
         vertices[max_index + 1] = triangle.corners[max_index] + edges[max_index] * 0.5f;
 
-        auto clipped_vertices = SutherlandHodgman( planes, vertices);
+        std::array<Math::Float3, c_max_clipped_vertex_count> clipped_vertices;
+        auto clipped_count = SutherlandHodgman( planes, vertices, clipped_vertices );
         auto clip_normal = aligned_face_normals[face_index];
         auto plane = BoundingShapes::CreatePlane(clip_normal, CopySign(extent, clip_normal));
-        auto size_clipped_vertices = DiscardVertices( plane, clipped_vertices );
+        auto size_clipped_vertices = DiscardVertices( plane, CreateRange( clipped_vertices.data(), clipped_count ) );
         auto contact_point_count = uint8_t( std::min( size_clipped_vertices, Size( output_contact_points ) ) );
         Copy( clipped_vertices.data(), contact_point_count, begin(output_contact_points));
         return contact_point_count;
@@ -240,9 +247,10 @@ uint8_t FindContactPoints( Math::Float3 extent, BoundingShapes::Triangle triangl
         std::array<BoundingShapes::Plane, 3> planes;
         MakePlaneEquations( triangle, planes );
         auto vertices = GetFaceCorners( aligned_box, face_index );
-        auto clipped_vertices = SutherlandHodgman( planes, vertices );
+        std::array<Math::Float3, c_max_clipped_vertex_count> clipped_vertices;
+        auto clipped_count = SutherlandHodgman( planes, vertices, clipped_vertices );
         auto plane = BoundingShapes::CreatePlane(triangle_normal, GetCenter(triangle));
-        auto size_clipped_vertices = DiscardVertices( plane, clipped_vertices );
+        auto size_clipped_vertices = DiscardVertices( plane, CreateRange( clipped_vertices.data(), clipped_count ) );
         auto contact_point_count = uint8_t( std::min( size_clipped_vertices, Size(output_contact_points) ) );
         Copy( clipped_vertices.data(), contact_point_count, begin( output_contact_points ) );
         return contact_point_count;
@@ -13,10 +13,15 @@
 #include <array>
 #include <cstdint>
 
+// clipping by a plane adds at most one vertex, so this is enough for a quad clipped by four planes
+static const size_t c_max_clipped_vertex_count = 8;
+
 // input:
 // - plane_normals & plane_origins,
 // - vertices, each vertex forms an edge with the subsequent vertex
-std::vector<Math::Float3> SutherlandHodgman( Range<BoundingShapes::Plane const *> planes, Range<Math::Float3 const*> vertices );
+// writes the clipped vertices to the output and returns their count,
+// the vertex count plus the plane count should not exceed c_max_clipped_vertex_count
+size_t SutherlandHodgman( Range<BoundingShapes::Plane const *> planes, Range<Math::Float3 const*> vertices, std::array<Math::Float3, c_max_clipped_vertex_count> & clipped_vertices );
 
 // returns the number of contact points and outputs the contact points
 uint8_t FindContactPoints( Math::Float3 extent, BoundingShapes::Triangle triangle, Math::Float3 separation_axis, Range<Math::Float3*> output_contact_points );
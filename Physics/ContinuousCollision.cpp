@@ -0,0 +1,41 @@
+#include "ContinuousCollision.h"
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <algorithm>
+
+namespace Physics
+{
+    bool CreateSweep(Orientation const & previous, Orientation const & current, BoundingShapes::AxisAlignedBox const & local_bounds, Sweep & sweep)
+    {
+        auto motion = current.position - previous.position;
+        sweep.length = Norm(motion);
+        sweep.thickness = std::min({local_bounds.extent.x, local_bounds.extent.y, local_bounds.extent.z});
+        if(!(sweep.length > sweep.thickness))
+        {
+            return false;
+        }
+        sweep.path = {previous.position, motion / sweep.length};
+        return true;
+    }
+
+
+    Orientation ClampToImpact(Sweep const & sweep, float impact_time, Orientation current)
+    {
+        auto time = std::max(impact_time - sweep.thickness / 2, 0.f);
+        current.position = sweep.path.start + sweep.path.direction * time;
+        return current;
+    }
+
+
+    Movement RemoveImpactMomentum(Movement movement, Math::Float3 normal)
+    {
+        auto into_surface = Dot(movement.momentum, normal);
+        if(into_surface < 0)
+        {
+            movement.momentum -= into_surface * normal;
+        }
+        return movement;
+    }
+}
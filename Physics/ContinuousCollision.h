@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Movement.h"
+
+#include <BoundingShapes\AxisAlignedBox.h>
+#include <BoundingShapes\Ray.h>
+#include <Conventions\Orientation.h>
+
+namespace Physics
+{
+    // the path of the center of a body during a step
+    struct Sweep
+    {
+        BoundingShapes::Ray path;
+        float length;
+        // smallest half extent of the body, the discrete collision detection can't miss anything closer than this
+        float thickness;
+    };
+
+    // returns false if the body moved less than its thickness, the discrete collision detection handles those
+    bool CreateSweep(Orientation const & previous, Orientation const & current, BoundingShapes::AxisAlignedBox const & local_bounds, Sweep & sweep);
+
+    // moves the body back to where its center hits at impact_time along the path,
+    // a bit into the surface so the discrete collision detection finds the contact in the next step
+    Orientation ClampToImpact(Sweep const & sweep, float impact_time, Orientation current);
+
+    // removes the momentum into the surface with the normal
+    Movement RemoveImpactMomentum(Movement movement, Math::Float3 normal);
+}
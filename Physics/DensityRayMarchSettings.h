@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Physics
+{
+    // limits of ray casts through density functions
+    struct DensityRayMarchSettings
+    {
+        // upper bound of the gradient length of the density functions
+        // steps of |density| / lipschitz_bound can't pass the surface, larger values take smaller steps
+        float lipschitz_bound;
+        // rays that haven't hit anything within this distance miss
+        float max_length;
+        // a cast takes at most max_steps evaluations before refining the hit, rays that need more steps miss,
+        // which happens when grazing a surface over a long distance
+        uint32_t max_steps;
+        // the hit is refined until it is known within this distance, steps are at least this long,
+        // so features thinner than it can be missed
+        float accuracy;
+    };
+}
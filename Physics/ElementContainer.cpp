@@ -4,12 +4,316 @@
 #include "InertiaFunctions.h"
 
 #include <BoundingShapes\AxisAlignedBoxFunctions.h>
+#include <BoundingShapes\AxisAlignedBoxHierarchyFunctions.h>
 #include <BoundingShapes\OrientedBox.h>
 #include <Utilities\StdVectorFunctions.h>
 #include <Utilities\IndexedHelp.h>
 #include <Utilities\VectorHelper.h>
 #include <Math\FloatMatrixOperators.h>
 
+#include <algorithm>
+
+namespace
+{
+    using Physics::ElementContainer;
+
+    // the least number of unused entries that is kept in front of the rigid body storage when it has to grow at the front
+    uint32_t const c_minimum_rigid_body_storage_slack = 64;
+
+
+    template<typename DataType>
+    void CopyEntry( uint32_t from, uint32_t to, std::vector<DataType> & data )
+    {
+        data[to] = data[from];
+    }
+
+
+    template<typename DataType>
+    void AppendCopy( uint32_t from, std::vector<DataType> & data )
+    {
+        // copy first, the reference would not survive the reallocation
+        auto value = data[from];
+        data.push_back(value);
+    }
+
+
+    template<typename DataType>
+    void InsertUnusedEntries( uint32_t count, std::vector<DataType> & data )
+    {
+        data.insert(begin(data), count, DataType());
+    }
+
+
+    template<typename DataType>
+    void RemoveUnusedEntries( uint32_t count, std::vector<DataType> & data )
+    {
+        data.erase(begin(data), begin(data) + count);
+    }
+
+
+    void CopyEntry( uint32_t from, uint32_t to, ElementContainer::Storage::Common & self )
+    {
+        CopyEntry(from, to, self.body_ids);
+        CopyEntry(from, to, self.orientations);
+        CopyEntry(from, to, self.previous_orientations);
+        CopyEntry(from, to, self.broad_bounds);
+        CopyEntry(from, to, self.transformed_broad_bounds);
+        CopyEntry(from, to, self.bounce_factors);
+        CopyEntry(from, to, self.friction_factors);
+    }
+
+
+    void SetEntry(
+        uint32_t index,
+        Physics::BodyID body_id,
+        Orientation orientation,
+        BoundingShapes::AxisAlignedBox aabox,
+        BoundingShapes::AxisAlignedBox transformed_aabox,
+        float bounciness,
+        float friction_factor,
+        ElementContainer::Storage::Common & self )
+    {
+        self.body_ids[index] = body_id;
+        self.orientations[index] = orientation;
+        self.previous_orientations[index] = orientation;
+        self.broad_bounds[index] = aabox;
+        self.transformed_broad_bounds[index] = transformed_aabox;
+        self.bounce_factors[index] = bounciness;
+        self.friction_factors[index] = friction_factor;
+    }
+
+
+    void Resize( uint32_t size, ElementContainer::Storage::Common & self )
+    {
+        ResizeMultipleVectors(size, self.body_ids, self.orientations, self.previous_orientations, self.broad_bounds, self.transformed_broad_bounds, self.bounce_factors, self.friction_factors);
+    }
+
+
+    void Reserve( uint32_t size, ElementContainer::Storage::Common & self )
+    {
+        self.body_ids.reserve(size);
+        self.orientations.reserve(size);
+        self.previous_orientations.reserve(size);
+        self.broad_bounds.reserve(size);
+        self.transformed_broad_bounds.reserve(size);
+        self.bounce_factors.reserve(size);
+        self.friction_factors.reserve(size);
+    }
+
+
+    void CopyEntry( uint32_t from, uint32_t to, ElementContainer::Storage::RigidBody & self )
+    {
+        CopyEntry(from, to, self.centers_of_mass);
+        CopyEntry(from, to, self.movements);
+        CopyEntry(from, to, self.inverse_inertias);
+        CopyEntry(from, to, self.forces);
+    }
+
+
+    void AppendCopy( uint32_t from, ElementContainer::Storage::RigidBody & self )
+    {
+        AppendCopy(from, self.centers_of_mass);
+        AppendCopy(from, self.movements);
+        AppendCopy(from, self.inverse_inertias);
+        AppendCopy(from, self.forces);
+    }
+
+
+    void Append( Math::Float3 center_of_mass, Physics::Movement movement, Physics::Inertia inverse_inertia, ElementContainer::Storage::RigidBody & self )
+    {
+        self.centers_of_mass.push_back(center_of_mass);
+        self.movements.push_back(movement);
+        self.inverse_inertias.push_back(inverse_inertia);
+        self.forces.push_back(Math::Float3(0));
+    }
+
+
+    void Reserve( uint32_t size, ElementContainer::Storage::RigidBody & self )
+    {
+        self.centers_of_mass.reserve(size);
+        self.movements.reserve(size);
+        self.inverse_inertias.reserve(size);
+        self.forces.reserve(size);
+    }
+
+
+    void PopBack( ElementContainer::Storage::RigidBody & self )
+    {
+        self.centers_of_mass.pop_back();
+        self.movements.pop_back();
+        self.inverse_inertias.pop_back();
+        self.forces.pop_back();
+    }
+
+
+    void InsertUnusedEntries( uint32_t count, ElementContainer::Storage::RigidBody & self )
+    {
+        InsertUnusedEntries(count, self.centers_of_mass);
+        InsertUnusedEntries(count, self.movements);
+        InsertUnusedEntries(count, self.inverse_inertias);
+        InsertUnusedEntries(count, self.forces);
+    }
+
+
+    void RemoveUnusedEntries( uint32_t count, ElementContainer::Storage::RigidBody & self )
+    {
+        RemoveUnusedEntries(count, self.centers_of_mass);
+        RemoveUnusedEntries(count, self.movements);
+        RemoveUnusedEntries(count, self.inverse_inertias);
+        RemoveUnusedEntries(count, self.forces);
+    }
+
+
+    void Clear( ElementContainer::Storage::RigidBody & self )
+    {
+        self.centers_of_mass.clear();
+        self.movements.clear();
+        self.inverse_inertias.clear();
+        self.forces.clear();
+    }
+
+
+    uint32_t RigidBodyStorageIndex( uint32_t element, ElementContainer const & self )
+    {
+        assert(element >= self.storage.rigid_body_storage_start);
+        return element - self.storage.rigid_body_storage_start;
+    }
+
+
+    uint32_t RigidBodyStorageSlack( ElementContainer const & self )
+    {
+        return std::max(c_minimum_rigid_body_storage_slack, RigidBodyEnd(self.offsets) - RigidBodyStart(self.offsets));
+    }
+
+
+    // makes sure the rigid body storage has an entry for the element, by growing it at the front by at least the slack,
+    // so it takes that many removals in front of the rigid bodies before it has to grow again
+    void ReserveRigidBodyStorage( uint32_t element, ElementContainer & self )
+    {
+        auto & start = self.storage.rigid_body_storage_start;
+        if( element >= start ) return;
+        auto count = std::min(start, std::max(start - element, RigidBodyStorageSlack(self)));
+        InsertUnusedEntries(count, self.storage.rigid_body);
+        start -= count;
+    }
+
+
+    // call after the offsets were updated, drops the unused entries at the front of the rigid body storage
+    // when there are no rigid bodies or twice the slack has piled up, such that the storage size stays linear in the rigid body count
+    void TrimRigidBodyStorage( ElementContainer & self )
+    {
+        auto & start = self.storage.rigid_body_storage_start;
+        auto rigid_start = RigidBodyStart(self.offsets);
+        if( rigid_start == RigidBodyEnd(self.offsets) )
+        {
+            Clear(self.storage.rigid_body);
+            start = rigid_start;
+            return;
+        }
+        auto unused = rigid_start - start;
+        auto slack = RigidBodyStorageSlack(self);
+        if( unused > 2 * slack )
+        {
+            RemoveUnusedEntries(unused - slack, self.storage.rigid_body);
+            start += unused - slack;
+        }
+    }
+
+
+    // moves the body at element 'from' to element 'to', only the mapping of the moved body changes
+    // moving a body onto itself does nothing, which happens when a partition after the removed element is empty
+    void MoveBody( uint32_t from, uint32_t to, ElementContainer & self )
+    {
+        if( from == to ) return;
+        CopyEntry(from, to, self.storage.common);
+        self.storage.body_to_element[self.storage.common.body_ids[to].index] = to;
+    }
+
+
+    // appends an element and moves the first body of each partition after the one that ends at 'partition_end' to the end of its partition,
+    // such that the element at 'partition_end' is free, doesn't update the offsets
+    void MakeRoomAtPartitionEnd( uint32_t partition_end, ElementContainer & self )
+    {
+        auto static_end = StaticBodyEnd(self.offsets);
+        auto kinematic_end = KinematicBodyEnd(self.offsets);
+        auto rigid_end = RigidBodyEnd(self.offsets);
+        Resize(rigid_end + 1, self.storage.common);
+
+        // the rigid body data stays where it is, the start of the rigid body storage just moves up
+        if( partition_end <= kinematic_end && kinematic_end < rigid_end )
+        {
+            MoveBody(kinematic_end, rigid_end, self);
+            AppendCopy(RigidBodyStorageIndex(kinematic_end, self), self.storage.rigid_body);
+        }
+        if( partition_end < kinematic_end )
+        {
+            MoveBody(static_end, kinematic_end, self);
+        }
+    }
+
+
+    // adds the common data of a body in the free element at 'partition_end', doesn't update the offsets
+    void AddAtPartitionEnd(
+        uint32_t partition_end,
+        Physics::BodyID body_id,
+        Orientation orientation,
+        BoundingShapes::AxisAlignedBox aabox,
+        BoundingShapes::AxisAlignedBox transformed_aabox,
+        float bounciness,
+        float friction_factor,
+        ElementContainer & self )
+    {
+        MakeRoomAtPartitionEnd(partition_end, self);
+        SetEntry(partition_end, body_id, orientation, aabox, transformed_aabox, bounciness, friction_factor, self.storage.common);
+        AddIndexToIndices( self.storage.body_to_element, body_id.index, partition_end );
+    }
+
+
+    // fills the element with the last body of its partition, then fills the element that became free with the last body of the next partition,
+    // and so on, such that only the last element is left to be removed, the mapping of the removed body isn't changed
+    void RemoveElement( uint32_t element, ElementContainer & self )
+    {
+        auto static_end = StaticBodyEnd(self.offsets);
+        auto kinematic_end = KinematicBodyEnd(self.offsets);
+        auto rigid_end = RigidBodyEnd(self.offsets);
+
+        auto free_element = element;
+        if( free_element < static_end )
+        {
+            MoveBody(static_end - 1, free_element, self);
+            free_element = static_end - 1;
+        }
+        if( free_element < kinematic_end )
+        {
+            MoveBody(kinematic_end - 1, free_element, self);
+            free_element = kinematic_end - 1;
+        }
+        if( kinematic_end < rigid_end )
+        {
+            // the free element becomes the first rigid body if it was in front of them
+            ReserveRigidBodyStorage(free_element, self);
+            MoveBody(rigid_end - 1, free_element, self);
+            CopyEntry(RigidBodyStorageIndex(rigid_end - 1, self), RigidBodyStorageIndex(free_element, self), self.storage.rigid_body);
+            PopBack(self.storage.rigid_body);
+        }
+        Resize(rigid_end - 1, self.storage.common);
+
+        if( element < static_end )
+        {
+            ChangedStaticBodyCount(-1, self.offsets);
+        }
+        else if( element < kinematic_end )
+        {
+            ChangedKinematicBodyCount(-1, self.offsets);
+        }
+        else
+        {
+            ChangedRigidBodyCount(-1, self.offsets);
+        }
+    }
+}
+
+
 void Physics::AddRigidBodyComponent(
         BodyID body_id,
         Orientation orientation,
@@ -21,25 +325,11 @@ void Physics::AddRigidBodyComponent(
         float friction_factor,
         ElementContainer & self )
 {
-    auto index = RigidBodyEnd(self.offsets);
-
-    Insert(body_id, index, self.storage.common.body_ids);
-    Insert(orientation, index, self.storage.common.orientations);
-    Insert(orientation, index, self.storage.common.previous_orientations);
-    Insert(aabox, index, self.storage.common.broad_bounds);
-    Insert(TransformByOrientation(aabox, orientation), index, self.storage.common.transformed_broad_bounds);
-    Insert(bounciness, index, self.storage.common.bounce_factors);
-    Insert(friction_factor, index, self.storage.common.friction_factors);
-
-    auto rigid_index = index - RigidBodyStart(self.offsets);
-    Insert(center_of_mass, rigid_index, self.storage.rigid_body.centers_of_mass);
-    Insert(movement, rigid_index, self.storage.rigid_body.movements);
-    Insert(inverse_inertia, rigid_index, self.storage.rigid_body.inverse_inertias);
-    Insert(Math::Float3(0), rigid_index, self.storage.rigid_body.forces);
-
-    InsertIndexInIndices( self.storage.body_to_element, body_id.index, index );
+    AddAtPartitionEnd(RigidBodyEnd(self.offsets), body_id, orientation, aabox, TransformByOrientation(aabox, orientation), bounciness, friction_factor, self);
+    Append(center_of_mass, movement, inverse_inertia, self.storage.rigid_body);
 
     ChangedRigidBodyCount(1, self.offsets);
+    TrimRigidBodyStorage(self);
     UpdatePointers(self);
 }
 
@@ -52,19 +342,10 @@ void Physics::AddKinematicComponent(
     float friction_factor,
     ElementContainer & self)
 {
-    auto index = KinematicBodyEnd(self.offsets);
-
-    Insert(body_id, index, self.storage.common.body_ids);
-    Insert(orientation, index, self.storage.common.orientations);
-    Insert(orientation, index, self.storage.common.previous_orientations);
-    Insert(aabox, index, self.storage.common.broad_bounds);
-    Insert(TransformByOrientation(aabox, orientation), index, self.storage.common.transformed_broad_bounds);
-    Insert(bounciness, index, self.storage.common.bounce_factors);
-    Insert(friction_factor, index, self.storage.common.friction_factors);
-
-    InsertIndexInIndices( self.storage.body_to_element, body_id.index, index );
+    AddAtPartitionEnd(KinematicBodyEnd(self.offsets), body_id, orientation, aabox, TransformByOrientation(aabox, orientation), bounciness, friction_factor, self);
 
     ChangedKinematicBodyCount(1, self.offsets);
+    TrimRigidBodyStorage(self);
     UpdatePointers(self);
 }
 
@@ -79,23 +360,141 @@ void Physics::AddStaticComponent(
 {
     aabox = BoundingShapes::TransformByOrientation( aabox, orientation );
 
-    auto index = StaticBodyEnd(self.offsets);
+    AddAtPartitionEnd(StaticBodyEnd(self.offsets), body_id, orientation, aabox, aabox, bounciness, friction_factor, self);
 
-    Insert(body_id, index, self.storage.common.body_ids);
-    Insert(orientation, index, self.storage.common.orientations);
-    Insert(orientation, index, self.storage.common.previous_orientations);
-    Insert(aabox, index, self.storage.common.broad_bounds);
-    Insert(aabox, index, self.storage.common.transformed_broad_bounds);
-    Insert(bounciness, index, self.storage.common.bounce_factors);
-    Insert(friction_factor, index, self.storage.common.friction_factors);
+    ChangedStaticBodyCount(1, self.offsets);
+    StaticBodiesChanged(self);
+    TrimRigidBodyStorage(self);
+    UpdatePointers(self);
+}
 
-    InsertIndexInIndices( self.storage.body_to_element, body_id.index, index );
 
-    ChangedStaticBodyCount(1, self.offsets);
+namespace
+{
+    void Append(
+        Physics::BodyID body_id,
+        Orientation orientation,
+        BoundingShapes::AxisAlignedBox aabox,
+        BoundingShapes::AxisAlignedBox transformed_aabox,
+        float bounciness,
+        float friction_factor,
+        Physics::ElementContainer::Storage::Common & self )
+    {
+        self.body_ids.push_back(body_id);
+        self.orientations.push_back(orientation);
+        self.previous_orientations.push_back(orientation);
+        self.broad_bounds.push_back(aabox);
+        self.transformed_broad_bounds.push_back(transformed_aabox);
+        self.bounce_factors.push_back(bounciness);
+        self.friction_factors.push_back(friction_factor);
+    }
+
+
+    void Clear( Physics::ElementContainer::Storage::Common & self )
+    {
+        self.body_ids.clear();
+        self.orientations.clear();
+        self.previous_orientations.clear();
+        self.broad_bounds.clear();
+        self.transformed_broad_bounds.clear();
+        self.bounce_factors.clear();
+        self.friction_factors.clear();
+    }
+
+
+    void AddAtPartitionEnd( uint32_t partition_end, Physics::ElementContainer::Storage::Common const & batch, uint32_t index, Physics::ElementContainer & self )
+    {
+        AddAtPartitionEnd(partition_end, batch.body_ids[index], batch.orientations[index], batch.broad_bounds[index], batch.transformed_broad_bounds[index], batch.bounce_factors[index], batch.friction_factors[index], self);
+    }
+}
+
+
+void Physics::AddRigidBodyComponent(
+    BodyID body_id,
+    Orientation orientation,
+    Math::Float3 center_of_mass,
+    Movement movement,
+    Inertia inverse_inertia,
+    BoundingShapes::AxisAlignedBox aabox,
+    float bounciness,
+    float friction_factor,
+    ElementBatch & batch )
+{
+    Append(body_id, orientation, aabox, TransformByOrientation(aabox, orientation), bounciness, friction_factor, batch.rigid_bodies);
+    Append(center_of_mass, movement, inverse_inertia, batch.rigid_body);
+}
+
+
+void Physics::AddKinematicComponent(
+    BodyID body_id,
+    Orientation orientation,
+    BoundingShapes::AxisAlignedBox aabox,
+    float bounciness,
+    float friction_factor,
+    ElementBatch & batch )
+{
+    Append(body_id, orientation, aabox, TransformByOrientation(aabox, orientation), bounciness, friction_factor, batch.kinematic_bodies);
+}
+
+
+void Physics::AddStaticComponent(
+    BodyID body_id,
+    Orientation orientation,
+    BoundingShapes::AxisAlignedBox aabox,
+    float bounciness,
+    float friction_factor,
+    ElementBatch & batch )
+{
+    aabox = BoundingShapes::TransformByOrientation( aabox, orientation );
+    Append(body_id, orientation, aabox, aabox, bounciness, friction_factor, batch.static_bodies);
+}
+
+
+void Physics::AddBodies( ElementBatch & batch, ElementContainer & self )
+{
+    if( BatchedBodyCount(batch) == 0 ) return;
+
+    // grow once, then every body is added in constant time
+    Reserve(TotalBodyCount(self) + BatchedBodyCount(batch), self.storage.common);
+    Reserve(uint32_t(Size(self.storage.rigid_body.movements)) + BatchedBodyCount(batch), self.storage.rigid_body);
+
+    for( auto i = 0u; i < Size(batch.static_bodies.body_ids); ++i )
+    {
+        AddAtPartitionEnd(StaticBodyEnd(self.offsets), batch.static_bodies, i, self);
+        ChangedStaticBodyCount(1, self.offsets);
+        TrimRigidBodyStorage(self);
+    }
+    for( auto i = 0u; i < Size(batch.kinematic_bodies.body_ids); ++i )
+    {
+        AddAtPartitionEnd(KinematicBodyEnd(self.offsets), batch.kinematic_bodies, i, self);
+        ChangedKinematicBodyCount(1, self.offsets);
+        TrimRigidBodyStorage(self);
+    }
+    auto const & rigid_body = batch.rigid_body;
+    for( auto i = 0u; i < Size(batch.rigid_bodies.body_ids); ++i )
+    {
+        AddAtPartitionEnd(RigidBodyEnd(self.offsets), batch.rigid_bodies, i, self);
+        Append(rigid_body.centers_of_mass[i], rigid_body.movements[i], rigid_body.inverse_inertias[i], self.storage.rigid_body);
+        ChangedRigidBodyCount(1, self.offsets);
+    }
+
+    if( !batch.static_bodies.body_ids.empty() ) StaticBodiesChanged(self);
+    Clear(batch.static_bodies);
+    Clear(batch.kinematic_bodies);
+    Clear(batch.rigid_bodies);
+    Clear(batch.rigid_body);
+
+    TrimRigidBodyStorage(self);
     UpdatePointers(self);
 }
 
 
+uint32_t Physics::BatchedBodyCount( ElementBatch const & batch )
+{
+    return uint32_t(Size(batch.static_bodies.body_ids) + Size(batch.kinematic_bodies.body_ids) + Size(batch.rigid_bodies.body_ids));
+}
+
+
 void Physics::ReplaceWithRigidBodyComponent(
     BodyID body_id,
     Math::Float3 center_of_mass,
@@ -174,94 +573,54 @@ void Physics::ReplaceWithStaticComponent(
 
 void Physics::RemoveBodies( Range<BodyID const *> body_ids_to_be_removed, ElementContainer & self )
 {
-    if(IsEmpty(body_ids_to_be_removed)) return;
-    auto indices = RemoveIndices( self.storage.body_to_element, body_ids_to_be_removed );
-
-    std::sort( begin( indices ), end( indices ) );
-
-    RemoveEntries(self.storage.common.body_ids, indices);
-    RemoveEntries(self.storage.common.orientations, indices);
-    RemoveEntries(self.storage.common.previous_orientations, indices);
-    RemoveEntries(self.storage.common.broad_bounds, indices);
-    RemoveEntries(self.storage.common.transformed_broad_bounds, indices);
-    RemoveEntries(self.storage.common.bounce_factors, indices);
-    RemoveEntries(self.storage.common.friction_factors, indices);
-
-    auto indices_begin = begin( indices );
-
-    uint32_t removed_static_components;
-    // remove static components
-    {
-        assert(StaticBodyStart(self.offsets) == 0);
-        // auto start = std::lower_bound(begin(indices), end(indices), StaticDensityBodyStart(self.offsets)) - begin(indices);
-        auto start = 0;
-        // find the end and update the begin of where to search for indices
-        indices_begin = std::lower_bound(indices_begin, end(indices), StaticBodyEnd(self.offsets));
-        auto stop = indices_begin - begin(indices);
-        // record how many we removed
-        removed_static_components = uint32_t(stop - start);
-    }
-
-    // remove dynamic components
-    {
-        assert( DynamicBodyStart( self.offsets ) >= StaticBodyStart( self.offsets ) );
-        auto start_offset = DynamicBodyStart( self.offsets );
-        auto start = std::lower_bound( indices_begin, end( indices ), start_offset ) - begin( indices );
-        // the dynamic bodies should be at the end, so all indices should be smaller
-        assert( Last( indices ) <= DynamicBodyEnd( self.offsets ) );
-        // update the begin position to search for the kinematic bodies
-        indices_begin = begin( indices ) + start;
-    }
-
-    uint32_t removed_kinematic_components;
-    // remove kinematic components
-    {
-        assert(KinematicBodyStart(self.offsets) == DynamicBodyStart(self.offsets));
-        // auto start_offset = KinematicBodyStart(self.offsets);
-        // offset is zero, because the indices are already adjusted for the dynamic bodies (because they overlap and start at the same place as kinematic bodies)
-        //auto start = std::lower_bound(indices_begin, end(indices), 0u ) - begin(indices);
-        auto start = indices_begin - begin(indices);
-        // find the end and update the begin of where to search for indices
-        indices_begin = std::lower_bound(indices_begin, end(indices), KinematicBodyEnd(self.offsets) );
-        auto stop = indices_begin - begin(indices);
-        // nothing to adjust for kinematic, because there are no special kinematic components
-        // record how many we removed
-        removed_kinematic_components = uint32_t( stop - start );
-    }
-
-    uint32_t removed_rigid_components;
-    // remove rigid body components
-    {
-        assert(RigidBodyStart(self.offsets) >= KinematicBodyStart(self.offsets));
-        // calculate the offset
-        auto start_offset = RigidBodyStart( self.offsets );
-        auto start = std::lower_bound(indices_begin, end(indices), start_offset ) - begin(indices);
-        // the rigid bodies should be at the end, so all indices should be smaller
-        assert( Last(indices) < RigidBodyEnd(self.offsets));
-        // auto stop = std::lower_bound(indices_begin, end(indices), RigidBodyEnd(self.offsets)) - begin(indices);
-        // adjust all rigid body indices (which go to the end)
-        // such that they're correct for the rigid body storage
-        auto indices_range = CreateRange( indices, start, Size(indices) );
-        for( auto & i : indices_range )
-        {
-            i -= start_offset;
-        }
-        RemoveEntries(self.storage.rigid_body.centers_of_mass, indices_range);
-        RemoveEntries(self.storage.rigid_body.movements, indices_range);
-        RemoveEntries(self.storage.rigid_body.inverse_inertias, indices_range);
-        RemoveEntries(self.storage.rigid_body.forces, indices_range);
-        // record how many we removed
-        removed_rigid_components = uint32_t( Size(indices) - start );
+    auto removed_static_bodies = false;
+    for( auto body_id : body_ids_to_be_removed )
+    {
+        auto element = GetOptional(self.storage.body_to_element, body_id.index);
+        if( element == c_invalid_index ) continue;
+        removed_static_bodies |= element < StaticBodyEnd(self.offsets);
+        RemoveElement(element, self);
+        self.storage.body_to_element[body_id.index] = c_invalid_index;
     }
+    if( removed_static_bodies ) StaticBodiesChanged(self);
 
-    ChangedStaticBodyCount( -int32_t(removed_static_components), self.offsets );
-    ChangedKinematicBodyCount( -int32_t(removed_kinematic_components), self.offsets );
-    ChangedRigidBodyCount( -int32_t(removed_rigid_components), self.offsets );
-
+    TrimRigidBodyStorage(self);
     UpdatePointers(self);
 }
 
 
+void Physics::StaticBodiesChanged(ElementContainer & self)
+{
+    self.broad_bounds_hierarchies.static_bodies_changed = true;
+}
+
+
+namespace
+{
+    void CreateHierarchy( Range<BoundingShapes::AxisAlignedBox const *> boxes, Physics::ElementContainer::BroadBoundsHierarchies & hierarchies, BoundingShapes::AxisAlignedBoxHierarchy & hierarchy )
+    {
+        hierarchies.minmax.resize( Size( boxes ) );
+        std::transform( begin( boxes ), end( boxes ), begin( hierarchies.minmax ), BoundingShapes::GetMinMax );
+        CreateAxisAlignedBoxHierarchy( hierarchies.minmax, hierarchies.indices, hierarchy );
+    }
+}
+
+
+void Physics::UpdateBroadBoundsHierarchies(ElementContainer & self)
+{
+    // creating a hierarchy from no boxes leaves the nodes untouched
+    auto & hierarchies = self.broad_bounds_hierarchies;
+    if( hierarchies.static_bodies_changed )
+    {
+        hierarchies.static_bodies.nodes.clear();
+        CreateHierarchy( CreateStaticDataRange( self.offsets, self.pointers.transformed_broad_bounds ), hierarchies, hierarchies.static_bodies );
+        hierarchies.static_bodies_changed = false;
+    }
+    hierarchies.dynamic_bodies.nodes.clear();
+    CreateHierarchy( CreateDynamicDataRange( self.offsets, self.pointers.transformed_broad_bounds ), hierarchies, hierarchies.dynamic_bodies );
+}
+
+
 void Physics::UpdatePointers(ElementContainer & self)
 {
     self.pointers.body_to_element = CreateRange(self.storage.body_to_element);
@@ -272,7 +631,7 @@ void Physics::UpdatePointers(ElementContainer & self)
     self.pointers.transformed_broad_bounds = self.storage.common.transformed_broad_bounds.data();
     self.pointers.bounce_factors = self.storage.common.bounce_factors.data();
     self.pointers.friction_factors = self.storage.common.friction_factors.data();
-    auto rigid_offset = RigidBodyStart(self.offsets);
+    auto rigid_offset = self.storage.rigid_body_storage_start;
     self.pointers.centers_of_mass = self.storage.rigid_body.centers_of_mass.data() - rigid_offset;
     self.pointers.movements = self.storage.rigid_body.movements.data() - rigid_offset;
     self.pointers.inverse_inertias = self.storage.rigid_body.inverse_inertias.data() - rigid_offset;
@@ -9,6 +9,7 @@
 
 #include <Conventions\Orientation.h>
 #include <Math\FloatTypes.h>
+#include <Utilities\MinMax.h>
 #include <Utilities\Range.h>
 
 #include <vector>
@@ -36,7 +37,6 @@ namespace Physics
                 std::vector<Orientation> previous_orientations;
                 std::vector<BoundingShapes::AxisAlignedBox> broad_bounds; // local broad bounds, except for static, then they're already transformed
                 std::vector<BoundingShapes::AxisAlignedBox> transformed_broad_bounds; // broad bounds transformed to the current orientation of the bodies
-                BoundingShapes::AxisAlignedBoxHierarchy transformed_broad_bounds_hierarchy; // TODO: Not sure if it should be here
                 std::vector<float> bounce_factors;
                 std::vector<float> friction_factors;
             };
@@ -53,6 +53,9 @@ namespace Physics
 
             Common common;
             RigidBody rigid_body;
+            // element of the first entry in the rigid body storage, the entries up to the first rigid body are unused,
+            // so the rigid bodies can start an element earlier or later without moving all their data
+            uint32_t rigid_body_storage_start = 0;
         };
 
 
@@ -97,6 +100,20 @@ namespace Physics
         };
 
 
+        // hierarchies over the transformed broad bounds
+        struct BroadBoundsHierarchies
+        {
+            // indices into the static bodies, only rebuilt after static bodies were added, removed or moved
+            BoundingShapes::AxisAlignedBoxHierarchy static_bodies;
+            // indices into the dynamic bodies, counted from the first dynamic body, rebuilt every update
+            BoundingShapes::AxisAlignedBoxHierarchy dynamic_bodies;
+            bool static_bodies_changed = true;
+            // scratch memory for rebuilding the hierarchies, kept so the rebuild every update doesn't allocate
+            std::vector<MinMax<Math::Float3>> minmax;
+            std::vector<uint32_t> indices;
+        };
+
+
         // where the actual data is stored
         Storage storage;
         // Pointers that are all at an offset such that the body mapping works equally on all of them.
@@ -104,9 +121,22 @@ namespace Physics
         Pointers pointers;
         // offsets to where the different body types start and end
         Offsets offsets;
+        BroadBoundsHierarchies broad_bounds_hierarchies;
+    };
+
+
+    // bodies that are collected to be added to an ElementContainer all at once,
+    // so its vectors grow once per batch instead of once for every body
+    struct ElementBatch
+    {
+        ElementContainer::Storage::Common static_bodies;
+        ElementContainer::Storage::Common kinematic_bodies;
+        ElementContainer::Storage::Common rigid_bodies;
+        ElementContainer::Storage::RigidBody rigid_body;
     };
 
 
+    // these add the body at the end of its partition, the first body of each later partition moves to the end of that partition to make room
     void AddRigidBodyComponent(
         BodyID body_id,
         Orientation orientation,
@@ -137,6 +167,43 @@ namespace Physics
         ElementContainer & self);
 
 
+    // these add the body to the batch, AddBodies moves all of them to the container
+    void AddRigidBodyComponent(
+        BodyID body_id,
+        Orientation orientation,
+        Math::Float3 center_of_mass,
+        Movement movement,
+        Inertia inverse_inertia,
+        BoundingShapes::AxisAlignedBox aabox,
+        float bounciness,
+        float friction_factor,
+        ElementBatch & batch );
+
+
+    void AddKinematicComponent(
+        BodyID body_id,
+        Orientation orientation,
+        BoundingShapes::AxisAlignedBox aabox,
+        float bounciness,
+        float friction_factor,
+        ElementBatch & batch);
+
+
+    void AddStaticComponent(
+        BodyID body_id,
+        Orientation orientation,
+        BoundingShapes::AxisAlignedBox aabox,
+        float bounciness,
+        float friction_factor,
+        ElementBatch & batch);
+
+
+    // adds all bodies in the batch in a single pass over the container and clears the batch
+    void AddBodies( ElementBatch & batch, ElementContainer & self );
+
+    uint32_t BatchedBodyCount( ElementBatch const & batch );
+
+
     void ReplaceWithRigidBodyComponent(
         BodyID body_id,
         Math::Float3 center_of_mass,
@@ -163,10 +230,17 @@ namespace Physics
         ElementContainer & self );
 
 
+    // moves the last body of the partition into the place of each removed body, and the last body of each later partition into the element that becomes free,
+    // so only the mappings of the moved bodies change
     void RemoveBodies( Range<BodyID const *> body_ids_to_be_removed, ElementContainer & self );
 
     void UpdatePointers(ElementContainer & self);
 
+    // call after changing the static bodies' bounds directly, adding and removing bodies takes care of it already
+    void StaticBodiesChanged(ElementContainer & self);
+    // rebuilds the static hierarchy if needed and the dynamic hierarchy, expects the transformed broad bounds to be up to date
+    void UpdateBroadBoundsHierarchies(ElementContainer & self);
+
     bool IsStaticBody(BodyID id, ElementContainer const & self);
     bool IsRigidBody( BodyID id, ElementContainer const & self );
     bool IsKinematicBody( BodyID id, ElementContainer const & self );
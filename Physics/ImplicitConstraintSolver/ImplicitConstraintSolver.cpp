@@ -36,7 +36,10 @@ ImplicitConstraintSolver::ImplicitConstraintSolver() :
     relaxation_factor(1, 1),
     warm_start_factor(1.f),
     solve_parallel(false),
-    minimal_island_size(128)
+    minimal_island_size(128),
+    stiff_island_iteration_factor(1),
+    stiff_island_angular_step(0.25f),
+    has_stiff_islands(false)
 {}
 
 
@@ -44,12 +47,14 @@ ImplicitConstraintSolver::~ImplicitConstraintSolver()
 {}
 
 
-void ImplicitConstraintSolver::SetConfiguration(MinMax<float> relaxation_factor, float warm_start_factor, uint32_t minimal_island_size, bool solve_parallel)
+void ImplicitConstraintSolver::SetConfiguration(MinMax<float> relaxation_factor, float warm_start_factor, uint32_t minimal_island_size, bool solve_parallel, uint32_t stiff_island_iteration_factor, float stiff_island_angular_step)
 {
     this->relaxation_factor = relaxation_factor;
     this->warm_start_factor = warm_start_factor;
     this->minimal_island_size = minimal_island_size;
     this->solve_parallel = solve_parallel;
+    this->stiff_island_iteration_factor = stiff_island_iteration_factor;
+    this->stiff_island_angular_step = stiff_island_angular_step;
 }
 
 
@@ -61,7 +66,13 @@ void ImplicitConstraintSolver::SetConfigurationFromWorldConfiguration(WorldConfi
         world_config.angular_velocity_correction_fraction,
         world_config.velocity_correction_iterations,
         world_config.position_correction_iterations);
-    SetConfiguration(world_config.solver_relaxation_factor, world_config.warm_start_factor, world_config.minimal_island_size, world_config.solve_parallel);
+    SetConfiguration(
+        world_config.solver_relaxation_factor,
+        world_config.warm_start_factor,
+        world_config.minimal_island_size,
+        world_config.solve_parallel,
+        world_config.stiff_island_iteration_factor,
+        world_config.stiff_island_angular_step);
 }
 
 namespace
@@ -556,6 +567,44 @@ void ImplicitConstraintSolver::MakeIslands()
 }
 
 
+// Stiff islands get extra iterations, the others are solved as usual.
+void ImplicitConstraintSolver::MarkStiffIslands(Range<Constraint const *> persistent_position_constraints, Range<Constraint const *> persistent_velocity_constraints, float time_step)
+{
+    this->has_stiff_islands = false;
+    if( this->stiff_island_iteration_factor <= 1 ) return;
+
+    // both the velocity and position constraints connect bodies
+    this->has_stiff_islands = Physics::MarkStiffIslands(
+        this->velocity.constraints,
+        this->position.constraints,
+        persistent_position_constraints,
+        persistent_velocity_constraints,
+        this->rigid_body_inverse_inertias,
+        this->rigid_body_new_movements,
+        this->stiff_island_angular_step / time_step,
+        this->stiff_islands);
+}
+
+
+// Continues solving the constraints of the stiff islands, after all constraints got the normal iterations.
+// The islands don't share bodies, so this only changes the movements of the stiff islands.
+void ImplicitConstraintSolver::SolveStiffIslands(uint32_t iterations, Range<Constraint const *> constraints, Range<SingleBodyConstraint const *> single_body_constraints, Range<Movement *> movements)
+{
+    SelectStiffConstraints(this->stiff_islands, constraints, single_body_constraints, this->stiff.constraints, this->stiff.single_body_constraints);
+#if _DEBUG
+    Solve(
+#else
+    SolveSSE(
+#endif
+        iterations,
+        this->relaxation_factor,
+        this->stiff.constraints,
+        this->stiff.single_body_constraints,
+        movements
+        );
+}
+
+
 void ImplicitConstraintSolver::DoYourThing(float const time_step)
 {
     // clear
@@ -577,6 +626,7 @@ void ImplicitConstraintSolver::DoYourThing(float const time_step)
     MakeRigidStaticCollisionAndFrictionConstraints(time_step);
     MakeRigidRigidCollisionAndFrictionConstraints(time_step);
 
+    auto persistent_position_begin = Size(this->position.constraints);
     auto added_constraints = Grow(this->position.constraints, Size(this->position_constraints->bodies));
 	
     //CalculateSoftPositionConstraints(
@@ -608,6 +658,7 @@ void ImplicitConstraintSolver::DoYourThing(float const time_step)
         added_constraints);
 
 
+    auto persistent_velocity_begin = Size(this->velocity.constraints);
     added_constraints = Grow(this->velocity.constraints, Size(this->distance_constraints->bodies));
     CalculateDistanceConstraints(
         this->distance_constraints->bodies,
@@ -655,6 +706,8 @@ void ImplicitConstraintSolver::DoYourThing(float const time_step)
         added_constraints
         );
 
+    auto persistent_velocity_end = Size(this->velocity.constraints);
+
     auto added_single_body_constraints = Grow(this->velocity.single_body_constraints, Size(this->world_velocity_constraints->body_ids));
     CalculateSoftVelocityConstraints(
         this->world_velocity_constraints->body_ids,
@@ -716,6 +769,11 @@ void ImplicitConstraintSolver::DoYourThing(float const time_step)
         added_single_body_constraints
         );
 
+    MarkStiffIslands(
+        CreateRange(this->position.constraints, persistent_position_begin, Size(this->position.constraints)),
+        CreateRange(this->velocity.constraints, persistent_velocity_begin, persistent_velocity_end),
+        time_step);
+
     auto use_parallel = this->solve_parallel && Size(this->velocity.constraints) > this->minimal_island_size;
     if(use_parallel)
     {
@@ -757,6 +815,14 @@ void ImplicitConstraintSolver::DoYourThing(float const time_step)
             this->position_correction
             );
     }
+    if( this->has_stiff_islands )
+    {
+        SolveStiffIslands(
+            (this->stiff_island_iteration_factor - 1) * this->position_correction_iterations,
+            this->position.constraints,
+            this->position.single_body_constraints,
+            this->position_correction);
+    }
 
 
     ResetSize(this->movement_correction, Size(this->rigid_body_inverse_inertias));
@@ -794,6 +860,14 @@ void ImplicitConstraintSolver::DoYourThing(float const time_step)
             this->movement_correction
             );
     }
+    if( this->has_stiff_islands )
+    {
+        SolveStiffIslands(
+            (this->stiff_island_iteration_factor - 1) * this->velocity_correction_iterations,
+            this->velocity.constraints,
+            this->velocity.single_body_constraints,
+            this->movement_correction);
+    }
 
 
     AddMovements(this->movement_correction, this->rigid_body_new_movements, 1);
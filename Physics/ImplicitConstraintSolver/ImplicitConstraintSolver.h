@@ -1,6 +1,7 @@
 #pragma once
 
 #include "..\ConstraintSolver.h"
+#include "StiffIslands.h"
 
 #include "../BodyID.h"
 #include <Utilities\MinMax.h>
@@ -12,6 +13,7 @@ namespace Physics
 {
     struct Constraint;
     struct SingleBodyConstraint;
+    struct Movement;
 
     class ImplicitConstraintSolver final : public ConstraintSolver
     {
@@ -21,7 +23,7 @@ namespace Physics
         ImplicitConstraintSolver& operator=(ImplicitConstraintSolver const &) = delete;
         ~ImplicitConstraintSolver();
 
-        void SetConfiguration(MinMax<float> relaxation_factor, float warm_start_factor, uint32_t minimal_island_size, bool solve_parallel);
+        void SetConfiguration(MinMax<float> relaxation_factor, float warm_start_factor, uint32_t minimal_island_size, bool solve_parallel, uint32_t stiff_island_iteration_factor, float stiff_island_angular_step);
 
         void SetConfigurationFromWorldConfiguration(WorldConfiguration const & world_config) override;
 
@@ -32,11 +34,15 @@ namespace Physics
         void MakeRigidStaticCollisionAndFrictionConstraints(float time_step);
         void MakeRigidRigidCollisionAndFrictionConstraints(float time_step);
         void MakeIslands();
+        void MarkStiffIslands(Range<Constraint const *> persistent_position_constraints, Range<Constraint const *> persistent_velocity_constraints, float time_step);
+        void SolveStiffIslands(uint32_t iterations, Range<Constraint const *> constraints, Range<SingleBodyConstraint const *> single_body_constraints, Range<Movement *> movements);
 
         MinMax<float> relaxation_factor;
         float warm_start_factor;
         bool solve_parallel;
         uint32_t minimal_island_size;
+        uint32_t stiff_island_iteration_factor;
+        float stiff_island_angular_step;
 
         std::vector<Movement> position_correction, movement_correction;
 
@@ -65,6 +71,11 @@ namespace Physics
         std::vector<uint32_t> single_body_island_offsets;
         std::vector<SingleBodyConstraint> single_body_temp;
         std::vector<uint32_t> non_penetrating_single_body_island_offsets;
+
+        // stiff island related stuff
+        StiffIslands stiff_islands;
+        SolverConstraints stiff;
+        bool has_stiff_islands;
     };
 
 
@@ -0,0 +1,117 @@
+#include "StiffIslands.h"
+
+#include "Constraints.h"
+
+#include "../Inertia.h"
+#include "../Movement.h"
+
+#include <Math\FloatMatrixOperators.h>
+#include <Math\MathFunctions.h>
+
+#include <Utilities\StdVectorFunctions.h>
+#include <Utilities\UnionFind.h>
+
+#include <algorithm>
+
+using namespace Physics;
+
+namespace
+{
+    void AppendConnections(Range<Constraint const *> constraints, std::vector<std::pair<uint32_t, uint32_t>> & connections)
+    {
+        for( auto & c : constraints )
+        {
+            auto body1 = c.body_indices[0];
+            auto body2 = c.body_indices[1];
+            connections.emplace_back(std::min(body1, body2), std::max(body1, body2));
+        }
+    }
+
+
+    void Unite(Range<Constraint const *> constraints, Range<uint32_t *> groups)
+    {
+        for( auto & c : constraints )
+        {
+            ::Unite(c.body_indices[0], c.body_indices[1], groups);
+        }
+    }
+}
+
+
+bool Physics::MarkStiffIslands(
+    Range<Constraint const *> constraints,
+    Range<Constraint const *> other_constraints,
+    Range<Constraint const *> persistent_constraints,
+    Range<Constraint const *> other_persistent_constraints,
+    Range<Inertia const *> inverse_inertias,
+    Range<Movement const *> movements,
+    float max_angular_speed,
+    StiffIslands & self)
+{
+    auto body_count = Size(inverse_inertias);
+
+    // the rows of a joint all connect the same two bodies
+    self.connections.clear();
+    AppendConnections(persistent_constraints, self.connections);
+    AppendConnections(other_persistent_constraints, self.connections);
+    std::sort(begin(self.connections), end(self.connections));
+    self.connections.erase(std::unique(begin(self.connections), end(self.connections)), end(self.connections));
+    ResetSize(self.connection_counts, body_count);
+    std::fill(begin(self.connection_counts), end(self.connection_counts), 0u);
+    for( auto & connection : self.connections )
+    {
+        ++self.connection_counts[connection.first];
+        ++self.connection_counts[connection.second];
+    }
+
+    ResetSize(self.groups, body_count);
+    auto groups = CreateRange(self.groups);
+    InitializeUnionFind(groups);
+    Unite(constraints, groups);
+    Unite(other_constraints, groups);
+
+    ResetSize(self.is_stiff, body_count);
+    std::fill(begin(self.is_stiff), end(self.is_stiff), uint8_t(0));
+    auto any_stiff = false;
+    for( auto i = 0u; i < body_count; ++i )
+    {
+        auto angular_velocity = inverse_inertias[i].moment * movements[i].angular_momentum;
+        if( self.connection_counts[i] > 1 || SquaredNorm(angular_velocity) > max_angular_speed * max_angular_speed )
+        {
+            self.is_stiff[GetRoot(groups, i)] = 1;
+            any_stiff = true;
+        }
+    }
+    // point every body to its root, so the constraints can look up their island directly
+    for( auto i = 0u; i < body_count; ++i )
+    {
+        groups[i] = GetRoot(groups, i);
+    }
+    return any_stiff;
+}
+
+
+void Physics::SelectStiffConstraints(
+    StiffIslands const & self,
+    Range<Constraint const *> constraints,
+    Range<SingleBodyConstraint const *> single_body_constraints,
+    std::vector<Constraint> & stiff_constraints,
+    std::vector<SingleBodyConstraint> & stiff_single_body_constraints)
+{
+    stiff_constraints.clear();
+    stiff_single_body_constraints.clear();
+    for( auto & c : constraints )
+    {
+        if( self.is_stiff[self.groups[c.body_indices[0]]] )
+        {
+            stiff_constraints.push_back(c);
+        }
+    }
+    for( auto & c : single_body_constraints )
+    {
+        if( self.is_stiff[self.groups[c.body_index]] )
+        {
+            stiff_single_body_constraints.push_back(c);
+        }
+    }
+}
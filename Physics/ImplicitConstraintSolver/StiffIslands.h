@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Utilities\Range.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Physics
+{
+    struct Constraint;
+    struct SingleBodyConstraint;
+    struct Inertia;
+    struct Movement;
+
+    // the islands of bodies connected by constraints that get extra solver iterations
+    struct StiffIslands
+    {
+        // the island of each rigid body, identified by its root body
+        std::vector<uint32_t> groups;
+        // indexed by the island root
+        std::vector<uint8_t> is_stiff;
+
+        // the distinct body pairs of the persistent constraints and how many of them each body is part of
+        std::vector<std::pair<uint32_t, uint32_t>> connections;
+        std::vector<uint32_t> connection_counts;
+    };
+
+
+    // An island is stiff when one of its bodies turns faster than max_angular_speed, or is connected to more than one other body
+    // by persistent constraints, like the links of a ragdoll or a chain. A joint made of several constraint rows is a single connection,
+    // so a body with one attached part isn't stiff. The islands are formed by all constraints. Returns true if any island is stiff.
+    bool MarkStiffIslands(
+        Range<Constraint const *> constraints,
+        Range<Constraint const *> other_constraints,
+        Range<Constraint const *> persistent_constraints,
+        Range<Constraint const *> other_persistent_constraints,
+        Range<Inertia const *> inverse_inertias,
+        Range<Movement const *> movements,
+        float max_angular_speed,
+        StiffIslands & self);
+
+    // copies the constraints of the stiff islands, call after MarkStiffIslands
+    void SelectStiffConstraints(
+        StiffIslands const & self,
+        Range<Constraint const *> constraints,
+        Range<SingleBodyConstraint const *> single_body_constraints,
+        std::vector<Constraint> & stiff_constraints,
+        std::vector<SingleBodyConstraint> & stiff_single_body_constraints);
+}
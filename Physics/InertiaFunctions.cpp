@@ -2,6 +2,9 @@
 
 #include <Math\FloatMatrixOperators.h>
 #include <Math\TransformFunctions.h>
+#include <Math\MathFunctions.h>
+#include <Math\MathConstants.h>
+#include <BoundingShapes\CapsuleFunctions.h>
 #include <BoundingShapes\OrientedBoxFunctions.h>
 #include <BoundingShapes\SphereFunctions.h>
 
@@ -66,6 +69,53 @@ namespace Physics
     }
 
 
+    // axis goes from the center of one cap to the other, its length is the length of the cylinder
+    Inertia CreateCapsuleInertia( 
+        Math::Float3 axis, 
+        float radius, 
+        float mass 
+        )
+    {
+        // the mass is split by volume between the cylinder and the two hemispheres
+        auto const length = Norm( axis );
+        auto const squared_radius = radius * radius;
+        auto const cylinder_volume = c_PI.f * squared_radius * length;
+        auto const sphere_volume = 4.f / 3.f * c_PI.f * squared_radius * radius;
+        auto const cylinder_mass = mass * cylinder_volume / ( cylinder_volume + sphere_volume );
+        auto const sphere_mass = mass - cylinder_mass;
+
+        auto const around_axis = cylinder_mass * squared_radius / 2 + 2.f / 5.f * sphere_mass * squared_radius;
+        auto const hemisphere_offset = length * length / 4 + 3.f / 8.f * length * radius;
+        auto const across_axis =
+            cylinder_mass * ( squared_radius / 4 + length * length / 12 ) +
+            sphere_mass * ( 2.f / 5.f * squared_radius + hemisphere_offset );
+
+        auto inertia = CreateInertia( across_axis, mass );
+        if( length > 0 )
+        {
+            // add the difference along the axis, (around - across) * a * a^T
+            auto const a = axis / length;
+            auto const difference = around_axis - across_axis;
+            inertia.moment += Float3x3(
+                a * ( a.x * difference ),
+                a * ( a.y * difference ),
+                a * ( a.z * difference ) );
+        }
+        return inertia;
+    }
+
+
+    Inertia CreateInertia( 
+        BoundingShapes::Capsule const & capsule, 
+        float mass 
+        )
+    {
+        auto capsule_inertia = CreateCapsuleInertia( capsule.end - capsule.start, capsule.radius, mass );
+        capsule_inertia = TranslateAwayFromCenterOfMass( capsule_inertia, BoundingShapes::GetCenter( capsule ) );
+        return capsule_inertia;
+    }
+
+
     Inertia CreateInverseBoxInertia( 
         Math::Float3 size, 
         float mass 
@@ -135,6 +185,19 @@ namespace Physics
 
     namespace
     {
+        template<typename ShapeType>
+        Math::Float3 Center(ShapeType const & shape)
+        {
+            return shape.center;
+        }
+
+
+        Math::Float3 Center(BoundingShapes::Capsule const & capsule)
+        {
+            return BoundingShapes::GetCenter(capsule);
+        }
+
+
         template<typename ShapeType>
         float TotalVolume(Range<ShapeType const*> shapes)
         {
@@ -158,14 +221,14 @@ namespace Physics
         {
             auto density = total_mass / total_volume;
             Inertia total_inertia = CreateInertia(First(shapes), Volume(First(shapes)) * density);
-            auto center_of_mass = First(shapes).center;
+            auto center_of_mass = Center(First(shapes));
             for( auto i = 1; i < Size(shapes); ++i )
             {
                 auto & sphere = shapes[i];
                 auto volume = Volume(sphere);
                 auto mass = density * volume;
                 auto inertia = CreateInertia(sphere, mass);
-                Combine(inertia, sphere.center, total_inertia, center_of_mass, total_inertia, center_of_mass);
+                Combine(inertia, Center(sphere), total_inertia, center_of_mass, total_inertia, center_of_mass);
             }
             total_inertia_output = total_inertia;
             center_of_mass_output = center_of_mass;
@@ -184,6 +247,37 @@ namespace Physics
             float total_volume = TotalVolume(shapes);
             CalculateTotalInertiaImpl(shapes, total_volume, total_mass, total_inertia_output, center_of_mass_output);
         }
+
+
+        // the first kind of shape that is not empty starts the total, the others are combined with it
+        template <typename ShapeType>
+        void AddToTotalInertia(
+            Range<ShapeType const *> shapes, 
+            float total_volume, 
+            float total_mass, 
+            bool & has_shapes, 
+            Inertia & total_inertia, 
+            Math::Float3 & center_of_mass
+            )
+        {
+            if(IsEmpty(shapes))
+            {
+                return;
+            }
+            Inertia shapes_inertia{};
+            Math::Float3 shapes_center_of_mass{};
+            CalculateTotalInertiaImpl(shapes, total_volume, total_mass, shapes_inertia, shapes_center_of_mass);
+            if(has_shapes)
+            {
+                Combine(total_inertia, center_of_mass, shapes_inertia, shapes_center_of_mass, total_inertia, center_of_mass);
+            }
+            else
+            {
+                total_inertia = shapes_inertia;
+                center_of_mass = shapes_center_of_mass;
+                has_shapes = true;
+            }
+        }
     }
 
 
@@ -223,42 +317,18 @@ namespace Physics
     void CalculateTotalInertia(
         Range<BoundingShapes::Sphere const *> spheres, 
         Range<BoundingShapes::OrientedBox const *> boxes, 
+        Range<BoundingShapes::Capsule const *> capsules, 
         float total_mass, 
         Inertia & total_inertia, 
         Math::Float3 & center_of_mass
         )
     {
-        auto total_volume = TotalVolume(spheres) + TotalVolume(boxes);
-        Inertia spheres_inertia{};
-        Math::Float3 spheres_center_of_mass{};
-        auto no_spheres = IsEmpty(spheres);
-        auto no_boxes = IsEmpty(boxes);
-        assert(!no_spheres || !no_boxes);
-        if(!no_spheres)
-        {
-            CalculateTotalInertiaImpl(spheres, total_volume, total_mass, spheres_inertia, spheres_center_of_mass);
-        }
-        Inertia boxes_inertia{};
-        Math::Float3 boxes_center_of_mass{};
-        if(!no_boxes)
-        {
-            CalculateTotalInertiaImpl(boxes, total_volume, total_mass, boxes_inertia, boxes_center_of_mass);
-        }
-
-        if(!no_spheres && !no_boxes)
-        {
-            Combine(spheres_inertia, spheres_center_of_mass, boxes_inertia, boxes_center_of_mass, total_inertia, center_of_mass);
-        }
-        else if(!no_spheres)
-        {
-            total_inertia = spheres_inertia;
-            center_of_mass = spheres_center_of_mass;
-        }
-        else //if(!no_boxes)
-        {
-            total_inertia = boxes_inertia;
-            center_of_mass = boxes_center_of_mass;
-        }
+        auto total_volume = TotalVolume(spheres) + TotalVolume(boxes) + TotalVolume(capsules);
+        auto has_shapes = false;
+        AddToTotalInertia(spheres, total_volume, total_mass, has_shapes, total_inertia, center_of_mass);
+        AddToTotalInertia(boxes, total_volume, total_mass, has_shapes, total_inertia, center_of_mass);
+        AddToTotalInertia(capsules, total_volume, total_mass, has_shapes, total_inertia, center_of_mass);
+        assert(has_shapes);
     }
 
 
@@ -5,6 +5,7 @@
 
 namespace BoundingShapes
 {
+    struct Capsule;
     struct OrientedBox;
     struct Sphere;
 }
@@ -36,6 +37,17 @@ namespace Physics
         float mass 
         );
 
+    Inertia CreateCapsuleInertia( 
+        Math::Float3 axis, 
+        float radius, 
+        float mass 
+        );
+
+    Inertia CreateInertia( 
+        BoundingShapes::Capsule const & capsule, 
+        float mass 
+        );
+
     Inertia CreateInverseBoxInertia( 
         Math::Float3 box_size, 
         float mass 
@@ -86,6 +98,7 @@ namespace Physics
     void CalculateTotalInertia(
         Range<BoundingShapes::Sphere const *> spheres, 
         Range<BoundingShapes::OrientedBox const *> boxes, 
+        Range<BoundingShapes::Capsule const *> capsules, 
         float total_mass, 
         Inertia & total_inertia, 
         Math::Float3 & center_of_mass
@@ -5,8 +5,10 @@
 #include <BoundingShapes\BoundingShapeHierarchyMeshFunctions.h>
 #include <BoundingShapes\SATFunctions.h>
 #include <BoundingShapes\AxisAlignedBoxFunctions.h>
+#include <BoundingShapes\CapsuleFunctions.h>
 #include <BoundingShapes\OrientedBoxFunctions.h>
 #include <BoundingShapes\TriangleFunctions.h>
+#include <BoundingShapes\TriangleBatchFunctions.h>
 #include <BoundingShapes\IntersectionTests.h>
 #include <BoundingShapes\PlaneFunctions.h>
 
@@ -202,6 +204,24 @@ namespace Physics
         };
 
 
+        // clips the incident face against the planes of the reference face, all contact points get the same depth and axis
+        // discard_vertices removes the clipped vertices that are in front of the reference face and returns how many are left
+        template<typename DiscardVertices>
+        Manifold CreateClippedManifold( std::array<BoundingShapes::Plane, 4> const & planes, std::array<Math::Float3, 4> const & vertices, float depth, Math::Float3 separation_axis, DiscardVertices discard_vertices )
+        {
+            std::array<Math::Float3, c_max_clipped_vertex_count> clipped_vertices;
+            auto count = SutherlandHodgman( planes, vertices, clipped_vertices );
+            count = discard_vertices( CreateRange( clipped_vertices.data(), count ) );
+            std::array<float, c_max_clipped_vertex_count> penetration_depths;
+            penetration_depths.fill( depth );
+            std::array<uint8_t, c_max_clipped_vertex_count> ages;
+            ages.fill( 0 );
+            std::array<Math::Float3, c_max_clipped_vertex_count> separation_axes;
+            separation_axes.fill( separation_axis );
+            return CreateManifold( CreateRange( penetration_depths.data(), count ), CreateRange( separation_axes.data(), count ), CreateRange( clipped_vertices.data(), count ), CreateRange( ages.data(), count ) );
+        }
+
+
         Manifold CreateManifoldFromExtent( Math::Float3 const extent, BoundingShapes::OrientedBox box )
         {
             float const zero_axis_tolerance = 1e-3f;
@@ -285,12 +305,10 @@ namespace Physics
                 auto vertices = BoundingShapes::GetFaceCorners( BoundingShapes::AxisAlignedBox{ 0, extent }, incident_face_index );
                 std::array<BoundingShapes::Plane, 4> planes;
                 MakePlaneEquations( box, reference_face_index, planes );
-                auto clipped_vertices = SutherlandHodgman( planes, vertices );
-                clipped_vertices.resize( DiscardVertices( box, reference_face_index, clipped_vertices ) );
-                std::vector<float> penetration_depths(clipped_vertices.size(), min_depth);
-                std::vector<uint8_t> ages(clipped_vertices.size(), 0);
-                std::vector<Math::Float3> separation_axes(clipped_vertices.size(), separation_axis);
-                manifold = CreateManifold(penetration_depths, separation_axes, clipped_vertices, ages);
+                manifold = CreateClippedManifold( planes, vertices, min_depth, separation_axis, [&]( Range<Math::Float3 *> clipped_vertices )
+                {
+                    return DiscardVertices( box, reference_face_index, clipped_vertices );
+                } );
             }
             else if( min_depth_box <= min_depth_edges )
             {
@@ -308,12 +326,10 @@ namespace Physics
                 auto vertices = GetFaceCorners( box, incident_face_index );
                 std::array<BoundingShapes::Plane, 4> planes;
                 MakePlaneEquations( extent, reference_face_index, planes );
-                auto clipped_vertices = SutherlandHodgman( planes, vertices );
-                clipped_vertices.resize(DiscardVertices( BoundingShapes::AxisAlignedBox{ 0, extent }, reference_face_index, clipped_vertices ));
-                std::vector<float> penetration_depths(clipped_vertices.size(), min_depth);
-                std::vector<uint8_t> ages(clipped_vertices.size(), 0);
-                std::vector<Math::Float3> separation_axes(clipped_vertices.size(), separation_axis);
-                manifold = CreateManifold(penetration_depths, separation_axes, clipped_vertices, ages);
+                manifold = CreateClippedManifold( planes, vertices, min_depth, separation_axis, [&]( Range<Math::Float3 *> clipped_vertices )
+                {
+                    return DiscardVertices( BoundingShapes::AxisAlignedBox{ 0, extent }, reference_face_index, clipped_vertices );
+                } );
             }
             else
             {
@@ -607,11 +623,89 @@ namespace Physics
 
     namespace
     {
+        // number of triangles gathered from the mesh before they are tested
+        uint32_t const c_gathered_triangle_count = 64;
+        // number of contact points collected before they are reduced to a manifold
+        uint32_t const c_collected_contact_count = 64;
+
+
+        struct ContactCollection
+        {
+            std::array<float, c_collected_contact_count> penetration_depths;
+            std::array<Math::Float3, c_collected_contact_count> separation_axes;
+            std::array<Math::Float3, c_collected_contact_count> positions;
+            std::array<uint8_t, c_collected_contact_count> ages;
+            uint32_t count = 0;
+        };
+
+
+        Manifold ReduceContacts( ContactCollection & contacts )
+        {
+            return CreateManifold(
+                CreateRange( contacts.penetration_depths, 0, contacts.count ),
+                CreateRange( contacts.separation_axes, 0, contacts.count ),
+                CreateRange( contacts.positions, 0, contacts.count ),
+                CreateRange( contacts.ages, 0, contacts.count )
+                );
+        }
+
+
+        void AddContacts( Manifold const & manifold, ContactCollection & contacts )
+        {
+            if( contacts.count + manifold.contact_point_count > c_collected_contact_count )
+            {
+                // keeps the deepest point, so the result is the same as reducing everything at once
+                auto const reduced = ReduceContacts( contacts );
+                contacts.count = 0;
+                AddContacts( reduced, contacts );
+            }
+            auto const count = manifold.contact_point_count;
+            Copy( manifold.penetration_depths.data(), count, contacts.penetration_depths.data() + contacts.count );
+            Copy( manifold.separation_axes.data(), count, contacts.separation_axes.data() + contacts.count );
+            Copy( manifold.positions.data(), count, contacts.positions.data() + contacts.count );
+            Copy( manifold.ages.data(), count, contacts.ages.data() + contacts.count );
+            contacts.count += count;
+        }
+
+
+        // the triangles are in the space of the box, they are rejected four at a time and only the remaining ones get the exact test
+        void CollideTriangles( Math::Float3 extent, Range<BoundingShapes::Triangle const *> triangles, ContactCollection & contacts )
+        {
+            auto const triangle_count = uint32_t( Size( triangles ) );
+            for( auto i = 0u; i < triangle_count; i += BoundingShapes::c_triangle_batch_width )
+            {
+                // pad the last batch by repeating its last triangle
+                BoundingShapes::TriangleBatch batch;
+                for( auto lane = 0u; lane < BoundingShapes::c_triangle_batch_width; ++lane )
+                {
+                    SetTriangle( triangles[std::min( i + lane, triangle_count - 1 )], lane, batch );
+                }
+
+                auto const lanes = OverlappingLanes( batch, extent );
+                for( auto lane = 0u; lane < BoundingShapes::c_triangle_batch_width && i + lane < triangle_count; ++lane )
+                {
+                    if( lanes & ( 1u << lane ) )
+                    {
+                        auto const manifold = CreateManifoldFromExtent( extent, triangles[i + lane] );
+                        if( manifold.contact_point_count > 0 )
+                        {
+                            AddContacts( manifold, contacts );
+                        }
+                    }
+                }
+            }
+        }
+
+
         template<typename ShapeType>
         Manifold CreateManifoldImpl( BoundingShapes::OrientedBox const box, BoundingShapes::BoundingShapeHierarchyMesh<ShapeType> const & mesh )
         {
-            Manifold manifold;
-            manifold.contact_point_count = 0;
+            auto const to_box_space = Math::ReverseAffineTransform( box.center, box.rotation );
+
+            // gather the triangles in the leafs that are reached, and test them whenever the buffer is full
+            std::array<BoundingShapes::Triangle, c_gathered_triangle_count> triangles;
+            auto triangle_count = 0u;
+            ContactCollection contacts;
 
             Traverse(mesh,
                 [&box](ShapeType const & shape)
@@ -622,14 +716,23 @@ namespace Physics
                 {
                     auto const & positions = mesh.vertex_positions;
                     auto const triangle = BoundingShapes::CreateTriangle( positions[indices[0]], positions[indices[1]], positions[indices[2]] );
-                    auto const new_manifold = CreateManifold( box, triangle );
-                    if( new_manifold.contact_point_count > 0 )
+                    triangles[triangle_count] = BoundingShapes::Transform( triangle, to_box_space );
+                    ++triangle_count;
+                    if( triangle_count == c_gathered_triangle_count )
                     {
-                        manifold = MergeManifolds( manifold, new_manifold );
+                        CollideTriangles( box.extent, CreateRange( triangles, 0, triangle_count ), contacts );
+                        triangle_count = 0;
                     }
                     return true;
                 });
+            CollideTriangles( box.extent, CreateRange( triangles, 0, triangle_count ), contacts );
 
+            auto manifold = ReduceContacts( contacts );
+            for( auto i = 0u; i < manifold.contact_point_count; ++i )
+            {
+                manifold.positions[i] = Rotate( manifold.positions[i], box.rotation ) + box.center;
+                manifold.separation_axes[i] = Rotate( manifold.separation_axes[i], box.rotation );
+            }
             return manifold;
         }
     }
@@ -647,6 +750,173 @@ namespace Physics
     }
 
 
+    Manifold CreateManifold( BoundingShapes::Sphere sphere, BoundingShapes::Triangle const & triangle )
+    {
+        auto const closest_point = ClosestPoint( triangle, sphere.center );
+        auto const distance_vector = sphere.center - closest_point;
+        auto const squared_distance = SquaredNorm( distance_vector );
+        Manifold manifold;
+        if( squared_distance < sphere.radius * sphere.radius )
+        {
+            Math::Float3 separation_axis;
+            auto distance = 0.f;
+            if( squared_distance > 0 )
+            {
+                distance = Math::Sqrt( squared_distance );
+                separation_axis = distance_vector / distance;
+            }
+            else
+            {
+                // the center is on the triangle, push it out of the front face
+                separation_axis = GetNormal( triangle );
+            }
+            manifold.contact_point_count = 1;
+            manifold.separation_axes[0] = separation_axis;
+            manifold.positions[0] = closest_point;
+            manifold.penetration_depths[0] = sphere.radius - distance;
+        }
+        return manifold;
+    }
+
+
+    namespace
+    {
+        // tests all triangles of the mesh that are reached with the node function, and reduces their contacts once at the end
+        template<typename ShapeType, typename QueryShapeType, typename NodeFunctionType>
+        Manifold CreateMeshManifold( QueryShapeType const & query_shape, BoundingShapes::BoundingShapeHierarchyMesh<ShapeType> const & mesh, NodeFunctionType node_function )
+        {
+            ContactCollection contacts;
+            Traverse(mesh,
+                node_function,
+                [&](std::array<uint32_t,3> const & indices)
+                {
+                    auto const & positions = mesh.vertex_positions;
+                    auto const triangle = BoundingShapes::CreateTriangle( positions[indices[0]], positions[indices[1]], positions[indices[2]] );
+                    auto const manifold = CreateManifold( query_shape, triangle );
+                    if( manifold.contact_point_count > 0 )
+                    {
+                        AddContacts( manifold, contacts );
+                    }
+                    return true;
+                });
+            return ReduceContacts( contacts );
+        }
+
+
+        template<typename ShapeType>
+        Manifold CreateSphereMeshManifold( BoundingShapes::Sphere const & sphere, BoundingShapes::BoundingShapeHierarchyMesh<ShapeType> const & mesh )
+        {
+            return CreateMeshManifold( sphere, mesh, [&sphere]( ShapeType const & shape )
+            {
+                return Intersect( shape, sphere );
+            } );
+        }
+
+
+        template<typename ShapeType>
+        Manifold CreateCapsuleMeshManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::BoundingShapeHierarchyMesh<ShapeType> const & mesh )
+        {
+            auto const bounds = CreateAxisAlignedBox( capsule );
+            return CreateMeshManifold( capsule, mesh, [&bounds]( ShapeType const & shape )
+            {
+                return Intersect( bounds, shape );
+            } );
+        }
+
+
+        // parameters closer than this to the ends of the axis already get the contact of that end
+        float const c_capsule_end_tolerance = 1e-3f;
+
+
+        template<typename CreateSphereManifoldFunctionType>
+        Manifold CreateCapsuleManifold( BoundingShapes::Capsule const & capsule, float closest_parameter, CreateSphereManifoldFunctionType create_sphere_manifold )
+        {
+            auto manifold = create_sphere_manifold( BoundingShapes::Sphere{ capsule.start, capsule.radius } );
+            manifold = MergeManifolds( manifold, create_sphere_manifold( BoundingShapes::Sphere{ capsule.end, capsule.radius } ) );
+            if( closest_parameter > c_capsule_end_tolerance && closest_parameter < 1 - c_capsule_end_tolerance )
+            {
+                auto const closest_sphere = BoundingShapes::Sphere{ GetAxisPoint( capsule, closest_parameter ), capsule.radius };
+                manifold = MergeManifolds( manifold, create_sphere_manifold( closest_sphere ) );
+            }
+            return manifold;
+        }
+    }
+
+
+    Manifold CreateManifold( BoundingShapes::Sphere const & sphere, BoundingShapes::SphereHierarchyMesh const & mesh )
+    {
+        return CreateSphereMeshManifold( sphere, mesh );
+    }
+
+
+    Manifold CreateManifold( BoundingShapes::Sphere const & sphere, BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh )
+    {
+        return CreateSphereMeshManifold( sphere, mesh );
+    }
+
+
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::Sphere const & sphere )
+    {
+        auto const closest_parameter = ClosestAxisParameter( capsule, sphere.center );
+        return CreateManifold( BoundingShapes::Sphere{ GetAxisPoint( capsule, closest_parameter ), capsule.radius }, sphere );
+    }
+
+
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule1, BoundingShapes::Capsule const & capsule2 )
+    {
+        float closest_parameter1, closest_parameter2;
+        ClosestAxisParameters( capsule1, capsule2, closest_parameter1, closest_parameter2 );
+        return CreateCapsuleManifold( capsule1, closest_parameter1, [&capsule2]( BoundingShapes::Sphere const & sphere )
+        {
+            auto const parameter = ClosestAxisParameter( capsule2, sphere.center );
+            return CreateManifold( sphere, BoundingShapes::Sphere{ GetAxisPoint( capsule2, parameter ), capsule2.radius } );
+        } );
+    }
+
+
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::OrientedBox const & box )
+    {
+        auto const box_space_capsule = Rotate( Translate( capsule, -box.center ), Conjugate( box.rotation ) );
+        auto const closest_parameter = ClosestAxisParameter( box_space_capsule, BoundingShapes::AxisAlignedBox{ 0, box.extent } );
+        return CreateCapsuleManifold( capsule, closest_parameter, [&box]( BoundingShapes::Sphere const & sphere )
+        {
+            return CreateManifold( sphere, box );
+        } );
+    }
+
+
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::Triangle const & triangle )
+    {
+        auto const closest_parameter = ClosestAxisParameter( capsule, triangle );
+        return CreateCapsuleManifold( capsule, closest_parameter, [&triangle]( BoundingShapes::Sphere const & sphere )
+        {
+            return CreateManifold( sphere, triangle );
+        } );
+    }
+
+
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, DensityFunctionType const & sample_function )
+    {
+        // there is no closest point to a density, sample the middle
+        return CreateCapsuleManifold( capsule, 0.5f, [&sample_function]( BoundingShapes::Sphere const & sphere )
+        {
+            return CreateManifold( sphere, sample_function );
+        } );
+    }
+
+
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::SphereHierarchyMesh const & mesh )
+    {
+        return CreateCapsuleMeshManifold( capsule, mesh );
+    }
+
+
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh )
+    {
+        return CreateCapsuleMeshManifold( capsule, mesh );
+    }
+
+
     namespace
     {
         template<typename DataType>
@@ -3,6 +3,7 @@
 #include "DensityFunction.h"
 
 #include <BoundingShapes\AxisAlignedBox.h>
+#include <BoundingShapes\Capsule.h>
 #include <BoundingShapes\OrientedBox.h>
 #include <BoundingShapes\Sphere.h>
 #include <BoundingShapes\SphereHierarchyMesh.h>
@@ -30,6 +31,19 @@ namespace Physics
 	Manifold CreateManifold( BoundingShapes::OrientedBox const & box, BoundingShapes::SphereHierarchyMesh const & mesh );
     Manifold CreateManifold( BoundingShapes::OrientedBox const & box, BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh );
 
+    Manifold CreateManifold( BoundingShapes::Sphere sphere, BoundingShapes::Triangle const & triangle );
+    Manifold CreateManifold( BoundingShapes::Sphere const & sphere, BoundingShapes::SphereHierarchyMesh const & mesh );
+    Manifold CreateManifold( BoundingShapes::Sphere const & sphere, BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh );
+
+    // a capsule gets contacts at both ends and at its closest point in between, so it can rest on a surface
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::Sphere const & sphere );
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule1, BoundingShapes::Capsule const & capsule2 );
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::OrientedBox const & box );
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::Triangle const & triangle );
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, DensityFunctionType const & sample_function );
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::SphereHierarchyMesh const & mesh );
+    Manifold CreateManifold( BoundingShapes::Capsule const & capsule, BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh );
+
     // the input gets destroyed!
     Manifold CreateManifold(Range<float *> penetration_depths, Range<Math::Float3 *> separation_axes, Range<Math::Float3 *> positions, Range<uint8_t *> ages);
 
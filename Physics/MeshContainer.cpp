@@ -44,10 +44,13 @@ void Physics::AddMesh( BodyID body_id, AxisAlignedBoxHierarchyMeshID mesh_id, Me
 
 namespace
 {
+    // the meshes are indexed by their id, so the slot is only released for reuse and no other mesh or body mapping has to change
     void UncheckedRemove(AxisAlignedBoxHierarchyMeshID::index_t mesh_index , MeshContainer & self)
     {
-        ::Remove( mesh_index, self.meshes, self.body_to_data, self.generations, self.free_list );
+        ++self.generations[mesh_index];
+        self.meshes[mesh_index] = BoundingShapes::AxisAlignedBoxHierarchyMesh();
         self.usage_counts[mesh_index] = 0;
+        self.free_list.push_back(mesh_index);
     }
 }
 
@@ -68,6 +71,7 @@ void Physics::Remove( BodyID body_id, MeshContainer & self )
     if( index != c_invalid_index )
     {
         assert(self.usage_counts[index] > 0);
+        self.body_to_data[body_id.index] = c_invalid_index;
         if( (self.usage_counts[index] -= 1) == 0 )
         {
             UncheckedRemove(index, self);
@@ -3,11 +3,17 @@
 #include "ManifoldFunctions.h"
 
 #include <Conventions\OrientationFunctions.h>
+#include <BoundingShapes\CapsuleFunctions.h>
 #include <BoundingShapes\OrientedBoxFunctions.h>
 #include <BoundingShapes\SphereFunctions.h>
 #include <Utilities\VectorHelper.h>
 #include <Math\MathFunctions.h>
 
+#include <ppl.h>
+
+#include <algorithm>
+#include <array>
+
 namespace
 {
     using namespace Physics;
@@ -32,7 +38,6 @@ namespace
 
     struct CollisionCatagories
     {
-        std::vector<BodyAndOrientationPair> all;
         Range<BodyAndOrientationPair *>
             sphere_vs_sphere,
             sphere_vs_box,
@@ -40,7 +45,12 @@ namespace
             sphere_vs_mesh,
             box_vs_box,
             box_vs_density_function,
-            box_vs_mesh;
+            box_vs_mesh,
+            capsule_vs_sphere,
+            capsule_vs_box,
+            capsule_vs_capsule,
+            capsule_vs_density_function,
+            capsule_vs_mesh;
     };
 
 
@@ -112,37 +122,247 @@ namespace
     void CategorizeBodiesAndOrientations(
         Range<uint32_t const *> body_to_sphere,
         Range<uint32_t const *> body_to_box,
+        Range<uint32_t const *> body_to_capsule,
         Range<uint32_t const *> body_to_density_function,
         Range<uint32_t const *> body_to_mesh,
         Range<BodyAndOrientationPair *> entities_and_orientations,
+        std::vector<BodyAndOrientationPair> & storage,
         CollisionCatagories & catagories
         )
     {
-        catagories.all.clear();
-        catagories.all.reserve(Size(entities_and_orientations));
+        storage.clear();
+        storage.reserve(Size(entities_and_orientations));
 
-        std::array<uint32_t, 7> ends;
+        std::array<uint32_t, 12> ends;
 
         auto spheres = FindAll(entities_and_orientations, body_to_sphere);
-        ends[0] = CopyIfBoth(spheres, body_to_sphere, catagories.all);
-        ends[1] = ends[0] + CopyBothWays(spheres, body_to_sphere, body_to_box, catagories.all);
-        ends[2] = ends[1] + CopyBothWays(spheres, body_to_sphere, body_to_density_function, catagories.all);
-        ends[3] = ends[2] + CopyBothWays(spheres, body_to_sphere, body_to_mesh, catagories.all);
+        ends[0] = CopyIfBoth(spheres, body_to_sphere, storage);
+        ends[1] = ends[0] + CopyBothWays(spheres, body_to_sphere, body_to_box, storage);
+        ends[2] = ends[1] + CopyBothWays(spheres, body_to_sphere, body_to_density_function, storage);
+        ends[3] = ends[2] + CopyBothWays(spheres, body_to_sphere, body_to_mesh, storage);
 
         auto boxes = FindAll(entities_and_orientations, body_to_box);
-        ends[4] = ends[3] + CopyIfBoth(boxes, body_to_box, catagories.all);
-        ends[5] = ends[4] + CopyBothWays(boxes, body_to_box, body_to_density_function, catagories.all);
-        ends[6] = ends[5] + CopyBothWays(boxes, body_to_box, body_to_mesh, catagories.all);
-
-        catagories.sphere_vs_sphere = CreateRange(catagories.all, 0, ends[0]);
-        catagories.sphere_vs_box = CreateRange(catagories.all, ends[0], ends[1]);
-        catagories.sphere_vs_density_function = CreateRange(catagories.all, ends[1], ends[2]);
-        catagories.sphere_vs_mesh = CreateRange(catagories.all, ends[2], ends[3]);
-        catagories.box_vs_box = CreateRange(catagories.all, ends[3], ends[4]);
-        catagories.box_vs_density_function = CreateRange(catagories.all, ends[4], ends[5]);
-        catagories.box_vs_mesh = CreateRange(catagories.all, ends[5], ends[6]);
+        ends[4] = ends[3] + CopyIfBoth(boxes, body_to_box, storage);
+        ends[5] = ends[4] + CopyBothWays(boxes, body_to_box, body_to_density_function, storage);
+        ends[6] = ends[5] + CopyBothWays(boxes, body_to_box, body_to_mesh, storage);
+
+        auto capsules = FindAll(entities_and_orientations, body_to_capsule);
+        ends[7] = ends[6] + CopyBothWays(capsules, body_to_capsule, body_to_sphere, storage);
+        ends[8] = ends[7] + CopyBothWays(capsules, body_to_capsule, body_to_box, storage);
+        ends[9] = ends[8] + CopyIfBoth(capsules, body_to_capsule, storage);
+        ends[10] = ends[9] + CopyBothWays(capsules, body_to_capsule, body_to_density_function, storage);
+        ends[11] = ends[10] + CopyBothWays(capsules, body_to_capsule, body_to_mesh, storage);
+
+        catagories.sphere_vs_sphere = CreateRange(storage, 0, ends[0]);
+        catagories.sphere_vs_box = CreateRange(storage, ends[0], ends[1]);
+        catagories.sphere_vs_density_function = CreateRange(storage, ends[1], ends[2]);
+        catagories.sphere_vs_mesh = CreateRange(storage, ends[2], ends[3]);
+        catagories.box_vs_box = CreateRange(storage, ends[3], ends[4]);
+        catagories.box_vs_density_function = CreateRange(storage, ends[4], ends[5]);
+        catagories.box_vs_mesh = CreateRange(storage, ends[5], ends[6]);
+        catagories.capsule_vs_sphere = CreateRange(storage, ends[6], ends[7]);
+        catagories.capsule_vs_box = CreateRange(storage, ends[7], ends[8]);
+        catagories.capsule_vs_capsule = CreateRange(storage, ends[8], ends[9]);
+        catagories.capsule_vs_density_function = CreateRange(storage, ends[9], ends[10]);
+        catagories.capsule_vs_mesh = CreateRange(storage, ends[10], ends[11]);
+    }
+
+
+    // small enough to spread the work over the cores, large enough to not drown in scheduling overhead
+    uint32_t const c_pairs_per_chunk = 64;
+
+
+    uint32_t ChunkCount( size_t pair_count )
+    {
+        return uint32_t( ( pair_count + c_pairs_per_chunk - 1 ) / c_pairs_per_chunk );
+    }
+
+
+    // in the order of the CollisionCatagories
+    enum struct CollisionCategory : uint32_t
+    {
+        SphereVsSphere,
+        SphereVsBox,
+        SphereVsDensityFunction,
+        SphereVsMesh,
+        BoxVsBox,
+        BoxVsDensityFunction,
+        BoxVsMesh,
+        CapsuleVsSphere,
+        CapsuleVsBox,
+        CapsuleVsCapsule,
+        CapsuleVsDensityFunction,
+        CapsuleVsMesh,
+    };
+    uint32_t const c_category_count = 12;
+
+
+    struct NarrowPhaseShapes
+    {
+        Range<uint32_t const *> body_to_sphere_offset;
+        Range<uint32_t const *> sphere_offests;
+        Range<BoundingShapes::Sphere const *> spheres;
+        Range<uint32_t const *> body_to_box_offset;
+        Range<uint32_t const *> box_offests;
+        Range<BoundingShapes::OrientedBox const *> boxes;
+        Range<uint32_t const *> body_to_capsule_offset;
+        Range<uint32_t const *> capsule_offests;
+        Range<BoundingShapes::Capsule const *> capsules;
+        Range<uint32_t const *> body_to_density_function;
+        Range<DensityFunctionType const *> density_functions;
+        Range<uint32_t const *> body_to_mesh;
+        Range<BoundingShapes::AxisAlignedBoxHierarchyMesh const *> meshes;
+    };
+
+
+    void DetectCollisions(
+        CollisionCategory category,
+        Range<BodyAndOrientationPair const *> pairs,
+        NarrowPhaseShapes const & shapes,
+        NarrowPhaseChunkOutput & output
+        )
+    {
+        auto & bodies = output.collided_bodies;
+        auto & positions = output.relative_positions;
+        auto & manifolds = output.collision_manifolds;
+        switch( category )
+        {
+        case CollisionCategory::SphereVsSphere:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_sphere_offset, shapes.sphere_offests, shapes.spheres, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::SphereVsBox:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_sphere_offset, shapes.sphere_offests, shapes.spheres, shapes.body_to_box_offset, shapes.box_offests, shapes.boxes, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::SphereVsDensityFunction:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_sphere_offset, shapes.sphere_offests, shapes.spheres, shapes.body_to_density_function, shapes.density_functions, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::SphereVsMesh:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_sphere_offset, shapes.sphere_offests, shapes.spheres, shapes.body_to_mesh, shapes.meshes, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::BoxVsBox:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_box_offset, shapes.box_offests, shapes.boxes, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::BoxVsDensityFunction:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_box_offset, shapes.box_offests, shapes.boxes, shapes.body_to_density_function, shapes.density_functions, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::BoxVsMesh:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_box_offset, shapes.box_offests, shapes.boxes, shapes.body_to_mesh, shapes.meshes, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::CapsuleVsSphere:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_capsule_offset, shapes.capsule_offests, shapes.capsules, shapes.body_to_sphere_offset, shapes.sphere_offests, shapes.spheres, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::CapsuleVsBox:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_capsule_offset, shapes.capsule_offests, shapes.capsules, shapes.body_to_box_offset, shapes.box_offests, shapes.boxes, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::CapsuleVsCapsule:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_capsule_offset, shapes.capsule_offests, shapes.capsules, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::CapsuleVsDensityFunction:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_capsule_offset, shapes.capsule_offests, shapes.capsules, shapes.body_to_density_function, shapes.density_functions, bodies, positions, manifolds );
+            break;
+        case CollisionCategory::CapsuleVsMesh:
+            Physics::NarrowPhaseCollisionDetection( pairs, shapes.body_to_capsule_offset, shapes.capsule_offests, shapes.capsules, shapes.body_to_mesh, shapes.meshes, bodies, positions, manifolds );
+            break;
+        }
     }
 
+
+    // every shape of the first body against every shape of the second body, in world space relative to the first body
+    template<typename ShapeType1, typename ShapeType2>
+    void DetectShapeVsShapeCollisions(
+        Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+        Range<uint32_t const *> body_to_offset1,
+        Range<uint32_t const *> offsets1,
+        Range<ShapeType1 const *> shapes1,
+        Range<uint32_t const *> body_to_offset2,
+        Range<uint32_t const *> offsets2,
+        Range<ShapeType2 const *> shapes2,
+        std::vector<BodyPair> & collided_bodies,
+        std::vector<Math::Float3> & relative_positions,
+        std::vector<Manifold> & collision_manifolds)
+    {
+        for( auto i = 0u; i < Size(body_and_orientation_pairs); ++i )
+        {
+            auto const thingy = body_and_orientation_pairs[i];
+            auto const offset_index1 = body_to_offset1[thingy.body1.index];
+            auto const end_offset1 = offsets1[offset_index1 + 1];
+            auto const offset_index2 = body_to_offset2[thingy.body2.index];
+            auto const begin_offset2 = offsets2[offset_index2];
+            auto const end_offset2 = offsets2[offset_index2 + 1];
+            auto const orientation1 = thingy.orientation1;
+            auto orientation2 = thingy.orientation2;
+            orientation2.position -= orientation1.position;
+            Manifold manifold;
+            for( auto j = offsets1[offset_index1]; j < end_offset1; ++j )
+            {
+                auto const transformed_shape1 = Rotate( shapes1[j], orientation1.rotation );
+                for( auto k = begin_offset2; k < end_offset2; ++k )
+                {
+                    auto const transformed_shape2 = TransformByOrientation( shapes2[k], orientation2 );
+
+                    auto new_manifold = CreateManifold( transformed_shape1, transformed_shape2 );
+                    manifold = MergeManifolds(manifold, new_manifold);
+                }
+            }
+            if( manifold.contact_point_count > 0 )
+            {
+                auto const relative_position = orientation2.position;
+                collision_manifolds.push_back(manifold);
+                relative_positions.push_back(relative_position);
+                collided_bodies.emplace_back(thingy.body1, thingy.body2);
+            }
+        }
+    }
+
+
+    // every shape of the first body against the single density function or mesh of the second body, in the local space of the second body
+    template<typename ShapeType, typename OtherType>
+    void DetectShapeVsLocalCollisions(
+        Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+        Range<uint32_t const *> body_to_offset,
+        Range<uint32_t const *> offsets,
+        Range<ShapeType const *> shapes,
+        Range<uint32_t const *> body_to_other,
+        Range<OtherType const *> others,
+        std::vector<BodyPair> & collided_bodies,
+        std::vector<Math::Float3> & relative_positions,
+        std::vector<Manifold> & collision_manifolds)
+    {
+        for( auto i = 0u; i < Size(body_and_orientation_pairs); ++i )
+        {
+            auto thingy = body_and_orientation_pairs[i];
+            auto const orientation1 = thingy.orientation1;
+            auto const orientation2 = thingy.orientation2;
+            auto const & other = others[body_to_other[thingy.body2.index]];
+            auto const relative_orientation = ToParentFromLocal(Invert(orientation2), orientation1);
+
+            auto offset_index = body_to_offset[thingy.body1.index];
+            auto end_offset = offsets[offset_index + 1];
+            Manifold manifold;
+            for( auto j = offsets[offset_index]; j < end_offset; ++j )
+            {
+                auto const transformed_shape = TransformByOrientation( shapes[j], relative_orientation );
+
+                // create the manifold in the local space of the second body
+                Manifold new_manifold = CreateManifold( transformed_shape, other );
+                manifold = MergeManifolds(manifold, new_manifold);
+            }
+            if( manifold.contact_point_count > 0 )
+            {
+                // transform to world coordinates, but relative to the position of the first body
+                for( auto p = 0; p < manifold.contact_point_count; p++ )
+                {
+                    manifold.positions[p] = Rotate( manifold.positions[p] - relative_orientation.position, orientation2.rotation );
+                    manifold.separation_axes[p] = Rotate( manifold.separation_axes[p], orientation2.rotation );
+                }
+
+                auto const relative_position = relative_orientation.position;
+                collision_manifolds.push_back(manifold);
+                relative_positions.push_back(relative_position);
+                collided_bodies.emplace_back(thingy.body1, thingy.body2);
+            }
+        }
+    }
 }
 
 
@@ -294,6 +514,55 @@ void Physics::NarrowPhaseCollisionDetection(
     }
 }
 
+// sphere vs mesh
+void Physics::NarrowPhaseCollisionDetection(
+        Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+        Range<uint32_t const *> body_to_sphere_offset,
+        Range<uint32_t const *> sphere_offests,
+        Range<BoundingShapes::Sphere const *> spheres,
+        Range<uint32_t const *> body_to_mesh,
+        Range<BoundingShapes::AxisAlignedBoxHierarchyMesh const *> meshes,
+        std::vector<BodyPair> & collided_bodies,
+        std::vector<Math::Float3> & relative_positions,
+        std::vector<Manifold> & collision_manifolds)
+{
+    for( auto i = 0u; i < Size(body_and_orientation_pairs); ++i )
+    {
+        auto thingy = body_and_orientation_pairs[i];
+        auto const orientation1 = thingy.orientation1;
+        auto const orientation2 = thingy.orientation2;
+        auto const & mesh = meshes[body_to_mesh[thingy.body2.index]];
+        auto const relative_orientation = ToParentFromLocal(Invert(orientation2), orientation1);
+
+        auto sphere_offset_index = body_to_sphere_offset[thingy.body1.index];
+        auto end_offset = sphere_offests[sphere_offset_index + 1];
+        Manifold manifold;
+        for( auto j = sphere_offests[sphere_offset_index]; j < end_offset; ++j )
+        {
+            auto const & sphere = spheres[j];
+            auto const transformed_sphere = TransformByOrientation( sphere, relative_orientation );
+
+            // create the manifold in the local space of the mesh / second body
+            Manifold new_manifold = CreateManifold( transformed_sphere, mesh );
+            manifold = MergeManifolds(manifold, new_manifold);
+        }
+        if( manifold.contact_point_count > 0 )
+        {
+            // transform to world coordinates, but relative to the position of the first body
+            for( auto p = 0; p < manifold.contact_point_count; p++ )
+            {
+                manifold.positions[p] = Rotate( manifold.positions[p] - relative_orientation.position, orientation2.rotation );
+                manifold.separation_axes[p] = Rotate( manifold.separation_axes[p], orientation2.rotation );
+            }
+
+            auto const relative_position = relative_orientation.position;
+            collision_manifolds.push_back(manifold);
+            relative_positions.push_back(relative_position);
+            collided_bodies.emplace_back(thingy.body1, thingy.body2);
+        }
+    }
+}
+
 // box vs box
 void Physics::NarrowPhaseCollisionDetection(
         Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
@@ -445,19 +714,104 @@ void Physics::NarrowPhaseCollisionDetection(
 }
 
 
+// capsule vs sphere
 void Physics::NarrowPhaseCollisionDetection(
+    Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+    Range<uint32_t const *> body_to_capsule_offset,
+    Range<uint32_t const *> capsule_offests,
+    Range<BoundingShapes::Capsule const *> capsules,
     Range<uint32_t const *> body_to_sphere_offset,
     Range<uint32_t const *> sphere_offests,
     Range<BoundingShapes::Sphere const *> spheres,
+    std::vector<BodyPair> & collided_bodies,
+    std::vector<Math::Float3> & relative_positions,
+    std::vector<Manifold> & collision_manifolds)
+{
+    DetectShapeVsShapeCollisions( body_and_orientation_pairs, body_to_capsule_offset, capsule_offests, capsules, body_to_sphere_offset, sphere_offests, spheres, collided_bodies, relative_positions, collision_manifolds );
+}
+
+
+// capsule vs box
+void Physics::NarrowPhaseCollisionDetection(
+    Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+    Range<uint32_t const *> body_to_capsule_offset,
+    Range<uint32_t const *> capsule_offests,
+    Range<BoundingShapes::Capsule const *> capsules,
     Range<uint32_t const *> body_to_box_offset,
     Range<uint32_t const *> box_offests,
     Range<BoundingShapes::OrientedBox const *> boxes,
+    std::vector<BodyPair> & collided_bodies,
+    std::vector<Math::Float3> & relative_positions,
+    std::vector<Manifold> & collision_manifolds)
+{
+    DetectShapeVsShapeCollisions( body_and_orientation_pairs, body_to_capsule_offset, capsule_offests, capsules, body_to_box_offset, box_offests, boxes, collided_bodies, relative_positions, collision_manifolds );
+}
+
+
+// capsule vs capsule
+void Physics::NarrowPhaseCollisionDetection(
+    Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+    Range<uint32_t const *> body_to_capsule_offset,
+    Range<uint32_t const *> capsule_offests,
+    Range<BoundingShapes::Capsule const *> capsules,
+    std::vector<BodyPair> & collided_bodies,
+    std::vector<Math::Float3> & relative_positions,
+    std::vector<Manifold> & collision_manifolds)
+{
+    DetectShapeVsShapeCollisions( body_and_orientation_pairs, body_to_capsule_offset, capsule_offests, capsules, body_to_capsule_offset, capsule_offests, capsules, collided_bodies, relative_positions, collision_manifolds );
+}
+
+
+// capsule vs density
+void Physics::NarrowPhaseCollisionDetection(
+    Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+    Range<uint32_t const *> body_to_capsule_offset,
+    Range<uint32_t const *> capsule_offests,
+    Range<BoundingShapes::Capsule const *> capsules,
+    Range<uint32_t const *> body_to_density_function,
+    Range<DensityFunctionType const *> density_functions,
+    std::vector<BodyPair> & collided_bodies,
+    std::vector<Math::Float3> & relative_positions,
+    std::vector<Manifold> & collision_manifolds)
+{
+    DetectShapeVsLocalCollisions( body_and_orientation_pairs, body_to_capsule_offset, capsule_offests, capsules, body_to_density_function, density_functions, collided_bodies, relative_positions, collision_manifolds );
+}
+
+
+// capsule vs mesh
+void Physics::NarrowPhaseCollisionDetection(
+    Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+    Range<uint32_t const *> body_to_capsule_offset,
+    Range<uint32_t const *> capsule_offests,
+    Range<BoundingShapes::Capsule const *> capsules,
+    Range<uint32_t const *> body_to_mesh,
+    Range<BoundingShapes::AxisAlignedBoxHierarchyMesh const *> meshes,
+    std::vector<BodyPair> & collided_bodies,
+    std::vector<Math::Float3> & relative_positions,
+    std::vector<Manifold> & collision_manifolds)
+{
+    DetectShapeVsLocalCollisions( body_and_orientation_pairs, body_to_capsule_offset, capsule_offests, capsules, body_to_mesh, meshes, collided_bodies, relative_positions, collision_manifolds );
+}
+
+
+void Physics::NarrowPhaseCollisionDetection(
+    Range<uint32_t const *> body_to_sphere_offset,
+    Range<uint32_t const *> sphere_offests,
+    Range<BoundingShapes::Sphere const *> spheres,
+    Range<uint32_t const *> body_to_box_offset,
+    Range<uint32_t const *> box_offests,
+    Range<BoundingShapes::OrientedBox const *> boxes,
+    Range<uint32_t const *> body_to_capsule_offset,
+    Range<uint32_t const *> capsule_offests,
+    Range<BoundingShapes::Capsule const *> capsules,
     Range<uint32_t const *> body_to_density_function,
     Range<DensityFunctionType const *> density_functions,
     Range<uint32_t const *> body_to_mesh,
     Range<BoundingShapes::AxisAlignedBoxHierarchyMesh const *> meshes,
     // order gets changed
     Range<BodyAndOrientationPair *> entities_and_orientations,
+    std::vector<BodyAndOrientationPair> & categorized_pairs,
+    std::vector<NarrowPhaseChunkOutput> & chunk_outputs,
     // output
     std::vector<BodyPair> & collided_bodies,
     std::vector<Math::Float3> & relative_positions,
@@ -469,79 +823,81 @@ void Physics::NarrowPhaseCollisionDetection(
     CategorizeBodiesAndOrientations(
         body_to_sphere_offset,
         body_to_box_offset,
+        body_to_capsule_offset,
         body_to_density_function,
         body_to_mesh,
         entities_and_orientations,
+        categorized_pairs,
         catagories);
 
-    // sphere vs sphere
-    NarrowPhaseCollisionDetection(
-         catagories.sphere_vs_sphere,
-         body_to_sphere_offset,
-         sphere_offests,
-         spheres,
-         collided_bodies,
-         relative_positions,
-         collision_manifolds);
-
-    // sphere vs box
-    NarrowPhaseCollisionDetection(
+    // the chunks don't cross categories, so every chunk runs a single narrow phase function
+    std::array<Range<BodyAndOrientationPair *>, c_category_count> const category_pairs = {
+        catagories.sphere_vs_sphere,
         catagories.sphere_vs_box,
-        body_to_sphere_offset,
-        sphere_offests,
-        spheres,
-        body_to_box_offset,
-        box_offests,
-        boxes,
-        collided_bodies,
-        relative_positions,
-        collision_manifolds);
-
-    // sphere vs density
-    NarrowPhaseCollisionDetection(
         catagories.sphere_vs_density_function,
+        catagories.sphere_vs_mesh,
+        catagories.box_vs_box,
+        catagories.box_vs_density_function,
+        catagories.box_vs_mesh,
+        catagories.capsule_vs_sphere,
+        catagories.capsule_vs_box,
+        catagories.capsule_vs_capsule,
+        catagories.capsule_vs_density_function,
+        catagories.capsule_vs_mesh };
+    std::array<uint32_t, c_category_count + 1> chunk_starts;
+    chunk_starts[0] = 0;
+    for( auto c = 0u; c < c_category_count; ++c )
+    {
+        chunk_starts[c + 1] = chunk_starts[c] + ChunkCount( Size( category_pairs[c] ) );
+    }
+    auto const chunk_count = chunk_starts.back();
+    if( Size( chunk_outputs ) < chunk_count )
+    {
+        chunk_outputs.resize( chunk_count );
+    }
+
+    NarrowPhaseShapes const shapes = {
         body_to_sphere_offset,
         sphere_offests,
         spheres,
-        body_to_density_function,
-        density_functions,
-        collided_bodies,
-        relative_positions,
-        collision_manifolds);
-
-    assert(IsEmpty(catagories.sphere_vs_mesh) && "Not implemented yet.");
-
-    // box vs box
-    NarrowPhaseCollisionDetection(
-         catagories.box_vs_box,
-         body_to_box_offset,
-         box_offests,
-         boxes,
-         collided_bodies,
-         relative_positions,
-         collision_manifolds);
-
-    // box vs density
-    NarrowPhaseCollisionDetection(
-        catagories.box_vs_density_function,
         body_to_box_offset,
         box_offests,
         boxes,
+        body_to_capsule_offset,
+        capsule_offests,
+        capsules,
         body_to_density_function,
         density_functions,
-        collided_bodies,
-        relative_positions,
-        collision_manifolds);
-
-
-    NarrowPhaseCollisionDetection(
-        catagories.box_vs_mesh,
-        body_to_box_offset,
-        box_offests,
-        boxes,
         body_to_mesh,
-        meshes,
-        collided_bodies,
-        relative_positions,
-        collision_manifolds);
+        meshes };
+    Concurrency::parallel_for( 0u, chunk_count,
+        [&]( uint32_t chunk )
+    {
+        auto const category = uint32_t( std::upper_bound( begin( chunk_starts ), end( chunk_starts ), chunk ) - begin( chunk_starts ) ) - 1;
+        auto const pairs = category_pairs[category];
+        auto const pair_begin = ( chunk - chunk_starts[category] ) * c_pairs_per_chunk;
+        auto const pair_end = std::min( pair_begin + c_pairs_per_chunk, uint32_t( Size( pairs ) ) );
+        auto & output = chunk_outputs[chunk];
+        output.collided_bodies.clear();
+        output.relative_positions.clear();
+        output.collision_manifolds.clear();
+        DetectCollisions( CollisionCategory( category ), CreateRange( pairs, pair_begin, pair_end ), shapes, output );
+    } );
+
+    // merge in chunk order, which is the order of the pairs
+    auto total = Size( collided_bodies );
+    for( auto chunk = 0u; chunk < chunk_count; ++chunk )
+    {
+        total += Size( chunk_outputs[chunk].collided_bodies );
+    }
+    collided_bodies.reserve( total );
+    relative_positions.reserve( total );
+    collision_manifolds.reserve( total );
+    for( auto chunk = 0u; chunk < chunk_count; ++chunk )
+    {
+        auto const & output = chunk_outputs[chunk];
+        collided_bodies.insert( end( collided_bodies ), begin( output.collided_bodies ), end( output.collided_bodies ) );
+        relative_positions.insert( end( relative_positions ), begin( output.relative_positions ), end( output.relative_positions ) );
+        collision_manifolds.insert( end( collision_manifolds ), begin( output.collision_manifolds ), end( output.collision_manifolds ) );
+    }
 }
@@ -8,10 +8,12 @@
 #include <Utilities\Range.h>
 
 #include <cstdint>
+#include <vector>
 
 
 namespace BoundingShapes
 {
+    struct Capsule;
     struct OrientedBox;
     struct Sphere;
 }
@@ -19,6 +21,15 @@ namespace BoundingShapes
 
 namespace Physics
 {
+    // collisions found in one chunk of candidate pairs
+    struct NarrowPhaseChunkOutput
+    {
+        std::vector<BodyPair> collided_bodies;
+        std::vector<Math::Float3> relative_positions;
+        std::vector<Manifold> collision_manifolds;
+    };
+
+
     // sphere vs sphere
     void NarrowPhaseCollisionDetection(
         Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
@@ -54,6 +65,18 @@ namespace Physics
         std::vector<Math::Float3> & relative_positions,
         std::vector<Manifold> & collision_manifolds);
 
+    // sphere vs mesh
+    void NarrowPhaseCollisionDetection(
+        Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+        Range<uint32_t const *> body_to_sphere_offset,
+        Range<uint32_t const *> sphere_offests,
+        Range<BoundingShapes::Sphere const *> spheres,
+        Range<uint32_t const *> body_to_mesh,
+        Range<BoundingShapes::AxisAlignedBoxHierarchyMesh const *> meshes,
+        std::vector<BodyPair> & collided_bodies,
+        std::vector<Math::Float3> & relative_positions,
+        std::vector<Manifold> & collision_manifolds);
+
 
     // box vs box
     void NarrowPhaseCollisionDetection(
@@ -89,7 +112,69 @@ namespace Physics
         std::vector<Math::Float3> & relative_positions,
         std::vector<Manifold> & collision_manifolds);
 
+    // capsule vs sphere
+    void NarrowPhaseCollisionDetection(
+        Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+        Range<uint32_t const *> body_to_capsule_offset,
+        Range<uint32_t const *> capsule_offests,
+        Range<BoundingShapes::Capsule const *> capsules,
+        Range<uint32_t const *> body_to_sphere_offset,
+        Range<uint32_t const *> sphere_offests,
+        Range<BoundingShapes::Sphere const *> spheres,
+        std::vector<BodyPair> & collided_bodies,
+        std::vector<Math::Float3> & relative_positions,
+        std::vector<Manifold> & collision_manifolds);
+
+    // capsule vs box
+    void NarrowPhaseCollisionDetection(
+        Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+        Range<uint32_t const *> body_to_capsule_offset,
+        Range<uint32_t const *> capsule_offests,
+        Range<BoundingShapes::Capsule const *> capsules,
+        Range<uint32_t const *> body_to_box_offset,
+        Range<uint32_t const *> box_offests,
+        Range<BoundingShapes::OrientedBox const *> boxes,
+        std::vector<BodyPair> & collided_bodies,
+        std::vector<Math::Float3> & relative_positions,
+        std::vector<Manifold> & collision_manifolds);
+
+    // capsule vs capsule
+    void NarrowPhaseCollisionDetection(
+        Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+        Range<uint32_t const *> body_to_capsule_offset,
+        Range<uint32_t const *> capsule_offests,
+        Range<BoundingShapes::Capsule const *> capsules,
+        std::vector<BodyPair> & collided_bodies,
+        std::vector<Math::Float3> & relative_positions,
+        std::vector<Manifold> & collision_manifolds);
+
+    // capsule vs density
+    void NarrowPhaseCollisionDetection(
+        Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+        Range<uint32_t const *> body_to_capsule_offset,
+        Range<uint32_t const *> capsule_offests,
+        Range<BoundingShapes::Capsule const *> capsules,
+        Range<uint32_t const *> body_to_density_function,
+        Range<DensityFunctionType const *> density_functions,
+        std::vector<BodyPair> & collided_bodies,
+        std::vector<Math::Float3> & relative_positions,
+        std::vector<Manifold> & collision_manifolds);
+
+    // capsule vs mesh
+    void NarrowPhaseCollisionDetection(
+        Range<BodyAndOrientationPair const *> body_and_orientation_pairs,
+        Range<uint32_t const *> body_to_capsule_offset,
+        Range<uint32_t const *> capsule_offests,
+        Range<BoundingShapes::Capsule const *> capsules,
+        Range<uint32_t const *> body_to_mesh,
+        Range<BoundingShapes::AxisAlignedBoxHierarchyMesh const *> meshes,
+        std::vector<BodyPair> & collided_bodies,
+        std::vector<Math::Float3> & relative_positions,
+        std::vector<Manifold> & collision_manifolds);
+
     // everything vs everything
+    // the pairs are split in fixed size chunks that are processed in parallel,
+    // the chunk outputs are appended in pair order, so the output doesn't depend on the thread count
     void NarrowPhaseCollisionDetection(
         Range<uint32_t const *> body_to_sphere_offset,
         Range<uint32_t const *> sphere_offests,
@@ -97,12 +182,19 @@ namespace Physics
         Range<uint32_t const *> body_to_box_offset,
         Range<uint32_t const *> box_offests,
         Range<BoundingShapes::OrientedBox const *> boxes,
+        Range<uint32_t const *> body_to_capsule_offset,
+        Range<uint32_t const *> capsule_offests,
+        Range<BoundingShapes::Capsule const *> capsules,
         Range<uint32_t const *> body_to_density_function,
         Range<DensityFunctionType const *> density_functions,
         Range<uint32_t const *> body_to_mesh,
         Range<BoundingShapes::AxisAlignedBoxHierarchyMesh const *> meshes,
         // order gets changed
         Range<BodyAndOrientationPair *> bodies_and_orientations,
+        // temporary storage for the pairs sorted by shape types, pass the same vector every time to reuse its memory
+        std::vector<BodyAndOrientationPair> & categorized_pairs,
+        // temporary storage for the collisions of each chunk, pass the same vector every time to reuse its memory
+        std::vector<NarrowPhaseChunkOutput> & chunk_outputs,
         // output
         std::vector<BodyPair> & collided_bodies,
         std::vector<Math::Float3> & relative_positions,
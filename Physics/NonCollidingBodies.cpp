@@ -6,21 +6,43 @@
 using namespace Physics;
 
 
+namespace
+{
+    // moves the body at element 'from' to element 'to', only the mapping of the moved entity changes
+    // moving a body onto itself does nothing, which happens when there are no kinematic bodies
+    void MoveBody( uint32_t from, uint32_t to, NonCollidingBodies & self )
+    {
+        if( from == to ) return;
+        self.entity_ids[to] = self.entity_ids[from];
+        self.orientations[to] = self.orientations[from];
+        self.previous_orientations[to] = self.previous_orientations[from];
+        self.entity_to_element[self.entity_ids[to].index] = to;
+    }
+}
+
 
 void NonCollidingBodies::AddStaticComponent( EntityID entity_id, Orientation orientation )
 {
     auto insert_index = kinematic_body_start_index;
 
-    entity_ids.emplace( entity_ids.begin() + insert_index, entity_id );
-    orientations.emplace( orientations.begin() + insert_index, orientation );
-    previous_orientations.emplace( previous_orientations.begin() + insert_index, orientation );
-
-    for( auto & index : entity_to_element )
+    // the order within the kinematic bodies doesn't matter, so the first one moves to the end to make room
+    if( insert_index < entity_ids.size() )
     {
-        if( index >= insert_index && index != c_invalid_index )
-        {
-            ++index;
-        }
+        auto moved_entity_id = entity_ids[insert_index];
+        entity_ids.push_back( moved_entity_id );
+        orientations.push_back( orientations[insert_index] );
+        previous_orientations.push_back( previous_orientations[insert_index] );
+        entity_to_element[moved_entity_id.index] = uint32_t( entity_ids.size() - 1 );
+
+        entity_ids[insert_index] = entity_id;
+        orientations[insert_index] = orientation;
+        previous_orientations[insert_index] = orientation;
+    }
+    else
+    {
+        entity_ids.push_back( entity_id );
+        orientations.push_back( orientation );
+        previous_orientations.push_back( orientation );
     }
 
     AddIndexToIndices( entity_to_element, entity_id.index, insert_index );
@@ -35,17 +57,9 @@ void NonCollidingBodies::AddKinematicComponent( EntityID entity_id, Orientation
 {
     auto insert_index = uint32_t( entity_ids.size() );
 
-    entity_ids.emplace( entity_ids.begin() + insert_index, entity_id );
-    orientations.emplace( orientations.begin() + insert_index, orientation );
-    previous_orientations.emplace( previous_orientations.begin() + insert_index, orientation );
-
-    for( auto & index : entity_to_element )
-    {
-        if( index >= insert_index && index != c_invalid_index )
-        {
-            ++index;
-        }
-    }
+    entity_ids.push_back( entity_id );
+    orientations.push_back( orientation );
+    previous_orientations.push_back( orientation );
 
     AddIndexToIndices( entity_to_element, entity_id.index, insert_index );
 
@@ -58,14 +72,24 @@ void NonCollidingBodies::AddKinematicComponent( EntityID entity_id, Orientation
 
 void NonCollidingBodies::RemoveEntities( Range<EntityID const *> entity_ids_to_be_removed )
 {
-    auto indices = RemoveIndices( entity_to_element, entity_ids_to_be_removed );
-
-    std::sort( begin( indices ), end( indices ) );
+    for( auto entity_id : entity_ids_to_be_removed )
+    {
+        auto element = GetOptional( entity_to_element, entity_id.index );
+        if( element == c_invalid_index ) continue;
 
-    RemoveEntries( entity_ids, indices );
-    RemoveEntries( orientations, indices );
-    RemoveEntries( previous_orientations, indices );
+        // a static body is replaced by the last static body, whose place is then taken by the last kinematic body
+        auto free_element = element;
+        if( free_element < kinematic_body_start_index )
+        {
+            --kinematic_body_start_index;
+            MoveBody( kinematic_body_start_index, free_element, *this );
+            free_element = kinematic_body_start_index;
+        }
+        MoveBody( uint32_t( entity_ids.size() - 1 ), free_element, *this );
 
-    auto bound = std::lower_bound( begin( indices ), end( indices ), kinematic_body_start_index );
-    kinematic_body_start_index -= uint32_t(bound - begin( indices ));
+        entity_ids.pop_back();
+        orientations.pop_back();
+        previous_orientations.pop_back();
+        entity_to_element[entity_id.index] = c_invalid_index;
+    }
 }
\ No newline at end of file
@@ -8,6 +8,15 @@
 using namespace Physics;
 using namespace BoundingShapes;
 
+
+namespace
+{
+    uint32_t BoxCount( uint32_t index, OrientedBoxContainer const & self )
+    {
+        return self.offsets[index + 1] - self.offsets[index];
+    }
+}
+
 Physics::OrientedBoxContainer::OrientedBoxContainer()
 {
     Append(offsets, 0u);
@@ -32,7 +41,29 @@ void Physics::AddBoxes(BodyID body, Range<BoundingShapes::OrientedBox const*> bo
 
 void Physics::Remove(Range<BodyID const*> bodies, OrientedBoxContainer & self)
 {
-    auto indices = RemoveIndices( self.body_to_offset, bodies );
+    // a body with as many boxes as the last body is replaced by it, only the others need the compacting removal below
+    std::vector<BodyID> compacted_bodies;
+    for( auto body : bodies )
+    {
+        auto index = GetOptional( self.body_to_offset, body.index );
+        if( index == c_invalid_index ) continue;
+        auto last_index = uint32_t( Size( self.offsets ) - 2 );
+        auto count = BoxCount( index, self );
+        if( count == 0 || count != BoxCount( last_index, self ) )
+        {
+            compacted_bodies.push_back( body );
+            continue;
+        }
+        auto last_body = self.bodies.back();
+        SwapAndPruneBlock( index, self.offsets, self.boxes );
+        SwapAndPruneBlock( index, self.offsets, self.bodies );
+        self.offsets.pop_back();
+        self.body_to_offset[last_body.index] = index;
+        self.body_to_offset[body.index] = c_invalid_index;
+    }
+
+    Range<BodyID const *> compacted_range = CreateRange( compacted_bodies );
+    auto indices = RemoveIndices( self.body_to_offset, compacted_range );
     std::sort( begin( indices ), end( indices ) );
 
     RemoveEntries( self.boxes, self.offsets, indices );
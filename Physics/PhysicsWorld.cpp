@@ -5,6 +5,7 @@
 #include "BroadPhase.h"
 #include "CollisionResolving.h"
 #include "ConstraintSolverType.h"
+#include "ContinuousCollision.h"
 #include "ImplicitConstraintSolver\ImplicitConstraintSolver.h"
 #include "FrictionAlgorithms.h"
 #include "InertiaFunctions.h"
@@ -17,32 +18,39 @@
 
 #include <BoundingShapes\AxisAlignedBoxFunctions.h>
 #include <BoundingShapes\AxisAlignedBoxHierarchyFunctions.h>
+#include <BoundingShapes\AxisAlignedBoxHierarchyMeshFunctions.h>
+#include <BoundingShapes\CapsuleFunctions.h>
+#include <BoundingShapes\IntersectionTests.h>
 #include <BoundingShapes\OrientedBoxFunctions.h>
 #include <BoundingShapes\SphereFunctions.h>
 #include <BoundingShapes\RayFunctions.h>
+#include <BoundingShapes\RayPacketFunctions.h>
 
 #include <Conventions\OrientationFunctions.h>
 #include <Conventions\RotationConstraints.h>
 #include <Conventions\VelocityConstraints.h>
 
-#include <Math\Edge.h>
 #include <Math\FloatMatrixOperators.h>
 #include <Math\FloatMatrixTypes.h>
 #include <Math\MathFunctions.h>
-#include <Math\SparseAdjacencyMatrixFunctions.h>
+#include <Math\SSE.h>
 #include <Math\TransformFunctions.h>
 #include <Math\VectorAlgorithms.h>
 
+#include <Utilities\AllocationCounter.h>
 #include <Utilities\HRTimer.h>
 #include <Utilities\IndexedHelp.h>
 #include <Utilities\IntegerIterator.h>
+#include <Utilities\InvalidIndex.h>
 #include <Utilities\Logger.h>
 #include <Utilities\Memory.h>
 #include <Utilities\DogDealerException.h>
 #include <Utilities\VectorHelper.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <numeric>
 
 #include <Math\MathToString.h>
 
@@ -59,7 +67,12 @@ PhysicsWorld::PhysicsWorld()
     m_world_configuration.persitent_contact_expiry_age = 5;
     m_world_configuration.constraint_solver_type = ConstraintSolverType::Implicit;
     m_world_configuration.solver_relaxation_factor = {1, 1};
+    m_world_configuration.warm_start_factor = 1;
+    m_world_configuration.solve_parallel = false;
     m_world_configuration.minimal_island_size = 128;
+    m_world_configuration.stiff_island_iteration_factor = 4;
+    m_world_configuration.stiff_island_angular_step = 0.25f;
+    m_world_configuration.density_ray_march = {1, 1000, 1024, 1e-3f};
     m_gravity = { 0, 0, -9.81f };
 
     m_constraint_solver = std::make_unique<ImplicitConstraintSolver>();
@@ -118,6 +131,7 @@ namespace
             collision_data.axis_aligned_box = new_collision_data.axis_aligned_box;
             collision_data.oriented_boxes = move(new_collision_data.oriented_boxes);
             collision_data.spheres = move(new_collision_data.spheres);
+            collision_data.capsules = move(new_collision_data.capsules);
             resource_manager.StoreCollisionData(collision_file, collision_data);
         }
     }
@@ -126,11 +140,21 @@ namespace
     BodyID CreateNewBodyID(
         EntityID entity_id,
         BodyIDGenerator & generator,
-        BodyEntityMapping & mapping
+        std::vector<EntityID> & batched_entities,
+        std::vector<BodyID> & batched_bodies,
+        std::vector<uint32_t> & previous_batched_bodies,
+        std::vector<uint32_t> & last_batched_body_of_entity
         )
     {
         auto body_id = generator.NewID();
-        Add(entity_id, body_id, mapping);
+        if(entity_id.index >= last_batched_body_of_entity.size())
+        {
+            last_batched_body_of_entity.resize(entity_id.index + 1, c_invalid_index);
+        }
+        previous_batched_bodies.push_back(last_batched_body_of_entity[entity_id.index]);
+        last_batched_body_of_entity[entity_id.index] = uint32_t(batched_bodies.size());
+        batched_entities.push_back(entity_id);
+        batched_bodies.push_back(body_id);
         return body_id;
     }
 
@@ -162,13 +186,13 @@ void PhysicsWorld::CreateRigidBodyComponent(
     StoredCollisionData collision_data;
     ProvideCollisionData(collision_file, m_resource_manager, m_mesh_container, collision_data);
     // assert(collision_data.oriented_boxes.empty() != collision_data.spheres.empty()); // one XOR the other should not be empty
-    assert(!collision_data.oriented_boxes.empty() || !collision_data.spheres.empty());
+    assert(!collision_data.oriented_boxes.empty() || !collision_data.spheres.empty() || !collision_data.capsules.empty());
     assert(collision_data.mesh_ids.empty());
 
-    auto body_id = CreateNewBodyID(entity_id, m_body_id_generator, m_body_entity_mapping);
+    auto body_id = CreateNewBodyID(entity_id, m_body_id_generator, m_batched_body_entities, m_batched_bodies, m_previous_batched_bodies, m_last_batched_body_of_entity);
     Inertia total_inertia;
     Math::Float3 center_of_mass;
-    CalculateTotalInertia(collision_data.spheres, collision_data.oriented_boxes, mass, total_inertia, center_of_mass);
+    CalculateTotalInertia(collision_data.spheres, collision_data.oriented_boxes, collision_data.capsules, mass, total_inertia, center_of_mass);
     for( auto & box : collision_data.oriented_boxes )
     {
         box.center -= center_of_mass;
@@ -177,6 +201,10 @@ void PhysicsWorld::CreateRigidBodyComponent(
     {
         sphere.center -= center_of_mass;
     }
+    for( auto & capsule : collision_data.capsules )
+    {
+        capsule = Translate( capsule, -center_of_mass );
+    }
     if(!IsEmpty(collision_data.oriented_boxes))
     {
         AddBoxes( body_id, collision_data.oriented_boxes, m_oriented_box_container );
@@ -185,6 +213,10 @@ void PhysicsWorld::CreateRigidBodyComponent(
     {
         AddSpheres( body_id, collision_data.spheres, m_sphere_container );
     }
+    if(!collision_data.capsules.empty())
+    {
+        AddCapsules( body_id, collision_data.capsules, m_capsule_container );
+    }
     // for stabilization we add the mass to the diagonal
     total_inertia.moment( 0, 0 ) += mass;
     total_inertia.moment( 1, 1 ) += mass;
@@ -209,8 +241,8 @@ void PhysicsWorld::CreateRigidBodyComponent(
         collision_data.axis_aligned_box,
         bounciness,
         friction_factor,
-        m_element_container);
-
+        m_element_batch);
+    AddBatchedBodiesUnlessBatchIsOpen();
 }
 
 
@@ -242,6 +274,11 @@ void PhysicsWorld::CreateMultiRigidBodyComponent(
 
 void PhysicsWorld::CreatePersistentConstraints(EntityID entity_id, Range<Connection const *> connections)
 {
+    // the constraints need the element data of the bodies
+    if(!IsEmpty(connections))
+    {
+        AddBatchedBodies();
+    }
     auto bodies = Bodies(entity_id, m_body_entity_mapping);
     for(auto & connection : connections)
     {
@@ -271,8 +308,7 @@ void PhysicsWorld::CreatePersistentConstraints(EntityID entity_id, Range<Connect
                 Append(m_persistent_constraints.velocity_constraints.target_speeds, 0.f, 3);
                 Append(m_persistent_constraints.velocity_constraints.minmax_forces, infinities, 3);
 
-                Math::Edge edge(parent.index, child.index);
-                AddSymmetricEdges(CreateRange(&edge, 1), m_non_colliding_bodies_pairs);
+                AddExcludedPair(parent, child, m_collision_filter);
                 break;
             }
             case ConnectionType::KeepZRotation:
@@ -302,10 +338,11 @@ void PhysicsWorld::CreateKinematicBodyComponent(
 {
     StoredCollisionData collision_data;
     ProvideCollisionData( collision_file, m_resource_manager, m_mesh_container, collision_data);
-    auto body_id = CreateNewBodyID(entity_id, m_body_id_generator, m_body_entity_mapping);
-    AddKinematicComponent( body_id, orientation, collision_data.axis_aligned_box, bounciness, friction_factor, m_element_container);
+    auto body_id = CreateNewBodyID(entity_id, m_body_id_generator, m_batched_body_entities, m_batched_bodies, m_previous_batched_bodies, m_last_batched_body_of_entity);
+    AddKinematicComponent( body_id, orientation, collision_data.axis_aligned_box, bounciness, friction_factor, m_element_batch);
+    AddBatchedBodiesUnlessBatchIsOpen();
     assert(collision_data.mesh_ids.empty());
-    assert(!collision_data.oriented_boxes.empty() || !collision_data.spheres.empty()); // one should not be empty
+    assert(!collision_data.oriented_boxes.empty() || !collision_data.spheres.empty() || !collision_data.capsules.empty()); // one should not be empty
     if(!collision_data.oriented_boxes.empty())
     {
         AddBoxes(body_id, collision_data.oriented_boxes, m_oriented_box_container);
@@ -314,6 +351,10 @@ void PhysicsWorld::CreateKinematicBodyComponent(
     {
         AddSpheres(body_id, collision_data.spheres, m_sphere_container);
     }
+    if(!collision_data.capsules.empty())
+    {
+        AddCapsules(body_id, collision_data.capsules, m_capsule_container);
+    }
 }
 
 
@@ -326,8 +367,9 @@ void PhysicsWorld::CreateStaticDensityBodyComponent(
     float friction_factor
     )
 {
-    auto body_id = CreateNewBodyID(entity_id, m_body_id_generator, m_body_entity_mapping);
-    AddStaticComponent(body_id, orientation, broad_bounds, bounciness, friction_factor, m_element_container);
+    auto body_id = CreateNewBodyID(entity_id, m_body_id_generator, m_batched_body_entities, m_batched_bodies, m_previous_batched_bodies, m_last_batched_body_of_entity);
+    AddStaticComponent(body_id, orientation, broad_bounds, bounciness, friction_factor, m_element_batch);
+    AddBatchedBodiesUnlessBatchIsOpen();
     AddFunction(move(sample_function), body_id, m_density_function_container);
 }
 
@@ -342,8 +384,8 @@ void PhysicsWorld::CreateStaticBodyComponent(
 {
     StoredCollisionData collision_data;
     ProvideCollisionData(collision_file, m_resource_manager, m_mesh_container, collision_data);
-    assert( collision_data.mesh_ids.empty() + collision_data.oriented_boxes.empty() + collision_data.spheres.empty() < 3); // one should not be empty
-    auto body_id = CreateNewBodyID(entity_id, m_body_id_generator, m_body_entity_mapping);
+    assert( collision_data.mesh_ids.empty() + collision_data.oriented_boxes.empty() + collision_data.spheres.empty() + collision_data.capsules.empty() < 4); // one should not be empty
+    auto body_id = CreateNewBodyID(entity_id, m_body_id_generator, m_batched_body_entities, m_batched_bodies, m_previous_batched_bodies, m_last_batched_body_of_entity);
     if(!collision_data.mesh_ids.empty())
     {
         AddMesh(body_id, collision_data.mesh_ids.front(), m_mesh_container);
@@ -356,13 +398,18 @@ void PhysicsWorld::CreateStaticBodyComponent(
     {
         AddSpheres(body_id, collision_data.spheres, m_sphere_container);
     }
+    if(!collision_data.capsules.empty())
+    {
+        AddCapsules(body_id, collision_data.capsules, m_capsule_container);
+    }
     AddStaticComponent(
         body_id,
         orientation,
         collision_data.axis_aligned_box,
         bounciness,
         friction_factor,
-        m_element_container);
+        m_element_batch);
+    AddBatchedBodiesUnlessBatchIsOpen();
 }
 
 
@@ -395,7 +442,7 @@ void PhysicsWorld::ReplaceWithKinematicBodyComponent(
     ProvideCollisionData( collision_file, m_resource_manager, m_mesh_container, collision_data );
     assert(collision_data.mesh_ids.empty());
     // assert((collision_data.oriented_boxes.empty() + collision_data.spheres.empty()) == 1); // one should be empty
-    assert(!collision_data.oriented_boxes.empty() || !collision_data.spheres.empty()); // one should not be empty
+    assert(!collision_data.oriented_boxes.empty() || !collision_data.spheres.empty() || !collision_data.capsules.empty()); // one should not be empty
 
     auto bodies = Bodies(entity_id, m_body_entity_mapping);
     RemoveShapes(bodies);
@@ -410,6 +457,10 @@ void PhysicsWorld::ReplaceWithKinematicBodyComponent(
     {
         AddSpheres(body_id, collision_data.spheres, m_sphere_container);
     }
+    if(!collision_data.capsules.empty())
+    {
+        AddCapsules(body_id, collision_data.capsules, m_capsule_container);
+    }
     // first remove all but the first body
     PopFirst(bodies);
     RemoveBodies(bodies, m_element_container);
@@ -434,7 +485,7 @@ void PhysicsWorld::ReplaceWithRigidBodyComponent(
     StoredCollisionData collision_data;
     ProvideCollisionData( collision_file, m_resource_manager, m_mesh_container, collision_data );
     // assert(collision_data.oriented_boxes.empty() != collision_data.spheres.empty()); // one XOR the other should not be empty
-    assert(!collision_data.oriented_boxes.empty() || !collision_data.spheres.empty());
+    assert(!collision_data.oriented_boxes.empty() || !collision_data.spheres.empty() || !collision_data.capsules.empty());
     assert(collision_data.mesh_ids.empty());
     auto bodies = Bodies(entity_id, m_body_entity_mapping);
     Remove(bodies, m_persistent_constraints);
@@ -442,7 +493,7 @@ void PhysicsWorld::ReplaceWithRigidBodyComponent(
     auto body_id = First(bodies);
     Inertia total_inertia;
     Math::Float3 center_of_mass;
-    CalculateTotalInertia(collision_data.spheres, collision_data.oriented_boxes, mass, total_inertia, center_of_mass);
+    CalculateTotalInertia(collision_data.spheres, collision_data.oriented_boxes, collision_data.capsules, mass, total_inertia, center_of_mass);
     for( auto & box : collision_data.oriented_boxes )
     {
         box.center -= center_of_mass;
@@ -451,6 +502,10 @@ void PhysicsWorld::ReplaceWithRigidBodyComponent(
     {
         sphere.center -= center_of_mass;
     }
+    for( auto & capsule : collision_data.capsules )
+    {
+        capsule = Translate( capsule, -center_of_mass );
+    }
     if(!IsEmpty(collision_data.oriented_boxes))
     {
         AddBoxes( body_id, collision_data.oriented_boxes, m_oriented_box_container );
@@ -459,6 +514,10 @@ void PhysicsWorld::ReplaceWithRigidBodyComponent(
     {
         AddSpheres( body_id, collision_data.spheres, m_sphere_container );
     }
+    if(!IsEmpty(collision_data.capsules))
+    {
+        AddCapsules( body_id, collision_data.capsules, m_capsule_container );
+    }
     // for stabilization we add the mass to the diagonal
     total_inertia.moment( 0, 0 ) += mass;
     total_inertia.moment( 1, 1 ) += mass;
@@ -554,7 +613,7 @@ void PhysicsWorld::ReplaceWithStaticBodyComponent(
 {
     StoredCollisionData collision_data;
     ProvideCollisionData(collision_file, m_resource_manager, m_mesh_container, collision_data);
-    assert( (collision_data.mesh_ids.empty() + collision_data.oriented_boxes.empty() + collision_data.spheres.empty()) <= 2); // one should not be empty
+    assert( (collision_data.mesh_ids.empty() + collision_data.oriented_boxes.empty() + collision_data.spheres.empty() + collision_data.capsules.empty()) <= 3); // one should not be empty
     auto bodies = Bodies(entity_id, m_body_entity_mapping);
     Remove(bodies, m_persistent_constraints);
     RemoveShapes(bodies);
@@ -571,6 +630,10 @@ void PhysicsWorld::ReplaceWithStaticBodyComponent(
     {
         AddSpheres(body_id, collision_data.spheres, m_sphere_container);
     }
+    if(!collision_data.capsules.empty())
+    {
+        AddCapsules(body_id, collision_data.capsules, m_capsule_container);
+    }
     // first remove all but the first body
     PopFirst(bodies);
     RemoveBodies(bodies, m_element_container);
@@ -598,6 +661,72 @@ void PhysicsWorld::RemoveEntities( Range<EntityID const *> const entity_ids )
     RemoveBodiesFromNonCollidingBodyPairs(bodies);
     m_moving_entities.RemoveEntities( entity_ids );
     m_non_colliding_bodies.RemoveEntities(entity_ids);
+    for(auto entity_id : entity_ids)
+    {
+        SetContinuousCollision(entity_id, false);
+    }
+}
+
+
+void PhysicsWorld::SetContinuousCollision( EntityID entity_id, bool enabled )
+{
+    auto & entities = m_continuous_collision_entities;
+    auto & indices = m_continuous_collision_entity_indices;
+    if(entity_id.index >= indices.size())
+    {
+        indices.resize(entity_id.index + 1, c_invalid_index);
+    }
+    auto index = indices[entity_id.index];
+    if(enabled && index == c_invalid_index)
+    {
+        indices[entity_id.index] = uint32_t(entities.size());
+        entities.push_back(entity_id);
+    }
+    else if(!enabled && index != c_invalid_index)
+    {
+        indices[entities.back().index] = index;
+        entities[index] = entities.back();
+        entities.pop_back();
+        indices[entity_id.index] = c_invalid_index;
+    }
+}
+
+
+void PhysicsWorld::BeginBodyBatch()
+{
+    assert(!m_body_batch_open);
+    m_body_batch_open = true;
+}
+
+
+void PhysicsWorld::EndBodyBatch()
+{
+    assert(m_body_batch_open);
+    m_body_batch_open = false;
+    AddBatchedBodies();
+}
+
+
+void PhysicsWorld::AddBatchedBodies()
+{
+    Add(m_batched_body_entities, m_batched_bodies, m_body_entity_mapping);
+    for(auto entity_id : m_batched_body_entities)
+    {
+        m_last_batched_body_of_entity[entity_id.index] = c_invalid_index;
+    }
+    m_batched_body_entities.clear();
+    m_batched_bodies.clear();
+    m_previous_batched_bodies.clear();
+    AddBodies(m_element_batch, m_element_container);
+}
+
+
+void PhysicsWorld::AddBatchedBodiesUnlessBatchIsOpen()
+{
+    if(!m_body_batch_open)
+    {
+        AddBatchedBodies();
+    }
 }
 
 
@@ -615,6 +744,7 @@ void PhysicsWorld::RemoveShapes(Range<BodyID const *> const bodies)
     Remove(bodies, m_density_function_container);
     Remove(bodies, m_mesh_container);
     Remove(bodies, m_sphere_container);
+    Remove(bodies, m_capsule_container);
 }
 
 
@@ -673,22 +803,109 @@ Math::Float3 PhysicsWorld::CastRayOnStaticEntities(
     BoundingShapes::Ray const & ray
     ) const
 {
-    // auto bodies = CreateStaticDataRange(m_element_container.offsets, m_element_container.pointers.body_ids);
     auto bodies = CreateStaticDataRange(m_element_container.offsets, m_element_container.pointers.body_ids);
     auto broad_bounds = CreateStaticDataRange(m_element_container.offsets, m_element_container.pointers.transformed_broad_bounds);
-    auto broad_bounds_hierarchy = CreateAxisAlignedBoxHierarchy(broad_bounds);
-    std::vector<BodyID> candidate_bodies;
-    BroadPhaseRayCasting(
-        broad_bounds,
-        broad_bounds_hierarchy,
-        bodies,
-        ray,
-        candidate_bodies
-        );
-    return CastRayOnBodies(ray, candidate_bodies);
+
+    auto time = std::numeric_limits<float>::infinity();
+    auto node_callback = [&ray](BoundingShapes::AxisAlignedBox const & node_box)
+    {
+        return Intersect(node_box, ray);
+    };
+    auto leaf_callback = [&](uint32_t index)
+    {
+        if(Intersect(broad_bounds[index], ray))
+        {
+            time = Math::Min(RayIntersectionTime(ray, bodies[index]), time);
+        }
+        return true;
+    };
+
+    auto const & hierarchies = m_element_container.broad_bounds_hierarchies;
+    if(!hierarchies.static_bodies_changed)
+    {
+        Traverse(hierarchies.static_bodies, node_callback, leaf_callback);
+    }
+    else
+    {
+        // static bodies were added or removed since the last update
+        Traverse(CreateAxisAlignedBoxHierarchy(broad_bounds), node_callback, leaf_callback);
+    }
+    return PointAlongRay(ray, time);
 }
 
 
+void PhysicsWorld::CastRaysOnStaticEntities(
+    Range<BoundingShapes::Ray const *> rays,
+    Range<RayHit *> hits
+    ) const
+{
+    using namespace Math::SSE;
+    assert(Size(rays) == Size(hits));
+    auto bodies = CreateStaticDataRange(m_element_container.offsets, m_element_container.pointers.body_ids);
+    auto broad_bounds = CreateStaticDataRange(m_element_container.offsets, m_element_container.pointers.transformed_broad_bounds);
+
+    auto const & hierarchies = m_element_container.broad_bounds_hierarchies;
+    BoundingShapes::AxisAlignedBoxHierarchy changed_hierarchy;
+    if(hierarchies.static_bodies_changed)
+    {
+        // static bodies were added or removed since the last update
+        changed_hierarchy = CreateAxisAlignedBoxHierarchy(broad_bounds);
+    }
+    auto const & hierarchy = hierarchies.static_bodies_changed ? changed_hierarchy : hierarchies.static_bodies;
+
+    for(auto first = size_t(0); first < Size(rays); first += BoundingShapes::c_ray_packet_width)
+    {
+        auto packet_rays = CreateRange(rays, first, Math::Min(first + BoundingShapes::c_ray_packet_width, Size(rays)));
+        auto packet = BoundingShapes::CreateRayPacket(packet_rays);
+        auto packet_hits = CreateEmptyRayPacketHits();
+        std::array<BodyID, BoundingShapes::c_ray_packet_width> hit_bodies;
+
+        // only descend while one of the rays could still find a closer hit
+        auto node_callback = [&](BoundingShapes::AxisAlignedBox const & node_box)
+        {
+            return AnySignBitsSet(LessThan(IntersectionTimes(packet, node_box), packet_hits.times));
+        };
+        auto leaf_callback = [&](uint32_t index)
+        {
+            if(AnySignBitsSet(LessThan(IntersectionTimes(packet, broad_bounds[index]), packet_hits.times)))
+            {
+                auto closer = RayPacketIntersectCloser(packet, packet_rays, bodies[index], packet_hits);
+                for(auto lane = 0u; lane < packet.count; ++lane)
+                {
+                    if(closer & (1u << lane))
+                    {
+                        hit_bodies[lane] = bodies[index];
+                    }
+                }
+            }
+            return true;
+        };
+        Traverse(hierarchy, node_callback, leaf_callback);
+
+        alignas(16) std::array<float, BoundingShapes::c_ray_packet_width> times, normal_x, normal_y, normal_z;
+        Store(packet_hits.times, times.data());
+        Store(packet_hits.normal_x, normal_x.data());
+        Store(packet_hits.normal_y, normal_y.data());
+        Store(packet_hits.normal_z, normal_z.data());
+        for(auto lane = 0u; lane < packet.count; ++lane)
+        {
+            auto & hit = hits[first + lane];
+            hit.time = times[lane];
+            hit.normal = {normal_x[lane], normal_y[lane], normal_z[lane]};
+            if(times[lane] < std::numeric_limits<float>::infinity())
+            {
+                hit.body = hit_bodies[lane];
+                hit.entity = Entity(hit_bodies[lane], m_body_entity_mapping);
+            }
+            else
+            {
+                hit.body = c_invalid_body_id;
+                hit.entity = c_invalid_entity_id;
+            }
+        }
+    }
+}
+
 
 Math::Float3 PhysicsWorld::CastRayOnBody(
     BoundingShapes::Ray const & ray,
@@ -706,33 +923,154 @@ Math::Float3 PhysicsWorld::CastRayOnBodies(
     auto time = std::numeric_limits<float>::infinity();
     for(auto body : bodies)
     {
-        auto element_index = m_element_container.pointers.body_to_element[body.index];
-        auto orientation = m_element_container.pointers.orientations[element_index];
-        auto transformed_ray = TransformByOrientation(ray, Invert(orientation));
-        // density function bodies
-        if(Contains(body, m_density_function_container))
+        time = Math::Min(RayIntersectionTime(ray, body), time);
+    }
+
+    return PointAlongRay(ray, time);
+}
+
+
+float PhysicsWorld::RayIntersectionTime(
+    BoundingShapes::Ray const & ray,
+    BodyID body
+    ) const
+{
+    auto time = std::numeric_limits<float>::infinity();
+    auto element_index = m_element_container.pointers.body_to_element[body.index];
+    auto orientation = m_element_container.pointers.orientations[element_index];
+    auto transformed_ray = TransformByOrientation(ray, Invert(orientation));
+    // density function bodies
+    if(Contains(body, m_density_function_container))
+    {
+        auto index = m_density_function_container.body_to_data[body.index];
+        auto & function = m_density_function_container.functions[index];
+        // auto search_direction = InverseRotate(ray.direction, orientation.rotation);
+        // auto starting_position = InverseRotate( ray.start - orientation.position, orientation.rotation );
+        time = Math::Min(IntersectionTime(transformed_ray, function, m_world_configuration.density_ray_march), time);
+    }
+    if(Contains(body, m_oriented_box_container))
+    {
+        auto offset_index = m_oriented_box_container.body_to_offset[body.index];
+        auto boxes = CreateRange(m_oriented_box_container.boxes, m_oriented_box_container.offsets[offset_index], m_oriented_box_container.offsets[offset_index + 1]);
+        time = Math::Min(IntersectionTime(transformed_ray, boxes), time);
+    }
+    if(Contains(body, m_sphere_container))
+    {
+        auto offset_index = m_sphere_container.body_to_offset[body.index];
+        auto spheres = CreateRange(m_sphere_container.spheres, m_sphere_container.offsets[offset_index], m_sphere_container.offsets[offset_index + 1]);
+        time = Math::Min(IntersectionTime(transformed_ray, spheres), time);
+    }
+    if(Contains(body, m_capsule_container))
+    {
+        auto offset_index = m_capsule_container.body_to_offset[body.index];
+        auto capsules = CreateRange(m_capsule_container.capsules, m_capsule_container.offsets[offset_index], m_capsule_container.offsets[offset_index + 1]);
+        time = Math::Min(IntersectionTime(transformed_ray, capsules), time);
+    }
+    if(Contains(body, m_mesh_container))
+    {
+        auto & mesh = m_mesh_container.meshes[m_mesh_container.body_to_data[body.index]];
+        time = Math::Min(IntersectionTime(transformed_ray, mesh), time);
+    }
+    return time;
+}
+
+
+unsigned PhysicsWorld::RayPacketIntersectCloser(
+    BoundingShapes::RayPacket const & packet,
+    Range<BoundingShapes::Ray const *> packet_rays,
+    BodyID body,
+    RayPacketHits & hits
+    ) const
+{
+    auto closer = 0u;
+    auto element_index = m_element_container.pointers.body_to_element[body.index];
+    auto orientation = m_element_container.pointers.orientations[element_index];
+    if(Contains(body, m_oriented_box_container))
+    {
+        auto offset_index = m_oriented_box_container.body_to_offset[body.index];
+        auto boxes = CreateRange(m_oriented_box_container.boxes, m_oriented_box_container.offsets[offset_index], m_oriented_box_container.offsets[offset_index + 1]);
+        for(auto const & box : boxes)
         {
-            auto index = m_density_function_container.body_to_data[body.index];
-            auto & function = m_density_function_container.functions[index];
-            // auto search_direction = InverseRotate(ray.direction, orientation.rotation);
-            // auto starting_position = InverseRotate( ray.start - orientation.position, orientation.rotation );
-            time = Math::Min(IntersectionTime(transformed_ray, function, 1e-3f ), time);
+            closer |= IntersectCloser(packet, TransformByOrientation(box, orientation), hits);
         }
-        if(Contains(body, m_oriented_box_container))
+    }
+    if(Contains(body, m_sphere_container))
+    {
+        auto offset_index = m_sphere_container.body_to_offset[body.index];
+        auto spheres = CreateRange(m_sphere_container.spheres, m_sphere_container.offsets[offset_index], m_sphere_container.offsets[offset_index + 1]);
+        for(auto const & sphere : spheres)
         {
-            auto offset_index = m_oriented_box_container.body_to_offset[body.index];
-            auto boxes = CreateRange(m_oriented_box_container.boxes, m_oriented_box_container.offsets[offset_index], m_oriented_box_container.offsets[offset_index + 1]);
-            time = Math::Min(IntersectionTime(transformed_ray, boxes), time);
+            closer |= IntersectCloser(packet, TransformByOrientation(sphere, orientation), hits);
+        }
+    }
+    // density functions are iterated per ray
+    if(Contains(body, m_density_function_container))
+    {
+        using namespace Math::SSE;
+        auto index = m_density_function_container.body_to_data[body.index];
+        auto & function = m_density_function_container.functions[index];
+        alignas(16) std::array<float, BoundingShapes::c_ray_packet_width> times;
+        Store(hits.times, times.data());
+        auto inverse_orientation = Invert(orientation);
+        for(auto lane = 0u; lane < Size(packet_rays); ++lane)
+        {
+            auto transformed_ray = TransformByOrientation(packet_rays[lane], inverse_orientation);
+            auto time = IntersectionTime(transformed_ray, function, m_world_configuration.density_ray_march);
+            if(time < times[lane])
+            {
+                float density;
+                Math::Float3 gradient;
+                function(PointAlongRay(transformed_ray, time), density, gradient);
+                SetHit(lane, time, Rotate(-Normalize(gradient), orientation.rotation), hits);
+                closer |= 1u << lane;
+            }
         }
-        if(Contains(body, m_sphere_container))
+    }
+    // capsules are intersected per ray
+    if(Contains(body, m_capsule_container))
+    {
+        using namespace Math::SSE;
+        auto offset_index = m_capsule_container.body_to_offset[body.index];
+        auto capsules = CreateRange(m_capsule_container.capsules, m_capsule_container.offsets[offset_index], m_capsule_container.offsets[offset_index + 1]);
+        alignas(16) std::array<float, BoundingShapes::c_ray_packet_width> times;
+        Store(hits.times, times.data());
+        auto inverse_orientation = Invert(orientation);
+        for(auto lane = 0u; lane < Size(packet_rays); ++lane)
         {
-            auto offset_index = m_sphere_container.body_to_offset[body.index];
-            auto spheres = CreateRange(m_sphere_container.spheres, m_sphere_container.offsets[offset_index], m_sphere_container.offsets[offset_index + 1]);
-            time = Math::Min(IntersectionTime(transformed_ray, spheres), time);
+            auto transformed_ray = TransformByOrientation(packet_rays[lane], inverse_orientation);
+            for(auto const & capsule : capsules)
+            {
+                Math::Float3 normal;
+                auto time = IntersectionTime(transformed_ray, capsule, normal);
+                if(time < times[lane])
+                {
+                    times[lane] = time;
+                    SetHit(lane, time, Rotate(normal, orientation.rotation), hits);
+                    closer |= 1u << lane;
+                }
+            }
         }
     }
-
-    return PointAlongRay(ray, time);
+    // meshes are traversed per ray
+    if(Contains(body, m_mesh_container))
+    {
+        using namespace Math::SSE;
+        auto & mesh = m_mesh_container.meshes[m_mesh_container.body_to_data[body.index]];
+        alignas(16) std::array<float, BoundingShapes::c_ray_packet_width> times;
+        Store(hits.times, times.data());
+        auto inverse_orientation = Invert(orientation);
+        for(auto lane = 0u; lane < Size(packet_rays); ++lane)
+        {
+            Math::Float3 normal;
+            auto time = IntersectionTime(TransformByOrientation(packet_rays[lane], inverse_orientation), mesh, normal);
+            if(time < times[lane])
+            {
+                SetHit(lane, time, Rotate(normal, orientation.rotation), hits);
+                closer |= 1u << lane;
+            }
+        }
+    }
+    return closer;
 }
 
 
@@ -861,87 +1199,26 @@ namespace
         auto total_force = spring_force + damping_force;
         return -total_force;
     }
-
-
-    // maybe we should move this someplace else, but it depends on being able to merge the manifolds
-    void RemoveDuplicates(Physics::CollisionEvents & events)
-    {
-        // first make sure the first entity is always smaller
-        FlipIf(events, [](auto const & entities)
-        {
-            return entities.id1.index < entities.id2.index;
-        });
-
-        // create indices so we can reorder the events later
-        auto size = uint32_t(Size(events.bodies));
-        std::vector<uint32_t> indices(IntegerIterator<uint32_t>(0), IntegerIterator<uint32_t>(size));
-
-        // sort the indices
-        std::sort(begin(indices), end(indices), [&events](uint32_t a, uint32_t b)
-        {
-            return events.bodies[a] < events.bodies[b];
-        });
-
-        // make a compare function
-        auto compare_entities = [&events](uint32_t a, uint32_t b){return events.bodies[a] == events.bodies[b];};
-
-        // find all duplicate entity pairs
-        for( auto adjacent_pair = std::adjacent_find(begin(indices), end(indices), compare_entities);
-            adjacent_pair < end(indices);
-            adjacent_pair = std::adjacent_find(adjacent_pair, end(indices), compare_entities))
-        {
-            auto first = adjacent_pair[0];
-            // and merge the manifolds
-            auto & manifold = events.manifolds[first];
-            adjacent_pair += 1;
-            for( auto first_bodies = events.bodies[first]; adjacent_pair < end( indices ) && first_bodies == events.bodies[*adjacent_pair]; ++adjacent_pair )
-            {
-                manifold = Physics::MergeManifolds(manifold, events.manifolds[*adjacent_pair]);
-            }
-        }
-
-        // remove duplicate indices
-        indices.erase(std::unique(begin(indices), end(indices), compare_entities), end(indices));
-
-        // reorder the events
-        Reorder(indices, events);
-
-        // and remove the excess elements
-        Resize(Size(indices), events);
-    }
-
-
-    size_t Filter(
-        Math::SparseAdjacencyMatrix const & filter,
-        Range<BodyAndOrientationPair *> collision_pairs
-        )
-    {
-        return std::remove_if(begin(collision_pairs), end(collision_pairs),
-                              [&filter](auto const & entity_pair)
-        {
-            return Exists({entity_pair.body1.index, entity_pair.body2.index}, filter);
-        }) - begin(collision_pairs);
-    }
 }
 
 
-Physics::CollisionEvents PhysicsWorld::FindCollisions( Physics::CollisionEvents collision_events ) const
+Physics::CollisionEvents PhysicsWorld::FindCollisions( Physics::CollisionEvents collision_events )
 {
-    HRTimer timer;
-    timer.Start();
-
-    std::vector<BodyAndOrientationPair> candidate_collision_entities;
+    auto & candidate_collision_entities = m_candidate_collision_pairs;
+    candidate_collision_entities.clear();
     BroadPhaseCollisionDetection(
         CreateAllBodyDataRange(m_element_container.offsets, m_element_container.pointers.transformed_broad_bounds),
-        m_element_container.storage.common.transformed_broad_bounds_hierarchy,
+        m_element_container.broad_bounds_hierarchies.static_bodies,
+        m_element_container.broad_bounds_hierarchies.dynamic_bodies,
         CreateAllBodyDataRange(m_element_container.offsets, m_element_container.pointers.orientations),
         CreateAllBodyDataRange(m_element_container.offsets, m_element_container.pointers.body_ids),
         StaticBodyEnd(m_element_container.offsets),
+        m_overlapping_index_pairs,
         candidate_collision_entities);
 
     Clear(collision_events);
 
-    auto new_size = Filter(m_non_colliding_bodies_pairs, candidate_collision_entities);
+    auto new_size = Filter(m_collision_filter, candidate_collision_entities);
     candidate_collision_entities.resize(new_size);
 
     NarrowPhaseCollisionDetection(
@@ -951,24 +1228,24 @@ Physics::CollisionEvents PhysicsWorld::FindCollisions( Physics::CollisionEvents
         m_oriented_box_container.body_to_offset,
         m_oriented_box_container.offsets,
         m_oriented_box_container.boxes,
+        m_capsule_container.body_to_offset,
+        m_capsule_container.offsets,
+        m_capsule_container.capsules,
         m_density_function_container.body_to_data,
         m_density_function_container.functions,
         m_mesh_container.body_to_data,
         m_mesh_container.meshes,
         // order gets changed
         candidate_collision_entities,
+        m_categorized_collision_pairs,
+        m_narrow_phase_chunk_outputs,
         // output
         collision_events.bodies,
         collision_events.relative_positions,
         collision_events.manifolds);
 
-    RemoveDuplicates(collision_events);
+    RemoveDuplicates(collision_events, m_frame_arena);
 
-    timer.Stop();
-    Log( [&timer]()
-    {
-        return "FindCollisions took " + std::to_string( timer.GetMilliSeconds() ) + " ms";
-    } );
     return collision_events;
 }
 
@@ -981,6 +1258,7 @@ namespace
         ::CollisionEvents & output_events
         )
     {
+        output_events.entities.clear();
         for(auto body : physics_events.bodies)
         {
             auto entity1 = Physics::Entity(body.id1, mapping);
@@ -999,6 +1277,7 @@ namespace
         Physics::WorldRotationConstraints & physics
         )
     {
+        physics.body_ids.clear();
         for(auto entity : external.entity_ids)
         {
             auto body = First(Physics::Bodies(entity, mapping));
@@ -1017,6 +1296,7 @@ namespace
         Physics::WorldVelocityConstraints & physics
         )
     {
+        physics.body_ids.clear();
         for(auto entity : external.entity_ids)
         {
             auto body = First(Physics::Bodies(entity, mapping));
@@ -1035,6 +1315,7 @@ namespace
         Physics::WorldAngularVelocityConstraints & physics
         )
     {
+        physics.body_ids.clear();
         for(auto entity : external.entity_ids)
         {
             auto body = First(Physics::Bodies(entity, mapping));
@@ -1048,7 +1329,7 @@ namespace
 }
 
 
-::CollisionEvents PhysicsWorld::UpdateBodies(
+::CollisionEvents const & PhysicsWorld::UpdateBodies(
     EntityForces const & entity_forces,
     EntityTorques const & entity_torque,
     ::RotationConstraints const & external_rotation_constraints,
@@ -1057,6 +1338,9 @@ namespace
     float const time_step
     )
 {
+    auto const start_allocation_count = AllocationCount();
+    m_frame_arena.Reset();
+
     // Update broad bounds
     {
         // first transform all broad bounds
@@ -1065,16 +1349,17 @@ namespace
             CreateDynamicDataRange(m_element_container.offsets, m_element_container.pointers.orientations),
             CreateDynamicDataRange(m_element_container.offsets, m_element_container.pointers.transformed_broad_bounds)
             );
-        // update the broad bounds hierarchy
-        BoundingShapes::CreateAxisAlignedBoxHierarchy(
-            CreateAllBodyDataRange(m_element_container.offsets, m_element_container.pointers.transformed_broad_bounds),
-            m_element_container.storage.common.transformed_broad_bounds_hierarchy );
+        // update the broad bounds hierarchies, the static one only if static bodies changed
+        UpdateBroadBoundsHierarchies(m_element_container);
     }
 
+    HRTimer collision_timer;
+    collision_timer.Start();
     auto collision_events = FindCollisions(std::move(m_current_collision_events));
+    collision_timer.Stop();
     CollisionEventOffsets event_offsets;
     auto body_to_element = m_element_container.pointers.body_to_element;
-    SortAndCatagorize( collision_events, event_offsets, body_to_element, KinematicBodyStart( m_element_container.offsets ), RigidBodyStart( m_element_container.offsets ) );
+    SortAndCatagorize( collision_events, event_offsets, body_to_element, KinematicBodyStart( m_element_container.offsets ), RigidBodyStart( m_element_container.offsets ), m_frame_arena );
 
     if(m_world_configuration.persitent_contact_expiry_age > 0)
     {
@@ -1135,9 +1420,9 @@ namespace
     }
 
     auto rigid_body_orientations = CreateRigidDataRange( m_element_container.offsets, m_element_container.pointers.orientations );
-    std::vector<Inertia> rigid_body_inverse_inertias( Size( rigid_body_orientations ) );
+    auto rigid_body_inverse_inertias = AllocateRange<Inertia>( m_frame_arena, Size( rigid_body_orientations ) );
     RotateInertias( CreateRigidDataRange( m_element_container.offsets, m_element_container.pointers.inverse_inertias ), rigid_body_orientations, rigid_body_inverse_inertias );
-    std::vector<uint32_t> rigid_body_to_element(begin(body_to_element), end(body_to_element));
+    auto rigid_body_to_element = AllocateCopy<uint32_t>( m_frame_arena, body_to_element );
     for( auto & i : rigid_body_to_element)
     {
         if( i != c_invalid_index )
@@ -1161,7 +1446,7 @@ namespace
     AddForces( entity_forces, m_body_entity_mapping, rigid_body_to_element, rigid_body_forces );
 
     auto rigid_body_movements = CreateRigidDataRange(m_element_container.offsets, m_element_container.pointers.movements);
-    std::vector<Movement> old_movements(begin(rigid_body_movements), end(rigid_body_movements));
+    auto old_movements = AllocateCopy<Movement>( m_frame_arena, rigid_body_movements );
     ApplyForces( old_movements, rigid_body_forces, time_step, rigid_body_movements );
     ApplyTorques( rigid_body_movements, body_to_element, entity_torque.torques, entity_torque.entity_ids, m_body_entity_mapping, time_step, rigid_body_movements );
     auto rigid_body_bounds = CreateRigidDataRange( m_element_container.offsets, m_element_container.pointers.broad_bounds );
@@ -1169,21 +1454,18 @@ namespace
     ApplyInternalFriction( rigid_body_movements, 1 - m_world_configuration.fixed_fraction_velocity_loss_per_second, time_step, rigid_body_movements );
 
 
-    Physics::WorldRotationConstraints rotation_constraints;
-    Physics::WorldVelocityConstraints velocity_constraints;
-    Physics::WorldAngularVelocityConstraints angular_velocity_constraints;
-    ConvertConstraints(external_rotation_constraints, m_body_entity_mapping, rotation_constraints);
-    ConvertConstraints(external_velocity_constraints, m_body_entity_mapping, velocity_constraints);
-    ConvertConstraints(external_angular_velocity_constraints, m_body_entity_mapping, angular_velocity_constraints);
+    ConvertConstraints(external_rotation_constraints, m_body_entity_mapping, m_rotation_constraints);
+    ConvertConstraints(external_velocity_constraints, m_body_entity_mapping, m_velocity_constraints);
+    ConvertConstraints(external_angular_velocity_constraints, m_body_entity_mapping, m_angular_velocity_constraints);
     m_constraint_solver->SetCollisionEvents(&collision_events, &event_offsets);
     m_constraint_solver->SetConstraints(
         &m_persistent_constraints.distance_constraints,
         &m_persistent_constraints.position_constraints,
         &m_persistent_constraints.rotation_constraints,
         &m_persistent_constraints.velocity_constraints,
-        &velocity_constraints,
-        &angular_velocity_constraints,
-        &rotation_constraints);
+        &m_velocity_constraints,
+        &m_angular_velocity_constraints,
+        &m_rotation_constraints);
     m_constraint_solver->SetRigidBodyData(rigid_body_to_element, old_movements, rigid_body_movements, rigid_body_orientations, rigid_body_inverse_inertias, rigid_body_forces);
     m_constraint_solver->SetCommonBodyData(
         body_to_element,
@@ -1191,12 +1473,10 @@ namespace
         CreateAllBodyDataRange(m_element_container.offsets, m_element_container.pointers.friction_factors)
         );
 
-    static HRTimer solver_timer;
+    HRTimer solver_timer;
     solver_timer.Start();
     m_constraint_solver->DoYourThing(time_step);
     solver_timer.Stop();
-    auto solver_time = solver_timer.GetMilliSeconds();
-    Log([solver_time](){return "Solving rigid body constraints took: " + std::to_string(solver_time) + " milliseconds.";});
 
     // Log([rigid_body_orientations]()
     // {
@@ -1212,12 +1492,109 @@ namespace
     //     return out;
     // });
 
-    ::CollisionEvents output_events;
-    ConvertCollisionEvents(collision_events, m_body_entity_mapping, output_events);
+    ConvertCollisionEvents(collision_events, m_body_entity_mapping, m_output_collision_events);
+    SweepContinuousCollisionBodies();
     m_current_collision_events = std::move(m_previous_collision_events);
     m_previous_collision_events = std::move(collision_events);
     std::swap(m_previous_collision_event_offsets, event_offsets);
-    return output_events;
+
+    // count before logging, building the log messages allocates
+    m_last_update_allocation_count = AllocationCount() - start_allocation_count;
+    auto collision_time = collision_timer.GetMilliSeconds();
+    auto solver_time = solver_timer.GetMilliSeconds();
+    Log([collision_time](){return "FindCollisions took " + std::to_string(collision_time) + " ms";});
+    Log([solver_time](){return "Solving rigid body constraints took: " + std::to_string(solver_time) + " milliseconds.";});
+    return m_output_collision_events;
+}
+
+
+void PhysicsWorld::SweepContinuousCollisionBodies()
+{
+    using namespace Math::SSE;
+    if(m_continuous_collision_entities.empty())
+    {
+        return;
+    }
+
+    auto const & offsets = m_element_container.offsets;
+    auto const & pointers = m_element_container.pointers;
+    auto static_bodies = CreateStaticDataRange(offsets, pointers.body_ids);
+    auto static_bounds = CreateStaticDataRange(offsets, pointers.transformed_broad_bounds);
+
+    auto const & hierarchies = m_element_container.broad_bounds_hierarchies;
+    BoundingShapes::AxisAlignedBoxHierarchy changed_hierarchy;
+    if(hierarchies.static_bodies_changed)
+    {
+        changed_hierarchy = CreateAxisAlignedBoxHierarchy(static_bounds);
+    }
+    auto const & hierarchy = hierarchies.static_bodies_changed ? changed_hierarchy : hierarchies.static_bodies;
+
+    for(auto entity_id : m_continuous_collision_entities)
+    {
+        for(auto body : Bodies(entity_id, m_body_entity_mapping))
+        {
+            if(!IsRigidBody(body, m_element_container))
+            {
+                continue;
+            }
+            auto const element = pointers.body_to_element[body.index];
+            Sweep sweep;
+            if(!CreateSweep(pointers.previous_orientations[element], pointers.orientations[element], pointers.broad_bounds[element], sweep))
+            {
+                continue;
+            }
+
+            // only hits along the path of this step are of interest
+            auto path = CreateRange(&sweep.path, 1);
+            auto packet = BoundingShapes::CreateRayPacket(path);
+            auto hits = CreateEmptyRayPacketHits();
+            hits.times = SetAll(sweep.length);
+            auto hit_body = c_invalid_body_id;
+
+            auto node_callback = [&](BoundingShapes::AxisAlignedBox const & node_box)
+            {
+                return AnySignBitsSet(LessThan(IntersectionTimes(packet, node_box), hits.times));
+            };
+            auto leaf_callback = [&](uint32_t index)
+            {
+                if(RayPacketIntersectCloser(packet, path, static_bodies[index], hits) & 1u)
+                {
+                    hit_body = static_bodies[index];
+                }
+                return true;
+            };
+            Traverse(hierarchy, node_callback, leaf_callback);
+
+            // a path starting inside a static body is left to the discrete collision detection
+            auto const time = GetSingle(hits.times);
+            if(hit_body == c_invalid_body_id || !(time > 0))
+            {
+                continue;
+            }
+            Math::Float3 const normal = {GetSingle(hits.normal_x), GetSingle(hits.normal_y), GetSingle(hits.normal_z)};
+
+            auto & orientation = pointers.orientations[element];
+            orientation = ClampToImpact(sweep, time, orientation);
+            pointers.movements[element] = RemoveImpactMomentum(pointers.movements[element], normal);
+
+            auto const static_entity = Entity(hit_body, m_body_entity_mapping);
+            auto const & events = m_output_collision_events.entities;
+            auto const reported = std::any_of(begin(events), end(events), [&](EntityPair const & pair)
+            {
+                return pair == EntityPair(entity_id, static_entity) || pair == EntityPair(static_entity, entity_id);
+            });
+            if(!reported)
+            {
+                Manifold manifold;
+                manifold.contact_point_count = 1;
+                manifold.positions[0] = sweep.path.start + sweep.path.direction * time - orientation.position;
+                manifold.separation_axes[0] = normal;
+                m_output_collision_events.entities.push_back({entity_id, static_entity});
+                m_output_collision_events.relative_positions.push_back(pointers.orientations[pointers.body_to_element[hit_body.index]].position - orientation.position);
+                m_output_collision_events.manifolds.push_back(manifold);
+            }
+        }
+    }
 }
 
 
@@ -1247,6 +1624,13 @@ void PhysicsWorld::AdjustAllPositions(Math::Float3 adjustment)
     {
         box.center += adjustment;
     }
+    // the static bounds are transformed already, so they're not updated with the dynamic ones
+    boxes = CreateStaticDataRange(m_element_container.offsets, m_element_container.pointers.transformed_broad_bounds);
+    for( auto & box : boxes )
+    {
+        box.center += adjustment;
+    }
+    StaticBodiesChanged(m_element_container);
 
     orientations = m_non_colliding_bodies.orientations;
     for( auto & orientation : orientations )
@@ -1262,6 +1646,65 @@ void PhysicsWorld::AdjustAllPositions(Math::Float3 adjustment)
 }
 
 
+void PhysicsWorld::GetStaticGeometry(
+    std::vector<Math::Float3>& triangle_vertices,
+    std::vector<DensityFunctionType>& density_functions,
+    std::vector<BoundingShapes::AxisAlignedBox>& density_bounds
+    ) const
+{
+    auto bodies = CreateStaticDataRange(m_element_container.offsets, m_element_container.pointers.body_ids);
+    auto orientations = CreateStaticDataRange(m_element_container.offsets, m_element_container.pointers.orientations);
+    auto broad_bounds = CreateStaticDataRange(m_element_container.offsets, m_element_container.pointers.transformed_broad_bounds);
+    for(auto i = 0u; i < Size(bodies); ++i)
+    {
+        auto body = bodies[i];
+        auto orientation = orientations[i];
+        if(Contains(body, m_mesh_container))
+        {
+            auto mesh = TransformByOrientation(m_mesh_container.meshes[m_mesh_container.body_to_data[body.index]], orientation);
+            for(auto n = 0u; n < Size(mesh.nodes); ++n)
+            {
+                auto const & node = mesh.nodes[n];
+                if(node.escape_index != n + 1) continue;
+                for(auto index : node.vertex_indices)
+                {
+                    triangle_vertices.push_back(mesh.vertex_positions[index]);
+                }
+            }
+        }
+        if(Contains(body, m_oriented_box_container))
+        {
+            auto offset_index = m_oriented_box_container.body_to_offset[body.index];
+            auto boxes = CreateRange(m_oriented_box_container.boxes, m_oriented_box_container.offsets[offset_index], m_oriented_box_container.offsets[offset_index + 1]);
+            for(auto const & local_box : boxes)
+            {
+                auto box = TransformByOrientation(local_box, orientation);
+                for(uint8_t face = 0; face < 6; ++face)
+                {
+                    auto corners = GetFaceCorners(box, face);
+                    // the face corners go around the face, but not necessarily counter clockwise
+                    if(Math::Dot(Math::Cross(corners[1] - corners[0], corners[2] - corners[0]), GetFaceNormal(box, face)) < 0)
+                    {
+                        std::swap(corners[1], corners[3]);
+                    }
+                    triangle_vertices.insert(triangle_vertices.end(), {corners[0], corners[1], corners[2], corners[0], corners[2], corners[3]});
+                }
+            }
+        }
+        if(Contains(body, m_density_function_container))
+        {
+            auto function = m_density_function_container.functions[m_density_function_container.body_to_data[body.index]];
+            density_functions.push_back([function, orientation](Math::Float3 const position, float & density, Math::Float3 & gradient)
+            {
+                function(InverseRotate(position - orientation.position, orientation.rotation), density, gradient);
+                gradient = Rotate(gradient, orientation.rotation);
+            });
+            density_bounds.push_back(broad_bounds[i]);
+        }
+    }
+}
+
+
 void PhysicsWorld::GetAllOrientedBoxes(std::vector<BoundingShapes::OrientedBox>& boxes, std::vector<EntityID>& entities)
 {
     for(auto id : m_oriented_box_container.bodies)
@@ -1349,52 +1792,59 @@ void PhysicsWorld::GetAllSpheres(
 
 void PhysicsWorld::AddNonCollidingEntityPairs(Range<EntityPair const *> entity_pairs)
 {
-    std::vector<Math::Edge> edges;
-    edges.reserve(Size(entity_pairs));
     for(auto p : entity_pairs)
     {
-        auto bodies1 = Bodies(p.id1, m_body_entity_mapping);
-        auto bodies2 = Bodies(p.id2, m_body_entity_mapping);
-        for(auto b1 : bodies1)
+        for(auto b1 : Bodies(p.id1, m_body_entity_mapping))
         {
-            for(auto b2 : bodies2)
+            for(auto b2 : Bodies(p.id2, m_body_entity_mapping))
             {
-                edges.emplace_back(b1.index, b2.index);
+                AddExcludedPair(b1, b2, m_collision_filter);
             }
         }
     }
-    AddSymmetricEdges(edges, m_non_colliding_bodies_pairs);
 }
 
 
 
 void PhysicsWorld::RemoveNonCollidingEntityPairs(Range<EntityPair const *> entity_pairs)
 {
-    std::vector<Math::Edge> edges;
-    edges.reserve(Size(entity_pairs));
     for(auto p : entity_pairs)
     {
-        auto bodies1 = Bodies(p.id1, m_body_entity_mapping);
-        auto bodies2 = Bodies(p.id2, m_body_entity_mapping);
-        for(auto b1 : bodies1)
+        for(auto b1 : Bodies(p.id1, m_body_entity_mapping))
         {
-            for(auto b2 : bodies2)
+            for(auto b2 : Bodies(p.id2, m_body_entity_mapping))
             {
-                edges.emplace_back(b1.index, b2.index);
+                RemoveExcludedPair(b1, b2, m_collision_filter);
             }
         }
     }
-    RemoveSymmetricEdges(edges, m_non_colliding_bodies_pairs);
 }
 
 
 void PhysicsWorld::RemoveBodiesFromNonCollidingBodyPairs(Range<BodyID const *> bodies)
 {
-    std::vector<uint32_t> vertices;
-    vertices.reserve(Size(bodies));
-    for(auto b : bodies)
+    Remove(bodies, m_collision_filter);
+}
+
+
+void PhysicsWorld::SetCollisionLayers(EntityID entity_id, Range<ComponentDescription::Body const *> descriptions)
+{
+    // the bodies of a batch are only added to the mapping when the batch ends
+    std::vector<BodyID> bodies;
+    AppendBodies(CreateRange(&entity_id, 1), m_body_entity_mapping, bodies);
+    if(entity_id.index < m_last_batched_body_of_entity.size())
+    {
+        // the batched bodies are linked from the last to the first
+        auto first_batched = bodies.size();
+        for(auto i = m_last_batched_body_of_entity[entity_id.index]; i != c_invalid_index; i = m_previous_batched_bodies[i])
+        {
+            bodies.push_back(m_batched_bodies[i]);
+        }
+        std::reverse(begin(bodies) + first_batched, end(bodies));
+    }
+    assert(Size(bodies) == Size(descriptions) || bodies.empty());
+    for(auto i = 0u; i < Size(bodies); ++i)
     {
-        vertices.emplace_back(b.index);
+        SetLayer(bodies[i], descriptions[i].collision_layer, descriptions[i].collision_mask, m_collision_filter);
     }
-    RemoveVertices(vertices, m_non_colliding_bodies_pairs);
 }
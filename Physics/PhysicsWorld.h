@@ -2,14 +2,17 @@
 #include "DLL.h"
 // local includes
 #include "CollisionEventOffsets.h"
+#include "CollisionFilter.h"
 #include "DensityFunctionContainer.h"
 #include "ElementContainer.h"
 #include "MeshContainer.h"
 #include "MovingEntities.h"
+#include "NarrowPhase.h"
 #include "NonCollidingBodies.h"
 #include "OrientedBoxContainer.h"
 #include "ResourceManager.h"
 #include "SphereContainer.h"
+#include "CapsuleContainer.h"
 #include "Movement.h"
 #include "WorldConfiguration.h"
 #include "BodyIDGenerator.h"
@@ -17,15 +20,22 @@
 #include "CollisionEvent.h"
 #include "ResourceDescriptions.h"
 #include "PersistentConstraints.h"
+#include "Constraints.h"
+#include "BodyAndOrientationPair.h"
+#include "RayCasting.h"
+#include "RayHit.h"
 
 // DogDealer includes
 #include <Conventions\CollisionEvent.h>
 #include <Conventions\EntityID.h>
 #include <Conventions\Velocity.h>
-#include <Math\SparseAdjacencyMatrix.h>
 #include <BoundingShapes\Ray.h>
+#include <BoundingShapes\RayPacket.h>
+#include <Utilities\FrameArena.h>
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 struct RotationConstraints;
 struct VelocityConstraints;
@@ -48,16 +58,42 @@ namespace Physics
         NonCollidingBodies m_non_colliding_bodies;
         OrientedBoxContainer m_oriented_box_container;
         SphereContainer m_sphere_container;
+        CapsuleContainer m_capsule_container;
         BodyEntityMapping m_body_entity_mapping;
         PerstistentConstraints m_persistent_constraints;
         // records which bodies can't collide, and thus have to be ignored by the collision detection
-        Math::SparseAdjacencyMatrix m_non_colliding_bodies_pairs;
+        CollisionFilter m_collision_filter;
 
         CollisionEvents m_current_collision_events, m_previous_collision_events;
         CollisionEventOffsets m_previous_collision_event_offsets;
         std::unique_ptr<ConstraintSolver> m_constraint_solver;
         WorldConfiguration m_world_configuration;
         BodyIDGenerator m_body_id_generator;
+
+        // new bodies are collected here and added to the element container and body entity mapping all at once,
+        // at the end of the function that created them or, when a body batch is open, in EndBodyBatch
+        ElementBatch m_element_batch;
+        std::vector<EntityID> m_batched_body_entities;
+        std::vector<BodyID> m_batched_bodies;
+        // per batched body the previous batched body of its entity, and per entity index its last batched body,
+        // so the bodies of an entity are found without scanning the whole batch
+        std::vector<uint32_t> m_previous_batched_bodies;
+        std::vector<uint32_t> m_last_batched_body_of_entity;
+        bool m_body_batch_open = false;
+
+        // scratch memory for UpdateBodies, kept between ticks so a steady simulation doesn't allocate
+        FrameArena m_frame_arena;
+        std::vector<std::pair<uint32_t, uint32_t>> m_overlapping_index_pairs;
+        std::vector<BodyAndOrientationPair> m_candidate_collision_pairs, m_categorized_collision_pairs;
+        std::vector<NarrowPhaseChunkOutput> m_narrow_phase_chunk_outputs;
+        WorldRotationConstraints m_rotation_constraints;
+        WorldVelocityConstraints m_velocity_constraints;
+        WorldAngularVelocityConstraints m_angular_velocity_constraints;
+        ::CollisionEvents m_output_collision_events;
+        std::vector<EntityID> m_continuous_collision_entities;
+        // per entity index its position in m_continuous_collision_entities, or c_invalid_index
+        std::vector<uint32_t> m_continuous_collision_entity_indices;
+        uint64_t m_last_update_allocation_count = 0;
     public:
 
         Math::Float3 m_gravity;
@@ -166,6 +202,11 @@ namespace Physics
             Range<EntityID const *> const entity_ids
             );
 
+        // bodies created between these calls are added to the containers in a single pass in EndBodyBatch,
+        // they should not be queried or replaced before the batch is ended
+        void BeginBodyBatch();
+        void EndBodyBatch();
+
         // will assume all bodies of each entity pair cannot collide with each other
         void AddNonCollidingEntityPairs(
             Range<EntityPair const *> entity_pairs
@@ -177,6 +218,20 @@ namespace Physics
 
         void RemoveBodiesFromNonCollidingBodyPairs(Range<BodyID const*> bodies);
 
+        // sets the collision layer and mask of each body of the entity from the description with the same index
+        // two bodies only collide if the layer of each one is in the mask of the other one
+        void SetCollisionLayers(
+            EntityID entity_id,
+            Range<ComponentDescription::Body const *> descriptions
+            );
+
+        // rigid bodies of entities with continuous collision are swept against the static bodies after each update,
+        // so they can't tunnel through thin static geometry when they move more than their own size in one step
+        void SetContinuousCollision(
+            EntityID entity_id,
+            bool enabled
+            );
+
         bool HasRigidBodyComponent(
             EntityID entity_id
             ) const;
@@ -190,6 +245,13 @@ namespace Physics
             BoundingShapes::Ray const & ray
             ) const;
 
+        // writes the closest static hit of each ray, misses get an infinite time
+        // the rays are tested in packets against the static broad phase hierarchy
+        void CastRaysOnStaticEntities(
+            Range<BoundingShapes::Ray const *> rays,
+            Range<RayHit *> hits
+            ) const;
+
         Math::Float3 PhysicsWorld::CastRayOnBody(
             BoundingShapes::Ray const & ray,
             BodyID const & body
@@ -215,7 +277,8 @@ namespace Physics
             EntityRotations const & entity_rotations
             );
 
-        ::CollisionEvents UpdateBodies(
+        // the returned events stay valid until the next call
+        ::CollisionEvents const & UpdateBodies(
             EntityForces const & entity_forces,
             EntityTorques const & entity_torque,
             ::RotationConstraints const & rotation_constraints,
@@ -224,6 +287,9 @@ namespace Physics
             float const time_step
             );
 
+        // heap allocations made during the last UpdateBodies, see Utilities\AllocationCounter.h
+        uint64_t GetLastUpdateAllocationCount() const;
+
 		void CalculateVelocities(
             float time_step
             );
@@ -244,15 +310,45 @@ namespace Physics
             std::vector<EntityID>& entities
             );
 
+        // appends the world space triangles of the static meshes and oriented boxes, wound counter clockwise seen from outside,
+        // and the static density functions in world space together with the bounds of their bodies
+        void GetStaticGeometry(
+            std::vector<Math::Float3>& triangle_vertices,
+            std::vector<DensityFunctionType>& density_functions,
+            std::vector<BoundingShapes::AxisAlignedBox>& density_bounds
+            ) const;
+
     private:
 
         // currently the previous_collision_events are only used to re-use the storage
         Physics::CollisionEvents FindCollisions(
             Physics::CollisionEvents previous_collision_events = {}
-            ) const;
+            );
 
         void CreatePersistentConstraints(EntityID entity_id, Range<Connection const *> connections);
 
+        // time along the ray until it hits the body, infinity if it misses
+        float RayIntersectionTime(
+            BoundingShapes::Ray const & ray,
+            BodyID body
+            ) const;
+
+        // replaces the hits of the rays that hit the body before their current hit, returns a bit for each replaced hit
+        // packet_rays are the rays the packet was created from
+        unsigned RayPacketIntersectCloser(
+            BoundingShapes::RayPacket const & packet,
+            Range<BoundingShapes::Ray const *> packet_rays,
+            BodyID body,
+            RayPacketHits & hits
+            ) const;
+
+        // moves the rigid bodies of the continuous collision entities back to their first static hit along their path
+        // and appends a collision event for each hit to the output collision events
+        void SweepContinuousCollisionBodies();
+
+        void AddBatchedBodies();
+        void AddBatchedBodiesUnlessBatchIsOpen();
+
         void RemoveShapes(
             Range<EntityID const *> const entity_ids
             );
@@ -267,4 +363,10 @@ namespace Physics
     {
         return m_moving_entities;
     }
+
+
+    inline uint64_t PhysicsWorld::GetLastUpdateAllocationCount() const
+    {
+        return m_last_update_allocation_count;
+    }
 }
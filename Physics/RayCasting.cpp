@@ -3,58 +3,78 @@
 #include <BoundingShapes\BoxConversion.h>
 #include <BoundingShapes\AxisAlignedBoxFunctions.h>
 #include <BoundingShapes\AxisAlignedBoxSSEFunctions.h>
+#include <BoundingShapes\CapsuleFunctions.h>
 #include <BoundingShapes\RayFunctions.h>
+#include <BoundingShapes\RayPacketFunctions.h>
+#include <BoundingShapes\TriangleBatchFunctions.h>
 
 #include <Math\SSE.h>
 #include <Math\SSEMathConversions.h>
 #include <Math\MathFunctions.h>
+#include <Math\FloatOperators.h>
 
+#include <array>
 #include <limits>
+#include <vector>
 
-float Physics::IntersectionTime(BoundingShapes::Ray const & ray, DensityFunctionType const & density_function, float accuracy)
+float Physics::IntersectionTime(BoundingShapes::Ray const & ray, DensityFunctionType const & density_function, DensityRayMarchSettings const & settings)
 {
-    auto const max_iterations = 1000;
-    assert( accuracy > 0 );
+    assert(settings.lipschitz_bound > 0 && settings.max_length > 0 && settings.max_steps > 0 && settings.accuracy > 0);
     float density;
     Math::Float3 gradient;
-    auto position = ray.start;
-    auto direction = ray.direction;
-    size_t iteration = 0;
-    float time = 0;
-    for( density_function(position, density, gradient); Math::Abs(density) > accuracy && iteration < max_iterations; density_function(position, density, gradient) )
+    density_function(ray.start, density, gradient);
+    if(density > 0)
     {
-        auto a = Dot(gradient, direction);
-        auto time_step = (-density / a);
-        time += time_step;
-        position += time_step * direction;
-        iteration += 1;
+        return 0;
     }
-    if(iteration == max_iterations || time < 0)
+
+    // the surface is at least -density / lipschitz_bound away, closer than the accuracy the steps don't get any smaller
+    // so only features thinner than the accuracy can be passed, when the steps run out before max_length the ray misses
+    auto outside_time = 0.f;
+    auto inside_time = std::numeric_limits<float>::infinity();
+    for(auto step = 0u; step < settings.max_steps && outside_time < settings.max_length; ++step)
     {
-        time = std::numeric_limits<float>::infinity();
+        auto time = Math::Min(outside_time + Math::Max(-density / settings.lipschitz_bound, settings.accuracy), settings.max_length);
+        density_function(PointAlongRay(ray, time), density, gradient);
+        if(density > 0)
+        {
+            inside_time = time;
+            break;
+        }
+        outside_time = time;
+    }
+    if(inside_time == std::numeric_limits<float>::infinity())
+    {
+        return inside_time;
     }
-    return time;
-}
-
 
-Math::Float3 Physics::IntersectionPoint(BoundingShapes::Ray const & ray, DensityFunctionType const & density_function, float accuracy)
-{
-    assert( accuracy > 0 );
-    float density;
-    Math::Float3 gradient;
-    auto position = ray.start;
-    auto direction = ray.direction;
-    size_t iteration = 0;
-    for( density_function(position, density, gradient); Math::Abs(density) > accuracy && iteration < 1000; density_function(position, density, gradient) )
+    // bisect between the last step outside and the first one inside, the step in between couldn't pass a surface thicker than the accuracy
+    while(inside_time - outside_time > settings.accuracy)
     {
-        auto a = Dot(gradient, direction);
-        auto time_step = (-density / a);
-        auto step = time_step * direction;
-        position += step;
-        iteration += 1;
+        auto middle_time = (outside_time + inside_time) / 2;
+        if(middle_time <= outside_time || middle_time >= inside_time)
+        {
+            // the accuracy is finer than the float precision at this distance
+            break;
+        }
+        density_function(PointAlongRay(ray, middle_time), density, gradient);
+        if(density > 0)
+        {
+            inside_time = middle_time;
+        }
+        else
+        {
+            outside_time = middle_time;
+        }
     }
+    return (outside_time + inside_time) / 2;
+}
+
 
-    return position;
+Math::Float3 Physics::IntersectionPoint(BoundingShapes::Ray const & ray, DensityFunctionType const & density_function, DensityRayMarchSettings const & settings)
+{
+    auto time = IntersectionTime(ray, density_function, settings);
+    return PointAlongRay(ray, time);
 }
 
 
@@ -76,8 +96,11 @@ namespace
         tmin = Max(Swizzle<1, 2, 0>(tmin), tmin);
         tmin = Max(Swizzle<2, 0, 1>(tmin), tmin);
 
-        // check if all tmax values are larger than the lowest tmin
-        auto is_negative = MaskSignBits(Subtract(tmax, tmin));
+        // rays starting inside hit at the start, so boxes behind the start, with a negative tmax, aren't hit
+        tmin = Max(tmin, ZeroFloat32Vector());
+
+        // check if all tmax values are larger than the common tmin, the fourth lane isn't part of the box
+        auto is_negative = MaskSignBits(Subtract(tmax, tmin)) & 7;
         if(is_negative)
         {
             // no intersection
@@ -117,8 +140,11 @@ Math::Float3 Physics::IntersectionPoint(BoundingShapes::Ray const & ray, Boundin
 
 float Physics::IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::OrientedBox const & box)
 {
-    auto transformed_ray = Rotate(ray, Conjugate(box.rotation));
-    return IntersectionTime(ray, AxisAlignedBoxPartOfOrientedBox(box));
+    // in the space of the box it is axis aligned around the origin
+    auto inverse_rotation = Conjugate(box.rotation);
+    BoundingShapes::Ray local_ray = {Rotate(ray.start - box.center, inverse_rotation), Rotate(ray.direction, inverse_rotation)};
+    BoundingShapes::AxisAlignedBox local_box = {0, box.extent};
+    return IntersectionTime(local_ray, local_box);
 }
 
 
@@ -155,13 +181,19 @@ float Physics::IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes:
     auto center_time = Dot(ray.direction, -ray_start);
     auto closet_point = ray_start + ray.direction * center_time;
     auto distance² = SquaredNorm(closet_point);
-    auto extra_time² = distance² - sphere.radius * sphere.radius;
+    auto extra_time² = sphere.radius * sphere.radius - distance²;
     if(extra_time² < 0)
     {
         return std::numeric_limits<float>::infinity();
     }
     auto extra_time = Math::Sqrt(extra_time²);
-    return center_time - extra_time;
+    // the sphere is behind the start
+    if(center_time + extra_time < 0)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+    // rays starting inside hit at the start
+    return Math::Max(center_time - extra_time, 0.f);
 }
 
 
@@ -183,3 +215,405 @@ Math::Float3 Physics::IntersectionPoint(BoundingShapes::Ray const & ray, Range<B
     auto time = IntersectionTime(ray, spheres);
     return PointAlongRay(ray, time);
 }
+
+
+float Physics::IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::Capsule const & capsule)
+{
+    // the spheres at both ends are the caps, the cylinder in between only counts where it is between them
+    auto time = Math::Min(
+        IntersectionTime(ray, BoundingShapes::Sphere{ capsule.start, capsule.radius }),
+        IntersectionTime(ray, BoundingShapes::Sphere{ capsule.end, capsule.radius }));
+    auto axis = capsule.end - capsule.start;
+    auto axis_length² = SquaredNorm(axis);
+    if(axis_length² == 0)
+    {
+        return time;
+    }
+
+    // the parts of the ray that are perpendicular to the axis
+    auto ray_start = ray.start - capsule.start;
+    auto start_parameter = Dot(ray_start, axis) / axis_length²;
+    auto direction_parameter = Dot(ray.direction, axis) / axis_length²;
+    auto start_offset = ray_start - axis * start_parameter;
+    auto direction_offset = ray.direction - axis * direction_parameter;
+    auto radius² = capsule.radius * capsule.radius;
+    auto start_distance² = SquaredNorm(start_offset) - radius²;
+    // rays starting inside hit at the start
+    if(start_distance² <= 0 && start_parameter >= 0 && start_parameter <= 1)
+    {
+        return 0;
+    }
+    auto a = SquaredNorm(direction_offset);
+    auto b = Dot(start_offset, direction_offset);
+    auto discriminant = b * b - a * start_distance²;
+    // parallel to the axis or missing the infinite cylinder
+    if(a == 0 || discriminant < 0)
+    {
+        return time;
+    }
+    auto cylinder_time = (-b - Math::Sqrt(discriminant)) / a;
+    auto parameter = start_parameter + direction_parameter * cylinder_time;
+    if(cylinder_time >= 0 && parameter >= 0 && parameter <= 1)
+    {
+        time = Math::Min(cylinder_time, time);
+    }
+    return time;
+}
+
+
+float Physics::IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::Capsule const & capsule, Math::Float3 & normal)
+{
+    auto time = IntersectionTime(ray, capsule);
+    if(time == 0)
+    {
+        normal = -ray.direction;
+    }
+    else if(time < std::numeric_limits<float>::infinity())
+    {
+        auto point = PointAlongRay(ray, time);
+        normal = Normalize(point - GetAxisPoint(capsule, ClosestAxisParameter(capsule, point)));
+    }
+    return time;
+}
+
+
+float Physics::IntersectionTime(BoundingShapes::Ray const & ray, Range<BoundingShapes::Capsule const *> capsules)
+{
+    auto time = IntersectionTime(ray, First(capsules));
+    PopFirst(capsules);
+    for(auto const & capsule : capsules)
+    {
+        auto new_time = IntersectionTime(ray, capsule);
+        time = Math::Min(new_time, time);
+    }
+    return time;
+}
+
+
+namespace
+{
+    // exact slab test, the approximate reciprocal of the single box test can miss nodes the ray only grazes
+    // returns a negative time if the ray starts inside the box
+    float EntryTime(BoundingShapes::Ray const & ray, Math::Float3 const & inverse_direction, BoundingShapes::AxisAlignedBox const & box)
+    {
+        auto entry = -std::numeric_limits<float>::infinity();
+        auto exit = std::numeric_limits<float>::infinity();
+        for(auto a = 0u; a < 3; ++a)
+        {
+            auto t0 = (box.center[a] - box.extent[a] - ray.start[a]) * inverse_direction[a];
+            auto t1 = (box.center[a] + box.extent[a] - ray.start[a]) * inverse_direction[a];
+            entry = Math::Max(entry, Math::Min(t0, t1));
+            exit = Math::Min(exit, Math::Max(t0, t1));
+        }
+        if(entry > exit || exit < 0)
+        {
+            return std::numeric_limits<float>::infinity();
+        }
+        return entry;
+    }
+
+
+    BoundingShapes::Triangle GetTriangle(BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh, unsigned node_index)
+    {
+        auto const & indices = mesh.nodes[node_index].vertex_indices;
+        return {{{mesh.vertex_positions[indices[0]], mesh.vertex_positions[indices[1]], mesh.vertex_positions[indices[2]]}}};
+    }
+}
+
+
+float Physics::IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh)
+{
+    Math::Float3 normal;
+    return IntersectionTime(ray, mesh, normal);
+}
+
+
+float Physics::IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh, Math::Float3 & normal)
+{
+    using namespace Math::SSE;
+    auto time = std::numeric_limits<float>::infinity();
+    if(mesh.nodes.empty())
+    {
+        return time;
+    }
+
+    // the triangles wait in a batch until four of them can be tested at once
+    BoundingShapes::TriangleBatch batch;
+    std::array<unsigned, BoundingShapes::c_triangle_batch_width> batch_nodes;
+    auto batch_size = 0u;
+    auto hit_node = 0u;
+    auto test_batch = [&]()
+    {
+        // unused lanes repeat the last triangle
+        for(auto lane = batch_size; lane < BoundingShapes::c_triangle_batch_width; ++lane)
+        {
+            SetTriangle(GetTriangle(mesh, batch_nodes[batch_size - 1]), lane, batch);
+        }
+        alignas(16) std::array<float, BoundingShapes::c_triangle_batch_width> times;
+        Store(IntersectionTimes(ray, batch), times.data());
+        for(auto lane = 0u; lane < batch_size; ++lane)
+        {
+            if(times[lane] < time)
+            {
+                time = times[lane];
+                hit_node = batch_nodes[lane];
+            }
+        }
+        batch_size = 0;
+    };
+
+    // leafs don't store a box, they get the entry time of their parent
+    struct StackEntry
+    {
+        unsigned node;
+        float time;
+    };
+    // the SAH builder doesn't bound the depth of the tree,
+    // entries that don't fit on the fixed stack spill into a vector that only allocates for deep trees
+    std::array<StackEntry, 64> stack;
+    auto stack_size = 0u;
+    std::vector<StackEntry> spilled_stack;
+    auto const push = [&](StackEntry const & entry)
+    {
+        if(stack_size < stack.size())
+        {
+            stack[stack_size++] = entry;
+        }
+        else
+        {
+            spilled_stack.push_back(entry);
+        }
+    };
+    auto const pop = [&]()
+    {
+        if(!spilled_stack.empty())
+        {
+            auto const entry = spilled_stack.back();
+            spilled_stack.pop_back();
+            return entry;
+        }
+        return stack[--stack_size];
+    };
+
+    Math::Float3 const inverse_direction = {1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z};
+    auto const node_count = unsigned(mesh.nodes.size());
+    auto const is_leaf = [&](unsigned index)
+    {
+        return mesh.nodes[index].escape_index == index + 1;
+    };
+    auto const node_time = [&](unsigned index, float parent_time)
+    {
+        return is_leaf(index) ? parent_time : EntryTime(ray, inverse_direction, mesh.nodes[index].shape);
+    };
+
+    push({0, node_time(0, 0)});
+    while(stack_size > 0)
+    {
+        auto const entry = pop();
+        if(!(entry.time < time))
+        {
+            continue;
+        }
+        if(is_leaf(entry.node))
+        {
+            SetTriangle(GetTriangle(mesh, entry.node), batch_size, batch);
+            batch_nodes[batch_size++] = entry.node;
+            if(batch_size == BoundingShapes::c_triangle_batch_width)
+            {
+                test_batch();
+            }
+            continue;
+        }
+
+        // push the farther child first, so the closer one is visited next
+        auto const first = entry.node + 1;
+        auto const second = mesh.nodes[first].escape_index;
+        assert(second < node_count);
+        StackEntry first_entry = {first, node_time(first, entry.time)};
+        StackEntry second_entry = {second, node_time(second, entry.time)};
+        if(first_entry.time < second_entry.time)
+        {
+            std::swap(first_entry, second_entry);
+        }
+        push(first_entry);
+        push(second_entry);
+    }
+    if(batch_size > 0)
+    {
+        test_batch();
+    }
+
+    if(time < std::numeric_limits<float>::infinity())
+    {
+        auto const triangle = GetTriangle(mesh, hit_node);
+        normal = Normalize(Cross(triangle.corners[1] - triangle.corners[0], triangle.corners[2] - triangle.corners[0]));
+        if(Dot(normal, ray.direction) > 0)
+        {
+            normal = -normal;
+        }
+    }
+    return time;
+}
+
+
+namespace
+{
+    // a vector for each ray of a packet
+    struct PacketVector
+    {
+        Float32Vector x, y, z;
+    };
+
+
+    Float32Vector PacketDot(PacketVector const & a, PacketVector const & b)
+    {
+        return MultiplyAdd(a.x, b.x, MultiplyAdd(a.y, b.y, Multiply(a.z, b.z)));
+    }
+
+
+    Float32Vector PacketDot(PacketVector const & a, Math::Float3 const & b)
+    {
+        return MultiplyAdd(a.x, SetAll(b.x), MultiplyAdd(a.y, SetAll(b.y), Multiply(a.z, SetAll(b.z))));
+    }
+
+
+    PacketVector PacketStartRelativeTo(BoundingShapes::RayPacket const & rays, Math::Float3 const & origin)
+    {
+        return {Subtract(rays.start_x, SetAll(origin.x)), Subtract(rays.start_y, SetAll(origin.y)), Subtract(rays.start_z, SetAll(origin.z))};
+    }
+
+
+    PacketVector PacketDirection(BoundingShapes::RayPacket const & rays)
+    {
+        return {rays.direction_x, rays.direction_y, rays.direction_z};
+    }
+
+
+    PacketVector NormalizedInverse(PacketVector const & v)
+    {
+        auto scale = Divide(SetAll(-1.f), SquareRoot(PacketDot(v, v)));
+        return {Multiply(v.x, scale), Multiply(v.y, scale), Multiply(v.z, scale)};
+    }
+
+
+    // stores the times and normals of the hit lanes
+    unsigned StoreHits(BoundingShapes::RayPacket const & rays, Float32Vector hit, Float32Vector times, PacketVector const & normals, Physics::RayPacketHits & hits)
+    {
+        hits.times = Blend(hits.times, times, hit);
+        hits.normal_x = Blend(hits.normal_x, normals.x, hit);
+        hits.normal_y = Blend(hits.normal_y, normals.y, hit);
+        hits.normal_z = Blend(hits.normal_z, normals.z, hit);
+        // leave out the lanes that repeat the last ray
+        return MaskSignBits(hit) & ((1u << rays.count) - 1);
+    }
+}
+
+
+Physics::RayPacketHits Physics::CreateEmptyRayPacketHits()
+{
+    using namespace Math::SSE;
+    return {SetAll(std::numeric_limits<float>::infinity()), ZeroFloat32Vector(), ZeroFloat32Vector(), ZeroFloat32Vector()};
+}
+
+
+void Physics::SetHit(unsigned lane, float time, Math::Float3 const & normal, RayPacketHits & hits)
+{
+    using namespace Math::SSE;
+    assert(lane < BoundingShapes::c_ray_packet_width);
+    auto mask = Set(lane == 0 ? -1.f : 0.f, lane == 1 ? -1.f : 0.f, lane == 2 ? -1.f : 0.f, lane == 3 ? -1.f : 0.f);
+    hits.times = Blend(hits.times, SetAll(time), mask);
+    hits.normal_x = Blend(hits.normal_x, SetAll(normal.x), mask);
+    hits.normal_y = Blend(hits.normal_y, SetAll(normal.y), mask);
+    hits.normal_z = Blend(hits.normal_z, SetAll(normal.z), mask);
+}
+
+
+unsigned Physics::IntersectCloser(BoundingShapes::RayPacket const & rays, BoundingShapes::OrientedBox const & box, RayPacketHits & hits)
+{
+    using namespace Math::SSE;
+    std::array<Math::Float3, 3> const axes = {{
+        Rotate(Math::Float3(1, 0, 0), box.rotation),
+        Rotate(Math::Float3(0, 1, 0), box.rotation),
+        Rotate(Math::Float3(0, 0, 1), box.rotation),
+    }};
+    auto const start = PacketStartRelativeTo(rays, box.center);
+    auto const direction = PacketDirection(rays);
+
+    // slab test along the axes of the box
+    std::array<Float32Vector, 3> axis_entries;
+    std::array<Float32Vector, 3> axis_directions;
+    auto entry = SetAll(-std::numeric_limits<float>::infinity());
+    auto exit = SetAll(std::numeric_limits<float>::infinity());
+    for(auto a = 0u; a < 3; ++a)
+    {
+        auto local_start = PacketDot(start, axes[a]);
+        axis_directions[a] = PacketDot(direction, axes[a]);
+        auto inverse_direction = Divide(SetAll(1.f), axis_directions[a]);
+        auto t0 = Multiply(Subtract(SetAll(-box.extent[a]), local_start), inverse_direction);
+        auto t1 = Multiply(Subtract(SetAll(box.extent[a]), local_start), inverse_direction);
+        axis_entries[a] = Min(t0, t1);
+        entry = Max(entry, axis_entries[a]);
+        exit = Min(exit, Max(t0, t1));
+    }
+
+    auto const zero = ZeroFloat32Vector();
+    auto const times = Max(entry, zero);
+    auto const hit = And(And(LessThanOrEqual(entry, exit), GreaterThanOrEqual(exit, zero)), LessThan(times, hits.times));
+    if(!AnySignBitsSet(hit))
+    {
+        return 0;
+    }
+
+    // the normal of the face of the slab the ray entered last, going backwards gives the first axis priority on edges
+    auto normals = NormalizedInverse(direction);
+    auto const inside = LessThan(entry, zero);
+    for(auto a = 3u; a-- > 0;)
+    {
+        auto on_face = AndNot(GreaterThanOrEqual(axis_entries[a], entry), inside);
+        auto sign = CopySign(SetAll(1.f), Negate(axis_directions[a]));
+        normals.x = Blend(normals.x, Multiply(sign, SetAll(axes[a].x)), on_face);
+        normals.y = Blend(normals.y, Multiply(sign, SetAll(axes[a].y)), on_face);
+        normals.z = Blend(normals.z, Multiply(sign, SetAll(axes[a].z)), on_face);
+    }
+    return StoreHits(rays, hit, times, normals, hits);
+}
+
+
+unsigned Physics::IntersectCloser(BoundingShapes::RayPacket const & rays, BoundingShapes::Sphere const & sphere, RayPacketHits & hits)
+{
+    using namespace Math::SSE;
+    auto const start = PacketStartRelativeTo(rays, sphere.center);
+    auto const direction = PacketDirection(rays);
+
+    // solve |start + t * direction|² = radius² for t
+    auto const a = PacketDot(direction, direction);
+    auto const b = PacketDot(start, direction);
+    auto const c = Subtract(PacketDot(start, start), SetAll(sphere.radius * sphere.radius));
+    auto const discriminant = Subtract(Multiply(b, b), Multiply(a, c));
+    auto const root = SquareRoot(Max(discriminant, ZeroFloat32Vector()));
+    auto const near_time = Divide(Subtract(Negate(b), root), a);
+    auto const far_time = Divide(Subtract(root, b), a);
+
+    auto const zero = ZeroFloat32Vector();
+    auto const times = Max(near_time, zero);
+    auto const hit = And(And(GreaterThanOrEqual(discriminant, zero), GreaterThanOrEqual(far_time, zero)), LessThan(times, hits.times));
+    if(!AnySignBitsSet(hit))
+    {
+        return 0;
+    }
+
+    auto const inverse_radius = SetAll(1.f / sphere.radius);
+    PacketVector const surface_normals = {
+        Multiply(MultiplyAdd(direction.x, times, start.x), inverse_radius),
+        Multiply(MultiplyAdd(direction.y, times, start.y), inverse_radius),
+        Multiply(MultiplyAdd(direction.z, times, start.z), inverse_radius),
+    };
+    auto const inside_normals = NormalizedInverse(direction);
+    auto const inside = LessThan(near_time, zero);
+    PacketVector const normals = {
+        Blend(surface_normals.x, inside_normals.x, inside),
+        Blend(surface_normals.y, inside_normals.y, inside),
+        Blend(surface_normals.z, inside_normals.z, inside),
+    };
+    return StoreHits(rays, hit, times, normals, hits);
+}
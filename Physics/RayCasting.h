@@ -1,21 +1,40 @@
 #pragma once
 
 #include "DensityFunction.h"
+#include "DensityRayMarchSettings.h"
 
 #include <Math\FloatTypes.h>
 
 #include <BoundingShapes\Ray.h>
+#include <BoundingShapes\RayPacket.h>
 #include <BoundingShapes\AxisAlignedBox.h>
+#include <BoundingShapes\AxisAlignedBoxHierarchyMesh.h>
+#include <BoundingShapes\Capsule.h>
 #include <BoundingShapes\OrientedBox.h>
 #include <BoundingShapes\Sphere.h>
 
+#include <Math\SSETypes.h>
 #include <Utilities\Range.h>
 
 namespace Physics
 {
+    // the closest hits found so far for the rays of a packet, infinite times for rays without a hit
+    struct RayPacketHits
+    {
+        Math::SSE::Float32Vector times;
+        Math::SSE::Float32Vector normal_x, normal_y, normal_z;
+    };
 
-    float IntersectionTime(BoundingShapes::Ray const & ray, DensityFunctionType const & density_function, float accuracy);
+    RayPacketHits CreateEmptyRayPacketHits();
 
+    // replaces the hit of a single ray of the packet
+    void SetHit(unsigned lane, float time, Math::Float3 const & normal, RayPacketHits & hits);
+
+    // marches along the ray in steps that can't pass the surface and refines the first step that ends up inside
+    // rays starting inside hit at time zero
+    float IntersectionTime(BoundingShapes::Ray const & ray, DensityFunctionType const & density_function, DensityRayMarchSettings const & settings);
+
+    // like the packet tests, rays starting inside hit at time zero and shapes behind the start return infinity
     float IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::AxisAlignedBox const & box);
 
     float IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::OrientedBox const & box);
@@ -26,7 +45,20 @@ namespace Physics
 
     float IntersectionTime(BoundingShapes::Ray const & ray, Range<BoundingShapes::Sphere const *> spheres);
 
-    Math::Float3 IntersectionPoint(BoundingShapes::Ray const & ray, DensityFunctionType const & density_function, float accuracy);
+    float IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::Capsule const & capsule);
+
+    // also returns the normal of the surface at the hit, rays starting inside get a normal against the ray
+    float IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::Capsule const & capsule, Math::Float3 & normal);
+
+    float IntersectionTime(BoundingShapes::Ray const & ray, Range<BoundingShapes::Capsule const *> capsules);
+
+    // both sides of the triangles are hit, closer nodes are visited first and farther nodes are skipped once something was hit
+    float IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh);
+
+    // also returns the normal of the hit triangle, facing against the ray
+    float IntersectionTime(BoundingShapes::Ray const & ray, BoundingShapes::AxisAlignedBoxHierarchyMesh const & mesh, Math::Float3 & normal);
+
+    Math::Float3 IntersectionPoint(BoundingShapes::Ray const & ray, DensityFunctionType const & density_function, DensityRayMarchSettings const & settings);
 
     Math::Float3 IntersectionPoint(BoundingShapes::Ray const & ray, BoundingShapes::AxisAlignedBox const & box);
 
@@ -36,4 +68,9 @@ namespace Physics
 
     Math::Float3 IntersectionPoint(BoundingShapes::Ray const & ray, Range<BoundingShapes::Sphere const *> spheres);
 
+    // replace the hits of the rays that hit the shape before their current hit, returns a bit for each replaced hit
+    // rays starting inside the shape hit it at time zero, with a normal against the ray direction
+    unsigned IntersectCloser(BoundingShapes::RayPacket const & rays, BoundingShapes::OrientedBox const & box, RayPacketHits & hits);
+
+    unsigned IntersectCloser(BoundingShapes::RayPacket const & rays, BoundingShapes::Sphere const & sphere, RayPacketHits & hits);
 }
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "BodyID.h"
+
+#include <Conventions\EntityID.h>
+#include <Math\FloatTypes.h>
+
+namespace Physics
+{
+    struct RayHit
+    {
+        // distance along the ray, infinity if it didn't hit anything
+        float time;
+        BodyID body;
+        EntityID entity;
+        // surface normal at the hit, pointing out of the body
+        Math::Float3 normal;
+    };
+}
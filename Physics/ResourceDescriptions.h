@@ -33,6 +33,11 @@ namespace Physics{
             float bounciness;
             float friction_factor;
             bool lock_rotation;
+            // sweep the body against the static geometry so it can't tunnel through it when moving fast
+            bool continuous_collision;
+            // bit of the layer the body is in, and the bits of the layers it can collide with
+            uint32_t collision_layer;
+            uint32_t collision_mask;
             std::string collision_file;
         };
         BodyType body_type;
@@ -1,6 +1,7 @@
 #pragma once
 #include "ResourceManager.h"
 
+#include <BoundingShapes\Capsule.h>
 #include <BoundingShapes\FileLayout.h>
 #include <BoundingShapes\ShapeType.h>
 #include <BoundingShapes\Sphere.h>
@@ -50,6 +51,7 @@ void ResourceManager::LoadCollisionData( std::string const & file_name, NewColli
 
     std::vector<BoundingShapes::OrientedBox> & boxes = collision_data.oriented_boxes;
     std::vector<BoundingShapes::Sphere> & spheres = collision_data.spheres;
+    std::vector<BoundingShapes::Capsule> & capsules = collision_data.capsules;
     std::vector<BoundingShapes::AxisAlignedBoxHierarchyMesh> & meshes = collision_data.meshes;
 
     std::vector<BoundingShapes::ShapeType> shape_types(file_data.number_of_shapes);
@@ -73,6 +75,13 @@ void ResourceManager::LoadCollisionData( std::string const & file_name, NewColli
                 boxes.push_back(box);
                 break;
             }
+            case ShapeType::Capsule:
+            {
+                BoundingShapes::Capsule capsule;
+                ReadObject(data_stream, capsule);
+                capsules.push_back(capsule);
+                break;
+            }
             case ShapeType::AxisAlignedBoxHierarchyMesh:
             {
                 AxisAlignedBoxHierarchyMesh mesh;
@@ -12,6 +12,7 @@ namespace BoundingShapes
 {
     struct Sphere;
     struct OrientedBox;
+    struct Capsule;
 }
 
 namespace Physics{
@@ -22,6 +23,7 @@ namespace Physics{
         // narrow shapes
         std::vector<BoundingShapes::OrientedBox> oriented_boxes;
         std::vector<BoundingShapes::Sphere> spheres;
+        std::vector<BoundingShapes::Capsule> capsules;
         std::vector<BoundingShapes::AxisAlignedBoxHierarchyMesh> meshes;
     };
 
@@ -31,6 +33,7 @@ namespace Physics{
         // narrow shapes
         std::vector<BoundingShapes::OrientedBox> oriented_boxes;
         std::vector<BoundingShapes::Sphere> spheres;
+        std::vector<BoundingShapes::Capsule> capsules;
         std::vector<AxisAlignedBoxHierarchyMeshID> mesh_ids;
     };
 
@@ -0,0 +1,84 @@
+#include "CppUnitTest.h"
+
+#include <Physics\CollisionEvent.h>
+
+#include <Utilities\FrameArena.h>
+
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Physics;
+
+namespace DogDealerPhysicsUnitTests
+{
+    namespace
+    {
+        void AddEvent( uint32_t body1, uint32_t body2, float depth, CollisionEvents & events )
+        {
+            Manifold manifold;
+            manifold.contact_point_count = 1;
+            manifold.penetration_depths[0] = depth;
+            manifold.separation_axes[0] = { 0, 1, 0 };
+            manifold.positions[0] = { depth, 0, 0 };
+            events.bodies.emplace_back( BodyID{ body1, 0 }, BodyID{ body2, 0 } );
+            events.relative_positions.push_back( { 0, 0, 0 } );
+            events.manifolds.push_back( manifold );
+        }
+    }
+
+
+    TEST_CLASS(CollisionEventUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestRemoveDuplicatesKeepsFirstOccurrenceOrder)
+        {
+            CollisionEvents events;
+            AddEvent( 7, 3, 0.1f, events );
+            AddEvent( 1, 2, 0.2f, events );
+            // duplicate of the first one, with the bodies flipped
+            AddEvent( 3, 7, 0.3f, events );
+            AddEvent( 9, 4, 0.4f, events );
+            AddEvent( 2, 1, 0.5f, events );
+
+            FrameArena arena;
+            RemoveDuplicates( events, arena );
+
+            Assert::AreEqual( size_t( 3 ), Size( events.bodies ) );
+            Assert::IsTrue( events.bodies[0] == BodyPair( { 7, 0 }, { 3, 0 } ) );
+            Assert::IsTrue( events.bodies[1] == BodyPair( { 2, 0 }, { 1, 0 } ) );
+            Assert::IsTrue( events.bodies[2] == BodyPair( { 9, 0 }, { 4, 0 } ) );
+            // the manifolds of the duplicates are merged into the kept events
+            Assert::AreEqual( uint8_t( 2 ), events.manifolds[0].contact_point_count );
+            Assert::AreEqual( uint8_t( 2 ), events.manifolds[1].contact_point_count );
+            Assert::AreEqual( uint8_t( 1 ), events.manifolds[2].contact_point_count );
+        }
+
+
+        TEST_METHOD(TestRemoveDuplicatesOfManyEvents)
+        {
+            std::mt19937 generator( 1234 );
+            std::uniform_int_distribution<uint32_t> body( 0, 99 );
+            std::uniform_int_distribution<uint32_t> other_body_offset( 1, 99 );
+            CollisionEvents events;
+            for( auto i = 0u; i < 5000; ++i )
+            {
+                auto const body1 = body( generator );
+                AddEvent( body1, ( body1 + other_body_offset( generator ) ) % 100, 0.1f, events );
+            }
+
+            FrameArena arena;
+            RemoveDuplicates( events, arena );
+
+            for( auto i = 0u; i < Size( events.bodies ); ++i )
+            {
+                Assert::IsTrue( events.bodies[i].id1.index > events.bodies[i].id2.index );
+                for( auto j = i + 1; j < Size( events.bodies ); ++j )
+                {
+                    Assert::IsFalse( events.bodies[i] == events.bodies[j] );
+                }
+            }
+            Assert::IsTrue( Size( events.bodies ) < 5000 );
+        }
+    };
+}
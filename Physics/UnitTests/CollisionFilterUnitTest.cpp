@@ -0,0 +1,136 @@
+#include "CppUnitTest.h"
+
+#include <Physics\CollisionFilter.h>
+
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Physics;
+
+namespace DogDealerPhysicsUnitTests
+{
+    namespace
+    {
+        BodyID Body( uint32_t index )
+        {
+            return { index, 0 };
+        }
+
+
+        std::pair<uint32_t, uint32_t> SortedPair( uint32_t a, uint32_t b )
+        {
+            return a < b ? std::make_pair( a, b ) : std::make_pair( b, a );
+        }
+    }
+
+
+    TEST_CLASS(CollisionFilterUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestLayersAndMasks)
+        {
+            CollisionFilter filter;
+            Assert::IsTrue( CanCollide( Body( 0 ), Body( 1 ), filter ) );
+
+            // a projectile that doesn't hit other projectiles
+            SetLayer( Body( 2 ), 2, ~2u, filter );
+            SetLayer( Body( 3 ), 2, ~2u, filter );
+            Assert::IsFalse( CanCollide( Body( 2 ), Body( 3 ), filter ) );
+            Assert::IsTrue( CanCollide( Body( 2 ), Body( 0 ), filter ) );
+
+            // both masks have to match
+            SetLayer( Body( 4 ), 1, 1, filter );
+            Assert::IsFalse( CanCollide( Body( 4 ), Body( 2 ), filter ) );
+            Assert::IsFalse( CanCollide( Body( 2 ), Body( 4 ), filter ) );
+
+            auto const removed = Body( 2 );
+            Remove( CreateRange( &removed, 1 ), filter );
+            Assert::IsTrue( CanCollide( Body( 2 ), Body( 3 ), filter ) );
+        }
+
+
+        TEST_METHOD(TestExcludedPairs)
+        {
+            CollisionFilter filter;
+            AddExcludedPair( Body( 5 ), Body( 1 ), filter );
+            AddExcludedPair( Body( 1 ), Body( 5 ), filter );
+            AddExcludedPair( Body( 1 ), Body( 7 ), filter );
+            Assert::AreEqual( 2u, filter.excluded_pair_count );
+            Assert::IsTrue( IsExcludedPair( Body( 1 ), Body( 5 ), filter ) );
+            Assert::IsFalse( CanCollide( Body( 7 ), Body( 1 ), filter ) );
+            Assert::IsFalse( IsExcludedPair( Body( 5 ), Body( 7 ), filter ) );
+
+            RemoveExcludedPair( Body( 5 ), Body( 1 ), filter );
+            Assert::IsFalse( IsExcludedPair( Body( 1 ), Body( 5 ), filter ) );
+            Assert::IsTrue( IsExcludedPair( Body( 1 ), Body( 7 ), filter ) );
+
+            auto const removed = Body( 7 );
+            Remove( CreateRange( &removed, 1 ), filter );
+            Assert::AreEqual( 0u, filter.excluded_pair_count );
+            Assert::IsTrue( CanCollide( Body( 1 ), Body( 7 ), filter ) );
+        }
+
+
+        TEST_METHOD(TestFilterMatchesSinglePairTests)
+        {
+            std::mt19937 generator( 1234 );
+            std::uniform_int_distribution<uint32_t> body( 0, 199 );
+            std::uniform_int_distribution<uint32_t> layer( 0, 3 );
+
+            CollisionFilter filter;
+            for( auto i = 0u; i < 200; i += 3 )
+            {
+                SetLayer( Body( i ), 1u << layer( generator ), ~( 1u << layer( generator ) ), filter );
+            }
+
+            // add and remove many pairs, so the removals have to move keys around in the hash set
+            std::set<std::pair<uint32_t, uint32_t>> excluded;
+            for( auto i = 0u; i < 3000; ++i )
+            {
+                auto const a = body( generator );
+                auto const b = body( generator );
+                if( i % 3 == 2 )
+                {
+                    RemoveExcludedPair( Body( a ), Body( b ), filter );
+                    excluded.erase( SortedPair( a, b ) );
+                }
+                else
+                {
+                    AddExcludedPair( Body( a ), Body( b ), filter );
+                    excluded.insert( SortedPair( a, b ) );
+                }
+            }
+            Assert::AreEqual( uint32_t( excluded.size() ), filter.excluded_pair_count );
+
+            std::vector<BodyAndOrientationPair> pairs( 10001 );
+            for( auto & pair : pairs )
+            {
+                pair.body1 = Body( body( generator ) );
+                pair.body2 = Body( body( generator ) );
+            }
+
+            std::vector<BodyAndOrientationPair> expected;
+            for( auto const & pair : pairs )
+            {
+                auto const is_excluded = excluded.count( SortedPair( pair.body1.index, pair.body2.index ) ) > 0;
+                Assert::AreEqual( is_excluded, IsExcludedPair( pair.body1, pair.body2, filter ) );
+                if( CanCollide( pair.body1, pair.body2, filter ) )
+                {
+                    expected.push_back( pair );
+                }
+            }
+
+            auto const size = Filter( filter, CreateRange( pairs ) );
+            Assert::AreEqual( expected.size(), size );
+            for( auto i = 0u; i < size; ++i )
+            {
+                Assert::IsTrue( expected[i].body1 == pairs[i].body1 );
+                Assert::IsTrue( expected[i].body2 == pairs[i].body2 );
+            }
+        }
+    };
+}
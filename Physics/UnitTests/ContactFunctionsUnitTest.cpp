@@ -47,7 +47,9 @@ namespace DogDealerPhysicsUnitTests
                     { { 0, -1, 0 }, -.5 }
             } };
 
-            auto clipped_vertices = SutherlandHodgman( planes, vertices );
+            array<Float3, c_max_clipped_vertex_count> clipped_vertex_storage;
+            auto const clipped_count = SutherlandHodgman( planes, vertices, clipped_vertex_storage );
+            vector<Float3> clipped_vertices( begin( clipped_vertex_storage ), begin( clipped_vertex_storage ) + clipped_count );
 
             vector<Float3> expected_output = { {
                 { 0.5, 0.5, 0 },
@@ -0,0 +1,59 @@
+#include "CppUnitTest.h"
+
+#include <Physics\ContinuousCollision.h>
+#include <Physics\RayCasting.h>
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Physics;
+
+namespace DogDealerPhysicsUnitTests
+{
+    TEST_CLASS(ContinuousCollisionUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestSweepStopsFastBodyAtThinWall)
+        {
+            // a small box that moves through a thin wall in a single step
+            BoundingShapes::AxisAlignedBox const local_bounds = { { 0, 0, 0 }, { 0.1f, 0.1f, 0.1f } };
+            BoundingShapes::AxisAlignedBox const wall = { { 0, 0, 0 }, { 0.05f, 10, 10 } };
+            Orientation const previous = { { -5, 0, 0 }, Math::Identity() };
+            Orientation const current = { { 5, 0, 0 }, Math::Identity() };
+
+            Sweep sweep;
+            Assert::IsTrue( CreateSweep( previous, current, local_bounds, sweep ) );
+            Assert::AreEqual( 10.f, sweep.length, 1e-5f );
+
+            auto const time = IntersectionTime( sweep.path, wall );
+            Assert::IsTrue( time > 0 && time < sweep.length );
+
+            // the body ends up in front of the wall, overlapping it slightly so the next step finds the contact
+            auto const clamped = ClampToImpact( sweep, time, current );
+            Assert::IsTrue( clamped.position.x < -0.05f );
+            Assert::IsTrue( clamped.position.x + local_bounds.extent.x > -0.05f );
+
+            Movement const movement = { { 20, 1, 0 }, { 0, 0, 0 } };
+            auto const stopped = RemoveImpactMomentum( movement, { -1, 0, 0 } );
+            Assert::AreEqual( 0.f, stopped.momentum.x, 1e-5f );
+            Assert::AreEqual( 1.f, stopped.momentum.y, 1e-5f );
+
+            // moving away from the surface keeps the momentum
+            auto const leaving = RemoveImpactMomentum( movement, { 1, 0, 0 } );
+            Assert::AreEqual( 20.f, leaving.momentum.x, 1e-5f );
+        }
+
+
+        TEST_METHOD(TestSlowBodiesAreNotSwept)
+        {
+            BoundingShapes::AxisAlignedBox const local_bounds = { { 0, 0, 0 }, { 0.5f, 1, 1 } };
+            Orientation const previous = { { 0, 0, 0 }, Math::Identity() };
+            Orientation const current = { { 0.4f, 0, 0 }, Math::Identity() };
+            Sweep sweep;
+            Assert::IsFalse( CreateSweep( previous, current, local_bounds, sweep ) );
+            Assert::IsFalse( CreateSweep( previous, previous, local_bounds, sweep ) );
+        }
+    };
+}
@@ -0,0 +1,304 @@
+#include "CppUnitTest.h"
+
+#include <Physics\BroadPhase.h>
+#include <Physics\ElementContainer.h>
+#include <Physics\BodyEntityMapping.h>
+#include <Physics\BodyEntityMappingFunctions.h>
+
+#include <BoundingShapes\AxisAlignedBox.h>
+#include <BoundingShapes\AxisAlignedBoxHierarchyFunctions.h>
+#include <Math\MathFunctions.h>
+#include <Utilities\InvalidIndex.h>
+#include <Utilities\UnitTest\CreateHandle.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Physics;
+
+namespace DogDealerPhysicsUnitTests
+{
+    namespace
+    {
+        enum struct BodyKind
+        {
+            Static,
+            Kinematic,
+            Rigid,
+        };
+
+
+        template<typename Target>
+        void AddBody( BodyID body_id, BodyKind kind, Target & target )
+        {
+            Orientation orientation = { Math::Float3( float( body_id.index ), 0, 0 ), Math::Identity() };
+            BoundingShapes::AxisAlignedBox box = { 0, 1 };
+            switch( kind )
+            {
+            case BodyKind::Static:
+                AddStaticComponent( body_id, orientation, box, 0.5f, 0.5f, target );
+                break;
+            case BodyKind::Kinematic:
+                AddKinematicComponent( body_id, orientation, box, 0.5f, 0.5f, target );
+                break;
+            case BodyKind::Rigid:
+                Movement movement = { Math::Float3( float( body_id.index ) ), 0 };
+                AddRigidBodyComponent( body_id, orientation, Math::Float3( 0 ), movement, Inertia(), box, 0.5f, 0.5f, target );
+                break;
+            }
+        }
+
+
+        BodyKind Kind( BodyID body_id, ElementContainer const & container )
+        {
+            return IsStaticBody( body_id, container ) ? BodyKind::Static : IsKinematicBody( body_id, container ) ? BodyKind::Kinematic : BodyKind::Rigid;
+        }
+
+
+        // checks that every body is in the partition of its kind and can be found through the mapping with its own data
+        void AssertConsistent( std::map<uint32_t, BodyKind> const & bodies, ElementContainer const & container )
+        {
+            Assert::AreEqual( uint32_t( bodies.size() ), TotalBodyCount( container ) );
+            Assert::AreEqual( TotalBodyCount( container ), TotalBodyCount( container.offsets ) );
+            for( auto const & body : bodies )
+            {
+                auto body_id = CreateHandle<BodyID>( body.first );
+                auto element = container.storage.body_to_element[body.first];
+                Assert::IsTrue( container.pointers.body_ids[element] == body_id );
+                Assert::IsTrue( Kind( body_id, container ) == body.second );
+                Assert::AreEqual( float( body.first ), container.pointers.orientations[element].position.x );
+                if( body.second == BodyKind::Rigid )
+                {
+                    Assert::AreEqual( float( body.first ), container.pointers.movements[element].momentum.x );
+                }
+            }
+        }
+    }
+
+
+    TEST_CLASS(ElementContainerUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestBatchedBodiesMatchSingleBodies)
+        {
+            ElementContainer single, batched;
+            ElementBatch batch;
+            std::map<uint32_t, BodyKind> bodies;
+            // the first bodies are added one at a time to both, so the batch is merged into a filled container
+            for( auto i = 0u; i < 60; ++i )
+            {
+                // scatter the body id indices, so the body to element mapping has gaps
+                auto body_id = CreateHandle<BodyID>( ( i * 37 ) % 101 );
+                auto kind = BodyKind( i % 3 );
+                bodies[body_id.index] = kind;
+                AddBody( body_id, kind, single );
+                if( i < 20 )
+                {
+                    AddBody( body_id, kind, batched );
+                }
+                else
+                {
+                    AddBody( body_id, kind, batch );
+                }
+            }
+            Assert::AreEqual( 40u, BatchedBodyCount( batch ) );
+            AddBodies( batch, batched );
+            Assert::AreEqual( 0u, BatchedBodyCount( batch ) );
+
+            Assert::AreEqual( single.offsets.static_body_end_index, batched.offsets.static_body_end_index );
+            Assert::AreEqual( single.offsets.kinematic_body_end_index, batched.offsets.kinematic_body_end_index );
+            Assert::AreEqual( single.offsets.rigid_body_end_index, batched.offsets.rigid_body_end_index );
+            // the order within the partitions depends on the order of adding, so only compare each body
+            AssertConsistent( bodies, single );
+            AssertConsistent( bodies, batched );
+        }
+
+
+        TEST_METHOD(TestSwapAndPopKeepsTheMappingConsistent)
+        {
+            std::mt19937 generator( 1234 );
+            std::uniform_int_distribution<uint32_t> body_index( 0, 299 );
+            std::uniform_int_distribution<uint32_t> kind( 0, 2 );
+
+            ElementContainer container;
+            std::map<uint32_t, BodyKind> bodies;
+            for( auto i = 0u; i < 5000; ++i )
+            {
+                auto body_id = CreateHandle<BodyID>( body_index( generator ) );
+                if( bodies.count( body_id.index ) )
+                {
+                    RemoveBodies( CreateRange( &body_id, 1 ), container );
+                    bodies.erase( body_id.index );
+                    Assert::AreEqual( c_invalid_index, container.storage.body_to_element[body_id.index] );
+                }
+                else
+                {
+                    auto body_kind = BodyKind( kind( generator ) );
+                    AddBody( body_id, body_kind, container );
+                    bodies[body_id.index] = body_kind;
+                }
+                if( i % 50 == 0 )
+                {
+                    AssertConsistent( bodies, container );
+                }
+            }
+            AssertConsistent( bodies, container );
+
+            // removing many at once, including bodies that aren't there
+            std::vector<BodyID> removed;
+            for( auto i = 0u; i < 300; i += 2 ) removed.push_back( CreateHandle<BodyID>( i ) );
+            RemoveBodies( CreateRange( removed ), container );
+            for( auto i = 0u; i < 300; i += 2 ) bodies.erase( i );
+            AssertConsistent( bodies, container );
+
+            // the rigid body storage doesn't keep growing when bodies move in front of the rigid bodies
+            auto rigid = CreateHandle<BodyID>( 1000 );
+            AddBody( rigid, BodyKind::Rigid, container );
+            bodies[rigid.index] = BodyKind::Rigid;
+            for( auto i = 0u; i < 2000; ++i )
+            {
+                auto body_id = CreateHandle<BodyID>( 2000 + i );
+                AddBody( body_id, BodyKind::Static, container );
+                bodies[body_id.index] = BodyKind::Static;
+            }
+            AssertConsistent( bodies, container );
+            auto rigid_count = RigidBodyEnd( container.offsets ) - RigidBodyStart( container.offsets );
+            Assert::IsTrue( container.storage.rigid_body.movements.size() <= 3 * std::max( rigid_count, 64u ) );
+        }
+
+
+        TEST_METHOD(TestRemovingStaticBodiesWithoutKinematicBodies)
+        {
+            // with an empty kinematic partition the hole left by a static body is filled directly by the last rigid body
+            ElementContainer container;
+            std::map<uint32_t, BodyKind> bodies;
+            for( auto index : { 2u, 1u, 5u } )
+            {
+                AddBody( CreateHandle<BodyID>( index ), BodyKind::Static, container );
+                bodies[index] = BodyKind::Static;
+            }
+            for( auto index : { 10u, 11u } )
+            {
+                AddBody( CreateHandle<BodyID>( index ), BodyKind::Rigid, container );
+                bodies[index] = BodyKind::Rigid;
+            }
+            for( auto index : { 2u, 5u, 1u } )
+            {
+                auto body_id = CreateHandle<BodyID>( index );
+                RemoveBodies( CreateRange( &body_id, 1 ), container );
+                bodies.erase( index );
+                AssertConsistent( bodies, container );
+            }
+
+            // and without rigid bodies the last static body just moves into the hole
+            for( auto index : { 3u, 4u, 6u } )
+            {
+                AddBody( CreateHandle<BodyID>( index ), BodyKind::Static, container );
+                bodies[index] = BodyKind::Static;
+            }
+            for( auto index : { 10u, 11u, 3u } )
+            {
+                auto body_id = CreateHandle<BodyID>( index );
+                RemoveBodies( CreateRange( &body_id, 1 ), container );
+                bodies.erase( index );
+                AssertConsistent( bodies, container );
+            }
+        }
+
+
+        TEST_METHOD(TestBatchedBodyEntityMappingMatchesSingleAdds)
+        {
+            BodyEntityMapping single, batched;
+            std::vector<EntityID> entities;
+            std::vector<BodyID> bodies;
+            for( auto i = 0u; i < 50; ++i )
+            {
+                // some entities get multiple bodies, not necessarily after each other
+                EntityID entity = { EntityID::index_t( ( i * 7 ) % 23 ), 0 };
+                auto body = CreateHandle<BodyID>( i );
+                Add( entity, body, single );
+                if( i < 10 )
+                {
+                    Add( entity, body, batched );
+                }
+                else
+                {
+                    entities.push_back( entity );
+                    bodies.push_back( body );
+                }
+            }
+            Add( entities, bodies, batched );
+
+            Assert::IsTrue( single.entity_ids == batched.entity_ids );
+            Assert::IsTrue( single.entity_to_bodies == batched.entity_to_bodies );
+            Assert::IsTrue( single.entity_bodies == batched.entity_bodies );
+        }
+
+
+        TEST_METHOD(TestStaticHierarchyIsOnlyRebuiltAfterStaticChanges)
+        {
+            ElementContainer container;
+            for( auto i = 0u; i < 30; ++i )
+            {
+                AddBody( CreateHandle<BodyID>( i ), BodyKind( i % 3 ), container );
+            }
+            UpdateBroadBoundsHierarchies( container );
+            Assert::IsFalse( container.broad_bounds_hierarchies.static_bodies_changed );
+            auto const static_nodes = container.broad_bounds_hierarchies.static_bodies.nodes.size();
+            Assert::IsTrue( static_nodes > 0 );
+
+            AddBody( CreateHandle<BodyID>( 30 ), BodyKind::Rigid, container );
+            auto kinematic = CreateHandle<BodyID>( 1 );
+            RemoveBodies( CreateRange( &kinematic, 1 ), container );
+            Assert::IsFalse( container.broad_bounds_hierarchies.static_bodies_changed );
+
+            std::vector<BodyID> static_bodies;
+            for( auto i = 0u; i < 30; i += 3 ) static_bodies.push_back( CreateHandle<BodyID>( i ) );
+            RemoveBodies( CreateRange( static_bodies.data(), 5 ), container );
+            Assert::IsTrue( container.broad_bounds_hierarchies.static_bodies_changed );
+            UpdateBroadBoundsHierarchies( container );
+            Assert::IsTrue( container.broad_bounds_hierarchies.static_bodies.nodes.size() < static_nodes );
+
+            // no static bodies left, so nothing of the old hierarchy may remain
+            RemoveBodies( CreateRange( static_bodies.data() + 5, static_bodies.data() + static_bodies.size() ), container );
+            UpdateBroadBoundsHierarchies( container );
+            Assert::IsTrue( container.broad_bounds_hierarchies.static_bodies.nodes.empty() );
+        }
+
+
+        TEST_METHOD(TestSplitBroadPhaseFindsTheSamePairs)
+        {
+            ElementContainer container;
+            for( auto i = 0u; i < 90; ++i )
+            {
+                AddBody( CreateHandle<BodyID>( ( i * 37 ) % 101 ), BodyKind( i % 3 ), container );
+            }
+            UpdateBroadBoundsHierarchies( container );
+
+            auto boxes = CreateAllBodyDataRange( container.offsets, container.pointers.transformed_broad_bounds );
+            auto orientations = CreateAllBodyDataRange( container.offsets, container.pointers.orientations );
+            auto body_ids = CreateAllBodyDataRange( container.offsets, container.pointers.body_ids );
+            auto static_count = StaticBodyEnd( container.offsets );
+
+            std::vector<std::pair<uint32_t, uint32_t>> index_pairs;
+            std::vector<BodyAndOrientationPair> single_pairs, split_pairs;
+            auto single_hierarchy = BoundingShapes::CreateAxisAlignedBoxHierarchy( boxes );
+            BroadPhaseCollisionDetection( boxes, single_hierarchy, orientations, body_ids, static_count, index_pairs, single_pairs );
+            BroadPhaseCollisionDetection( boxes, container.broad_bounds_hierarchies.static_bodies, container.broad_bounds_hierarchies.dynamic_bodies, orientations, body_ids, static_count, index_pairs, split_pairs );
+
+            auto to_indices = []( std::vector<BodyAndOrientationPair> const & pairs )
+            {
+                std::vector<std::pair<uint32_t, uint32_t>> indices;
+                for( auto const & pair : pairs ) indices.emplace_back( pair.body1.index, pair.body2.index );
+                std::sort( begin( indices ), end( indices ) );
+                return indices;
+            };
+            Assert::IsFalse( single_pairs.empty() );
+            Assert::IsTrue( to_indices( single_pairs ) == to_indices( split_pairs ) );
+        }
+    };
+}
@@ -38,6 +38,8 @@ namespace Physics
             world_config.constraint_solver_type = ConstraintSolverType(0);
             world_config.solve_parallel = true;
             world_config.minimal_island_size = 32;
+            world_config.stiff_island_iteration_factor = 1;
+            world_config.stiff_island_angular_step = 0.25f;
             world_config.warm_start_factor = 0.75f;
             world_config.solver_relaxation_factor = {1.f, 1.f};
             Physics::WorldRotationConstraints rotation_constraints;
@@ -131,6 +133,8 @@ namespace Physics
             world_config.constraint_solver_type = ConstraintSolverType(0);
             world_config.solve_parallel = true;
             world_config.minimal_island_size = 32;
+            world_config.stiff_island_iteration_factor = 1;
+            world_config.stiff_island_angular_step = 0.25f;
             world_config.warm_start_factor = 0.75f;
             world_config.solver_relaxation_factor = {1.f, 1.f};
             Physics::WorldRotationConstraints rotation_constraints;
@@ -221,6 +225,8 @@ namespace Physics
             world_config.constraint_solver_type = ConstraintSolverType(0);
             world_config.solve_parallel = true;
             world_config.minimal_island_size = 32;
+            world_config.stiff_island_iteration_factor = 1;
+            world_config.stiff_island_angular_step = 0.25f;
             world_config.warm_start_factor = 0.75f;
             world_config.solver_relaxation_factor = {1.f, 1.f};
             Physics::WorldRotationConstraints rotation_constraints;
@@ -313,6 +319,8 @@ namespace Physics
             world_config.constraint_solver_type = ConstraintSolverType(0);
             world_config.solve_parallel = true;
             world_config.minimal_island_size = 32;
+            world_config.stiff_island_iteration_factor = 1;
+            world_config.stiff_island_angular_step = 0.25f;
             world_config.warm_start_factor = 0.75f;
             world_config.solver_relaxation_factor = {1.f, 1.f};
             Physics::WorldRotationConstraints rotation_constraints;
@@ -404,6 +412,8 @@ namespace Physics
             world_config.constraint_solver_type = ConstraintSolverType(0);
             world_config.solve_parallel = true;
             world_config.minimal_island_size = 32;
+            world_config.stiff_island_iteration_factor = 1;
+            world_config.stiff_island_angular_step = 0.25f;
             world_config.warm_start_factor = 0.750000000f;
             world_config.solver_relaxation_factor = {1.00000000f, 1.50000000f};
             Physics::WorldRotationConstraints rotation_constraints;
@@ -494,6 +504,8 @@ namespace Physics
             world_config.constraint_solver_type = ConstraintSolverType(0);
             world_config.solve_parallel = true;
             world_config.minimal_island_size = 32;
+            world_config.stiff_island_iteration_factor = 1;
+            world_config.stiff_island_angular_step = 0.25f;
             world_config.warm_start_factor = 0.750000000f;
             world_config.solver_relaxation_factor = {1.00000000f, 1.50000000f};
             Physics::WorldRotationConstraints rotation_constraints;
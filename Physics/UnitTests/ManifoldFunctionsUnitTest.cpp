@@ -9,8 +9,17 @@
 
 #include <Physics\ManifoldFunctions.h>
 
+#include <BoundingShapes\AxisAlignedBoxHierarchyMeshFunctions.h>
+#include <BoundingShapes\BoundingShapeHierarchyMeshFunctions.h>
+#include <BoundingShapes\IntersectionTests.h>
+#include <BoundingShapes\TriangleFunctions.h>
+
 #include <Utilities\UnitTest\ToString.h>
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace std;
 using namespace Math;
@@ -301,5 +310,142 @@ namespace DogDealerPhysicsUnitTests
                 Assert::IsTrue(manifold.penetration_depths[i] >= 0);
             }
         }
+
+
+        TEST_METHOD(ManifoldTestBoxMeshMatchesTriangles)
+        {
+            // bumpy terrain
+            auto const size = 16u;
+            std::vector<Math::Float3> positions;
+            std::vector<unsigned> indices;
+            for( auto z = 0u; z <= size; ++z )
+            {
+                for( auto x = 0u; x <= size; ++x )
+                {
+                    positions.push_back( { float( x ), std::sin( 0.7f * x ) * std::cos( 0.5f * z ), float( z ) } );
+                }
+            }
+            for( auto z = 0u; z < size; ++z )
+            {
+                for( auto x = 0u; x < size; ++x )
+                {
+                    auto const corner = z * ( size + 1 ) + x;
+                    indices.insert( indices.end(), { corner, corner + size + 1, corner + 1 } );
+                    indices.insert( indices.end(), { corner + 1, corner + size + 1, corner + size + 2 } );
+                }
+            }
+            auto const mesh = BoundingShapes::CreateAxisAlignedBoxHierarchyMesh( positions, indices );
+
+            std::mt19937 generator( 7 );
+            std::uniform_real_distribution<float> position( 0.f, float( size ) );
+            std::uniform_real_distribution<float> height( -1.5f, 1.5f );
+            std::uniform_real_distribution<float> extent( 0.1f, 3.f );
+            std::uniform_real_distribution<float> angle( -3.f, 3.f );
+            auto hits = 0u;
+            for( auto i = 0u; i < 200; ++i )
+            {
+                BoundingShapes::OrientedBox box;
+                box.center = { position( generator ), height( generator ), position( generator ) };
+                box.extent = { extent( generator ), extent( generator ), extent( generator ) };
+                box.rotation = EulerToQuaternion( { angle( generator ), angle( generator ), angle( generator ) } );
+
+                // test every triangle that is reached on its own
+                auto expected_depth = 0.f;
+                auto expected_hit = false;
+                Traverse( mesh,
+                    [&box]( BoundingShapes::AxisAlignedBox const & node_box )
+                    {
+                        return Intersect( box, node_box );
+                    },
+                    [&]( std::array<uint32_t, 3> const & triangle_indices )
+                    {
+                        auto const triangle = BoundingShapes::CreateTriangle( mesh.vertex_positions[triangle_indices[0]], mesh.vertex_positions[triangle_indices[1]], mesh.vertex_positions[triangle_indices[2]] );
+                        auto const triangle_manifold = CreateManifold( box, triangle );
+                        for( auto p = 0u; p < triangle_manifold.contact_point_count; ++p )
+                        {
+                            expected_hit = true;
+                            expected_depth = std::max( expected_depth, triangle_manifold.penetration_depths[p] );
+                        }
+                        return true;
+                    } );
+
+                auto const manifold = CreateManifold( box, mesh );
+                Assert::AreEqual( expected_hit, manifold.contact_point_count > 0 );
+                Assert::IsTrue( manifold.contact_point_count <= Manifold::c_max_contact_points );
+                if( expected_hit )
+                {
+                    ++hits;
+                    auto const depth = *std::max_element( manifold.penetration_depths.begin(), manifold.penetration_depths.begin() + manifold.contact_point_count );
+                    Assert::AreEqual( expected_depth, depth, 1e-5f );
+                }
+            }
+            // make sure both cases are tested
+            Assert::IsTrue( hits > 0 && hits < 200 );
+        }
+
+
+        TEST_METHOD(ManifoldTestSphereMesh)
+        {
+            // two triangles making a square floor at height 0, with the front faces up
+            std::vector<Math::Float3> positions = { { 0, 0, 0 }, { 0, 0, 2 }, { 2, 0, 0 }, { 2, 0, 2 } };
+            std::vector<unsigned> indices = { 0, 1, 2, 2, 1, 3 };
+            auto const mesh = BoundingShapes::CreateAxisAlignedBoxHierarchyMesh( positions, indices );
+
+            auto const manifold = CreateManifold( BoundingShapes::Sphere{ { 1, 0.4f, 1 }, 0.5f }, mesh );
+            Assert::IsTrue( manifold.contact_point_count > 0 );
+            for( auto i = 0u; i < manifold.contact_point_count; ++i )
+            {
+                Assert::AreEqual( 0.1f, manifold.penetration_depths[i], 1e-5f );
+                Assert::IsTrue( Math::Equal( manifold.separation_axes[i], Math::Float3( 0, 1, 0 ), 1e-5f ) );
+            }
+
+            auto const center_on_floor = CreateManifold( BoundingShapes::Sphere{ { 0.5f, 0, 0.5f }, 0.5f }, mesh );
+            Assert::AreEqual( 0.5f, center_on_floor.penetration_depths[0], 1e-5f );
+            Assert::IsTrue( Math::Equal( center_on_floor.separation_axes[0], Math::Float3( 0, 1, 0 ), 1e-5f ) );
+
+            Assert::AreEqual( uint8_t( 0 ), CreateManifold( BoundingShapes::Sphere{ { 1, 0.6f, 1 }, 0.5f }, mesh ).contact_point_count );
+        }
+
+
+        TEST_METHOD(ManifoldTestCapsuleRestsOnBothEnds)
+        {
+            BoundingShapes::OrientedBox box;
+            box.center = { 0, -1, 0 };
+            box.extent = { 4, 1, 4 };
+            box.rotation = Math::Identity();
+
+            // lying on the box, both ends touch it
+            BoundingShapes::Capsule const capsule = { { -1, 0.4f, 0 }, { 1, 0.4f, 0 }, 0.5f };
+            auto const box_manifold = CreateManifold( capsule, box );
+            Assert::AreEqual( uint8_t( 2 ), box_manifold.contact_point_count );
+            for( auto i = 0u; i < box_manifold.contact_point_count; ++i )
+            {
+                Assert::AreEqual( 0.1f, box_manifold.penetration_depths[i], 1e-5f );
+                Assert::IsTrue( Math::Equal( box_manifold.separation_axes[i], Math::Float3( 0, 1, 0 ), 1e-5f ) );
+            }
+
+            // the same floor as a mesh
+            std::vector<Math::Float3> positions = { { -4, 0, -4 }, { -4, 0, 4 }, { 4, 0, -4 }, { 4, 0, 4 } };
+            std::vector<unsigned> indices = { 0, 1, 2, 2, 1, 3 };
+            auto const mesh = BoundingShapes::CreateAxisAlignedBoxHierarchyMesh( positions, indices );
+            auto const mesh_manifold = CreateManifold( capsule, mesh );
+            Assert::IsTrue( mesh_manifold.contact_point_count >= 2 );
+            for( auto i = 0u; i < mesh_manifold.contact_point_count; ++i )
+            {
+                Assert::AreEqual( 0.1f, mesh_manifold.penetration_depths[i], 1e-5f );
+            }
+
+            // standing upright on a sphere only the lower end touches
+            BoundingShapes::Capsule const standing = { { 0, 1.4f, 0 }, { 0, 3, 0 }, 0.5f };
+            auto const sphere_manifold = CreateManifold( standing, BoundingShapes::Sphere{ { 0, 0, 0 }, 1 } );
+            Assert::AreEqual( uint8_t( 1 ), sphere_manifold.contact_point_count );
+            Assert::AreEqual( 0.1f, sphere_manifold.penetration_depths[0], 1e-5f );
+
+            // two crossing capsules touch in the middle
+            auto const crossing = CreateManifold( capsule, BoundingShapes::Capsule{ { 0, 1.2f, -1 }, { 0, 1.2f, 1 }, 0.5f } );
+            Assert::AreEqual( uint8_t( 1 ), crossing.contact_point_count );
+            Assert::AreEqual( 0.2f, crossing.penetration_depths[0], 1e-5f );
+            Assert::IsTrue( Math::Equal( crossing.separation_axes[0], Math::Float3( 0, -1, 0 ), 1e-5f ) );
+        }
     };
 }
\ No newline at end of file
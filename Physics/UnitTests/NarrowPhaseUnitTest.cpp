@@ -0,0 +1,178 @@
+#include "CppUnitTest.h"
+
+#include <Physics\NarrowPhase.h>
+
+#include <BoundingShapes\Capsule.h>
+#include <BoundingShapes\OrientedBox.h>
+#include <BoundingShapes\Sphere.h>
+
+#include <Math\FloatOperators.h>
+
+#include <Utilities\InvalidIndex.h>
+
+#include <concrt.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Physics;
+
+namespace DogDealerPhysicsUnitTests
+{
+    namespace
+    {
+        // every body has a single sphere, box or capsule, in that order by body index
+        struct Shapes
+        {
+            std::vector<uint32_t> body_to_sphere_offset, sphere_offsets;
+            std::vector<BoundingShapes::Sphere> spheres;
+            std::vector<uint32_t> body_to_box_offset, box_offsets;
+            std::vector<BoundingShapes::OrientedBox> boxes;
+            std::vector<uint32_t> body_to_capsule_offset, capsule_offsets;
+            std::vector<BoundingShapes::Capsule> capsules;
+        };
+
+
+        Shapes CreateShapes( uint32_t body_count )
+        {
+            Shapes shapes;
+            shapes.sphere_offsets.push_back( 0 );
+            shapes.box_offsets.push_back( 0 );
+            shapes.capsule_offsets.push_back( 0 );
+            for( auto i = 0u; i < body_count; ++i )
+            {
+                shapes.body_to_sphere_offset.push_back( c_invalid_index );
+                shapes.body_to_box_offset.push_back( c_invalid_index );
+                shapes.body_to_capsule_offset.push_back( c_invalid_index );
+                if( i % 3 == 0 )
+                {
+                    shapes.body_to_sphere_offset.back() = uint32_t( shapes.spheres.size() );
+                    shapes.spheres.push_back( { { 0, 0, 0 }, 1 } );
+                    shapes.sphere_offsets.push_back( uint32_t( shapes.spheres.size() ) );
+                }
+                else if( i % 3 == 1 )
+                {
+                    shapes.body_to_box_offset.back() = uint32_t( shapes.boxes.size() );
+                    shapes.boxes.push_back( { { 0, 0, 0 }, { 1, 1, 1 }, Math::Identity() } );
+                    shapes.box_offsets.push_back( uint32_t( shapes.boxes.size() ) );
+                }
+                else
+                {
+                    shapes.body_to_capsule_offset.back() = uint32_t( shapes.capsules.size() );
+                    shapes.capsules.push_back( { { 0, 0, -0.5f }, { 0, 0, 0.5f }, 0.5f } );
+                    shapes.capsule_offsets.push_back( uint32_t( shapes.capsules.size() ) );
+                }
+            }
+            return shapes;
+        }
+
+
+        // random pairs of bodies close enough to each other that about half of them collide
+        std::vector<BodyAndOrientationPair> CreateRandomPairs( uint32_t body_count, uint32_t pair_count )
+        {
+            std::mt19937 generator( 1234 );
+            std::uniform_int_distribution<uint32_t> body( 0, body_count - 1 );
+            std::uniform_real_distribution<float> position( -2.f, 2.f );
+            std::vector<BodyAndOrientationPair> pairs( pair_count );
+            for( auto & pair : pairs )
+            {
+                pair.body1 = { body( generator ), 0 };
+                do
+                {
+                    pair.body2 = { body( generator ), 0 };
+                } while( pair.body2.index == pair.body1.index );
+                pair.orientation1 = { { position( generator ), position( generator ), position( generator ) }, Math::Identity() };
+                pair.orientation2 = { { position( generator ), position( generator ), position( generator ) }, Math::Identity() };
+            }
+            return pairs;
+        }
+
+
+        struct Collisions
+        {
+            std::vector<BodyPair> bodies;
+            std::vector<Math::Float3> relative_positions;
+            std::vector<Manifold> manifolds;
+        };
+
+
+        Collisions DetectCollisions( Shapes const & shapes, std::vector<BodyAndOrientationPair> pairs, std::vector<NarrowPhaseChunkOutput> & chunk_outputs )
+        {
+            std::vector<BodyAndOrientationPair> categorized_pairs;
+            Collisions collisions;
+            NarrowPhaseCollisionDetection(
+                shapes.body_to_sphere_offset, shapes.sphere_offsets, shapes.spheres,
+                shapes.body_to_box_offset, shapes.box_offsets, shapes.boxes,
+                shapes.body_to_capsule_offset, shapes.capsule_offsets, shapes.capsules,
+                {}, {}, {}, {},
+                CreateRange( pairs ),
+                categorized_pairs,
+                chunk_outputs,
+                collisions.bodies,
+                collisions.relative_positions,
+                collisions.manifolds );
+            return collisions;
+        }
+
+
+        bool BitwiseEqual( std::vector<Math::Float3> const & a, std::vector<Math::Float3> const & b )
+        {
+            return a.size() == b.size() && ( a.empty() || std::memcmp( a.data(), b.data(), a.size() * sizeof( Math::Float3 ) ) == 0 );
+        }
+
+
+        bool BitwiseEqual( std::vector<Manifold> const & a, std::vector<Manifold> const & b )
+        {
+            if( a.size() != b.size() ) return false;
+            for( auto i = 0u; i < a.size(); ++i )
+            {
+                if( a[i].contact_point_count != b[i].contact_point_count ) return false;
+                for( auto p = 0u; p < a[i].contact_point_count; ++p )
+                {
+                    if( std::memcmp( &a[i].positions[p], &b[i].positions[p], sizeof( Math::Float3 ) ) != 0 ) return false;
+                    if( std::memcmp( &a[i].separation_axes[p], &b[i].separation_axes[p], sizeof( Math::Float3 ) ) != 0 ) return false;
+                    if( std::memcmp( &a[i].penetration_depths[p], &b[i].penetration_depths[p], sizeof( float ) ) != 0 ) return false;
+                }
+            }
+            return true;
+        }
+    }
+
+
+    TEST_CLASS(NarrowPhaseUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestChunkedNarrowPhaseIsDeterministic)
+        {
+            auto const body_count = 200u;
+            auto const shapes = CreateShapes( body_count );
+            auto const pairs = CreateRandomPairs( body_count, 5000 );
+
+            std::vector<NarrowPhaseChunkOutput> chunk_outputs;
+            auto const first = DetectCollisions( shapes, pairs, chunk_outputs );
+            Assert::IsFalse( first.bodies.empty() );
+            Assert::IsTrue( first.bodies.size() < pairs.size() );
+
+            // reusing the chunk outputs of the previous run doesn't change anything
+            for( auto run = 0u; run < 4; ++run )
+            {
+                auto const again = DetectCollisions( shapes, pairs, chunk_outputs );
+                Assert::IsTrue( first.bodies == again.bodies );
+                Assert::IsTrue( BitwiseEqual( first.relative_positions, again.relative_positions ) );
+                Assert::IsTrue( BitwiseEqual( first.manifolds, again.manifolds ) );
+            }
+
+            // a scheduler with a single thread runs the chunks one after the other, the output has to be the same
+            std::vector<NarrowPhaseChunkOutput> serial_chunk_outputs;
+            Concurrency::CurrentScheduler::Create( Concurrency::SchedulerPolicy( 1, Concurrency::MaxConcurrency, 1 ) );
+            auto const serial = DetectCollisions( shapes, pairs, serial_chunk_outputs );
+            Concurrency::CurrentScheduler::Detach();
+            Assert::IsTrue( first.bodies == serial.bodies );
+            Assert::IsTrue( BitwiseEqual( first.relative_positions, serial.relative_positions ) );
+            Assert::IsTrue( BitwiseEqual( first.manifolds, serial.manifolds ) );
+        }
+    };
+}
@@ -0,0 +1,105 @@
+#include "CppUnitTest.h"
+
+#include <Physics\NonCollidingBodies.h>
+
+#include <Utilities\InvalidIndex.h>
+#include <Utilities\UnitTest\CreateHandle.h>
+
+#include <map>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Physics;
+
+namespace DogDealerPhysicsUnitTests
+{
+    namespace
+    {
+        Orientation CreateOrientation( uint32_t index )
+        {
+            return { Math::Float3( float( index ), 0, 0 ), Math::Identity() };
+        }
+
+
+        // the value is true for static entities
+        void AssertConsistent( std::map<uint32_t, bool> const & entities, NonCollidingBodies const & bodies )
+        {
+            Assert::AreEqual( entities.size(), bodies.entity_ids.size() );
+            Assert::AreEqual( entities.size(), bodies.orientations.size() );
+            for( auto const & entity : entities )
+            {
+                auto element = bodies.entity_to_element[entity.first];
+                Assert::IsTrue( element < bodies.entity_ids.size() );
+                Assert::IsTrue( bodies.entity_ids[element] == CreateHandle<EntityID>( entity.first ) );
+                Assert::AreEqual( entity.second, element < bodies.kinematic_body_start_index );
+                Assert::AreEqual( float( entity.first ), bodies.orientations[element].position.x );
+            }
+        }
+
+
+        void Remove( uint32_t index, std::map<uint32_t, bool> & entities, NonCollidingBodies & bodies )
+        {
+            auto entity_id = CreateHandle<EntityID>( index );
+            bodies.RemoveEntities( CreateRange( &entity_id, 1 ) );
+            entities.erase( index );
+            Assert::AreEqual( c_invalid_index, bodies.entity_to_element[index] );
+        }
+    }
+
+
+    TEST_CLASS(NonCollidingBodiesUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestRemovingStaticEntitiesWithoutKinematicEntities)
+        {
+            NonCollidingBodies bodies;
+            std::map<uint32_t, bool> entities;
+            for( auto index : { 2u, 1u, 10u } )
+            {
+                bodies.AddStaticComponent( CreateHandle<EntityID>( index ), CreateOrientation( index ) );
+                entities[index] = true;
+            }
+            Remove( 2, entities, bodies );
+            AssertConsistent( entities, bodies );
+            Remove( 10, entities, bodies );
+            AssertConsistent( entities, bodies );
+            Remove( 1, entities, bodies );
+            AssertConsistent( entities, bodies );
+        }
+
+
+        TEST_METHOD(TestSwapAndPopKeepsTheMappingConsistent)
+        {
+            std::mt19937 generator( 1234 );
+            std::uniform_int_distribution<uint32_t> entity_index( 0, 99 );
+            std::uniform_int_distribution<uint32_t> kind( 0, 3 );
+
+            NonCollidingBodies bodies;
+            std::map<uint32_t, bool> entities;
+            for( auto i = 0u; i < 3000; ++i )
+            {
+                auto index = entity_index( generator );
+                if( entities.count( index ) )
+                {
+                    Remove( index, entities, bodies );
+                }
+                else
+                {
+                    // mostly static, so the kinematic partition is often empty
+                    auto is_static = kind( generator ) != 0;
+                    if( is_static )
+                    {
+                        bodies.AddStaticComponent( CreateHandle<EntityID>( index ), CreateOrientation( index ) );
+                    }
+                    else
+                    {
+                        bodies.AddKinematicComponent( CreateHandle<EntityID>( index ), CreateOrientation( index ) );
+                    }
+                    entities[index] = is_static;
+                }
+                AssertConsistent( entities, bodies );
+            }
+        }
+    };
+}
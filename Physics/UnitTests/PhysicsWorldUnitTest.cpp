@@ -0,0 +1,143 @@
+#include "CppUnitTest.h"
+
+#include <Physics\PhysicsWorld.h>
+
+#include <BoundingShapes\Capsule.h>
+#include <BoundingShapes\FileLayout.h>
+#include <BoundingShapes\OrientedBox.h>
+#include <BoundingShapes\ShapeType.h>
+
+#include <Conventions\Force.h>
+#include <Conventions\RotationConstraints.h>
+#include <Conventions\VelocityConstraints.h>
+
+#include <Math\Identity.h>
+
+#include <Utilities\StreamHelpers.h>
+#include <Utilities\UnitTest\CreateHandle.h>
+
+#include <direct.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Physics;
+
+namespace DogDealerPhysicsUnitTests
+{
+    namespace
+    {
+        // writes a collision file with a single box, in the layout the resource converter writes
+        void WriteBoxCollisionFile( std::string const & name, Math::Float3 extent )
+        {
+            _mkdir( "Resources" );
+            std::ofstream stream( "Resources\\" + name + ".collision", std::ios::out | std::ios::binary );
+            CollisionMeshFileHeader header;
+            header.axis_aligned_box = { 0, extent };
+            header.number_of_shapes = 1;
+            WriteObject( stream, header );
+            WriteVector( stream, std::vector<BoundingShapes::ShapeType>( { BoundingShapes::ShapeType::OrientedBox } ) );
+            WriteObject( stream, BoundingShapes::OrientedBox( { 0, extent, Math::Identity() } ) );
+        }
+
+
+        // writes a collision file with a single capsule along the z axis, centered on the origin
+        void WriteCapsuleCollisionFile( std::string const & name, float half_length, float radius )
+        {
+            _mkdir( "Resources" );
+            std::ofstream stream( "Resources\\" + name + ".collision", std::ios::out | std::ios::binary );
+            CollisionMeshFileHeader header;
+            header.axis_aligned_box = { 0, { radius, radius, half_length + radius } };
+            header.number_of_shapes = 1;
+            WriteObject( stream, header );
+            WriteVector( stream, std::vector<BoundingShapes::ShapeType>( { BoundingShapes::ShapeType::Capsule } ) );
+            WriteObject( stream, BoundingShapes::Capsule( { { 0, 0, -half_length }, { 0, 0, half_length }, radius } ) );
+        }
+    }
+
+
+    TEST_CLASS( PhysicsWorldTest )
+    {
+    public:
+
+        TEST_METHOD( TestSteadyStateUpdateDoesNotAllocate )
+        {
+            WriteBoxCollisionFile( "physics_world_test_ground", { 20, 20, 1 } );
+            WriteBoxCollisionFile( "physics_world_test_box", { 0.5f, 0.5f, 0.5f } );
+
+            PhysicsWorld world;
+            world.BeginBodyBatch();
+            world.CreateStaticBodyComponent( CreateHandle<EntityID>( 0 ), "physics_world_test_ground", { { 0, 0, -1 }, Math::Identity() }, 0, 1 );
+            // a few stacks of boxes, so there are box-box and box-ground contacts
+            auto index = 1u;
+            for( auto x = 0; x < 3; ++x )
+            {
+                for( auto z = 0; z < 3; ++z )
+                {
+                    Orientation const orientation = { { 2.f * x, 0, 0.5f + 1.f * z }, Math::Identity() };
+                    world.CreateRigidBodyComponent( CreateHandle<EntityID>( index++ ), "physics_world_test_box", 1, orientation, { 0, 0 }, 0, 1, false );
+                }
+            }
+            world.EndBodyBatch();
+
+            EntityForces forces;
+            EntityTorques torques;
+            ::RotationConstraints rotation_constraints;
+            ::VelocityConstraints velocity_constraints;
+            ::AngularVelocityConstraints angular_velocity_constraints;
+            EntityPositions positions;
+            EntityRotations rotations;
+            auto const time_step = 1 / 60.f;
+            auto tick = [&]()
+            {
+                world.CalculateVelocities( time_step );
+                world.CopyCurrentToPrevious();
+                world.UpdateOrientations( positions, rotations );
+                world.UpdateBodies( forces, torques, rotation_constraints, velocity_constraints, angular_velocity_constraints, time_step );
+            };
+
+            // the scratch memory grows to the size of the workload during the first ticks
+            for( auto i = 0; i < 120; ++i )
+            {
+                tick();
+            }
+            for( auto i = 0; i < 60; ++i )
+            {
+                tick();
+                Assert::AreEqual( uint64_t( 0 ), world.GetLastUpdateAllocationCount() );
+            }
+        }
+
+
+        TEST_METHOD( TestCapsuleBodyRestsOnTheGround )
+        {
+            WriteBoxCollisionFile( "physics_world_test_ground", { 20, 20, 1 } );
+            WriteCapsuleCollisionFile( "physics_world_test_capsule", 0.5f, 0.5f );
+
+            PhysicsWorld world;
+            world.CreateStaticBodyComponent( CreateHandle<EntityID>( 0 ), "physics_world_test_ground", { { 0, 0, -1 }, Math::Identity() }, 0, 1 );
+            world.CreateRigidBodyComponent( CreateHandle<EntityID>( 1 ), "physics_world_test_capsule", 1, { { 0, 0, 3 }, Math::Identity() }, { 0, 0 }, 0, 1, true );
+
+            EntityForces forces;
+            EntityTorques torques;
+            ::RotationConstraints rotation_constraints;
+            ::VelocityConstraints velocity_constraints;
+            ::AngularVelocityConstraints angular_velocity_constraints;
+            EntityPositions positions;
+            EntityRotations rotations;
+            auto const time_step = 1 / 60.f;
+            for( auto i = 0; i < 180; ++i )
+            {
+                world.CalculateVelocities( time_step );
+                world.CopyCurrentToPrevious();
+                world.UpdateOrientations( positions, rotations );
+                world.UpdateBodies( forces, torques, rotation_constraints, velocity_constraints, angular_velocity_constraints, time_step );
+            }
+
+            // the lower cap touches the ground, the upper cap is hit by a ray from above
+            auto const top = world.CastRayOnEntity( { { 0, 0, 10 }, { 0, 0, -1 } }, CreateHandle<EntityID>( 1 ) );
+            Assert::AreEqual( 2.f, top.z, 0.1f );
+        }
+    };
+}
@@ -0,0 +1,354 @@
+#include "CppUnitTest.h"
+
+#include <Physics\RayCasting.h>
+
+#include <BoundingShapes\AxisAlignedBoxHierarchyMeshFunctions.h>
+#include <BoundingShapes\CapsuleFunctions.h>
+#include <BoundingShapes\RayFunctions.h>
+#include <BoundingShapes\RayPacketFunctions.h>
+
+#include <Math\FloatOperators.h>
+#include <Math\MathFunctions.h>
+#include <Math\SSE.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Physics;
+
+namespace DogDealerPhysicsUnitTests
+{
+    namespace
+    {
+        std::vector<BoundingShapes::Ray> CreateRandomRays( uint32_t count )
+        {
+            std::mt19937 generator( 1234 );
+            std::uniform_real_distribution<float> position( -10.f, 10.f );
+            std::vector<BoundingShapes::Ray> rays( count );
+            for( auto & ray : rays )
+            {
+                ray.start = { position( generator ), position( generator ), position( generator ) };
+                // aim roughly at the origin, so about half of the rays hit the shapes
+                Math::Float3 target = { position( generator ) * 0.3f, position( generator ) * 0.3f, position( generator ) * 0.3f };
+                ray.direction = Math::Normalize( target - ray.start );
+            }
+            return rays;
+        }
+
+
+        std::array<float, BoundingShapes::c_ray_packet_width> StoreTimes( RayPacketHits const & hits )
+        {
+            alignas( 16 ) std::array<float, BoundingShapes::c_ray_packet_width> times;
+            Math::SSE::Store( hits.times, times.data() );
+            return times;
+        }
+
+
+        // single triangle Möller–Trumbore, both sides count
+        float TriangleIntersectionTime( BoundingShapes::Ray const & ray, Math::Float3 a, Math::Float3 b, Math::Float3 c )
+        {
+            auto const edge1 = b - a;
+            auto const edge2 = c - a;
+            auto const p = Math::Cross( ray.direction, edge2 );
+            auto const determinant = Math::Dot( edge1, p );
+            auto const start = ray.start - a;
+            auto const u = Math::Dot( start, p ) / determinant;
+            auto const q = Math::Cross( start, edge1 );
+            auto const v = Math::Dot( ray.direction, q ) / determinant;
+            auto const time = Math::Dot( edge2, q ) / determinant;
+            if( std::abs( determinant ) > 1e-8f && u >= 0 && v >= 0 && u + v <= 1 && time >= 0 )
+            {
+                return time;
+            }
+            return std::numeric_limits<float>::infinity();
+        }
+
+
+        // positive inside the spheres, distance to the closest surface outside
+        DensityFunctionType CreateSpheresDensity( std::vector<BoundingShapes::Sphere> spheres, uint32_t & evaluations )
+        {
+            return [spheres, &evaluations]( Math::Float3 const position, float & density, Math::Float3 & gradient )
+            {
+                ++evaluations;
+                density = -std::numeric_limits<float>::infinity();
+                for( auto const & sphere : spheres )
+                {
+                    auto const offset = sphere.center - position;
+                    auto const sphere_density = sphere.radius - Math::Norm( offset );
+                    if( sphere_density > density )
+                    {
+                        density = sphere_density;
+                        gradient = Math::Normalize( offset );
+                    }
+                }
+            };
+        }
+
+
+        template<typename ShapeType>
+        void CompareWithSingleRays( ShapeType const & shape, std::vector<BoundingShapes::Ray> const & rays )
+        {
+            for( auto first = size_t( 0 ); first < rays.size(); first += BoundingShapes::c_ray_packet_width )
+            {
+                auto packet_rays = CreateRange( rays.data() + first, rays.data() + first + BoundingShapes::c_ray_packet_width );
+                auto packet = BoundingShapes::CreateRayPacket( packet_rays );
+                auto hits = CreateEmptyRayPacketHits();
+                IntersectCloser( packet, shape, hits );
+                auto times = StoreTimes( hits );
+                for( auto lane = 0u; lane < BoundingShapes::c_ray_packet_width; ++lane )
+                {
+                    auto const expected = IntersectionTime( packet_rays[lane], shape );
+                    if( std::isinf( expected ) )
+                    {
+                        Assert::IsTrue( std::isinf( times[lane] ) );
+                    }
+                    else
+                    {
+                        Assert::AreEqual( expected, times[lane], 1e-2f );
+                    }
+                }
+            }
+        }
+    }
+
+
+    TEST_CLASS( RayCastingUnitTest )
+    {
+    public:
+
+        TEST_METHOD( TestPacketOrientedBoxMatchesSingleRays )
+        {
+            BoundingShapes::OrientedBox box = { { 1, -1, 0.5f }, { 2, 1, 3 }, Math::Normalize( Math::Quaternion{ 0.3f, 0.2f, -0.1f, 0.9f } ) };
+            CompareWithSingleRays( box, CreateRandomRays( 256 ) );
+        }
+
+
+        TEST_METHOD( TestPacketSphereMatchesSingleRays )
+        {
+            BoundingShapes::Sphere sphere = { { 1, -1, 0.5f }, 2.5f };
+            CompareWithSingleRays( sphere, CreateRandomRays( 256 ) );
+        }
+
+
+        TEST_METHOD( TestSingleRaysDontHitBehindTheStart )
+        {
+            BoundingShapes::OrientedBox const box = { { 0, 0, 0 }, { 1, 1, 1 }, Math::Normalize( Math::Quaternion{ 0.3f, 0.2f, -0.1f, 0.9f } ) };
+            BoundingShapes::Sphere const sphere = { { 0, 0, 0 }, 1 };
+            BoundingShapes::Ray const away = { { 5, 0, 0 }, { 1, 0, 0 } };
+            BoundingShapes::Ray const inside = { { 0.1f, 0, 0 }, { 1, 0, 0 } };
+            BoundingShapes::Ray const towards = { { -5, 0, 0 }, { 1, 0, 0 } };
+
+            Assert::IsTrue( std::isinf( IntersectionTime( away, box ) ) );
+            Assert::IsTrue( std::isinf( IntersectionTime( away, sphere ) ) );
+            Assert::AreEqual( 0.f, IntersectionTime( inside, box ) );
+            Assert::AreEqual( 0.f, IntersectionTime( inside, sphere ) );
+            Assert::AreEqual( 4.f, IntersectionTime( towards, sphere ), 1e-5f );
+            Assert::IsTrue( IntersectionTime( towards, box ) > 3.f );
+
+            // the closest of several shapes ignores the ones behind the start
+            std::vector<BoundingShapes::Sphere> const spheres = { { { -10, 0, 0 }, 1 }, { { 10, 0, 0 }, 1 } };
+            BoundingShapes::Ray const between = { { 0, 0, 0 }, { 1, 0, 0 } };
+            Assert::AreEqual( 9.f, IntersectionTime( between, CreateRange( spheres ) ), 1e-5f );
+        }
+
+
+        TEST_METHOD( TestCapsuleHitsAreOnTheSurface )
+        {
+            BoundingShapes::Capsule const capsule = { { -2, 1, 0 }, { 1, -1, 2 }, 1.5f };
+            auto distance_to_axis = [&capsule]( Math::Float3 point )
+            {
+                return Math::Norm( point - GetAxisPoint( capsule, ClosestAxisParameter( capsule, point ) ) );
+            };
+            auto hit_count = 0u;
+            for( auto const & ray : CreateRandomRays( 256 ) )
+            {
+                auto const time = IntersectionTime( ray, capsule );
+                if( std::isinf( time ) )
+                {
+                    // a miss never gets inside
+                    for( auto t = 0.f; t < 40.f; t += 0.01f )
+                    {
+                        Assert::IsTrue( distance_to_axis( PointAlongRay( ray, t ) ) > capsule.radius - 1e-3f );
+                    }
+                    continue;
+                }
+                ++hit_count;
+                Assert::IsTrue( time >= 0 );
+                if( time > 0 )
+                {
+                    Assert::AreEqual( capsule.radius, distance_to_axis( PointAlongRay( ray, time ) ), 1e-3f );
+                    // nothing is hit earlier
+                    for( auto t = 0.f; t < time - 1e-3f; t += 0.01f )
+                    {
+                        Assert::IsTrue( distance_to_axis( PointAlongRay( ray, t ) ) > capsule.radius - 1e-3f );
+                    }
+                }
+            }
+            Assert::IsTrue( hit_count > 0 );
+
+            // the cylinder between the caps is hit, parallel rays only hit the caps
+            BoundingShapes::Capsule const upright = { { 0, 0, -1 }, { 0, 0, 1 }, 1 };
+            Assert::AreEqual( 4.f, IntersectionTime( { { -5, 0, 0.5f }, { 1, 0, 0 } }, upright ), 1e-5f );
+            Assert::AreEqual( 3.f, IntersectionTime( { { 0, 0, -5 }, { 0, 0, 1 } }, upright ), 1e-5f );
+            Assert::AreEqual( 0.f, IntersectionTime( { { 0.5f, 0, 0.5f }, { 1, 0, 0 } }, upright ) );
+        }
+
+
+        TEST_METHOD( TestPacketHitNormalsFaceTheRays )
+        {
+            BoundingShapes::OrientedBox box = { { 0, 0, 0 }, { 1, 1, 1 }, Math::Quaternion{ 0, 0, 0, 1 } };
+            std::array<BoundingShapes::Ray, 3> rays = { {
+                { { -5, 0, 0 }, { 1, 0, 0 } },
+                { { 0, 0, 5 }, { 0, 0, -1 } },
+                { { 0, 0, 0 }, { 0, 1, 0 } },
+            } };
+            auto packet = BoundingShapes::CreateRayPacket( rays );
+            auto hits = CreateEmptyRayPacketHits();
+            Assert::AreEqual( 7u, IntersectCloser( packet, box, hits ) );
+
+            alignas( 16 ) std::array<float, BoundingShapes::c_ray_packet_width> x, y, z;
+            Math::SSE::Store( hits.normal_x, x.data() );
+            Math::SSE::Store( hits.normal_y, y.data() );
+            Math::SSE::Store( hits.normal_z, z.data() );
+            auto times = StoreTimes( hits );
+            Assert::AreEqual( 4.f, times[0], 1e-5f );
+            Assert::AreEqual( -1.f, x[0], 1e-5f );
+            Assert::AreEqual( 4.f, times[1], 1e-5f );
+            Assert::AreEqual( 1.f, z[1], 1e-5f );
+            // starting inside hits at the start, against the ray direction
+            Assert::AreEqual( 0.f, times[2] );
+            Assert::AreEqual( -1.f, y[2], 1e-5f );
+
+            // a farther shape doesn't replace the hits
+            BoundingShapes::Sphere sphere = { { 3, 0, 0 }, 0.5f };
+            Assert::AreEqual( 0u, IntersectCloser( packet, sphere, hits ) );
+        }
+
+
+        TEST_METHOD( TestDensityRayMarchFindsTheFirstSurface )
+        {
+            // a small sphere in front of a large one, a gradient step from the start would jump towards the large one
+            uint32_t evaluations = 0;
+            auto const density = CreateSpheresDensity( { { { 0, 0, 0 }, 0.5f }, { { 20, 0, 0 }, 10 } }, evaluations );
+            DensityRayMarchSettings const settings = { 1, 100, 256, 1e-4f };
+            // the defaults of the physics world
+            DensityRayMarchSettings const default_settings = { 1, 1000, 1024, 1e-3f };
+
+            BoundingShapes::Ray const ray = { { -10, 0.3f, 0 }, { 1, 0, 0 } };
+            auto const expected = 10 - std::sqrt( 0.5f * 0.5f - 0.3f * 0.3f );
+            Assert::AreEqual( expected, IntersectionTime( ray, density, settings ), 1e-3f );
+            Assert::AreEqual( expected, IntersectionTime( ray, density, default_settings ), 2e-3f );
+
+            // a thin sphere far along a long ray isn't stepped over either
+            auto const far_density = CreateSpheresDensity( { { { 500, 0, 0 }, 0.05f }, { { 520, 0, 0 }, 10 } }, evaluations );
+            BoundingShapes::Ray const far_ray = { { 0, 0.02f, 0 }, { 1, 0, 0 } };
+            auto const far_expected = 500 - std::sqrt( 0.05f * 0.05f - 0.02f * 0.02f );
+            Assert::AreEqual( far_expected, IntersectionTime( far_ray, far_density, default_settings ), 2e-3f );
+
+            // starting inside hits immediately
+            BoundingShapes::Ray const inside_ray = { { 21, 0, 0 }, { 0, 0, 1 } };
+            Assert::AreEqual( 0.f, IntersectionTime( inside_ray, density, settings ) );
+        }
+
+
+        TEST_METHOD( TestDensityRayMarchCostIsBounded )
+        {
+            uint32_t evaluations = 0;
+            auto const density = CreateSpheresDensity( { { { 0, 0, 0 }, 1 } }, evaluations );
+            DensityRayMarchSettings const settings = { 1, 50, 64, 1e-3f };
+
+            // grazing the sphere keeps the steps small until they run out, which counts as a miss
+            BoundingShapes::Ray const grazing_ray = { { -10, 1.0001f, 0 }, { 1, 0, 0 } };
+            Assert::IsTrue( std::isinf( IntersectionTime( grazing_ray, density, settings ) ) );
+            Assert::IsTrue( evaluations <= settings.max_steps + 1 );
+
+            // the sphere is beyond the maximum length
+            evaluations = 0;
+            BoundingShapes::Ray const far_ray = { { -60, 0, 0 }, { 1, 0, 0 } };
+            Assert::IsTrue( std::isinf( IntersectionTime( far_ray, density, settings ) ) );
+            Assert::IsTrue( evaluations <= settings.max_steps + 1 );
+        }
+
+
+        TEST_METHOD( TestMeshMatchesAllTriangles )
+        {
+            std::mt19937 generator( 4321 );
+            std::uniform_real_distribution<float> position( -6.f, 6.f );
+            std::uniform_real_distribution<float> offset( -1.f, 1.f );
+            std::vector<Math::Float3> vertices;
+            std::vector<unsigned> indices;
+            for( auto t = 0u; t < 300; ++t )
+            {
+                Math::Float3 center = { position( generator ), position( generator ), position( generator ) };
+                for( auto c = 0u; c < 3; ++c )
+                {
+                    indices.push_back( unsigned( vertices.size() ) );
+                    vertices.push_back( center + Math::Float3( offset( generator ), offset( generator ), offset( generator ) ) );
+                }
+            }
+
+            auto const rays = CreateRandomRays( 200 );
+            for( auto const & mesh : { BoundingShapes::CreateAxisAlignedBoxHierarchyMesh( vertices, indices ), BoundingShapes::CreateAxisAlignedBoxHierarchyMeshSAH( vertices, indices ) } )
+            {
+                auto hits = 0u;
+                for( auto const & ray : rays )
+                {
+                    auto expected = std::numeric_limits<float>::infinity();
+                    for( auto i = size_t( 0 ); i < indices.size(); i += 3 )
+                    {
+                        expected = Math::Min( expected, TriangleIntersectionTime( ray, vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]] ) );
+                    }
+                    Math::Float3 normal;
+                    auto const time = IntersectionTime( ray, mesh, normal );
+                    if( std::isinf( expected ) )
+                    {
+                        Assert::IsTrue( std::isinf( time ) );
+                        continue;
+                    }
+                    ++hits;
+                    Assert::AreEqual( expected, time, 1e-3f );
+                    Assert::IsTrue( Math::Dot( normal, ray.direction ) <= 0 );
+                    Assert::AreEqual( 1.f, Math::Norm( normal ), 1e-4f );
+                }
+                Assert::IsTrue( hits > 0 );
+            }
+        }
+
+
+        TEST_METHOD( TestMeshHierarchyDeeperThanTheTraversalStack )
+        {
+            // a chain of equal boxes, each with a leaf and the next box as children,
+            // the traversal visits the boxes first, so every level keeps a leaf on the stack
+            auto const depth = 300u;
+            BoundingShapes::AxisAlignedBoxHierarchyMesh mesh;
+            auto const node_count = 2 * depth + 1;
+            mesh.nodes.resize( node_count );
+            auto add_leaf = [&]( unsigned node_index, float z )
+            {
+                auto const first_vertex = unsigned( mesh.vertex_positions.size() );
+                mesh.vertex_positions.push_back( { -1, -1, z } );
+                mesh.vertex_positions.push_back( { 1, -1, z } );
+                mesh.vertex_positions.push_back( { 0, 1, z } );
+                mesh.nodes[node_index].vertex_indices = { { first_vertex, first_vertex + 1, first_vertex + 2 } };
+                mesh.nodes[node_index].escape_index = node_index + 1;
+            };
+            for( auto level = 0u; level < depth; ++level )
+            {
+                mesh.nodes[2 * level].shape = { { 0, 0, 200 }, { 2, 2, 200 } };
+                mesh.nodes[2 * level].escape_index = node_count;
+                add_leaf( 2 * level + 1, float( 400 - level ) );
+            }
+            // the deepest leaf holds the closest triangle
+            add_leaf( 2 * depth, 10 );
+
+            BoundingShapes::Ray const ray = { { 0, 0, -10 }, { 0, 0, 1 } };
+            Math::Float3 normal;
+            Assert::AreEqual( 20.f, IntersectionTime( ray, mesh, normal ), 1e-4f );
+            Assert::AreEqual( -1.f, normal.z, 1e-4f );
+        }
+    };
+}
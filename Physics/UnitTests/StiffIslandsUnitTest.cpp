@@ -0,0 +1,103 @@
+#include "CppUnitTest.h"
+
+#include <Physics\ImplicitConstraintSolver\StiffIslands.h>
+#include <Physics\ImplicitConstraintSolver\Constraints.h>
+#include <Physics\Inertia.h>
+#include <Physics\Movement.h>
+
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Physics;
+
+namespace DogDealerPhysicsUnitTests
+{
+    namespace
+    {
+        // a joint that keeps the positions adds a constraint row for each axis
+        void AddJoint( uint32_t body1, uint32_t body2, std::vector<Constraint> & constraints )
+        {
+            for( auto axis = 0u; axis < 3; ++axis )
+            {
+                Constraint constraint = {};
+                constraint.body_indices = { { body1, body2 } };
+                constraints.push_back( constraint );
+            }
+        }
+    }
+
+
+    TEST_CLASS(StiffIslandsUnitTest)
+    {
+    public:
+
+        TEST_METHOD(TestOnlyChainsAndFastSpinningIslandsAreStiff)
+        {
+            auto const body_count = 8u;
+            std::vector<Inertia> inverse_inertias( body_count, Inertia( { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, 1 ) );
+            std::vector<Movement> movements( body_count, Movement{ { 0, 0, 0 }, { 0, 0, 0 } } );
+
+            // bodies 0, 1 and 2 form a chain, body 3 has a single attached part, body 4
+            std::vector<Constraint> position_constraints, velocity_constraints;
+            AddJoint( 0, 1, position_constraints );
+            AddJoint( 1, 2, position_constraints );
+            AddJoint( 3, 4, position_constraints );
+            velocity_constraints = position_constraints;
+            // bodies 5 and 6 only touch, 6 spins fast, body 7 is on its own and spins fast without constraints
+            Constraint contact = {};
+            contact.body_indices = { { 5, 6 } };
+            velocity_constraints.push_back( contact );
+            movements[6].angular_momentum = { 0, 0, 10 };
+            movements[7].angular_momentum = { 0, 0, 10 };
+
+            StiffIslands islands;
+            auto const any_stiff = MarkStiffIslands(
+                velocity_constraints, position_constraints,
+                position_constraints, CreateRange( velocity_constraints.data(), velocity_constraints.size() - 1 ),
+                inverse_inertias, movements, 5, islands );
+            Assert::IsTrue( any_stiff );
+
+            auto const is_stiff = [&]( uint32_t body ) { return islands.is_stiff[islands.groups[body]] != 0; };
+            Assert::IsTrue( is_stiff( 0 ) );
+            Assert::IsTrue( is_stiff( 1 ) );
+            Assert::IsTrue( is_stiff( 2 ) );
+            Assert::IsFalse( is_stiff( 3 ) );
+            Assert::IsFalse( is_stiff( 4 ) );
+            Assert::IsTrue( is_stiff( 5 ) );
+            Assert::IsTrue( is_stiff( 6 ) );
+            Assert::IsTrue( is_stiff( 7 ) );
+
+            // the chain and the spinning contact get the extra passes, the single joint doesn't
+            std::vector<SingleBodyConstraint> single_body_constraints( 2 );
+            single_body_constraints[0].body_index = 2;
+            single_body_constraints[1].body_index = 4;
+            std::vector<Constraint> stiff_constraints;
+            std::vector<SingleBodyConstraint> stiff_single_body_constraints;
+            SelectStiffConstraints( islands, velocity_constraints, single_body_constraints, stiff_constraints, stiff_single_body_constraints );
+            Assert::AreEqual( size_t( 7 ), stiff_constraints.size() );
+            for( auto const & constraint : stiff_constraints )
+            {
+                Assert::IsTrue( constraint.body_indices[0] != 3 );
+            }
+            Assert::AreEqual( size_t( 1 ), stiff_single_body_constraints.size() );
+            Assert::AreEqual( 2u, stiff_single_body_constraints[0].body_index );
+        }
+
+
+        TEST_METHOD(TestSingleJointsAreNotStiff)
+        {
+            // a character with a weapon attached to it, many rows between the same two bodies
+            std::vector<Inertia> inverse_inertias( 2, Inertia( { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, 1 ) );
+            std::vector<Movement> movements( 2, Movement{ { 0, 0, 0 }, { 0, 0, 0 } } );
+            std::vector<Constraint> position_constraints, velocity_constraints;
+            AddJoint( 0, 1, position_constraints );
+            AddJoint( 1, 0, velocity_constraints );
+
+            StiffIslands islands;
+            Assert::IsFalse( MarkStiffIslands(
+                velocity_constraints, position_constraints,
+                position_constraints, velocity_constraints,
+                inverse_inertias, movements, 5, islands ) );
+        }
+    };
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DensityRayMarchSettings.h"
+
 #include <Utilities\MinMax.h>
 
 namespace Physics
@@ -34,5 +36,11 @@ namespace Physics
         float warm_start_factor;
         // relaxation factors, starting at max and gradually moving towards min at the max iteration
         MinMax<float> solver_relaxation_factor;
+        // islands with a body held by more than one persistent constraint, or turning more than the angular step [rad] in a tick,
+        // are solved with this many times the iterations, the other islands keep the configured iterations, 1 turns it off
+        uint32_t stiff_island_iteration_factor;
+        float stiff_island_angular_step;
+        // how ray casts search for the surface of density function bodies
+        DensityRayMarchSettings density_ray_march;
     };
 }
\ No newline at end of file
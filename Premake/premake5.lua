@@ -56,6 +56,12 @@ workspace "DogDealer"
       defines { "NDEBUG" }
       optimize "On"
 
+   filter "platforms:UnitTest"
+      -- count heap allocations, see Utilities/AllocationCounter.h
+      defines { "COUNT_ALLOCATIONS" }
+
+   filter {}
+
 
    project "DogDealer"
       kind "WindowedApp"
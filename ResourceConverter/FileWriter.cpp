@@ -5,6 +5,7 @@
 
 #include <BoundingShapes\AxisAlignedBoxFunctions.h>
 #include <BoundingShapes\AxisAlignedBoxHierarchyMeshFunctions.h>
+#include <BoundingShapes\CapsuleFunctions.h>
 #include <BoundingShapes\FileLayout.h>
 #include <BoundingShapes\OrientedBoxFunctions.h>
 #include <BoundingShapes\SphereFunctions.h>
@@ -197,6 +198,10 @@ namespace
             {
                 shape_types[i] = ShapeType::OrientedBox;
             }
+            else if(shape_name.compare(0, 7, "Capsule") == 0)
+            {
+                shape_types[i] = ShapeType::Capsule;
+            }
             else
             {
                 // assume it's a mesh
@@ -232,9 +237,17 @@ namespace
                     axis_boxes[1] = RotateAroundCenter(axis_boxes[1], box.rotation);
                     break;
                 }
+                case ShapeType::Capsule:
+                {
+                    auto capsule = CreateCapsule(file_datas[i].vertex_positions);
+                    WriteObject(stream, capsule);
+                    axis_boxes[1] = CreateAxisAlignedBox(capsule);
+                    break;
+                }
                 case ShapeType::AxisAlignedBoxHierarchyMesh:
                 {
-                    auto mesh = CreateAxisAlignedBoxHierarchyMesh( file_datas[i].vertex_positions, file_datas[i].vertex_indices);
+                    auto mesh = CreateAxisAlignedBoxHierarchyMeshSAH( file_datas[i].vertex_positions, file_datas[i].vertex_indices);
+                    wcout << output_sub_prefix << "collision mesh with " << file_datas[i].vertex_indices.size() / 3 << " triangles, expected traversal cost: " << ExpectedTraversalCost( mesh ) << "\n";
                     WriteObject( stream, unsigned( mesh.nodes.size() ) );
                     WriteVector( stream, mesh.nodes );
                     WriteObject( stream, unsigned( mesh.vertex_positions.size() ) );
@@ -511,7 +511,9 @@ namespace
     int SetGraphicsConfiguration( lua_State * L )
     {
         auto dog_world = luaW_check<DogWorld>( L, 1 );
-        ReadGraphicsConfiguration(L, 2, dog_world->GraphicsConfiguration());
+        auto configuration = dog_world->GraphicsConfiguration();
+        ReadGraphicsConfiguration(L, 2, configuration);
+        dog_world->SetGraphicsConfiguration(configuration);
         return 0;
     }
 
@@ -534,6 +536,32 @@ namespace
     }
 
 
+    int SetLevelNavigationMesh( lua_State * L )
+    {
+        auto dog_world = luaW_check<DogWorld>( L, 1 );
+        dog_world->SetLevelNavigationMesh( luaU_check<std::string>( L, 2 ) );
+        return 0;
+    }
+
+
+    int UpdateNavigationMesh( lua_State * L )
+    {
+        auto dog_world = luaW_check<DogWorld>( L, 1 );
+        auto center = luaU_check<Math::Float3>( L, 2 );
+        auto extent = luaU_check<Math::Float3>( L, 3 );
+        dog_world->UpdateNavigationMesh( { center, extent } );
+        return 0;
+    }
+
+
+    int SetSeparateRenderThread( lua_State * L )
+    {
+        auto dog_world = luaW_check<DogWorld>( L, 1 );
+        dog_world->m_world_configuration.separate_render_thread = luaU_check<bool>( L, 2 );
+        return 0;
+    }
+
+
     int SetGravity( lua_State * L )
     {
         auto dog_world = luaW_check<DogWorld>( L, 1 );
@@ -674,14 +702,17 @@ static luaL_Reg metatable[] =
     { "SetGraphicsConfiguration", SetGraphicsConfiguration },
     { "SetGravity", SetGravity },
     { "SetHitpoints", SetHitpoints },
+    { "SetLevelNavigationMesh", SetLevelNavigationMesh },
     { "SetPhysicsConfiguration", SetPhysicsConfiguration },
     { "SetPlayerKeys", SetPlayerKeys },
+    { "SetSeparateRenderThread", SetSeparateRenderThread },
     { "SetTerrainGrassTypes", SetTerrainGrassTypes },
     { "SetTimeStep", SetTimeStep },
     { "SetUpdateFunction", SetUpdateFunction },
     { "SpawnEntity", SpawnEntity },
     { "SpawnItem", SpawnItem },
     { "SpawnLight", SpawnLight },
+    { "UpdateNavigationMesh", UpdateNavigationMesh },
     { nullptr, nullptr }
 };
 
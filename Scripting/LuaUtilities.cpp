@@ -13,6 +13,7 @@
 #include <Graphics\ResourceDescriptions.h>
 #include <Graphics\TextureFiltering.h>
 #include <Animating\ResourceDescriptions.h>
+#include <Physics\CollisionFilter.h>
 #include <Physics\ConstraintSolverType.h>
 
 #include <World\DogWorld.h>
@@ -38,6 +39,9 @@ namespace
             c_friction = "friction",
             c_collision_file = "collision_file",
             c_lock_rotation = "lock_rotation",
+            c_continuous_collision = "continuous_collision",
+            c_collision_layer = "collision_layer",
+            c_collision_mask = "collision_mask",
 
             // physics configuration
             c_position_correction_iterations = "position_correction_iterations",
@@ -277,6 +281,11 @@ namespace
 
         description.lock_rotation = luaU_optfield<bool>( L, table_index, c_lock_rotation.c_str(), false );
 
+        description.continuous_collision = luaU_optfield<bool>( L, table_index, c_continuous_collision.c_str(), false );
+
+        description.collision_layer = luaU_optfield<uint32_t>( L, table_index, c_collision_layer.c_str(), Physics::c_default_collision_layer );
+        description.collision_mask = luaU_optfield<uint32_t>( L, table_index, c_collision_mask.c_str(), Physics::c_all_collision_layers );
+
         if( luaU_checkfield<bool>( L, table_index, c_static.c_str() ) )
         {
             description.mass = std::numeric_limits<decltype( description.mass )>::infinity();
@@ -485,6 +494,21 @@ void ReadPhysicsConfiguration( lua_State * L, int table_index, Physics::WorldCon
         luaL_error(L, "relaxation_factor has an invalid value. The valid range is (0, 2).");
     }
     configuration.minimal_island_size = luaU_optfield<uint32_t>( L, table_index, "minimal_island_size", 128 );
+    configuration.stiff_island_iteration_factor = luaU_optfield<uint32_t>( L, table_index, "stiff_island_iteration_factor", 4 );
+    configuration.stiff_island_angular_step = luaU_optfield<float>( L, table_index, "stiff_island_angular_step", 0.25f );
+    if( configuration.stiff_island_iteration_factor == 0 || configuration.stiff_island_angular_step <= 0 )
+    {
+        luaL_error( L, "stiff_island_iteration_factor and stiff_island_angular_step have to be larger than zero." );
+    }
+    configuration.density_ray_march.lipschitz_bound = luaU_optfield<float>( L, table_index, "density_lipschitz_bound", 1.f );
+    configuration.density_ray_march.max_length = luaU_optfield<float>( L, table_index, "max_ray_length", 1000.f );
+    configuration.density_ray_march.max_steps = luaU_optfield<uint32_t>( L, table_index, "max_ray_march_steps", 1024 );
+    configuration.density_ray_march.accuracy = luaU_optfield<float>( L, table_index, "ray_march_accuracy", 1e-3f );
+    if( configuration.density_ray_march.lipschitz_bound <= 0 || configuration.density_ray_march.max_length <= 0 ||
+        configuration.density_ray_march.max_steps == 0 || configuration.density_ray_march.accuracy <= 0 )
+    {
+        luaL_error( L, "density_lipschitz_bound, max_ray_length, max_ray_march_steps and ray_march_accuracy have to be larger than zero." );
+    }
     auto solver_name = luaU_optfield<std::string>( L, table_index, c_constraint_solver_type.c_str(), "Implicit" );
     if( solver_name == "Implicit" )
     {
@@ -0,0 +1,72 @@
+#include "AllocationCounter.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<uint64_t> s_allocation_count( 0 );
+}
+
+
+// replacing the global operators counts the allocations of everything linked into the same binary
+void * operator new( size_t size )
+{
+    ++s_allocation_count;
+    if( size == 0 ) size = 1;
+    for( ;; )
+    {
+        if( auto memory = std::malloc( size ) ) return memory;
+        auto handler = std::get_new_handler();
+        if( !handler ) throw std::bad_alloc();
+        handler();
+    }
+}
+
+
+void * operator new[]( size_t size )
+{
+    return operator new( size );
+}
+
+
+void operator delete( void * memory ) noexcept
+{
+    std::free( memory );
+}
+
+
+void operator delete[]( void * memory ) noexcept
+{
+    std::free( memory );
+}
+
+
+void operator delete( void * memory, size_t ) noexcept
+{
+    std::free( memory );
+}
+
+
+void operator delete[]( void * memory, size_t ) noexcept
+{
+    std::free( memory );
+}
+
+
+uint64_t AllocationCount()
+{
+    return s_allocation_count.load();
+}
+
+#else
+
+uint64_t AllocationCount()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// number of times the global operator new was called since the program started
+// only counted when COUNT_ALLOCATIONS is defined (the unit test platform), otherwise this always returns 0
+uint64_t AllocationCount();
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// first in first out queue with a fixed capacity that can be shared between two threads
+// pushing blocks while the queue is full and popping blocks while it is empty, until the queue is closed
+template<typename Type>
+class BoundedQueue
+{
+    std::vector<Type> m_items;
+    size_t m_first = 0;
+    size_t m_size = 0;
+    bool m_closed = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_not_full;
+    std::condition_variable m_not_empty;
+
+public:
+
+    explicit BoundedQueue( size_t capacity );
+
+    // returns false if the queue was closed, in which case the item is not added
+    bool Push( Type item );
+    // returns false if the queue is full or closed, in which case the item is not touched
+    bool TryPush( Type & item );
+
+    // returns false if the queue is closed and empty
+    bool Pop( Type & item );
+    // returns false if the queue is empty
+    bool TryPop( Type & item );
+
+    // wakes up all waiting threads, pushing fails afterwards and popping only returns the remaining items
+    void Close();
+    void Reopen();
+
+    size_t Capacity() const;
+};
+
+
+#include "BoundedQueue.inl"
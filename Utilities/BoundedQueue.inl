@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cassert>
+#include <utility>
+
+template<typename Type>
+BoundedQueue<Type>::BoundedQueue( size_t capacity ) :
+    m_items( capacity )
+{
+    assert( capacity > 0 );
+}
+
+
+template<typename Type>
+bool BoundedQueue<Type>::Push( Type item )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_not_full.wait( lock, [this](){ return m_closed || m_size < m_items.size(); } );
+    if( m_closed ) return false;
+    m_items[( m_first + m_size ) % m_items.size()] = std::move( item );
+    ++m_size;
+    lock.unlock();
+    m_not_empty.notify_one();
+    return true;
+}
+
+
+template<typename Type>
+bool BoundedQueue<Type>::TryPush( Type & item )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    if( m_closed || m_size == m_items.size() ) return false;
+    m_items[( m_first + m_size ) % m_items.size()] = std::move( item );
+    ++m_size;
+    lock.unlock();
+    m_not_empty.notify_one();
+    return true;
+}
+
+
+template<typename Type>
+bool BoundedQueue<Type>::Pop( Type & item )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_not_empty.wait( lock, [this](){ return m_closed || m_size > 0; } );
+    if( m_size == 0 ) return false;
+    // swap instead of move, so the buffers of the old item can be reused by whoever pushes into this slot
+    std::swap( item, m_items[m_first] );
+    m_first = ( m_first + 1 ) % m_items.size();
+    --m_size;
+    lock.unlock();
+    m_not_full.notify_one();
+    return true;
+}
+
+
+template<typename Type>
+bool BoundedQueue<Type>::TryPop( Type & item )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    if( m_size == 0 ) return false;
+    std::swap( item, m_items[m_first] );
+    m_first = ( m_first + 1 ) % m_items.size();
+    --m_size;
+    lock.unlock();
+    m_not_full.notify_one();
+    return true;
+}
+
+
+template<typename Type>
+void BoundedQueue<Type>::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_closed = true;
+    }
+    m_not_full.notify_all();
+    m_not_empty.notify_all();
+}
+
+
+template<typename Type>
+void BoundedQueue<Type>::Reopen()
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    m_closed = false;
+}
+
+
+template<typename Type>
+size_t BoundedQueue<Type>::Capacity() const
+{
+    return m_items.size();
+}
@@ -0,0 +1,85 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace
+{
+    size_t const c_minimum_block_size = 64 * 1024;
+
+
+    uintptr_t AlignUp( uintptr_t address, size_t alignment )
+    {
+        assert( alignment != 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+        return ( address + alignment - 1 ) & ~uintptr_t( alignment - 1 );
+    }
+}
+
+
+FrameArena::FrameArena( size_t initial_capacity )
+{
+    if( initial_capacity > 0 )
+    {
+        AddBlock( initial_capacity );
+    }
+}
+
+
+void FrameArena::AddBlock( size_t size )
+{
+    m_blocks.emplace_back( new uint8_t[size] );
+    m_block_sizes.push_back( size );
+    m_used = 0;
+}
+
+
+void * FrameArena::Allocate( size_t size, size_t alignment )
+{
+    if( size == 0 ) return nullptr;
+
+    if( !m_blocks.empty() )
+    {
+        auto const block_start = reinterpret_cast<uintptr_t>( m_blocks.back().get() );
+        auto const aligned = AlignUp( block_start + m_used, alignment );
+        auto const new_used = ( aligned - block_start ) + size;
+        if( new_used <= m_block_sizes.back() )
+        {
+            m_used = new_used;
+            return reinterpret_cast<void *>( aligned );
+        }
+    }
+
+    // grow geometrically so a growing workload only needs a few extra blocks
+    AddBlock( std::max( { size + alignment, Capacity(), c_minimum_block_size } ) );
+    auto const block_start = reinterpret_cast<uintptr_t>( m_blocks.back().get() );
+    auto const aligned = AlignUp( block_start, alignment );
+    m_used = ( aligned - block_start ) + size;
+    return reinterpret_cast<void *>( aligned );
+}
+
+
+void FrameArena::Reset()
+{
+    if( m_blocks.size() > 1 )
+    {
+        // merge into one block big enough for everything allocated since the last reset
+        auto const capacity = Capacity();
+        m_blocks.clear();
+        m_block_sizes.clear();
+        AddBlock( capacity );
+    }
+    m_used = 0;
+}
+
+
+size_t FrameArena::Capacity() const
+{
+    return std::accumulate( m_block_sizes.begin(), m_block_sizes.end(), size_t( 0 ) );
+}
+
+
+size_t FrameArena::BlockCount() const
+{
+    return m_blocks.size();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Utilities\Range.h>
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// bump allocator for scratch memory that only lives for one frame or tick
+// allocations are not freed one by one, Reset releases all of them at once
+// when the current block is full a new block is added, Reset merges all blocks into a single one
+// so after a couple of frames with a stable workload no more heap allocations are made
+class FrameArena
+{
+    std::vector<std::unique_ptr<uint8_t[]>> m_blocks;
+    std::vector<size_t> m_block_sizes;
+    // bytes used in the last block
+    size_t m_used = 0;
+
+    void AddBlock( size_t size );
+
+public:
+
+    explicit FrameArena( size_t initial_capacity = 0 );
+
+    // returns nullptr if size is 0
+    void * Allocate( size_t size, size_t alignment );
+    // invalidates all memory handed out since the last reset
+    void Reset();
+
+    size_t Capacity() const;
+    size_t BlockCount() const;
+};
+
+
+// value initialized range, the memory is only valid until the next reset of the arena
+template<typename Type>
+Range<Type *> AllocateRange( FrameArena & arena, size_t size );
+
+// the memory is only valid until the next reset of the arena
+template<typename Type>
+Range<Type *> AllocateCopy( FrameArena & arena, Range<Type const *> source );
+
+
+// template implementations
+
+
+template<typename Type>
+Range<Type *> AllocateRange( FrameArena & arena, size_t size )
+{
+    // the arena never calls destructors
+    static_assert( std::is_trivially_destructible<Type>::value, "Only trivially destructible types can be allocated from a FrameArena." );
+    auto data = static_cast<Type *>( arena.Allocate( size * sizeof( Type ), alignof( Type ) ) );
+    for( auto i = 0u; i < size; ++i )
+    {
+        new( data + i ) Type();
+    }
+    return CreateRange( data, size );
+}
+
+
+template<typename Type>
+Range<Type *> AllocateCopy( FrameArena & arena, Range<Type const *> source )
+{
+    static_assert( std::is_trivially_destructible<Type>::value, "Only trivially destructible types can be allocated from a FrameArena." );
+    auto const size = Size( source );
+    auto data = static_cast<Type *>( arena.Allocate( size * sizeof( Type ), alignof( Type ) ) );
+    std::uninitialized_copy( begin( source ), end( source ), data );
+    return CreateRange( data, size );
+}
@@ -0,0 +1,79 @@
+#include "CppUnitTest.h"
+
+#include <Utilities\BoundedQueue.h>
+
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace DogDealerUtilitiesUnitTest
+{
+    TEST_CLASS(BoundedQueueUnitTest)
+    {
+    public:
+
+        TEST_METHOD( TestFirstInFirstOut )
+        {
+            BoundedQueue<uint32_t> queue( 2 );
+            uint32_t item = 1;
+            Assert::IsTrue( queue.TryPush( item ) );
+            item = 2;
+            Assert::IsTrue( queue.TryPush( item ) );
+            item = 3;
+            Assert::IsFalse( queue.TryPush( item ) );
+
+            Assert::IsTrue( queue.TryPop( item ) );
+            Assert::AreEqual( 1u, item );
+            Assert::IsTrue( queue.Push( 3 ) );
+            Assert::IsTrue( queue.Pop( item ) );
+            Assert::AreEqual( 2u, item );
+            Assert::IsTrue( queue.Pop( item ) );
+            Assert::AreEqual( 3u, item );
+            Assert::IsFalse( queue.TryPop( item ) );
+        }
+
+
+        TEST_METHOD( TestCloseWakesUpAndDrains )
+        {
+            BoundedQueue<uint32_t> queue( 1 );
+            Assert::IsTrue( queue.Push( 5 ) );
+            queue.Close();
+            Assert::IsFalse( queue.Push( 6 ) );
+
+            uint32_t item = 0;
+            Assert::IsTrue( queue.Pop( item ) );
+            Assert::AreEqual( 5u, item );
+            Assert::IsFalse( queue.Pop( item ) );
+
+            queue.Reopen();
+            Assert::IsTrue( queue.Push( 7 ) );
+        }
+
+
+        TEST_METHOD( TestProducerAndConsumerThreads )
+        {
+            BoundedQueue<std::vector<uint32_t>> queue( 2 );
+            auto const count = 1000u;
+            std::thread producer( [&queue]()
+            {
+                for( auto i = 0u; i < count; ++i )
+                {
+                    queue.Push( std::vector<uint32_t>( 3, i ) );
+                }
+                queue.Close();
+            } );
+
+            auto expected = 0u;
+            std::vector<uint32_t> item;
+            while( queue.Pop( item ) )
+            {
+                Assert::AreEqual( size_t( 3 ), item.size() );
+                Assert::AreEqual( expected, item[0] );
+                ++expected;
+            }
+            producer.join();
+            Assert::AreEqual( count, expected );
+        }
+    };
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../Handle.h"
+
+#include <cstdint>
+
+// a handle of the first generation, tests don't reuse the indices of removed objects
+template<typename HandleType>
+HandleType CreateHandle( uint32_t index )
+{
+    return { typename HandleType::index_t( index ), 0 };
+}
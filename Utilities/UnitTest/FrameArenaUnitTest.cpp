@@ -0,0 +1,79 @@
+#include "CppUnitTest.h"
+
+#include <Utilities\AllocationCounter.h>
+#include <Utilities\FrameArena.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace DogDealerUtilitiesUnitTest
+{
+    TEST_CLASS(FrameArenaUnitTest)
+    {
+    public:
+
+        TEST_METHOD( TestAllocationsAreAlignedAndDistinct )
+        {
+            FrameArena arena( 256 );
+            auto bytes = AllocateRange<uint8_t>( arena, 3 );
+            auto doubles = AllocateRange<double>( arena, 5 );
+            auto aligned = arena.Allocate( 16, 64 );
+
+            Assert::AreEqual( size_t( 3 ), Size( bytes ) );
+            Assert::AreEqual( size_t( 0 ), reinterpret_cast<uintptr_t>( begin( doubles ) ) % alignof( double ) );
+            Assert::AreEqual( size_t( 0 ), reinterpret_cast<uintptr_t>( aligned ) % 64 );
+            Assert::IsTrue( static_cast<void *>( end( bytes ) ) <= static_cast<void *>( begin( doubles ) ) );
+            Assert::IsTrue( static_cast<void *>( end( doubles ) ) <= aligned );
+            for( auto d : doubles )
+            {
+                Assert::AreEqual( 0.0, d );
+            }
+
+            Assert::IsNull( arena.Allocate( 0, 4 ) );
+        }
+
+
+        TEST_METHOD( TestResetMergesBlocks )
+        {
+            FrameArena arena;
+            Assert::AreEqual( size_t( 0 ), arena.BlockCount() );
+
+            std::vector<uint32_t> source( 100000, 7 );
+            auto copy = AllocateCopy<uint32_t>( arena, source );
+            AllocateRange<uint32_t>( arena, 100000 );
+            Assert::IsTrue( arena.BlockCount() > 1 );
+            Assert::AreEqual( 7u, copy[99999] );
+
+            auto const capacity = arena.Capacity();
+            arena.Reset();
+            Assert::AreEqual( size_t( 1 ), arena.BlockCount() );
+            Assert::AreEqual( capacity, arena.Capacity() );
+        }
+
+
+        TEST_METHOD( TestNoHeapAllocationsAfterWarmUp )
+        {
+            FrameArena arena;
+            auto const frame = [&arena]()
+            {
+                arena.Reset();
+                for( auto i = 0u; i < 64; ++i )
+                {
+                    AllocateRange<uint64_t>( arena, 1000 + i );
+                }
+            };
+            frame();
+            frame();
+
+            auto const allocations = AllocationCount();
+            for( auto i = 0u; i < 10; ++i )
+            {
+                frame();
+            }
+            Assert::AreEqual( allocations, AllocationCount() );
+            Assert::AreEqual( size_t( 1 ), arena.BlockCount() );
+        }
+    };
+}
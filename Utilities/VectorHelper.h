@@ -3,6 +3,7 @@
 #include "InvalidIndex.h"
 #include "StdVectorFunctions.h"
 
+#include <algorithm>
 #include <vector>
 #include <iterator>
 #include <cstdint>
@@ -49,6 +50,20 @@ template<typename T, typename... Ts> void SwapAndPrune(size_t const pruned_index
 }
 
 
+// Remove the block of entries between offsets[pruned_index] and offsets[pruned_index + 1] by overwriting it with the last block
+// and shortening the vector by its size, both blocks need to be equally large, the offsets aren't changed
+template<typename T> void SwapAndPruneBlock(size_t const pruned_index, std::vector<uint32_t> const & offsets, std::vector<T> &data)
+{
+    auto const last_index = offsets.size() - 2;
+    assert(offsets[pruned_index + 1] - offsets[pruned_index] == offsets[last_index + 1] - offsets[last_index]);
+    if(pruned_index != last_index)
+    {
+        std::move(begin(data) + offsets[last_index], end(data), begin(data) + offsets[pruned_index]);
+    }
+    data.erase(begin(data) + offsets[last_index], end(data));
+}
+
+
 
 template<typename DataType, typename IndexType>
 DataType const & GetOptional( Range<DataType const *> const & data, IndexType index, DataType const & default_value )
@@ -20,6 +20,7 @@
 #include <Input\GameInput.h>
 #include <Input\InterfaceInput.h>
 
+#include <algorithm>
 #include <thread>
 
 namespace
@@ -30,10 +31,13 @@ namespace
 
 
 
-DogWorld::DogWorld()
+DogWorld::DogWorld() :
+    m_render_snapshots( 2 ),
+    m_free_render_snapshots( 2 )
 {
     m_world_reference_position = 0;
     m_world_configuration.time_step = 1 / 60.f;
+    m_graphics_configuration = m_render_world.m_world_configuration;
     ClearLogFile();
     Log( "Hello DogWorld!" );
 }
@@ -90,7 +94,10 @@ void DogWorld::RemoveEntities( std::vector<EntityID> & entity_ids )
 {
     m_logic_world.RemoveEntities( entity_ids );
 
-    m_render_world.RemoveEntities( entity_ids );
+    UpdateRenderWorld( [entity_ids]( Graphics::RenderWorld & render_world )
+    {
+        render_world.RemoveEntities( entity_ids );
+    } );
 
     m_animating_world.RemoveEntities(entity_ids);
 
@@ -170,9 +177,15 @@ void DogWorld::AddEntityComponents( EntityID const entity_id, EntityDescription
         m_logic_world.CreateDamageDealerComponent( entity_id, *description.logic_damage_dealer_component_description );
     }
 
-    for( auto & rc_description : description.render_component_desc )
+    if( !description.render_component_desc.empty() )
     {
-        m_render_world.CreateRenderComponent( rc_description, entity_id );
+        UpdateRenderWorld( [render_component_descriptions = description.render_component_desc, entity_id]( Graphics::RenderWorld & render_world )
+        {
+            for( auto & rc_description : render_component_descriptions )
+            {
+                render_world.CreateRenderComponent( rc_description, entity_id );
+            }
+        } );
     }
 
     // Create animating component if defined
@@ -230,6 +243,7 @@ void DogWorld::AddEntityComponents( EntityID const entity_id, EntityDescription
                             auto const mass = pc_description.mass;
                             Physics::Movement movement = {velocity * mass, 0};
                             m_physics_world.CreateRigidBodyComponent(entity_id, pc_description.collision_file, mass, orientation, movement, pc_description.bounciness, pc_description.friction_factor, pc_description.lock_rotation);
+                            m_physics_world.SetContinuousCollision(entity_id, pc_description.continuous_collision);
                             break;
                         }
                     default:
@@ -252,7 +266,10 @@ void DogWorld::AddEntityComponents( EntityID const entity_id, EntityDescription
                 description.physics_component_desc->bodies,
                 description.physics_component_desc->connections
                 );
+            auto const & bodies = description.physics_component_desc->bodies;
+            m_physics_world.SetContinuousCollision(entity_id, std::any_of(begin(bodies), end(bodies), [](auto const & bd){ return bd.continuous_collision; }));
         }
+        m_physics_world.SetCollisionLayers(entity_id, description.physics_component_desc->bodies);
     }
 
 }
@@ -283,7 +300,10 @@ void DogWorld::ReplaceEntityComponents( Range<EntityID const *> entity_ids, Rang
             m_logic_world.CreateDamageDealerComponent(entity_id, *description.logic_damage_dealer_component_description);
         }
 
-        m_render_world.ReplaceRenderComponents(description.render_component_desc, entity_id);
+        UpdateRenderWorld( [render_component_descriptions = description.render_component_desc, entity_id]( Graphics::RenderWorld & render_world )
+        {
+            render_world.ReplaceRenderComponents( render_component_descriptions, entity_id );
+        } );
 
         // not sure what to do in this case.
         assert(description.animating_component_desc == nullptr);
@@ -340,10 +360,12 @@ void DogWorld::ReplaceEntityComponents( Range<EntityID const *> entity_ids, Rang
                             assert(!pc_description.collision_file.empty());
                             auto const mass = pc_description.mass;
                             m_physics_world.ReplaceWithRigidBodyComponent(entity_id, pc_description.collision_file, mass, pc_description.bounciness, pc_description.friction_factor, pc_description.lock_rotation);
+                            m_physics_world.SetContinuousCollision(entity_id, pc_description.continuous_collision);
                             break;
                         }
                 }
             }
+            m_physics_world.SetCollisionLayers(entity_id, description.physics_component_desc->bodies);
         }
     }
 }
@@ -433,7 +455,10 @@ EntityID DogWorld::CreateTerrain(EntityDescription const & description,
 
     // Create RenderComponent
     assert( description.render_component_desc.size() == 1 );
-    m_render_world.CreateTerrainRenderComponent( description.render_component_desc[0], orientation.position, update_distance, terrain_block_count, terrain_block_dimensions, terrain_block_cube_count, degradation_thresholds, sample_function, entity_id );
+    UpdateRenderWorld( [=, render_component_description = description.render_component_desc[0]]( Graphics::RenderWorld & render_world )
+    {
+        render_world.CreateTerrainRenderComponent( render_component_description, orientation.position, update_distance, terrain_block_count, terrain_block_dimensions, terrain_block_cube_count, degradation_thresholds, sample_function, entity_id );
+    } );
 
     BoundingShapes::AxisAlignedBox box;
     box.center = 0;
@@ -486,7 +511,10 @@ EntityID DogWorld::CreateTerrain(EntityDescription const & description,
     {
         lod_distances[i] *= float(1 << i);
     }
-    m_render_world.CreateTerrainRenderComponent( description.render_component_desc[0], orientation.position, patch_dimensions, patch_size, lod_distances, sample_function_2d, entity_id );
+    UpdateRenderWorld( [=, render_component_description = description.render_component_desc[0]]( Graphics::RenderWorld & render_world )
+    {
+        render_world.CreateTerrainRenderComponent( render_component_description, orientation.position, patch_dimensions, patch_size, lod_distances, sample_function_2d, entity_id );
+    } );
 
 
     BoundingShapes::AxisAlignedBox box;
@@ -509,7 +537,10 @@ EntityID DogWorld::CreateTerrain(EntityDescription const & description,
 
 void DogWorld::SetTerrainGrassTypes(std::vector<Graphics::RenderComponentDescription> const & descriptions, std::vector<std::array<float, Graphics::c_lod_count>> const & densities)
 {
-    m_render_world.SetTerrainGrassTypes(descriptions, densities);
+    UpdateRenderWorld( [descriptions, densities]( Graphics::RenderWorld & render_world )
+    {
+        render_world.SetTerrainGrassTypes( descriptions, densities );
+    } );
 }
 
 
@@ -575,7 +606,10 @@ bool DogWorld::HasPositiveHitpoints( EntityID id ) const
 
 void DogWorld::AddLight( Graphics::LightDescription const & light_description, EntityID entity_id )
 {
-    m_render_world.CreateLight( light_description, entity_id );
+    UpdateRenderWorld( [light_description, entity_id]( Graphics::RenderWorld & render_world )
+    {
+        render_world.CreateLight( light_description, entity_id );
+    } );
 }
 
 
@@ -649,6 +683,19 @@ void DogWorld::Run()
     size_t game_tick_counter = 0;
     while( !m_input_manager.ShouldQuit() )
     {
+        // scripts can switch the render thread on and off, it only changes between ticks
+        if( m_world_configuration.separate_render_thread != m_render_thread.joinable() )
+        {
+            if( m_world_configuration.separate_render_thread )
+            {
+                StartRenderThread();
+            }
+            else
+            {
+                StopRenderThread();
+            }
+        }
+
         auto const time_step = m_world_configuration.time_step;
         while( m_take_single_step && !m_input_manager.ShouldQuit() )
         {
@@ -674,6 +721,10 @@ void DogWorld::Run()
         Log([game_tick_counter](){ return "Game tick number: " + std::to_string(game_tick_counter); });
 
         RemoveReplaceAndSpawnEntities();
+        if( m_navigation_mesh_pending )
+        {
+            PrepareNavigationMesh();
+        }
 
         InputAndScriptUpdate(game_input, interface_input);
 
@@ -686,13 +737,16 @@ void DogWorld::Run()
             if( !Equal( window_size, new_window_size ) )
             {
                 window_size = new_window_size;
-                m_render_world.Resize();
+                UpdateRenderWorld( []( Graphics::RenderWorld & render_world )
+                {
+                    render_world.Resize();
+                } );
                 m_logic_world.m_camera.m_perspective_view.aspect_ratio = float( new_window_size.x ) / float( new_window_size.y );
             }
             Orientation camera_orientation = m_logic_world.m_camera.GetOrientation();
 
             // TODO: use some other condition maybe?
-            if(m_render_world.m_world_configuration.render_external_debug_components)
+            if(m_graphics_configuration.render_external_debug_components)
             {
                 SetPhysicsDebugVisualization();
             }
@@ -700,7 +754,14 @@ void DogWorld::Run()
             // get the time it took to do all non-render updates and start there with rendering
             timer.Stop();
             auto const start_render_time = accumulated_time + timer.GetSeconds();
-            if( !m_pause_simulation )
+            if( m_render_thread.joinable() )
+            {
+                PublishRenderSnapshot( start_render_time, camera_orientation );
+                // the render thread takes care of the rest of this tick
+                timer.Stop();
+                SleepFor( time_step - ( accumulated_time + timer.GetSeconds() ) );
+            }
+            else if( !m_pause_simulation )
             {
                 auto const & orientations = m_physics_world.GetOrientations();
                 auto const & poses = m_animating_world.GetIndexedOffsetPoses();
@@ -730,6 +791,117 @@ void DogWorld::Run()
         accumulated_time -= time_step;
         game_tick_counter += 1;
     }
+
+    StopRenderThread();
+}
+
+
+void DogWorld::UpdateRenderWorld( std::function<void( Graphics::RenderWorld & )> update )
+{
+    if( m_render_thread.joinable() )
+    {
+        m_next_render_snapshot.render_world_updates.emplace_back( std::move( update ) );
+    }
+    else
+    {
+        update( m_render_world );
+    }
+}
+
+
+void DogWorld::SetGraphicsConfiguration( Graphics::WorldConfiguration const & configuration )
+{
+    m_graphics_configuration = configuration;
+    UpdateRenderWorld( [configuration]( Graphics::RenderWorld & render_world )
+    {
+        render_world.m_world_configuration = configuration;
+    } );
+}
+
+
+void DogWorld::StartRenderThread()
+{
+    assert( !m_render_thread.joinable() );
+    m_render_snapshots.Reopen();
+    m_free_render_snapshots.Reopen();
+    m_render_thread = std::thread( &DogWorld::RenderThread, this );
+}
+
+
+void DogWorld::StopRenderThread()
+{
+    if( !m_render_thread.joinable() ) return;
+    m_render_snapshots.Close();
+    m_render_thread.join();
+    // updates that never made it into a snapshot
+    for( auto & update : m_next_render_snapshot.render_world_updates )
+    {
+        update( m_render_world );
+    }
+    m_next_render_snapshot.render_world_updates.clear();
+}
+
+
+void DogWorld::PublishRenderSnapshot( double start_render_time, Orientation camera_orientation )
+{
+    auto & snapshot = m_next_render_snapshot;
+    // assigning keeps the capacity of the recycled snapshot
+    snapshot.orientations = m_physics_world.GetOrientations();
+    snapshot.poses = m_animating_world.GetIndexedOffsetPoses();
+    if( m_pause_simulation )
+    {
+        snapshot.orientations.previous_orientations = snapshot.orientations.orientations;
+        snapshot.poses.previous_bone_states = snapshot.poses.bone_states;
+    }
+    snapshot.camera_orientation = camera_orientation;
+    snapshot.previous_camera_orientation = m_previous_camera_orientation;
+    snapshot.perspective_view = m_logic_world.m_camera.m_perspective_view;
+    snapshot.time_step = m_world_configuration.time_step;
+    snapshot.start_render_time = start_render_time;
+    snapshot.publish_time = std::chrono::high_resolution_clock::now();
+
+    // blocks only if the render thread is more than a full queue behind
+    m_render_snapshots.Push( std::move( snapshot ) );
+    if( !m_free_render_snapshots.TryPop( snapshot ) )
+    {
+        // nothing to recycle, clear the moved from snapshot in place so whatever capacity it kept stays
+        snapshot.orientations.orientations.clear();
+        snapshot.orientations.previous_orientations.clear();
+        snapshot.orientations.indices.clear();
+        snapshot.poses.bone_states.clear();
+        snapshot.poses.previous_bone_states.clear();
+        snapshot.poses.pose_offsets.clear();
+        snapshot.poses.pose_from_entity.clear();
+        snapshot.render_world_updates.clear();
+    }
+}
+
+
+void DogWorld::RenderThread()
+{
+    RenderSnapshot snapshot;
+    while( m_render_snapshots.Pop( snapshot ) )
+    {
+        for( auto & update : snapshot.render_world_updates )
+        {
+            update( m_render_world );
+        }
+        snapshot.render_world_updates.clear();
+
+        // continue where the simulation thread would have started rendering, including the time the snapshot was waiting
+        auto const waiting_time = std::chrono::duration<double>( std::chrono::high_resolution_clock::now() - snapshot.publish_time ).count();
+        m_render_world.RenderFor(
+            snapshot.start_render_time + waiting_time,
+            snapshot.time_step,
+            snapshot.orientations,
+            snapshot.poses,
+            snapshot.camera_orientation,
+            snapshot.previous_camera_orientation,
+            snapshot.perspective_view );
+
+        // give the buffers back to the simulation, if it has enough already they are reused for the next snapshot that is popped
+        m_free_render_snapshots.TryPush( snapshot );
+    }
 }
 
 
@@ -738,11 +910,14 @@ void DogWorld::SetPhysicsDebugVisualization()
     std::vector<BoundingShapes::OrientedBox> physics_boxes;
     std::vector<EntityID> physics_boxes_entities;
     m_physics_world.GetAllOrientedBoxes(physics_boxes, physics_boxes_entities);
-    m_render_world.CreateDebugRenderComponents(physics_boxes_entities, physics_boxes);
     std::vector<BoundingShapes::Sphere> physics_spheres;
     std::vector<EntityID> physics_spheres_entities;
     m_physics_world.GetAllSpheres(physics_spheres, physics_spheres_entities);
-    m_render_world.CreateDebugRenderComponents(physics_spheres_entities, physics_spheres);
+    UpdateRenderWorld( [=]( Graphics::RenderWorld & render_world )
+    {
+        render_world.CreateDebugRenderComponents(physics_boxes_entities, physics_boxes);
+        render_world.CreateDebugRenderComponents(physics_spheres_entities, physics_spheres);
+    } );
 }
 
 
@@ -771,12 +946,23 @@ void DogWorld::RemoveReplaceAndSpawnEntities()
         m_entity_component_replacements.template_ids.clear();
     }
 
-    // spawn new entities
-    for( auto const & data : m_entities_to_be_spawned )
+    // spawn new entities, grouped by template, and add all their physics bodies in one pass
+    if( !m_entities_to_be_spawned.empty() )
     {
-        SpawnEntity( data.template_id, data.orientation, data.velocity, data.entity_id );
+        std::stable_sort( begin( m_entities_to_be_spawned ), end( m_entities_to_be_spawned ), []( EntitySpawn const & a, EntitySpawn const & b )
+        {
+            return a.template_id.index < b.template_id.index;
+        } );
+
+        m_physics_world.BeginBodyBatch();
+        for( auto const & data : m_entities_to_be_spawned )
+        {
+            SpawnEntity( data.template_id, data.orientation, data.velocity, data.entity_id );
+        }
+        m_physics_world.EndBodyBatch();
+
+        m_entities_to_be_spawned.clear();
     }
-    m_entities_to_be_spawned.clear();
 }
 
 
@@ -845,7 +1031,10 @@ CollisionEvents DogWorld::DoGameTick( CollisionEvents collision_events, GameInpu
             Math::Float3 adjustment = float{-c_move_reference_point_threshold} * Round(camera_position / float{c_move_reference_point_threshold});
             m_physics_world.AdjustAllPositions(adjustment);
             m_logic_world.AdjustAllPositions(adjustment);
-            m_render_world.AdjustAllPositions(adjustment);
+            UpdateRenderWorld( [adjustment]( Graphics::RenderWorld & render_world )
+            {
+                render_world.AdjustAllPositions( adjustment );
+            } );
             m_previous_camera_orientation.position += adjustment;
         }
     }
@@ -904,11 +1093,17 @@ CollisionEvents DogWorld::DoGameTick( CollisionEvents collision_events, GameInpu
                 // Get orientation for target
                 auto orientation_index = orientations.indices[camera_target.index];
                 auto target_orientation = orientations.orientations[orientation_index];
-                m_render_world.UpdateTerrain(target_orientation.position);
+                UpdateRenderWorld( [target_orientation]( Graphics::RenderWorld & render_world )
+                {
+                    render_world.UpdateTerrain( target_orientation.position );
+                } );
             }
             else
             {
-                m_render_world.UpdateTerrain(m_logic_world.m_camera.m_position);
+                UpdateRenderWorld( [camera_position = m_logic_world.m_camera.m_position]( Graphics::RenderWorld & render_world )
+                {
+                    render_world.UpdateTerrain( camera_position );
+                } );
             }
         }
 
@@ -978,3 +1173,53 @@ Math::Float3 DogWorld::FindRestingPositionOnEntity( Math::Float3 starting_positi
 {
     return m_physics_world.FindRestingPositionOnEntity( starting_position - Float3FromUnsigned3(m_world_reference_position), target_entity ) - Float3FromUnsigned3(m_world_reference_position);
 }
+
+
+void DogWorld::SetLevelNavigationMesh( std::string name )
+{
+    m_navigation_mesh_name = std::move( name );
+    m_navigation_mesh_pending = true;
+}
+
+
+void DogWorld::PrepareNavigationMesh()
+{
+    m_navigation_mesh_pending = false;
+    if( m_logic_world.LoadNavigationMesh( m_navigation_mesh_name ) )
+    {
+        return;
+    }
+    Log( [this](){ return "Generating the navigation mesh " + m_navigation_mesh_name + "."; } );
+    GenerateNavigationMesh();
+    m_logic_world.SaveNavigationMesh( m_navigation_mesh_name );
+}
+
+
+void DogWorld::GenerateNavigationMesh()
+{
+    m_logic_world.GenerateNavigationMesh( GetNavigationGeometry() );
+}
+
+
+void DogWorld::UpdateNavigationMesh( BoundingShapes::AxisAlignedBox const & changed_area )
+{
+    auto center = changed_area.center - Float3FromUnsigned3(m_world_reference_position);
+    m_logic_world.UpdateNavigationMesh( GetNavigationGeometry(), center - changed_area.extent, center + changed_area.extent );
+}
+
+
+Logic::NavigationGeometry DogWorld::GetNavigationGeometry() const
+{
+    Logic::NavigationGeometry geometry;
+    std::vector<Physics::DensityFunctionType> density_functions;
+    std::vector<BoundingShapes::AxisAlignedBox> density_bounds;
+    m_physics_world.GetStaticGeometry( geometry.triangle_vertices, density_functions, density_bounds );
+
+    geometry.density_functions.assign( begin(density_functions), end(density_functions) );
+    for( auto const & bounds : density_bounds )
+    {
+        geometry.density_minimums.push_back( bounds.center - bounds.extent );
+        geometry.density_maximums.push_back( bounds.center + bounds.extent );
+    }
+    return geometry;
+}
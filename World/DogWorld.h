@@ -2,6 +2,7 @@
 
 #include "EntityDescription.h"
 #include "EntityTemplates.h"
+#include "RenderSnapshot.h"
 #include "WorldConfiguration.h"
 
 #include <Conventions\EntityIDGenerator.h>
@@ -13,8 +14,11 @@
 #include <GameLogic\LogicWorld.h>
 #include <Graphics\RenderWorld.h>
 #include <Physics\PhysicsWorld.h>
+#include <Utilities\BoundedQueue.h>
 #include <Utilities\SimplexNoise.h>
 
+#include <functional>
+#include <thread>
 #include <vector>
 
 struct GameInput;
@@ -100,14 +104,23 @@ public:
 
     Math::Float3 FindRestingPositionOnEntity( Math::Float3 starting_position, EntityID target_entity ) const;
 
+    // the navigation mesh of the level is loaded from Resources\name.navmesh, or generated from the static bodies once they are spawned
+    // and saved there, so the file has to be deleted after changing the static geometry of the level
+    void SetLevelNavigationMesh( std::string name );
+    // builds the AI navigation mesh from the static bodies
+    void GenerateNavigationMesh();
+    // rebuilds the navigation mesh around the area, after static bodies in it were added or removed
+    void UpdateNavigationMesh( BoundingShapes::AxisAlignedBox const & changed_area );
+
     Input::WorldConfiguration & InputConfiguration( );
     Input::WorldConfiguration const & InputConfiguration( ) const;
 
     Logic::WorldConfiguration & LogicConfiguration( );
     Logic::WorldConfiguration const & LogicConfiguration( ) const;
 
-    Graphics::WorldConfiguration & GraphicsConfiguration();
     Graphics::WorldConfiguration const & GraphicsConfiguration() const;
+    // the render world gets the configuration through UpdateRenderWorld, so it's safe while the render thread runs
+    void SetGraphicsConfiguration( Graphics::WorldConfiguration const & configuration );
 
     void SetPhysicsConfiguration(Physics::WorldConfiguration const &);
 
@@ -143,6 +156,17 @@ private:
 
     void SetPhysicsDebugVisualization();
 
+    Logic::NavigationGeometry GetNavigationGeometry() const;
+    void PrepareNavigationMesh();
+
+    // runs the update right away, or when the render thread is running, before it renders the next snapshot
+    void UpdateRenderWorld( std::function<void( Graphics::RenderWorld & )> update );
+
+    void StartRenderThread();
+    void StopRenderThread();
+    void PublishRenderSnapshot( double start_render_time, Orientation camera_orientation );
+    void RenderThread();
+
     Math::Unsigned3 m_world_reference_position;
 
     Window m_window;
@@ -152,12 +176,25 @@ private:
 
 	Physics::PhysicsWorld	m_physics_world;
 	Graphics::RenderWorld	m_render_world;
+    // the copy of the graphics configuration the simulation reads, the render world has its own
+    Graphics::WorldConfiguration m_graphics_configuration;
+
+    // only touched by the simulation until it is pushed
+    RenderSnapshot m_next_render_snapshot;
+    // two snapshots in flight, so the simulation can work on the next tick while the previous one is rendered
+    BoundedQueue<RenderSnapshot> m_render_snapshots;
+    // snapshots that were rendered, so their buffers can be reused
+    BoundedQueue<RenderSnapshot> m_free_render_snapshots;
+    std::thread m_render_thread;
 	Animating::AnimatingWorld m_animating_world;
     Logic::LogicWorld m_logic_world;
 
     std::vector<EntityID> m_entity_ids;
     std::vector<std::string> m_entity_names;
 
+    std::string m_navigation_mesh_name;
+    bool m_navigation_mesh_pending = false;
+
     std::vector<EntitySpawn> m_entities_to_be_spawned;
 	std::vector<EntityID> m_entities_to_be_pruned;
     EntityComponentReplacements m_entity_component_replacements;
@@ -170,5 +207,4 @@ inline Input::WorldConfiguration const & DogWorld::InputConfiguration() const {
 inline Logic::WorldConfiguration & DogWorld::LogicConfiguration() { return m_logic_world.m_configuration; }
 inline Logic::WorldConfiguration const & DogWorld::LogicConfiguration() const { return m_logic_world.m_configuration; }
 
-inline Graphics::WorldConfiguration & DogWorld::GraphicsConfiguration() { return m_render_world.m_world_configuration; }
-inline Graphics::WorldConfiguration const & DogWorld::GraphicsConfiguration() const { return m_render_world.m_world_configuration; }
+inline Graphics::WorldConfiguration const & DogWorld::GraphicsConfiguration() const { return m_graphics_configuration; }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Conventions\Orientation.h>
+#include <Conventions\PerspectiveViewParameters.h>
+#include <Conventions\PoseInfo.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace Graphics
+{
+    class RenderWorld;
+}
+
+// everything the render thread needs to render the frames of one simulation tick
+// the simulation doesn't touch it anymore after it's published
+struct RenderSnapshot
+{
+    // both contain the current and previous state, so the render thread can blend between them
+    IndexedOrientations orientations;
+    IndexedOffsetPoses poses;
+    Orientation camera_orientation;
+    Orientation previous_camera_orientation;
+    PerspectiveViewParameters perspective_view;
+
+    // changes the simulation made to the render world during this tick, applied before rendering
+    std::vector<std::function<void( Graphics::RenderWorld & )>> render_world_updates;
+
+    float time_step = 0;
+    // the time since the start of the tick at the moment of publishing
+    double start_render_time = 0;
+    std::chrono::high_resolution_clock::time_point publish_time;
+};
@@ -3,4 +3,7 @@
 struct WorldConfiguration
 {
     float time_step;
+    // render on a separate thread from snapshots published by the simulation, instead of after every simulation tick
+    // set from scripts with SetSeparateRenderThread, takes effect at the start of the next tick
+    bool separate_render_thread = false;
 };
\ No newline at end of file
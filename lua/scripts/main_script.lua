@@ -23,6 +23,8 @@ function main()
     -- SpawnATower(1, Entities.Sheep);
     -- MakePlayer(nil, {x=0,y=5,z=0})
     SpawnPhysicsDemo();
+    -- load the navigation mesh of the level, or generate it from the static bodies spawned above
+    doggy:SetLevelNavigationMesh("navigation_main_level");
     -- SpawnATowerBlock(47, 8, Entities.RigidCube)
     -- TestParallelConstraintSolve();
     -- SpawnObstacleCourse(terrain_id);
@@ -65,6 +67,8 @@ function SetConfiguration()
     local gravity = {x = 0, y = 0, z = -9.81};
     doggy:SetGravity(gravity);
     doggy:SetTimeStep(1/60);
+    -- render from snapshots on a separate thread, so slow frames don't hold up the simulation
+    doggy:SetSeparateRenderThread(false);
 end
 
 
@@ -66,6 +66,7 @@ PhysicsComponents.Tomato = {
         mass = 0.12;
         bounciness = 0.3;
         friction = 0.2;
+        continuous_collision = true;
     }
 
 PhysicsComponents.GrassQuad = {